@@ -83,9 +83,11 @@ constexpr auto kSharedMediaLimit = 100;
 constexpr auto kFeedMessagesLimit = 50;
 constexpr auto kReadFeaturedSetsTimeout = TimeMs(1000);
 constexpr auto kFileLoaderQueueStopTimeout = TimeMs(5000);
+constexpr auto kFileLoaderMaxThreads = 4;
 constexpr auto kFeedReadTimeout = TimeMs(1000);
 constexpr auto kStickersByEmojiInvalidateTimeout = TimeMs(60 * 60 * 1000);
 constexpr auto kNotifySettingSaveTimeout = TimeMs(1000);
+constexpr auto kAnsweredRequestCacheTimeout = TimeMs(3000);
 
 using SimpleFileLocationId = Data::SimpleFileLocationId;
 using DocumentFileLocationId = Data::DocumentFileLocationId;
@@ -184,7 +186,9 @@ ApiWrap::ApiWrap(not_null<AuthSession*> session)
 , _webPagesTimer([=] { resolveWebPages(); })
 , _draftsSaveTimer([=] { saveDraftsToCloud(); })
 , _featuredSetsReadTimer([=] { readFeaturedSets(); })
-, _fileLoader(std::make_unique<TaskQueue>(kFileLoaderQueueStopTimeout))
+, _fileLoader(std::make_unique<TaskQueue>(
+	kFileLoaderQueueStopTimeout,
+	std::min(QThread::idealThreadCount(), kFileLoaderMaxThreads)))
 , _feedReadTimer([=] { readFeeds(); })
 , _proxyPromotionTimer([=] { refreshProxyPromotion(); })
 , _updateNotifySettingsTimer([=] { sendNotifySettingsUpdates(); }) {
@@ -900,9 +904,30 @@ void ApiWrap::requestWallPaper(
 	}).send();
 }
 
-void ApiWrap::requestFullPeer(not_null<PeerData*> peer) {
+bool ApiWrap::recentlyAnswered(
+		RecentAnswers &answers,
+		not_null<PeerData*> peer) {
+	const auto i = answers.find(peer);
+	if (i == answers.cend()) {
+		return false;
+	} else if (getms(true) - i->second >= kAnsweredRequestCacheTimeout) {
+		answers.erase(i);
+		return false;
+	}
+	return true;
+}
+
+void ApiWrap::rememberAnswered(
+		RecentAnswers &answers,
+		not_null<PeerData*> peer) {
+	answers[peer] = getms(true);
+}
+
+void ApiWrap::requestFullPeer(not_null<PeerData*> peer, bool forced) {
 	if (_fullPeerRequests.contains(peer)) {
 		return;
+	} else if (!forced && recentlyAnswered(_fullPeersAnswered, peer)) {
+		return;
 	}
 
 	const auto requestId = [&] {
@@ -1081,6 +1106,7 @@ void ApiWrap::gotChatFull(
 			_fullPeerRequests.erase(i);
 		}
 	}
+	rememberAnswered(_fullPeersAnswered, peer);
 	fullPeerUpdated().notify(peer);
 }
 
@@ -1129,12 +1155,15 @@ void ApiWrap::gotUserFull(
 			_fullPeerRequests.erase(i);
 		}
 	}
+	rememberAnswered(_fullPeersAnswered, user);
 	fullPeerUpdated().notify(user);
 }
 
 void ApiWrap::requestPeer(not_null<PeerData*> peer) {
 	if (_fullPeerRequests.contains(peer) || _peerRequests.contains(peer)) {
 		return;
+	} else if (recentlyAnswered(_peersAnswered, peer)) {
+		return;
 	}
 
 	const auto requestId = [&] {
@@ -1143,6 +1172,7 @@ void ApiWrap::requestPeer(not_null<PeerData*> peer) {
 		};
 		const auto chatHandler = [=](const MTPmessages_Chats &result) {
 			_peerRequests.remove(peer);
+			rememberAnswered(_peersAnswered, peer);
 			const auto &chats = result.match([](const auto &data) {
 				return data.vchats;
 			});
@@ -1154,6 +1184,7 @@ void ApiWrap::requestPeer(not_null<PeerData*> peer) {
 				MTP_vector<MTPInputUser>(1, user->inputUser)
 			)).done([=](const MTPVector<MTPUser> &result) {
 				_peerRequests.remove(user);
+				rememberAnswered(_peersAnswered, user);
 				_session->data().processUsers(result);
 			}).fail(failHandler).send();
 		} else if (const auto chat = peer->asChat()) {
@@ -1329,7 +1360,8 @@ void ApiWrap::requestPeers(const QList<PeerData*> &peers) {
 	for (const auto peer : peers) {
 		if (!peer
 			|| _fullPeerRequests.contains(peer)
-			|| _peerRequests.contains(peer)) {
+			|| _peerRequests.contains(peer)
+			|| recentlyAnswered(_peersAnswered, peer)) {
 			continue;
 		}
 		if (const auto user = peer->asUser()) {
@@ -1366,7 +1398,8 @@ void ApiWrap::requestPeers(const QList<PeerData*> &peers) {
 
 void ApiWrap::requestLastParticipants(not_null<ChannelData*> channel) {
 	if (!channel->isMegagroup()
-		|| _participantsRequests.contains(channel)) {
+		|| _participantsRequests.contains(channel)
+		|| recentlyAnswered(_participantsAnswered, channel)) {
 		return;
 	}
 
@@ -1380,6 +1413,7 @@ void ApiWrap::requestLastParticipants(not_null<ChannelData*> channel) {
 		MTP_int(participantsHash)
 	)).done([=](const MTPchannels_ChannelParticipants &result) {
 		_participantsRequests.remove(channel);
+		rememberAnswered(_participantsAnswered, channel);
 		parseChannelParticipants(channel, result, [&](
 				int availableCount,
 				const QVector<MTPChannelParticipant> &list) {
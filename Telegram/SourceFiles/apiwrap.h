@@ -97,7 +97,7 @@ public:
 		Fn<void(const Data::WallPaper &)> done,
 		Fn<void(const RPCError &)> fail);
 
-	void requestFullPeer(not_null<PeerData*> peer);
+	void requestFullPeer(not_null<PeerData*> peer, bool forced = false);
 	void requestPeer(not_null<PeerData*> peer);
 	void requestPeers(const QList<PeerData*> &peers);
 	void requestLastParticipants(not_null<ChannelData*> channel);
@@ -604,6 +604,13 @@ private:
 
 	void sendDialogRequests();
 
+	// Short-lived per-peer cache of freshly answered requests, so that
+	// different UI surfaces asking for the same data within a couple of
+	// seconds share one answer instead of repeating the RPC.
+	using RecentAnswers = base::flat_map<not_null<PeerData*>, TimeMs>;
+	bool recentlyAnswered(RecentAnswers &answers, not_null<PeerData*> peer);
+	void rememberAnswered(RecentAnswers &answers, not_null<PeerData*> peer);
+
 	not_null<AuthSession*> _session;
 
 	MessageDataRequests _messageDataRequests;
@@ -613,6 +620,9 @@ private:
 	using PeerRequests = QMap<PeerData*, mtpRequestId>;
 	PeerRequests _fullPeerRequests;
 	PeerRequests _peerRequests;
+	RecentAnswers _fullPeersAnswered;
+	RecentAnswers _peersAnswered;
+	RecentAnswers _participantsAnswered;
 
 	PeerRequests _participantsRequests;
 	PeerRequests _botsRequests;
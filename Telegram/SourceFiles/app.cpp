@@ -57,11 +57,16 @@ namespace {
 	using DependentItems = QMap<HistoryItem*, DependentItemsSet>;
 	DependentItems dependentItems;
 
-	using MsgsData = QHash<MsgId, HistoryItem*>;
+	using MsgsData = std::unordered_map<MsgId, HistoryItem*>;
 	MsgsData msgsData;
-	using ChannelMsgsData = QMap<ChannelId, MsgsData>;
+	using ChannelMsgsData = std::unordered_map<ChannelId, MsgsData>;
 	ChannelMsgsData channelMsgsData;
 
+	// Reserved bucket counts, so that message registration during
+	// history loads doesn't pay for incremental rehashes.
+	constexpr auto kMsgsDataReserve = 0x10000;
+	constexpr auto kChannelMsgsDataReserve = 0x400;
+
 	using RandomData = QMap<uint64, FullMsgId>;
 	RandomData randomData;
 
@@ -336,16 +341,22 @@ namespace App {
 	}
 
 	inline MsgsData *fetchMsgsData(ChannelId channelId, bool insert = true) {
-		if (channelId == NoChannel) return &msgsData;
-		ChannelMsgsData::iterator i = channelMsgsData.find(channelId);
+		if (channelId == NoChannel) {
+			if (msgsData.empty()) {
+				msgsData.reserve(kMsgsDataReserve);
+			}
+			return &msgsData;
+		}
+		auto i = channelMsgsData.find(channelId);
 		if (i == channelMsgsData.cend()) {
 			if (insert) {
-				i = channelMsgsData.insert(channelId, MsgsData());
+				i = channelMsgsData.emplace(channelId, MsgsData()).first;
+				i->second.reserve(kChannelMsgsDataReserve);
 			} else {
 				return 0;
 			}
 		}
-		return &(*i);
+		return &i->second;
 	}
 
 	void feedWereDeleted(
@@ -360,10 +371,11 @@ namespace App {
 
 		auto historiesToCheck = base::flat_set<not_null<History*>>();
 		for (const auto msgId : msgsIds) {
-			auto j = data->constFind(msgId.v);
+			auto j = data->find(msgId.v);
 			if (j != data->cend()) {
-				const auto history = (*j)->history();
-				(*j)->destroy();
+				const auto item = j->second;
+				const auto history = item->history();
+				item->destroy();
 				if (!history->chatListMessageKnown()) {
 					historiesToCheck.emplace(history);
 				}
@@ -425,9 +437,9 @@ namespace App {
 		auto data = fetchMsgsData(channelId, false);
 		if (!data) return nullptr;
 
-		auto i = data->constFind(itemId);
+		auto i = data->find(itemId);
 		if (i != data->cend()) {
-			return i.value();
+			return i->second;
 		}
 		return nullptr;
 	}
@@ -438,13 +450,13 @@ namespace App {
 
 	void historyRegItem(not_null<HistoryItem*> item) {
 		const auto data = fetchMsgsData(item->channelId());
-		const auto i = data->constFind(item->id);
+		const auto i = data->find(item->id);
 		if (i == data->cend()) {
-			data->insert(item->id, item);
-		} else if (i.value() != item) {
+			data->emplace(item->id, item);
+		} else if (i->second != item) {
 			LOG(("App Error: trying to historyRegItem() an already registered item"));
-			i.value()->destroy();
-			data->insert(item->id, item);
+			i->second->destroy();
+			(*data)[item->id] = item;
 		}
 	}
 
@@ -454,7 +466,7 @@ namespace App {
 
 		const auto i = data->find(item->id);
 		if (i != data->cend()) {
-			if (i.value() == item) {
+			if (i->second == item) {
 				data->erase(i);
 			}
 		}
@@ -487,11 +499,11 @@ namespace App {
 		::dependentItems.clear();
 		const auto oldData = base::take(msgsData);
 		const auto oldChannelData = base::take(channelMsgsData);
-		for (const auto item : oldData) {
+		for (const auto &[msgId, item] : oldData) {
 			delete item;
 		}
-		for (const auto &data : oldChannelData) {
-			for (const auto item : data) {
+		for (const auto &[channelId, data] : oldChannelData) {
+			for (const auto &[msgId, item] : data) {
 				delete item;
 			}
 		}
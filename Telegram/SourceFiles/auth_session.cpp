@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/file_upload.h"
 #include "storage/localstorage.h"
 #include "storage/storage_facade.h"
+#include "storage/storage_shared_media.h"
 #include "storage/serialize_common.h"
 #include "data/data_session.h"
 #include "data/data_user.h"
@@ -34,6 +35,7 @@ namespace {
 
 constexpr auto kAutoLockTimeoutLateMs = TimeMs(3000);
 constexpr auto kLegacyCallsPeerToPeerNobody = 4;
+constexpr auto kSaveSharedMediaCountsDelay = TimeMs(10000);
 
 } // namespace
 
@@ -48,7 +50,7 @@ AuthSessionSettings::Variables::Variables()
 
 QByteArray AuthSessionSettings::serialize() const {
 	const auto autoDownload = _variables.autoDownload.serialize();
-	auto size = sizeof(qint32) * 23;
+	auto size = sizeof(qint32) * 23 + sizeof(quint64);
 	for (auto i = _variables.soundOverrides.cbegin(), e = _variables.soundOverrides.cend(); i != e; ++i) {
 		size += Serialize::stringSize(i.key()) + Serialize::stringSize(i.value());
 	}
@@ -94,6 +96,7 @@ QByteArray AuthSessionSettings::serialize() const {
 		stream << qint32(_variables.exeLaunchWarning ? 1 : 0);
 		stream << autoDownload;
 		stream << qint32(_variables.supportAllSearchResults.current() ? 1 : 0);
+		stream << quint64(_variables.lastOpenPeer);
 	}
 	return result;
 }
@@ -130,6 +133,7 @@ void AuthSessionSettings::constructFromSerialized(const QByteArray &serialized)
 	qint32 exeLaunchWarning = _variables.exeLaunchWarning ? 1 : 0;
 	QByteArray autoDownload;
 	qint32 supportAllSearchResults = _variables.supportAllSearchResults.current() ? 1 : 0;
+	quint64 lastOpenPeer = _variables.lastOpenPeer;
 
 	stream >> selectorTab;
 	stream >> lastSeenWarningSeen;
@@ -209,6 +213,9 @@ void AuthSessionSettings::constructFromSerialized(const QByteArray &serialized)
 	if (!stream.atEnd()) {
 		stream >> supportAllSearchResults;
 	}
+	if (!stream.atEnd()) {
+		stream >> lastOpenPeer;
+	}
 	if (stream.status() != QDataStream::Ok) {
 		LOG(("App Error: "
 			"Bad data for AuthSessionSettings::constructFromSerialized()"));
@@ -278,6 +285,7 @@ void AuthSessionSettings::constructFromSerialized(const QByteArray &serialized)
 	_variables.countUnreadMessages = (countUnreadMessages == 1);
 	_variables.exeLaunchWarning = (exeLaunchWarning == 1);
 	_variables.supportAllSearchResults = (supportAllSearchResults == 1);
+	_variables.lastOpenPeer = lastOpenPeer;
 }
 
 void AuthSessionSettings::setSupportChatsTimeSlice(int slice) {
@@ -393,6 +401,17 @@ AuthSession::AuthSession(const MTPUser &user)
 	_saveDataTimer.setCallback([=] {
 		Local::writeUserSettings();
 	});
+	_saveMediaCountsTimer.setCallback([=] {
+		Local::writeSharedMediaCounts();
+	});
+	storage().sharedMediaSliceUpdated(
+	) | rpl::filter([](const Storage::SharedMediaSliceUpdate &update) {
+		return update.data.count.has_value();
+	}) | rpl::start_with_next([=] {
+		if (!_saveMediaCountsTimer.isActive()) {
+			_saveMediaCountsTimer.callOnce(kSaveSharedMediaCountsDelay);
+		}
+	}, _lifetime);
 	Core::App().passcodeLockChanges(
 	) | rpl::start_with_next([=] {
 		_shouldLockAt = 0;
@@ -216,6 +216,12 @@ public:
 	void setExeLaunchWarning(bool warning) {
 		_variables.exeLaunchWarning = warning;
 	}
+	PeerId lastOpenPeer() const {
+		return _variables.lastOpenPeer;
+	}
+	void setLastOpenPeer(PeerId peerId) {
+		_variables.lastOpenPeer = peerId;
+	}
 
 private:
 	struct Variables {
@@ -245,6 +251,7 @@ private:
 		bool includeMutedCounter = true;
 		bool countUnreadMessages = true;
 		bool exeLaunchWarning = true;
+		PeerId lastOpenPeer = 0;
 		Data::AutoDownload::Full autoDownload;
 
 		static constexpr auto kDefaultSupportChatsLimitSlice
@@ -342,6 +349,7 @@ private:
 
 	AuthSessionSettings _settings;
 	base::Timer _saveDataTimer;
+	base::Timer _saveMediaCountsTimer;
 
 	TimeMs _shouldLockAt = 0;
 	base::Timer _autoLockTimer;
@@ -0,0 +1,246 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "base/flat_map.h"
+#include "base/flat_set.h"
+
+#include <rpl/rpl.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace base {
+namespace assertion {
+
+// For Assert() / Expects() / Ensures() / Unexpected() to work.
+void log(const char *message, const char *file, int line) {
+	std::cout << message << " (" << file << ":" << line << ")" << std::endl;
+}
+
+} // namespace assertion
+} // namespace base
+
+namespace {
+
+// Each benchmark body performs the passed number of work units, the
+// runner doubles that count until a pass takes at least the minimum
+// run time and reports the best of several passes, so that results
+// are stable enough to compare across releases.
+constexpr auto kMinimumRunTime = std::chrono::milliseconds(100);
+constexpr auto kPassesCount = 3;
+
+using BenchmarkBody = std::function<void(int iterations)>;
+
+struct Benchmark {
+	std::string name;
+	BenchmarkBody body;
+};
+
+std::vector<Benchmark> &List() {
+	static auto result = std::vector<Benchmark>();
+	return result;
+}
+
+bool RegisterBenchmark(const char *name, BenchmarkBody body) {
+	List().push_back({ name, std::move(body) });
+	return true;
+}
+
+#define BENCHMARK(Name) \
+void Name(int iterations); \
+const auto Name##Registered = RegisterBenchmark(#Name, Name); \
+void Name(int iterations)
+
+std::vector<int> ShuffledValues(int count) {
+	auto result = std::vector<int>(count);
+	std::iota(begin(result), end(result), 0);
+	std::shuffle(begin(result), end(result), std::mt19937(42));
+	return result;
+}
+
+BENCHMARK(flat_map_insert_sequential) {
+	auto map = base::flat_map<int, int>();
+	for (auto i = 0; i != iterations; ++i) {
+		map.emplace(i, i);
+	}
+}
+
+BENCHMARK(flat_map_insert_shuffled) {
+	const auto values = ShuffledValues(iterations);
+	auto map = base::flat_map<int, int>();
+	for (const auto value : values) {
+		map.emplace(value, value);
+	}
+}
+
+BENCHMARK(flat_map_lookup) {
+	constexpr auto kSize = 1024;
+	auto map = base::flat_map<int, int>();
+	for (auto i = 0; i != kSize; ++i) {
+		map.emplace(i, i);
+	}
+	auto found = 0;
+	for (auto i = 0; i != iterations; ++i) {
+		found += (map.find(i % kSize) != map.end()) ? 1 : 0;
+	}
+	if (found != iterations) {
+		std::abort();
+	}
+}
+
+BENCHMARK(flat_set_insert_shuffled) {
+	const auto values = ShuffledValues(iterations);
+	auto set = base::flat_set<int>();
+	for (const auto value : values) {
+		set.emplace(value);
+	}
+}
+
+BENCHMARK(flat_set_lookup) {
+	constexpr auto kSize = 1024;
+	auto set = base::flat_set<int>();
+	for (auto i = 0; i != kSize; ++i) {
+		set.emplace(i);
+	}
+	auto found = 0;
+	for (auto i = 0; i != iterations; ++i) {
+		found += set.contains(i % kSize) ? 1 : 0;
+	}
+	if (found != iterations) {
+		std::abort();
+	}
+}
+
+BENCHMARK(rpl_event_stream_fire) {
+	auto lifetime = rpl::lifetime();
+	auto stream = rpl::event_stream<int>();
+	auto sum = 0;
+	stream.events(
+	) | rpl::start_with_next([&](int value) {
+		sum += value;
+	}, lifetime);
+	for (auto i = 0; i != iterations; ++i) {
+		stream.fire_copy(i);
+	}
+}
+
+BENCHMARK(rpl_chain_map_filter) {
+	auto lifetime = rpl::lifetime();
+	auto stream = rpl::event_stream<int>();
+	auto sum = 0;
+	stream.events(
+	) | rpl::map([](int value) {
+		return value * 2;
+	}) | rpl::filter([](int value) {
+		return (value % 4) == 0;
+	}) | rpl::start_with_next([&](int value) {
+		sum += value;
+	}, lifetime);
+	for (auto i = 0; i != iterations; ++i) {
+		stream.fire_copy(i);
+	}
+}
+
+BENCHMARK(rpl_chain_construct_destruct) {
+	for (auto i = 0; i != iterations; ++i) {
+		auto lifetime = rpl::lifetime();
+		auto stream = rpl::event_stream<int>();
+		stream.events(
+		) | rpl::map([](int value) {
+			return value + 1;
+		}) | rpl::distinct_until_changed(
+		) | rpl::start_with_next([](int) {
+		}, lifetime);
+		stream.fire_copy(i);
+	}
+}
+
+struct RunResult {
+	std::string name;
+	long long iterations = 0;
+	double nanosecondsPerIteration = 0.;
+};
+
+RunResult Run(const Benchmark &benchmark) {
+	using namespace std::chrono;
+
+	auto iterations = 1024;
+	while (true) {
+		const auto start = steady_clock::now();
+		benchmark.body(iterations);
+		const auto elapsed = steady_clock::now() - start;
+		if (elapsed >= kMinimumRunTime) {
+			break;
+		}
+		iterations *= 2;
+	}
+	auto best = double(0.);
+	for (auto pass = 0; pass != kPassesCount; ++pass) {
+		const auto start = steady_clock::now();
+		benchmark.body(iterations);
+		const auto elapsed = duration_cast<nanoseconds>(
+			steady_clock::now() - start).count();
+		const auto average = double(elapsed) / iterations;
+		if (!pass || average < best) {
+			best = average;
+		}
+	}
+	return { benchmark.name, iterations, best };
+}
+
+std::string ResultsToJson(const std::vector<RunResult> &results) {
+	auto stream = std::ostringstream();
+	stream << "[\n";
+	auto first = true;
+	for (const auto &result : results) {
+		if (!first) {
+			stream << ",\n";
+		}
+		first = false;
+		stream << "\t{ \"name\": \"" << result.name
+			<< "\", \"iterations\": " << result.iterations
+			<< ", \"ns_per_iteration\": " << result.nanosecondsPerIteration
+			<< " }";
+	}
+	stream << "\n]\n";
+	return stream.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+	auto outputPath = std::string();
+	for (auto i = 1; i < argc - 1; ++i) {
+		if (argv[i] == std::string("--output")) {
+			outputPath = argv[i + 1];
+		}
+	}
+	auto results = std::vector<RunResult>();
+	for (const auto &benchmark : List()) {
+		std::cerr << "Running " << benchmark.name << ".." << std::endl;
+		results.push_back(Run(benchmark));
+	}
+	const auto json = ResultsToJson(results);
+	if (!outputPath.empty()) {
+		auto output = std::ofstream(outputPath);
+		if (!output) {
+			std::cerr << "Could not open '" << outputPath
+				<< "' for writing." << std::endl;
+			return -1;
+		}
+		output << json;
+	} else {
+		std::cout << json;
+	}
+	return 0;
+}
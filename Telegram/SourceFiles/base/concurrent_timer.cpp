@@ -7,8 +7,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "base/concurrent_timer.h"
 
+#include "base/flat_map.h"
 #include <QtCore/QThread>
 #include <QtCore/QCoreApplication>
+#include <QtCore/QPointer>
 
 using namespace base::details;
 
@@ -75,33 +77,141 @@ CancelTimerEvent::CancelTimerEvent() : QEvent(kCancelTimerEvent) {
 
 } // namespace
 
+// A single system timer armed for the nearest pending deadline serves
+// all the timers of the environment. Expired entries are delivered in
+// one batch per wakeup, so thousands of pending timeouts don't create
+// thousands of system timers and wakeups on the timers thread. All the
+// methods are called only on that thread, no synchronization is needed.
+class TimerScheduler : public QObject {
+public:
+	void schedule(
+		not_null<TimerObject*> timer,
+		crl::time_type when,
+		Qt::TimerType type);
+	void cancel(not_null<TimerObject*> timer, crl::time_type when);
+
+protected:
+	void timerEvent(QTimerEvent *e) override;
+
+private:
+	struct Entry {
+		TimerObject *timer = nullptr;
+		Qt::TimerType type = Qt::CoarseTimer;
+	};
+
+	void fireBatch(crl::time_type now);
+	void rearm(crl::time_type now);
+	void disarm();
+
+	flat_multi_map<crl::time_type, Entry> _queue;
+	crl::time_type _armedFor = 0;
+	int _timerId = 0;
+
+};
+
 class TimerObject : public QObject {
 public:
 	TimerObject(
 		not_null<QThread*> thread,
 		not_null<QObject*> adjuster,
+		not_null<TimerScheduler*> scheduler,
 		Fn<void()> adjust);
+	~TimerObject();
+
+	void callNow();
 
 protected:
 	bool event(QEvent *e) override;
 
 private:
 	void callDelayed(not_null<CallDelayedEvent*> e);
-	void callNow();
 	void cancel();
 	void adjust();
 
+	QPointer<TimerScheduler> _scheduler;
 	FnMut<void()> _next;
 	Fn<void()> _adjust;
-	int _timerId = 0;
+	crl::time_type _scheduledFor = 0;
 
 };
 
+void TimerScheduler::schedule(
+		not_null<TimerObject*> timer,
+		crl::time_type when,
+		Qt::TimerType type) {
+	_queue.emplace(when, Entry{ timer.get(), type });
+	if (!_timerId || when < _armedFor) {
+		rearm(crl::time());
+	}
+}
+
+void TimerScheduler::cancel(
+		not_null<TimerObject*> timer,
+		crl::time_type when) {
+	for (auto i = _queue.findFirst(when)
+		; i != _queue.end() && i->first == when
+		; ++i) {
+		if (i->second.timer == timer) {
+			_queue.erase(i);
+			break;
+		}
+	}
+	if (_queue.empty()) {
+		disarm();
+	}
+}
+
+void TimerScheduler::timerEvent(QTimerEvent *e) {
+	if (e->timerId() != _timerId) {
+		return;
+	}
+	disarm();
+
+	const auto now = crl::time();
+	fireBatch(now);
+	if (!_queue.empty()) {
+		rearm(now);
+	}
+}
+
+void TimerScheduler::fireBatch(crl::time_type now) {
+	// The whole due batch is taken out of the queue first - firing a
+	// timer can schedule and cancel other timers, changing the queue.
+	auto due = std::vector<TimerObject*>();
+	while (!_queue.empty() && _queue.front().first <= now) {
+		due.push_back(_queue.front().second.timer);
+		_queue.erase(_queue.begin());
+	}
+	for (const auto timer : due) {
+		timer->callNow();
+	}
+}
+
+void TimerScheduler::rearm(crl::time_type now) {
+	Expects(!_queue.empty());
+
+	disarm();
+	const auto when = _queue.front().first;
+	const auto type = _queue.front().second.type;
+	const auto left = std::max(when - now, crl::time_type(0));
+	_armedFor = when;
+	_timerId = startTimer(int(left), type);
+}
+
+void TimerScheduler::disarm() {
+	if (const auto id = base::take(_timerId)) {
+		killTimer(id);
+	}
+	_armedFor = 0;
+}
+
 TimerObject::TimerObject(
 		not_null<QThread*> thread,
 		not_null<QObject*> adjuster,
+		not_null<TimerScheduler*> scheduler,
 		Fn<void()> adjust)
-: _adjust(std::move(adjust)) {
+: _scheduler(scheduler.get())
+, _adjust(std::move(adjust)) {
 	moveToThread(thread);
 	connect(
 		adjuster,
@@ -111,6 +221,10 @@ TimerObject::TimerObject(
 		Qt::DirectConnection);
 }
 
+TimerObject::~TimerObject() {
+	cancel();
+}
+
 bool TimerObject::event(QEvent *e) {
 	const auto type = e->type();
 	switch (type) {
@@ -120,9 +234,6 @@ bool TimerObject::event(QEvent *e) {
 	case kCancelTimerEvent:
 		cancel();
 		return true;
-	case QEvent::Timer:
-		callNow();
-		return true;
 	}
 	return QObject::event(e);
 }
@@ -134,23 +245,31 @@ void TimerObject::callDelayed(not_null<CallDelayedEvent*> e) {
 	const auto type = e->type();
 	_next = e->takeMethod();
 	if (timeout > 0) {
-		_timerId = startTimer(timeout, type);
+		if (const auto scheduler = _scheduler.data()) {
+			_scheduledFor = crl::time() + timeout;
+			scheduler->schedule(this, _scheduledFor, type);
+		}
 	} else {
 		base::take(_next)();
 	}
 }
 
 void TimerObject::cancel() {
-	if (const auto id = base::take(_timerId)) {
-		killTimer(id);
+	if (const auto when = base::take(_scheduledFor)) {
+		if (const auto scheduler = _scheduler.data()) {
+			scheduler->cancel(this, when);
+		}
 	}
 	_next = nullptr;
 }
 
 void TimerObject::callNow() {
-	auto next = base::take(_next);
-	cancel();
-	next();
+	_scheduledFor = 0;
+
+	// A timer fired earlier in the same batch could cancel this one.
+	if (auto next = base::take(_next)) {
+		next();
+	}
 }
 
 void TimerObject::adjust() {
@@ -203,7 +322,9 @@ void TimerObjectWrap::sendEvent(std::unique_ptr<QEvent> event) {
 
 } // namespace details
 
-ConcurrentTimerEnvironment::ConcurrentTimerEnvironment() {
+ConcurrentTimerEnvironment::ConcurrentTimerEnvironment()
+: _scheduler(std::make_unique<details::TimerScheduler>()) {
+	_scheduler->moveToThread(&_thread);
 	_thread.start();
 	_adjuster.moveToThread(&_thread);
 
@@ -222,6 +343,7 @@ std::unique_ptr<TimerObject> ConcurrentTimerEnvironment::createTimer(
 	return std::make_unique<TimerObject>(
 		&_thread,
 		&_adjuster,
+		_scheduler.get(),
 		std::move(adjust));
 }
 
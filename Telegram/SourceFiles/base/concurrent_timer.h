@@ -16,6 +16,7 @@ namespace base {
 namespace details {
 
 class TimerObject;
+class TimerScheduler;
 
 class TimerObjectWrap {
 public:
@@ -54,6 +55,11 @@ private:
 	QThread _thread;
 	QObject _adjuster;
 
+	// All the timers of the environment fire through this single
+	// scheduler living on the timers thread, so any number of pending
+	// timeouts costs one system timer and one wakeup per nearest batch.
+	std::unique_ptr<details::TimerScheduler> _scheduler;
+
 };
 
 class ConcurrentTimer {
@@ -16,6 +16,20 @@ namespace base {
 using std::begin;
 using std::end;
 
+namespace details {
+
+template <typename Compare, typename = void>
+struct is_transparent_compare : std::false_type {
+};
+
+template <typename Compare>
+struct is_transparent_compare<
+	Compare,
+	std::void_t<typename Compare::is_transparent>> : std::true_type {
+};
+
+} // namespace details
+
 template <
 	typename Key,
 	typename Type,
@@ -231,6 +245,18 @@ private:
 	using pair_type = flat_multi_map_pair_type<Key, Type>;
 	using impl_t = std::deque<pair_type>;
 
+	// Lookup methods get heterogeneous overloads if the comparator is
+	// transparent, so a QString key can be probed with a QStringRef or
+	// a std::string one with a std::string_view without constructing a
+	// temporary Key. Types implicitly convertible to Key or to an
+	// iterator are excluded, existing call sites keep hitting the
+	// exact-Key and the iterator versions exactly as before.
+	template <typename OtherKey>
+	using transparent_key_t = std::enable_if_t<
+		details::is_transparent_compare<Compare>::value
+			&& !std::is_convertible_v<const OtherKey&, Key>
+			&& !std::is_convertible_v<const OtherKey&, const_iterator>>;
+
 	using iterator_base = flat_multi_map_iterator_base_impl<
 		iterator,
 		Key,
@@ -429,6 +455,20 @@ public:
 		impl().erase(where);
 		return true;
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	bool removeOne(const OtherKey &key) {
+		if (empty()
+			|| compare()(key, front().first)
+			|| compare()(back().first, key)) {
+			return false;
+		}
+		auto where = getLowerBound(key);
+		if (compare()(key, where->first)) {
+			return false;
+		}
+		impl().erase(where);
+		return true;
+	}
 	int removeAll(const Key &key) {
 		if (empty()
 			|| compare()(key, front().first)
@@ -443,6 +483,21 @@ public:
 		impl().erase(range.first, range.second);
 		return result;
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	int removeAll(const OtherKey &key) {
+		if (empty()
+			|| compare()(key, front().first)
+			|| compare()(back().first, key)) {
+			return 0;
+		}
+		auto range = getEqualRange(key);
+		if (range.first == range.second) {
+			return 0;
+		}
+		const auto result = (range.second - range.first);
+		impl().erase(range.first, range.second);
+		return result;
+	}
 
 	iterator erase(const_iterator where) {
 		return impl().erase(where._impl);
@@ -453,6 +508,10 @@ public:
 	int erase(const Key &key) {
 		return removeAll(key);
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	int erase(const OtherKey &key) {
+		return removeAll(key);
+	}
 
 	iterator findFirst(const Key &key) {
 		if (empty()
@@ -463,6 +522,16 @@ public:
 		auto where = getLowerBound(key);
 		return compare()(key, where->first) ? impl().end() : where;
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	iterator findFirst(const OtherKey &key) {
+		if (empty()
+			|| compare()(key, front().first)
+			|| compare()(back().first, key)) {
+			return end();
+		}
+		auto where = getLowerBound(key);
+		return compare()(key, where->first) ? impl().end() : where;
+	}
 
 	const_iterator findFirst(const Key &key) const {
 		if (empty()
@@ -473,10 +542,24 @@ public:
 		auto where = getLowerBound(key);
 		return compare()(key, where->first) ? impl().end() : where;
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	const_iterator findFirst(const OtherKey &key) const {
+		if (empty()
+			|| compare()(key, front().first)
+			|| compare()(back().first, key)) {
+			return end();
+		}
+		auto where = getLowerBound(key);
+		return compare()(key, where->first) ? impl().end() : where;
+	}
 
 	bool contains(const Key &key) const {
 		return findFirst(key) != end();
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	bool contains(const OtherKey &key) const {
+		return findFirst(key) != end();
+	}
 	int count(const Key &key) const {
 		if (empty()
 			|| compare()(key, front().first)
@@ -486,6 +569,16 @@ public:
 		auto range = getEqualRange(key);
 		return (range.second - range.first);
 	}
+	template <typename OtherKey, typename = transparent_key_t<OtherKey>>
+	int count(const OtherKey &key) const {
+		if (empty()
+			|| compare()(key, front().first)
+			|| compare()(back().first, key)) {
+			return 0;
+		}
+		auto range = getEqualRange(key);
+		return (range.second - range.first);
+	}
 
 private:
 	friend class flat_map<Key, Type, Compare>;
@@ -558,48 +651,56 @@ private:
 		return _data.elements;
 	}
 
-	typename impl_t::iterator getLowerBound(const Key &key) {
+	template <typename OtherKey>
+	typename impl_t::iterator getLowerBound(const OtherKey &key) {
 		return std::lower_bound(
 			std::begin(impl()),
 			std::end(impl()),
 			key,
 			compare());
 	}
-	typename impl_t::const_iterator getLowerBound(const Key &key) const {
+	template <typename OtherKey>
+	typename impl_t::const_iterator getLowerBound(
+			const OtherKey &key) const {
 		return std::lower_bound(
 			std::begin(impl()),
 			std::end(impl()),
 			key,
 			compare());
 	}
-	typename impl_t::iterator getUpperBound(const Key &key) {
+	template <typename OtherKey>
+	typename impl_t::iterator getUpperBound(const OtherKey &key) {
 		return std::upper_bound(
 			std::begin(impl()),
 			std::end(impl()),
 			key,
 			compare());
 	}
-	typename impl_t::const_iterator getUpperBound(const Key &key) const {
+	template <typename OtherKey>
+	typename impl_t::const_iterator getUpperBound(
+			const OtherKey &key) const {
 		return std::upper_bound(
 			std::begin(impl()),
 			std::end(impl()),
 			key,
 			compare());
 	}
+	template <typename OtherKey>
 	std::pair<
 		typename impl_t::iterator,
 		typename impl_t::iterator
-	> getEqualRange(const Key &key) {
+	> getEqualRange(const OtherKey &key) {
 		return std::equal_range(
 			std::begin(impl()),
 			std::end(impl()),
 			key,
 			compare());
 	}
+	template <typename OtherKey>
 	std::pair<
 		typename impl_t::const_iterator,
 		typename impl_t::const_iterator
-	> getEqualRange(const Key &key) const {
+	> getEqualRange(const OtherKey &key) const {
 		return std::equal_range(
 			std::begin(impl()),
 			std::end(impl()),
@@ -726,6 +827,12 @@ public:
 	bool remove(const Key &key) {
 		return this->removeOne(key);
 	}
+	template <
+		typename OtherKey,
+		typename = typename parent::template transparent_key_t<OtherKey>>
+	bool remove(const OtherKey &key) {
+		return this->removeOne(key);
+	}
 
 	iterator find(const Key &key) {
 		return this->findFirst(key);
@@ -733,6 +840,18 @@ public:
 	const_iterator find(const Key &key) const {
 		return this->findFirst(key);
 	}
+	template <
+		typename OtherKey,
+		typename = typename parent::template transparent_key_t<OtherKey>>
+	iterator find(const OtherKey &key) {
+		return this->findFirst(key);
+	}
+	template <
+		typename OtherKey,
+		typename = typename parent::template transparent_key_t<OtherKey>>
+	const_iterator find(const OtherKey &key) const {
+		return this->findFirst(key);
+	}
 
 	Type &operator[](const Key &key) {
 		if (this->empty() || this->compare()(key, this->front().first)) {
@@ -758,6 +877,18 @@ public:
 		this->erase(it);
 		return std::move(result);
 	}
+	template <
+		typename OtherKey,
+		typename = typename parent::template transparent_key_t<OtherKey>>
+	std::optional<Type> take(const OtherKey &key) {
+		auto it = find(key);
+		if (it == this->end()) {
+			return std::nullopt;
+		}
+		auto result = std::move(it->second);
+		this->erase(it);
+		return std::move(result);
+	}
 
 private:
 	void finalize() {
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/flat_map.h"
 #include <string>
+#include <string_view>
 
 struct int_wrap {
 	int value;
@@ -119,3 +120,29 @@ TEST_CASE("flat_maps structured bindings", "[flat_map]") {
 		}
 	}
 }
+
+TEST_CASE("flat_maps heterogeneous lookup", "[flat_map]") {
+	base::flat_map<string, int> v;
+	v.emplace("a", 1);
+	v.emplace("b", 2);
+	v.emplace("c", 3);
+
+	const auto key = std::string_view("b");
+	REQUIRE(v.contains(key));
+	REQUIRE(v.find(key) != v.end());
+	REQUIRE(v.find(key)->second == 2);
+	REQUIRE(!v.contains(std::string_view("d")));
+
+	auto taken = v.take(key);
+	REQUIRE(taken == 2);
+	REQUIRE(!v.contains(key));
+	REQUIRE(v.remove(std::string_view("a")));
+	REQUIRE(v.size() == 1);
+
+	base::flat_multi_map<string, int> m;
+	m.emplace("x", 1);
+	m.emplace("x", 2);
+	REQUIRE(m.count(std::string_view("x")) == 2);
+	REQUIRE(m.removeAll(std::string_view("x")) == 2);
+	REQUIRE(m.empty());
+}
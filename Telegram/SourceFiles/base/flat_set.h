@@ -396,8 +396,18 @@ public:
 		typename Iterator,
 		typename = typename std::iterator_traits<Iterator>::iterator_category>
 	void merge(Iterator first, Iterator last) {
+		// The stored part is always sorted, so only the appended part
+		// needs sorting, after that the two parts are merged in place
+		// instead of re-sorting the whole storage on each merge.
+		const auto storedCount = impl().size();
 		impl().insert(impl().end(), first, last);
-		std::sort(std::begin(impl()), std::end(impl()), compare());
+		const auto middle = std::begin(impl()) + storedCount;
+		std::sort(middle, std::end(impl()), compare());
+		std::inplace_merge(
+			std::begin(impl()),
+			middle,
+			std::end(impl()),
+			compare());
 	}
 
 	void merge(const flat_multi_set<Type, Compare> &other) {
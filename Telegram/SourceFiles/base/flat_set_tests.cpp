@@ -56,6 +56,33 @@ TEST_CASE("flat_sets should keep items sorted", "[flat_set]") {
 	}
 }
 
+TEST_CASE("flat_sets merge", "[flat_set]") {
+	base::flat_set<int> v;
+	v.insert(0);
+	v.insert(2);
+	v.insert(4);
+
+	SECTION("merging an unsorted range keeps items sorted") {
+		auto other = std::vector<int>{ 5, 1, 3 };
+		v.merge(other.begin(), other.end());
+		REQUIRE(v.size() == 6);
+		for (auto i = 0; i != 6; ++i) {
+			REQUIRE(*(v.begin() + i) == i);
+		}
+	}
+	SECTION("merging removes duplicates") {
+		v.merge({ 4, 2, 3 });
+		REQUIRE(v.size() == 4);
+		REQUIRE(v.contains(3));
+	}
+	SECTION("merging into an empty set") {
+		auto empty = base::flat_set<int>();
+		empty.merge(v.begin(), v.end());
+		REQUIRE(empty.size() == 3);
+		REQUIRE(empty.contains(2));
+	}
+}
+
 TEST_CASE("flat_sets with custom comparators", "[flat_set]") {
 	base::flat_set<int_wrap, int_wrap_comparator> v;
 	v.insert({ 0 });
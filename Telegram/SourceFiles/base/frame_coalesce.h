@@ -0,0 +1,86 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include <crl/crl.h>
+#include <rpl/producer.h>
+#include "base/algorithm.h"
+#include "base/optional.h"
+
+namespace base {
+namespace details {
+
+class coalesce_frames_helper {
+public:
+	template <typename Value, typename Error, typename Generator>
+	auto operator()(
+			rpl::producer<Value, Error, Generator> &&initial) const {
+		return rpl::make_producer<Value, Error>([
+			initial = std::move(initial)
+		](const auto &consumer) mutable {
+			struct State {
+				std::optional<Value> latest;
+				bool delivered = false;
+				bool scheduled = false;
+				bool alive = true;
+			};
+			const auto state = std::make_shared<State>();
+			auto result = rpl::lifetime([state] {
+				state->alive = false;
+			});
+			result.add(std::move(initial).start(
+				[consumer, state](auto &&value) {
+					if (!state->delivered) {
+						// The first value initializes the chain below,
+						// it is passed through synchronously so that
+						// combines depending on it start right away.
+						state->delivered = true;
+						consumer.put_next_forward(
+							std::forward<decltype(value)>(value));
+						return;
+					}
+					state->latest = std::forward<decltype(value)>(value);
+					if (state->scheduled) {
+						return;
+					}
+					state->scheduled = true;
+					crl::on_main([consumer, state] {
+						state->scheduled = false;
+						if (state->alive && state->latest) {
+							consumer.put_next(*base::take(state->latest));
+						}
+					});
+				}, [consumer](auto &&error) {
+					consumer.put_error_forward(
+						std::forward<decltype(error)>(error));
+				}, [consumer, state] {
+					if (state->latest) {
+						consumer.put_next(*base::take(state->latest));
+					}
+					consumer.put_done();
+				}));
+			return result;
+		});
+	}
+
+};
+
+} // namespace details
+
+// Coalesces bursts of updates into a single evaluation per main queue
+// iteration. The first value passes through synchronously, after that
+// each incoming value only overwrites the stored latest one and the
+// chain below runs at most once per frame with that latest value.
+// Repeat values arrive asynchronously, so this is opt-in for chains
+// that tolerate a one-frame delay in exchange for update-storm immunity.
+inline auto coalesce_frames()
+-> details::coalesce_frames_helper {
+	return details::coalesce_frames_helper();
+}
+
+} // namespace base
@@ -1161,6 +1161,7 @@ void ProxiesBoxController::setDeleted(int id, bool deleted) {
 
 		if (item->data == Global::SelectedProxy()) {
 			_lastSelectedProxy = base::take(Global::RefSelectedProxy());
+			Global::RefreshProxyConfig();
 			if (Global::ProxySettings() == ProxyData::Settings::Enabled) {
 				_lastSelectedProxyUsed = true;
 				Core::App().setCurrentProxy(
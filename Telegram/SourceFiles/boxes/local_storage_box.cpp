@@ -113,7 +113,7 @@ public:
 		const Database::TaggedSummary &data);
 
 	void update(const Database::TaggedSummary &data);
-	void toggleProgress(bool shown);
+	void toggleProgress(bool shown, int donePercent = 0);
 
 	rpl::producer<> clearRequests() const;
 
@@ -164,25 +164,32 @@ void LocalStorageBox::Row::update(const Database::TaggedSummary &data) {
 	_clear->setVisible(data.count != 0);
 }
 
-void LocalStorageBox::Row::toggleProgress(bool shown) {
+void LocalStorageBox::Row::toggleProgress(bool shown, int donePercent) {
 	if (!shown) {
 		_progress = nullptr;
 		_description->show();
 		_clearing.destroy();
-	} else if (!_progress) {
+		return;
+	}
+	const auto text = (donePercent > 0)
+		? lang(lng_local_storage_clearing) + qsl(" %1%").arg(donePercent)
+		: lang(lng_local_storage_clearing);
+	if (!_progress) {
 		_progress = std::make_unique<Ui::InfiniteRadialAnimation>(
 			animation(this, &Row::step_radial),
 			st::proxyCheckingAnimation);
 		_progress->start();
 		_clearing = object_ptr<Ui::FlatLabel>(
 			this,
-			lang(lng_local_storage_clearing),
+			text,
 			Ui::FlatLabel::InitType::Simple,
 			st::localStorageRowSize);
 		_clearing->show();
 		_description->hide();
 		resizeToWidth(width());
 		RpWidget::update();
+	} else if (_clearing) {
+		_clearing->setText(text);
 	}
 }
 
@@ -298,7 +305,14 @@ void LocalStorageBox::updateRow(
 void LocalStorageBox::update(Database::Stats &&stats) {
 	_stats = std::move(stats);
 	if (const auto i = _rows.find(0); i != end(_rows)) {
-		i->second->entity()->toggleProgress(_stats.clearing);
+		const auto donePercent = (_stats.clearing && _stats.clearFull > 0)
+			? int(_stats.clearDone * 100 / _stats.clearFull)
+			: (_stats.compacting && _stats.compactFull > 0)
+			? int(_stats.compactDone * 100 / _stats.compactFull)
+			: 0;
+		i->second->entity()->toggleProgress(
+			_stats.clearing || _stats.compacting,
+			donePercent);
 	}
 	for (const auto &entry : _rows) {
 		if (entry.first) {
@@ -566,7 +566,8 @@ PeerListContent::PeerListContent(
 : RpWidget(parent)
 , _st(st)
 , _controller(controller)
-, _rowHeight(_st.item.height) {
+, _rowHeight(_st.item.height)
+, _loadProfilePhotos([this] { loadProfilePhotos(); }) {
 	subscribe(Auth().downloaderTaskFinished(), [this] { update(); });
 
 	using UpdateFlag = Notify::PeerUpdate::Flag;
@@ -635,7 +636,14 @@ void PeerListContent::addRowEntry(not_null<PeerListRow*> row) {
 	_rowsById.emplace(row->id(), row);
 	_rowsByPeer[row->peer()].push_back(row);
 	if (addingToSearchIndex()) {
-		addToSearchIndex(row);
+		if (_searchIndexDirty || _searchIndex.empty()) {
+			// The whole index is rebuilt in validateSearchIndex() when
+			// a search is actually performed, appending a huge members
+			// list shouldn't pay for the indexing row by row.
+			_searchIndexDirty = true;
+		} else {
+			addToSearchIndex(row);
+		}
 	}
 	if (_controller->isRowSelected(row->peer())) {
 		Assert(row->id() == row->peer()->id);
@@ -651,7 +659,9 @@ void PeerListContent::invalidatePixmapsCache() {
 
 bool PeerListContent::addingToSearchIndex() const {
 	// If we started indexing already, we continue.
-	return (_searchMode != PeerListSearchMode::Disabled) || !_searchIndex.empty();
+	return (_searchMode != PeerListSearchMode::Disabled)
+		|| !_searchIndex.empty()
+		|| _searchIndexDirty;
 }
 
 void PeerListContent::addToSearchIndex(not_null<PeerListRow*> row) {
@@ -683,6 +693,17 @@ void PeerListContent::removeFromSearchIndex(not_null<PeerListRow*> row) {
 	}
 }
 
+void PeerListContent::validateSearchIndex() {
+	if (!_searchIndexDirty) {
+		return;
+	}
+	_searchIndexDirty = false;
+	_searchIndex.clear();
+	for_const (auto &row, _rows) {
+		addToSearchIndex(row.get());
+	}
+}
+
 void PeerListContent::prependRow(std::unique_ptr<PeerListRow> row) {
 	Expects(row != nullptr);
 
@@ -707,7 +728,7 @@ void PeerListContent::prependRowFromSearchResult(not_null<PeerListRow*> row) {
 	refreshIndices();
 	removeRowAtIndex(_searchRows, index);
 
-	if (addingToSearchIndex()) {
+	if (addingToSearchIndex() && !_searchIndexDirty) {
 		addToSearchIndex(row);
 	}
 }
@@ -771,6 +792,7 @@ void PeerListContent::clearAllContent() {
 	_rowsByPeer.clear();
 	_filterResults.clear();
 	_searchIndex.clear();
+	_searchIndexDirty = false;
 	_rows.clear();
 	_searchRows.clear();
 	_searchQuery
@@ -865,10 +887,8 @@ void PeerListContent::refreshRows() {
 
 void PeerListContent::setSearchMode(PeerListSearchMode mode) {
 	if (_searchMode != mode) {
-		if (!addingToSearchIndex()) {
-			for_const (auto &row, _rows) {
-				addToSearchIndex(row.get());
-			}
+		if (!addingToSearchIndex() && !_rows.empty()) {
+			_searchIndexDirty = true;
 		}
 		_searchMode = mode;
 		if (_controller->hasComplexSearch()) {
@@ -1287,6 +1307,7 @@ void PeerListContent::searchQueryChanged(QString query) {
 	if (_normalizedSearchQuery != normalizedQuery) {
 		setSearchQuery(query, normalizedQuery);
 		if (_controller->searchInLocal() && !searchWordsList.isEmpty()) {
+			validateSearchIndex();
 			auto minimalList = (const std::vector<not_null<PeerListRow*>>*)nullptr;
 			for_const (auto &searchWord, searchWordsList) {
 				auto searchWordStart = searchWord[0].toLower();
@@ -1409,7 +1430,9 @@ void PeerListContent::visibleTopBottomUpdated(
 		int visibleBottom) {
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
-	loadProfilePhotos();
+	// Scrolling sends a stream of these updates, so the userpic
+	// preload walk is coalesced to one pass per event loop cycle.
+	_loadProfilePhotos.call();
 	checkScrollForPreload();
 }
 
@@ -1590,7 +1613,7 @@ void PeerListContent::handleNameChanged(const Notify::PeerUpdate &update) {
 	auto byPeer = _rowsByPeer.find(update.peer);
 	if (byPeer != _rowsByPeer.cend()) {
 		for (auto row : byPeer->second) {
-			if (addingToSearchIndex()) {
+			if (addingToSearchIndex() && !_searchIndexDirty) {
 				addToSearchIndex(row);
 			}
 			row->refreshName(_st.item);
@@ -567,6 +567,7 @@ private:
 	void addToSearchIndex(not_null<PeerListRow*> row);
 	bool addingToSearchIndex() const;
 	void removeFromSearchIndex(not_null<PeerListRow*> row);
+	void validateSearchIndex();
 	void setSearchQuery(const QString &query, const QString &normalizedQuery);
 	bool showingSearch() const {
 		return !_searchQuery.isEmpty();
@@ -594,6 +595,7 @@ private:
 	int _rowHeight = 0;
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
+	SingleQueuedInvokation _loadProfilePhotos;
 
 	Selected _selected;
 	Selected _pressed;
@@ -609,6 +611,7 @@ private:
 	std::map<PeerData*, std::vector<not_null<PeerListRow*>>> _rowsByPeer;
 
 	std::map<QChar, std::vector<not_null<PeerListRow*>>> _searchIndex;
+	bool _searchIndexDirty = false;
 	QString _searchQuery;
 	QString _normalizedSearchQuery;
 	QString _mentionHighlight;
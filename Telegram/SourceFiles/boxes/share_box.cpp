@@ -435,6 +435,7 @@ void ShareBox::innerSelectedChanged(PeerData *peer, bool checked) {
 
 void ShareBox::submit() {
 	if (_submitCallback) {
+		Local::saveRecentSharePeers(_inner->selected());
 		_submitCallback(
 			_inner->selected(),
 			_comment->entity()->getTextWithAppliedMarkdown());
@@ -494,6 +495,17 @@ ShareBox::Inner::Inner(
 	if (_filterCallback(self)) {
 		_chatsIndexed->addToEnd(self->owner().history(self));
 	}
+
+	// The most frequent share targets come right after the cloud draft,
+	// the index dedups them when the dialogs are appended below.
+	Local::readRecentSharePeers();
+	for (const auto &recent : cRecentSharePeers()) {
+		if (const auto peer = Auth().data().peerLoaded(recent.peer)) {
+			if (!peer->isSelf() && _filterCallback(peer)) {
+				_chatsIndexed->addToEnd(peer->owner().history(peer));
+			}
+		}
+	}
 	for (const auto row : dialogs->all()) {
 		if (const auto history = row->history()) {
 			if (!history->peer->isSelf()
@@ -39,6 +39,7 @@ namespace {
 constexpr auto kMinLayer = 65;
 constexpr auto kHangupTimeoutMs = 5000;
 constexpr auto kSha256Size = 32;
+constexpr auto kMainLoopStallCheckPeriod = TimeMs(100);
 
 using tgvoip::Endpoint;
 
@@ -324,8 +325,34 @@ void Call::redial() {
 }
 
 QString Call::getDebugLog() const {
+	if (!_controller) {
+		return QString();
+	}
 	const auto debug = _controller->GetDebugString();
-	return QString::fromUtf8(debug.data(), debug.size());
+	auto result = QString::fromUtf8(debug.data(), debug.size());
+
+	auto stats = tgvoip::VoIPController::TrafficStats();
+	_controller->GetStats(&stats);
+	result += qsl("\n\nTraffic, wifi: %1 B sent, %2 B received."
+	).arg(stats.bytesSentWifi
+	).arg(stats.bytesRecvdWifi);
+	result += qsl("\nTraffic, mobile: %1 B sent, %2 B received."
+	).arg(stats.bytesSentMobile
+	).arg(stats.bytesRecvdMobile);
+	result += qsl("\nLargest main loop stall: %1 ms."
+	).arg(_mainLoopLargestStall);
+	return result;
+}
+
+void Call::checkMainLoopStall() {
+	const auto now = getms();
+	const auto expected = _mainLoopLastTickTime + kMainLoopStallCheckPeriod;
+	if (_mainLoopLastTickTime && now > expected) {
+		_mainLoopLargestStall = std::max(
+			_mainLoopLargestStall,
+			now - expected);
+	}
+	_mainLoopLastTickTime = now;
 }
 
 void Call::startWaitingTrack() {
@@ -615,6 +642,13 @@ void Call::createAndStartController(const MTPDphoneCall &call) {
 	}
 	_controller->Start();
 	_controller->Connect();
+
+	// A stalled main thread can not feed the voice threads in time,
+	// the meter ties observed dropouts to the UI work that caused them.
+	_mainLoopLastTickTime = 0;
+	_mainLoopLargestStall = 0;
+	_mainLoopStallTimer.setCallback([=] { checkMainLoopStall(); });
+	_mainLoopStallTimer.callEach(kMainLoopStallCheckPeriod);
 }
 
 void Call::handleControllerStateChange(
@@ -871,6 +905,7 @@ void Call::handleControllerError(int error) {
 }
 
 void Call::destroyController() {
+	_mainLoopStallTimer.cancel();
 	if (_controller) {
 		DEBUG_LOG(("Call Info: Destroying call controller.."));
 		_controller.reset();
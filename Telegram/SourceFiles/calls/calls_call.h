@@ -166,6 +166,7 @@ private:
 		tgvoip::VoIPController *controller,
 		int count);
 	void createAndStartController(const MTPDphoneCall &call);
+	void checkMainLoopStall();
 
 	template <typename T>
 	bool checkCallCommonFields(const T &call);
@@ -194,6 +195,12 @@ private:
 	base::DelayedCallTimer _finishByTimeoutTimer;
 	base::Timer _discardByTimeoutTimer;
 
+	// Main thread stalls longer than the audio buffer cause dropouts,
+	// the largest observed stall is shown in the call debug info.
+	base::Timer _mainLoopStallTimer;
+	TimeMs _mainLoopLastTickTime = 0;
+	TimeMs _mainLoopLargestStall = 0;
+
 	bool _mute = false;
 	base::Observable<bool> _muteChanged;
 
@@ -100,6 +100,29 @@ const ushort Offsets[] = {
 620, 622, 624, 626, 628, 630, 632, 634, 636, 638, 640, 641,
 642, 643, 644, 646, 648, 650, 652, 654, 656, 658 };
 
+// Each lookup in the emoji table goes through a hash map, so the whole
+// table is resolved and validated only once and all the following calls
+// index into the ready vector directly.
+const std::vector<EmojiPtr> &EmojiTable() {
+	static const auto result = [] {
+		auto result = std::vector<EmojiPtr>();
+		constexpr auto count = int(base::array_size(Offsets) - 1);
+		result.reserve(count);
+		for (auto index = 0; index != count; ++index) {
+			const auto offset = Offsets[index];
+			const auto size = Offsets[index + 1] - offset;
+			const auto string = QString::fromRawData(
+				reinterpret_cast<const QChar*>(Data + offset),
+				size);
+			const auto emoji = Ui::Emoji::Find(string);
+			Assert(emoji != nullptr);
+			result.push_back(emoji);
+		}
+		return result;
+	}();
+	return result;
+}
+
 uint64 ComputeEmojiIndex(bytes::const_span bytes) {
 	Expects(bytes.size() == 8);
 	return ((gsl::to_integer<uint64>(bytes[0]) & 0x7F) << 56)
@@ -116,34 +139,16 @@ uint64 ComputeEmojiIndex(bytes::const_span bytes) {
 
 std::vector<EmojiPtr> ComputeEmojiFingerprint(not_null<Call*> call) {
 	auto result = std::vector<EmojiPtr>();
-	constexpr auto EmojiCount = (base::array_size(Offsets) - 1);
-	for (auto index = 0; index != EmojiCount; ++index) {
-		auto offset = Offsets[index];
-		auto size = Offsets[index + 1] - offset;
-		auto string = QString::fromRawData(
-			reinterpret_cast<const QChar*>(Data + offset),
-			size);
-		auto emoji = Ui::Emoji::Find(string);
-		Assert(emoji != nullptr);
-	}
+	const auto &table = EmojiTable();
 	if (call->isKeyShaForFingerprintReady()) {
 		auto sha256 = call->getKeyShaForFingerprint();
 		constexpr auto kPartSize = 8;
 		for (auto partOffset = 0; partOffset != sha256.size(); partOffset += kPartSize) {
 			auto value = ComputeEmojiIndex(gsl::make_span(sha256).subspan(partOffset, kPartSize));
-			auto index = value % EmojiCount;
-			auto offset = Offsets[index];
-			auto size = Offsets[index + 1] - offset;
-			auto string = QString::fromRawData(
-				reinterpret_cast<const QChar*>(Data + offset),
-				size);
-			auto emoji = Ui::Emoji::Find(string);
-			Assert(emoji != nullptr);
-			result.push_back(emoji);
+			result.push_back(table[value % table.size()]);
 		}
 	}
 	return result;
-
 }
 
 } // namespace Calls
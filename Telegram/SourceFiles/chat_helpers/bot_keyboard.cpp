@@ -26,6 +26,9 @@ public:
 	void startPaint(Painter &p) const override;
 	const style::TextStyle &textStyle() const override;
 	void repaint(not_null<const HistoryItem*> item) const override;
+	void repaintPart(
+		not_null<const HistoryItem*> item,
+		const QRect &rect) const override;
 
 protected:
 	void paintButtonBg(
@@ -64,6 +67,12 @@ void Style::repaint(not_null<const HistoryItem*> item) const {
 	_parent->update();
 }
 
+void Style::repaintPart(
+		not_null<const HistoryItem*> item,
+		const QRect &rect) const {
+	_parent->repaintButtonRect(rect);
+}
+
 int Style::buttonRadius() const {
 	return st::buttonRadius;
 }
@@ -240,6 +249,11 @@ bool BotKeyboard::maximizeSize() const {
 	return _maximizeSize;
 }
 
+void BotKeyboard::repaintButtonRect(const QRect &rect) {
+	const auto x = rtl() ? st::botKbScroll.width : _st->margin;
+	update(rect.translated(x, st::botKbScroll.deltat));
+}
+
 bool BotKeyboard::singleUse() const {
 	return _singleUse;
 }
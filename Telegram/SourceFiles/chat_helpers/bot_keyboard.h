@@ -39,6 +39,10 @@ public:
 	bool maximizeSize() const;
 	bool singleUse() const;
 
+	// Repaints only the part of the widget covered by a keyboard
+	// button rect (in keyboard coordinates).
+	void repaintButtonRect(const QRect &rect);
+
 	FullMsgId forMsgId() const {
 		return _wasForMsgId;
 	}
@@ -468,6 +468,8 @@ EmojiListWidget::SectionInfo EmojiListWidget::sectionInfoByOffset(int yOffset) c
 }
 
 int EmojiListWidget::countDesiredHeight(int newWidth) {
+	const auto wasColumnCount = _columnCount;
+	const auto wasSingleSize = _singleSize;
 	auto fullWidth = (st::buttonRadius + newWidth + st::emojiScroll.width);
 	_columnCount = std::max(
 		(fullWidth - st::emojiPadding * 2) / st::emojiPanDesiredSize,
@@ -480,6 +482,9 @@ int EmojiListWidget::countDesiredHeight(int newWidth) {
 	_rowsLeft -= st::buttonRadius;
 	_singleSize = QSize(singleWidth, singleWidth - 4 * st::lineWidth);
 	_picker->setSingleSize(_singleSize);
+	if (_columnCount != wasColumnCount || _singleSize != wasSingleSize) {
+		invalidateSectionCaches();
+	}
 	return sectionInfo(kEmojiSectionCount - 1).rowsBottom + st::emojiPanPadding;
 }
 
@@ -503,6 +508,42 @@ void EmojiListWidget::ensureLoaded(int section) {
 	}
 }
 
+void EmojiListWidget::validateSectionCache(int section) {
+	Expects(section >= 0 && section < kEmojiSectionCount);
+
+	auto &cache = _sectionCaches[section];
+	if (!cache.isNull()) {
+		return;
+	}
+	const auto info = sectionInfo(section);
+	const auto size = QSize(
+		_columnCount * _singleSize.width(),
+		info.rowsCount * _singleSize.height());
+	cache = QImage(
+		size * cIntRetinaFactor(),
+		QImage::Format_ARGB32_Premultiplied);
+	cache.setDevicePixelRatio(cRetinaFactor());
+	cache.fill(Qt::transparent);
+
+	Painter p(&cache);
+	for (auto index = 0; index != info.count; ++index) {
+		const auto row = index / _columnCount;
+		const auto column = index % _columnCount;
+		Ui::Emoji::Draw(
+			p,
+			_emoji[section][index],
+			_esize,
+			column * _singleSize.width() + (_singleSize.width() - (_esize / cIntRetinaFactor())) / 2,
+			row * _singleSize.height() + (_singleSize.height() - (_esize / cIntRetinaFactor())) / 2);
+	}
+}
+
+void EmojiListWidget::invalidateSectionCaches() {
+	for (auto i = 0; i != kEmojiSectionCount; ++i) {
+		_sectionCaches[i] = QImage();
+	}
+}
+
 void EmojiListWidget::paintEvent(QPaintEvent *e) {
 	Painter p(this);
 	QRect r = e ? e->rect() : rect();
@@ -511,15 +552,7 @@ void EmojiListWidget::paintEvent(QPaintEvent *e) {
 	}
 	p.fillRect(r, st::emojiPanBg);
 
-	auto fromColumn = floorclamp(r.x() - _rowsLeft, _singleSize.width(), 0, _columnCount);
-	auto toColumn = ceilclamp(r.x() + r.width() - _rowsLeft, _singleSize.width(), 0, _columnCount);
-	if (rtl()) {
-		qSwap(fromColumn, toColumn);
-		fromColumn = _columnCount - fromColumn;
-		toColumn = _columnCount - toColumn;
-	}
-
-	enumerateSections([this, &p, r, fromColumn, toColumn](const SectionInfo &info) {
+	enumerateSections([this, &p, r](const SectionInfo &info) {
 		if (r.top() >= info.rowsBottom) {
 			return true;
 		} else if (r.top() + r.height() <= info.top) {
@@ -532,29 +565,46 @@ void EmojiListWidget::paintEvent(QPaintEvent *e) {
 		}
 		if (r.top() + r.height() > info.rowsTop) {
 			ensureLoaded(info.section);
+			validateSectionCache(info.section);
 			auto fromRow = floorclamp(r.y() - info.rowsTop, _singleSize.height(), 0, info.rowsCount);
 			auto toRow = ceilclamp(r.y() + r.height() - info.rowsTop, _singleSize.height(), 0, info.rowsCount);
-			for (auto i = fromRow; i < toRow; ++i) {
-				for (auto j = fromColumn; j < toColumn; ++j) {
-					auto index = i * _columnCount + j;
-					if (index >= info.count) break;
-
-					auto selected = (!_picker->isHidden() && info.section * MatrixRowShift + index == _pickerSel) || (info.section * MatrixRowShift + index == _selected);
-
-					auto w = QPoint(_rowsLeft + j * _singleSize.width(), info.rowsTop + i * _singleSize.height());
-					if (selected) {
-						auto tl = w;
-						if (rtl()) tl.setX(width() - tl.x() - _singleSize.width());
-						App::roundRect(p, QRect(tl, _singleSize), st::emojiPanHover, StickerHoverCorners);
-					}
-					Ui::Emoji::Draw(
-						p,
-						_emoji[info.section][index],
-						_esize,
-						w.x() + (_singleSize.width() - (_esize / cIntRetinaFactor())) / 2,
-						w.y() + (_singleSize.height() - (_esize / cIntRetinaFactor())) / 2);
+
+			// The hover highlight lies under the emoji, so it is
+			// painted before blitting the cached band over it.
+			const auto paintSelected = [&](int index) {
+				if (index < 0 || index >= info.count) {
+					return;
 				}
+				const auto row = index / _columnCount;
+				if (row < fromRow || row >= toRow) {
+					return;
+				}
+				const auto column = index % _columnCount;
+				auto tl = QPoint(
+					_rowsLeft + column * _singleSize.width(),
+					info.rowsTop + row * _singleSize.height());
+				if (rtl()) tl.setX(width() - tl.x() - _singleSize.width());
+				App::roundRect(p, QRect(tl, _singleSize), st::emojiPanHover, StickerHoverCorners);
+			};
+			if ((_selected / MatrixRowShift) == info.section) {
+				paintSelected(_selected % MatrixRowShift);
+			}
+			if (!_picker->isHidden()
+				&& _pickerSel != _selected
+				&& (_pickerSel / MatrixRowShift) == info.section) {
+				paintSelected(_pickerSel % MatrixRowShift);
 			}
+
+			const auto &cache = _sectionCaches[info.section];
+			const auto factor = cIntRetinaFactor();
+			p.drawImage(
+				QPoint(_rowsLeft, info.rowsTop + fromRow * _singleSize.height()),
+				cache,
+				QRect(
+					0,
+					fromRow * _singleSize.height() * factor,
+					cache.width(),
+					(toRow - fromRow) * _singleSize.height() * factor));
 		}
 		return true;
 	});
@@ -695,6 +745,7 @@ void EmojiListWidget::colorChosen(EmojiPtr emoji) {
 		auto sel = _pickerSel % MatrixRowShift;
 		if (section >= 0 && section < kEmojiSectionCount) {
 			_emoji[section][sel] = emoji;
+			_sectionCaches[section] = QImage();
 			rtlupdate(emojiRect(section, sel));
 		}
 	}
@@ -769,12 +820,17 @@ void EmojiListWidget::processHideFinished() {
 		_pickerSel = -1;
 	}
 	clearSelection();
+
+	// No need to keep megabytes of rendered sections in memory
+	// while the panel is hidden, they are rebuilt on first paint.
+	invalidateSectionCaches();
 }
 
 void EmojiListWidget::refreshRecent() {
 	clearSelection();
 	_emoji[0] = Ui::Emoji::GetSection(Section::Recent);
 	_counts[0] = _emoji[0].size();
+	_sectionCaches[0] = QImage();
 	resizeToWidth(width());
 }
 
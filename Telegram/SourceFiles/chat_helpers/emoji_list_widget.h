@@ -91,6 +91,8 @@ private:
 	bool checkPickerHide();
 
 	void ensureLoaded(int section);
+	void validateSectionCache(int section);
+	void invalidateSectionCaches();
 	void updateSelected();
 	void setSelected(int newSelected);
 
@@ -103,6 +105,10 @@ private:
 	int _counts[kEmojiSectionCount];
 	QVector<EmojiPtr> _emoji[kEmojiSectionCount];
 
+	// Each section's emoji grid is rendered once into an image, so
+	// scrolling only blits the visible band from these caches.
+	QImage _sectionCaches[kEmojiSectionCount];
+
 	int _rowsLeft = 0;
 	int _columnCount = 1;
 	QSize _singleSize;
@@ -70,6 +70,7 @@ void FieldAutocomplete::showFiltered(
 	_channel = peer->asChannel();
 	if (query.isEmpty()) {
 		_type = Type::Mentions;
+		_mrowsValid = false;
 		rowsUpdated(internal::MentionRows(), internal::HashtagRows(), internal::BotCommandRows(), _srows, false);
 		return;
 	}
@@ -137,99 +138,205 @@ inline int indexOfInFirstN(const T &v, const U &elem, int last) {
 }
 }
 
-void FieldAutocomplete::updateFiltered(bool resetScroll) {
-	int32 now = unixtime(), recentInlineBots = 0;
-	internal::MentionRows mrows;
-	internal::HashtagRows hrows;
-	internal::BotCommandRows brows;
-	internal::StickerRows srows;
-	if (_emoji) {
-		srows = Stickers::GetListByEmoji(_emoji, _stickersSeed);
-	} else if (_type == Type::Mentions) {
-		int maxListSize = _addInlineBots ? cRecentInlineBots().size() : 0;
-		if (_chat) {
-			maxListSize += (_chat->participants.empty() ? _chat->lastAuthors.size() : _chat->participants.size());
-		} else if (_channel && _channel->isMegagroup()) {
-			if (_channel->mgInfo->lastParticipants.empty() || _channel->lastParticipantsCountOutdated()) {
-			} else {
-				maxListSize += _channel->mgInfo->lastParticipants.size();
-			}
+int FieldAutocomplete::mentionSourcesSize() const {
+	auto result = _addInlineBots ? cRecentInlineBots().size() : 0;
+	if (_chat) {
+		result += int(_chat->participants.size())
+			+ _chat->lastAuthors.size();
+	} else if (_channel && _channel->isMegagroup()) {
+		if (!_channel->mgInfo->lastParticipants.empty()
+			&& !_channel->lastParticipantsCountOutdated()) {
+			result += int(_channel->mgInfo->lastParticipants.size());
 		}
-		if (maxListSize) {
-			mrows.reserve(maxListSize);
+	}
+	return result;
+}
+
+void FieldAutocomplete::buildMentionRows(
+		internal::MentionRows &mrows,
+		int &recentInlineBots,
+		int32 now) {
+	_mrowsHeldBack.clear();
+
+	int maxListSize = _addInlineBots ? cRecentInlineBots().size() : 0;
+	if (_chat) {
+		maxListSize += (_chat->participants.empty() ? _chat->lastAuthors.size() : _chat->participants.size());
+	} else if (_channel && _channel->isMegagroup()) {
+		if (_channel->mgInfo->lastParticipants.empty() || _channel->lastParticipantsCountOutdated()) {
+		} else {
+			maxListSize += _channel->mgInfo->lastParticipants.size();
 		}
+	}
+	if (maxListSize) {
+		mrows.reserve(maxListSize);
+	}
 
-		auto filterNotPassedByUsername = [this](UserData *user) -> bool {
-			if (user->username.startsWith(_filter, Qt::CaseInsensitive)) {
-				bool exactUsername = (user->username.size() == _filter.size());
-				return exactUsername;
+	// Exact username matches are filtered out, but they may match
+	// again when the filter grows past the username, remember them
+	// for the incremental refinement in refineMentionRows().
+	auto holdBack = [&](UserData *user) {
+		if (!_mrowsHeldBack.contains(user)) {
+			_mrowsHeldBack.push_back(user);
+		}
+	};
+	auto filterNotPassedByUsername = [&](UserData *user) -> bool {
+		if (user->username.startsWith(_filter, Qt::CaseInsensitive)) {
+			bool exactUsername = (user->username.size() == _filter.size());
+			if (exactUsername) {
+				holdBack(user);
 			}
-			return true;
-		};
-		auto filterNotPassedByName = [&](UserData *user) -> bool {
-			for (const auto &nameWord : user->nameWords()) {
-				if (nameWord.startsWith(_filter, Qt::CaseInsensitive)) {
-					auto exactUsername = (user->username.compare(_filter, Qt::CaseInsensitive) == 0);
-					return exactUsername;
+			return exactUsername;
+		}
+		return true;
+	};
+	auto filterNotPassedByName = [&](UserData *user) -> bool {
+		for (const auto &nameWord : user->nameWords()) {
+			if (nameWord.startsWith(_filter, Qt::CaseInsensitive)) {
+				auto exactUsername = (user->username.compare(_filter, Qt::CaseInsensitive) == 0);
+				if (exactUsername) {
+					holdBack(user);
 				}
+				return exactUsername;
 			}
-			return filterNotPassedByUsername(user);
+		}
+		return filterNotPassedByUsername(user);
+	};
+
+	bool listAllSuggestions = _filter.isEmpty();
+	if (_addInlineBots) {
+		for_const (auto user, cRecentInlineBots()) {
+			if (user->isInaccessible()) continue;
+			if (!listAllSuggestions && filterNotPassedByUsername(user)) continue;
+			mrows.push_back(user);
+			++recentInlineBots;
+		}
+	}
+	if (_chat) {
+		auto ordered = QMultiMap<TimeId, not_null<UserData*>>();
+		const auto byOnline = [&](not_null<UserData*> user) {
+			return Data::SortByOnlineValue(user, now);
 		};
-
-		bool listAllSuggestions = _filter.isEmpty();
-		if (_addInlineBots) {
-			for_const (auto user, cRecentInlineBots()) {
+		mrows.reserve(mrows.size() + (_chat->participants.empty() ? _chat->lastAuthors.size() : _chat->participants.size()));
+		if (_chat->noParticipantInfo()) {
+			Auth().api().requestFullPeer(_chat);
+		} else if (!_chat->participants.empty()) {
+			for (const auto user : _chat->participants) {
 				if (user->isInaccessible()) continue;
-				if (!listAllSuggestions && filterNotPassedByUsername(user)) continue;
-				mrows.push_back(user);
-				++recentInlineBots;
+				if (!listAllSuggestions && filterNotPassedByName(user)) continue;
+				if (indexOfInFirstN(mrows, user, recentInlineBots) >= 0) continue;
+				ordered.insertMulti(byOnline(user), user);
 			}
 		}
-		if (_chat) {
-			auto ordered = QMultiMap<TimeId, not_null<UserData*>>();
-			const auto byOnline = [&](not_null<UserData*> user) {
-				return Data::SortByOnlineValue(user, now);
-			};
-			mrows.reserve(mrows.size() + (_chat->participants.empty() ? _chat->lastAuthors.size() : _chat->participants.size()));
-			if (_chat->noParticipantInfo()) {
-				Auth().api().requestFullPeer(_chat);
-			} else if (!_chat->participants.empty()) {
-				for (const auto user : _chat->participants) {
-					if (user->isInaccessible()) continue;
-					if (!listAllSuggestions && filterNotPassedByName(user)) continue;
-					if (indexOfInFirstN(mrows, user, recentInlineBots) >= 0) continue;
-					ordered.insertMulti(byOnline(user), user);
-				}
+		for (const auto user : _chat->lastAuthors) {
+			if (user->isInaccessible()) continue;
+			if (!listAllSuggestions && filterNotPassedByName(user)) continue;
+			if (indexOfInFirstN(mrows, user, recentInlineBots) >= 0) continue;
+			mrows.push_back(user);
+			if (!ordered.isEmpty()) {
+				ordered.remove(byOnline(user), user);
+			}
+		}
+		if (!ordered.isEmpty()) {
+			for (auto i = ordered.cend(), b = ordered.cbegin(); i != b;) {
+				--i;
+				mrows.push_back(i.value());
 			}
-			for (const auto user : _chat->lastAuthors) {
+		}
+	} else if (_channel && _channel->isMegagroup()) {
+		QMultiMap<int32, UserData*> ordered;
+		if (_channel->mgInfo->lastParticipants.empty() || _channel->lastParticipantsCountOutdated()) {
+			Auth().api().requestLastParticipants(_channel);
+		} else {
+			mrows.reserve(mrows.size() + _channel->mgInfo->lastParticipants.size());
+			for (const auto user : _channel->mgInfo->lastParticipants) {
 				if (user->isInaccessible()) continue;
 				if (!listAllSuggestions && filterNotPassedByName(user)) continue;
 				if (indexOfInFirstN(mrows, user, recentInlineBots) >= 0) continue;
 				mrows.push_back(user);
-				if (!ordered.isEmpty()) {
-					ordered.remove(byOnline(user), user);
-				}
 			}
-			if (!ordered.isEmpty()) {
-				for (auto i = ordered.cend(), b = ordered.cbegin(); i != b;) {
-					--i;
-					mrows.push_back(i.value());
-				}
+		}
+	}
+}
+
+bool FieldAutocomplete::refineMentionRows(
+		internal::MentionRows &mrows,
+		int &recentInlineBots) {
+	// A longer filter over the same sources can only narrow the rows
+	// down, so while the user keeps typing the previous rows are
+	// filtered again instead of rescanning the full participant
+	// lists. A change in the sources sizes (member list arrived,
+	// someone joined or left) forces a full rebuild.
+	if (!_mrowsValid
+		|| _mrowsChat != _chat
+		|| _mrowsUser != _user
+		|| _mrowsChannel != _channel
+		|| _mrowsAddInlineBots != _addInlineBots
+		|| _filter.size() <= _mrowsFilter.size()
+		|| !_filter.startsWith(_mrowsFilter, Qt::CaseInsensitive)
+		|| mentionSourcesSize() != _mrowsSourcesSize) {
+		return false;
+	}
+	const auto exactUsername = [&](UserData *user) {
+		return !user->username.compare(_filter, Qt::CaseInsensitive);
+	};
+	const auto passed = [&](UserData *user) {
+		if (exactUsername(user)) {
+			return false;
+		}
+		for (const auto &nameWord : user->nameWords()) {
+			if (nameWord.startsWith(_filter, Qt::CaseInsensitive)) {
+				return true;
 			}
-		} else if (_channel && _channel->isMegagroup()) {
-			QMultiMap<int32, UserData*> ordered;
-			if (_channel->mgInfo->lastParticipants.empty() || _channel->lastParticipantsCountOutdated()) {
-				Auth().api().requestLastParticipants(_channel);
-			} else {
-				mrows.reserve(mrows.size() + _channel->mgInfo->lastParticipants.size());
-				for (const auto user : _channel->mgInfo->lastParticipants) {
-					if (user->isInaccessible()) continue;
-					if (!listAllSuggestions && filterNotPassedByName(user)) continue;
-					if (indexOfInFirstN(mrows, user, recentInlineBots) >= 0) continue;
-					mrows.push_back(user);
-				}
+		}
+		return user->username.startsWith(_filter, Qt::CaseInsensitive);
+	};
+	const auto held = base::take(_mrowsHeldBack);
+	const auto candidates = base::take(_mrows);
+	mrows.reserve(candidates.size());
+	for (auto i = 0; i != candidates.size(); ++i) {
+		const auto user = candidates[i];
+		if (passed(user)) {
+			mrows.push_back(user);
+			if (i < _mrowsRecentInlineBots) {
+				++recentInlineBots;
 			}
+		} else if (exactUsername(user)) {
+			_mrowsHeldBack.push_back(user);
+		}
+	}
+	for (const auto user : held) {
+		if (passed(user)) {
+			mrows.push_back(user);
+		} else if (exactUsername(user)) {
+			_mrowsHeldBack.push_back(user);
+		}
+	}
+	return true;
+}
+
+void FieldAutocomplete::updateFiltered(bool resetScroll) {
+	int32 now = unixtime(), recentInlineBots = 0;
+	internal::MentionRows mrows;
+	internal::HashtagRows hrows;
+	internal::BotCommandRows brows;
+	internal::StickerRows srows;
+	if (_type != Type::Mentions || _emoji) {
+		_mrowsValid = false;
+	}
+	if (_emoji) {
+		srows = Stickers::GetListByEmoji(_emoji, _stickersSeed);
+	} else if (_type == Type::Mentions) {
+		if (!refineMentionRows(mrows, recentInlineBots)) {
+			buildMentionRows(mrows, recentInlineBots, now);
 		}
+		_mrowsChat = _chat;
+		_mrowsUser = _user;
+		_mrowsChannel = _channel;
+		_mrowsAddInlineBots = _addInlineBots;
+		_mrowsFilter = _filter;
+		_mrowsRecentInlineBots = recentInlineBots;
+		_mrowsSourcesSize = mentionSourcesSize();
+		_mrowsValid = true;
 	} else if (_type == Type::Hashtags) {
 		bool listAllSuggestions = _filter.isEmpty();
 		auto &recent(cRecentWriteHashtags());
@@ -93,12 +93,34 @@ private:
 	void updateFiltered(bool resetScroll = false);
 	void recount(bool resetScroll = false);
 
+	void buildMentionRows(
+		internal::MentionRows &mrows,
+		int &recentInlineBots,
+		int32 now);
+	bool refineMentionRows(
+		internal::MentionRows &mrows,
+		int &recentInlineBots);
+	int mentionSourcesSize() const;
+
 	QPixmap _cache;
 	internal::MentionRows _mrows;
 	internal::HashtagRows _hrows;
 	internal::BotCommandRows _brows;
 	internal::StickerRows _srows;
 
+	// State of the last mention rows rebuild. While the user types
+	// more characters over the same sources the previous rows are
+	// narrowed down instead of rescanning the full participant lists.
+	internal::MentionRows _mrowsHeldBack;
+	QString _mrowsFilter;
+	ChatData *_mrowsChat = nullptr;
+	UserData *_mrowsUser = nullptr;
+	ChannelData *_mrowsChannel = nullptr;
+	int _mrowsRecentInlineBots = 0;
+	int _mrowsSourcesSize = 0;
+	bool _mrowsAddInlineBots = false;
+	bool _mrowsValid = false;
+
 	void rowsUpdated(const internal::MentionRows &mrows, const internal::HashtagRows &hrows, const internal::BotCommandRows &brows, const internal::StickerRows &srows, bool resetScroll);
 
 	object_ptr<Ui::ScrollArea> _scroll;
@@ -177,10 +177,41 @@ void GifsListWidget::visibleTopBottomUpdated(
 	Inner::visibleTopBottomUpdated(visibleTop, visibleBottom);
 	if (top != getVisibleTop()) {
 		_lastScrolled = getms();
+		preloadUpcomingRow(getVisibleTop() > top);
 	}
 	checkLoadMore();
 }
 
+void GifsListWidget::preloadUpcomingRow(bool scrollingDown) {
+	// Start loading the media of the first row beyond the visible
+	// area in the scroll direction, so it is ready once it shows up.
+	auto preloadRow = -1;
+	auto top = 0;
+	for (auto row = 0, rows = _rows.size(); row != rows; ++row) {
+		const auto bottom = top + _rows[row].height;
+		if (scrollingDown) {
+			if (top >= getVisibleBottom()) {
+				preloadRow = row;
+				break;
+			}
+		} else if (bottom <= getVisibleTop()) {
+			preloadRow = row;
+		} else {
+			break;
+		}
+		top = bottom;
+	}
+	if (preloadRow < 0) {
+		return;
+	}
+	for_const (auto item, _rows[preloadRow].items) {
+		item->preload();
+		if (const auto document = item->getDocument()) {
+			document->automaticLoad(inlineItemFileOrigin(), nullptr);
+		}
+	}
+}
+
 void GifsListWidget::checkLoadMore() {
 	auto visibleHeight = (getVisibleBottom() - getVisibleTop());
 	if (getVisibleBottom() + visibleHeight > height()) {
@@ -759,7 +790,10 @@ void GifsListWidget::inlineItemRepaint(const InlineBots::Layout::ItemBase *layou
 	}
 }
 
-bool GifsListWidget::inlineItemVisible(const InlineBots::Layout::ItemBase *layout) {
+bool GifsListWidget::inlineItemInRange(
+		const InlineBots::Layout::ItemBase *layout,
+		int rangeTop,
+		int rangeBottom) const {
 	auto position = layout->position();
 	if (position < 0 || !isVisible()) {
 		return false;
@@ -769,13 +803,26 @@ bool GifsListWidget::inlineItemVisible(const InlineBots::Layout::ItemBase *layou
 	auto col = position % MatrixRowShift;
 	Assert((row < _rows.size()) && (col < _rows[row].items.size()));
 
-	auto &inlineItems = _rows[row].items;
 	auto top = 0;
 	for (auto i = 0; i != row; ++i) {
 		top += _rows[i].height;
 	}
 
-	return (top < getVisibleBottom()) && (top + _rows[row].items[col]->height() > getVisibleTop());
+	return (top < rangeBottom) && (top + _rows[row].items[col]->height() > rangeTop);
+}
+
+bool GifsListWidget::inlineItemVisible(const InlineBots::Layout::ItemBase *layout) {
+	return inlineItemInRange(layout, getVisibleTop(), getVisibleBottom());
+}
+
+bool GifsListWidget::inlineItemNearVisible(const InlineBots::Layout::ItemBase *layout) {
+	// Keep clip readers of the nearest invisible rows alive, so that
+	// scrolling back and forth doesn't reopen and redecode the files.
+	const auto margin = st::inlineMediaHeight;
+	return inlineItemInRange(
+		layout,
+		getVisibleTop() - margin,
+		getVisibleBottom() + margin);
 }
 
 Data::FileOrigin GifsListWidget::inlineItemFileOrigin() {
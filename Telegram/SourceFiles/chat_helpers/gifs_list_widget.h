@@ -50,6 +50,7 @@ public:
 	void inlineItemLayoutChanged(const InlineBots::Layout::ItemBase *layout) override;
 	void inlineItemRepaint(const InlineBots::Layout::ItemBase *layout) override;
 	bool inlineItemVisible(const InlineBots::Layout::ItemBase *layout) override;
+	bool inlineItemNearVisible(const InlineBots::Layout::ItemBase *layout) override;
 	Data::FileOrigin inlineItemFileOrigin() override;
 
 	void afterShown() override;
@@ -105,6 +106,11 @@ private:
 	void refreshSavedGifs();
 	int refreshInlineRows(const InlineCacheEntry *results, bool resultsDeleted);
 	void checkLoadMore();
+	bool inlineItemInRange(
+		const InlineBots::Layout::ItemBase *layout,
+		int rangeTop,
+		int rangeBottom) const;
+	void preloadUpcomingRow(bool scrollingDown);
 
 	int32 showInlineRows(bool newResults);
 	bool refreshInlineRows(int32 *added = 0);
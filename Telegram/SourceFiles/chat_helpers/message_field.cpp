@@ -28,6 +28,11 @@ using EditLinkAction = Ui::InputField::EditLinkAction;
 using EditLinkSelection = Ui::InputField::EditLinkSelection;
 
 constexpr auto kParseLinksTimeout = TimeMs(1000);
+
+// Long composer sessions otherwise grow the document history without
+// a bound, this many recent steps survive each compaction.
+constexpr auto kFieldUndoLimit = 64;
+
 const auto kMentionTagStart = qstr("mention://user.");
 
 bool IsMentionLink(const QString &link) {
@@ -324,6 +329,7 @@ void InitMessageField(
 	field->setInstantReplacesEnabled(Global::ReplaceEmojiValue());
 	field->setMarkdownReplacesEnabled(rpl::single(true));
 	field->setEditLinkCallback(DefaultEditLinkCallback(field));
+	field->setUndoLimit(kFieldUndoLimit);
 }
 
 bool HasSendText(not_null<const Ui::InputField*> field) {
@@ -550,12 +556,142 @@ void MessageLinksParser::parse() {
 	const auto &tags = textWithTags.tags;
 	const auto &markdownTags = _field->getMarkdownTags();
 	if (text.isEmpty()) {
+		_lastText = QString();
+		_lastTags = TextWithTags::Tags();
+		_lastMarkdownTags.clear();
+		_ranges.clear();
 		_list = QStringList();
 		return;
 	}
 
+	// Find the edited range as a prefix / suffix diff against the
+	// last parsed text and expand it to whole paragraphs, so a
+	// keystroke in a long draft rescans only the touched paragraph.
+	const auto length = int(text.size());
+	const auto lastLength = int(_lastText.size());
+	const auto delta = length - lastLength;
+	auto prefix = 0;
+	const auto minLength = std::min(length, lastLength);
+	while (prefix != minLength && text[prefix] == _lastText[prefix]) {
+		++prefix;
+	}
+	auto suffix = 0;
+	const auto maxSuffix = minLength - prefix;
+	while (suffix != maxSuffix
+		&& (text[length - suffix - 1]
+			== _lastText[lastLength - suffix - 1])) {
+		++suffix;
+	}
+	const auto from = (prefix > 0)
+		? (text.lastIndexOf('\n', prefix - 1) + 1)
+		: 0;
+	const auto newTill = [&] {
+		const auto index = text.indexOf('\n', length - suffix);
+		return (index < 0) ? length : index;
+	}();
+	const auto oldTill = newTill - delta;
+
+	// Tags and markdown tags may depend on text far from the edit
+	// (an opened pre-block restyles everything below it), so the
+	// splice is valid only when each of them either stayed in the
+	// untouched prefix or just shifted with the suffix.
+	const auto tagsShifted = [&] {
+		if (tags.size() != _lastTags.size()) {
+			return false;
+		}
+		for (auto i = 0, count = int(tags.size()); i != count; ++i) {
+			const auto &now = tags[i];
+			const auto &was = _lastTags[i];
+			if (was.offset + was.length <= from) {
+				if (now.offset != was.offset
+					|| now.length != was.length
+					|| now.id != was.id) {
+					return false;
+				}
+			} else if (was.offset >= oldTill) {
+				if (now.offset != was.offset + delta
+					|| now.length != was.length
+					|| now.id != was.id) {
+					return false;
+				}
+			} else if (was.offset < from
+				|| was.offset + was.length > oldTill
+				|| now.offset < from
+				|| now.offset + now.length > newTill) {
+				return false;
+			}
+		}
+		return true;
+	};
+	const auto markdownTagsShifted = [&] {
+		if (markdownTags.size() != _lastMarkdownTags.size()) {
+			return false;
+		}
+		for (auto i = 0, count = int(markdownTags.size())
+			; i != count
+			; ++i) {
+			const auto &now = markdownTags[i];
+			const auto &was = _lastMarkdownTags[i];
+			if (was.adjustedStart + was.adjustedLength <= from) {
+				if (now.adjustedStart != was.adjustedStart
+					|| now.adjustedLength != was.adjustedLength
+					|| now.closed != was.closed
+					|| now.tag != was.tag) {
+					return false;
+				}
+			} else if (was.adjustedStart >= oldTill) {
+				if (now.adjustedStart != was.adjustedStart + delta
+					|| now.adjustedLength != was.adjustedLength
+					|| now.closed != was.closed
+					|| now.tag != was.tag) {
+					return false;
+				}
+			} else if (was.adjustedStart < from
+				|| was.adjustedStart + was.adjustedLength > oldTill
+				|| now.adjustedStart < from
+				|| now.adjustedStart + now.adjustedLength > newTill) {
+				return false;
+			}
+		}
+		return true;
+	};
+
 	auto ranges = QVector<LinkRange>();
+	if (!_lastText.isEmpty()
+		&& from <= oldTill
+		&& tagsShifted()
+		&& markdownTagsShifted()) {
+		ranges.reserve(_ranges.size() + 2);
+		for (const auto &range : _ranges) {
+			if (range.start + range.length <= from) {
+				ranges.push_back(range);
+			}
+		}
+		scanRanges(text, from, newTill, tags, markdownTags, ranges);
+		for (const auto &range : _ranges) {
+			if (range.start >= oldTill) {
+				ranges.push_back(
+					{ range.start + delta, range.length, range.custom });
+			}
+		}
+	} else {
+		scanRanges(text, 0, length, tags, markdownTags, ranges);
+	}
+	_lastText = text;
+	_lastTags = tags;
+	_lastMarkdownTags = markdownTags;
+	_ranges = ranges;
 
+	apply(text, ranges);
+}
+
+void MessageLinksParser::scanRanges(
+		const QString &text,
+		int from,
+		int till,
+		const TextWithTags::Tags &tags,
+		const std::vector<Ui::InputField::MarkdownTag> &markdownTags,
+		QVector<LinkRange> &ranges) const {
 	auto tag = tags.begin();
 	const auto tagsEnd = tags.end();
 	const auto processTag = [&] {
@@ -603,13 +739,17 @@ void MessageLinksParser::parse() {
 				+ markdownTag->adjustedLength < from + length);
 	};
 
-	const auto len = text.size();
+	while (tag != tagsEnd && tag->offset + tag->length <= from) {
+		++tag;
+	}
+
 	const QChar *start = text.unicode(), *end = start + text.size();
-	for (auto offset = 0, matchOffset = offset; offset < len;) {
+	for (auto offset = from, matchOffset = offset; offset < till;) {
 		auto m = qthelp::RegExpDomain().match(text, matchOffset);
 		if (!m.hasMatch()) break;
 
 		auto domainOffset = m.capturedStart();
+		if (domainOffset >= till) break;
 
 		auto protocol = m.captured(1).toLower();
 		auto topDomain = m.captured(3).toLower();
@@ -675,9 +815,9 @@ void MessageLinksParser::parse() {
 		}
 		offset = matchOffset = p - start;
 	}
-	processTagsBefore(QFIXED_MAX);
-
-	apply(text, ranges);
+	while (tag != tagsEnd && tag->offset < till) {
+		processTag();
+	}
 }
 
 void MessageLinksParser::apply(
@@ -92,11 +92,27 @@ private:
 	}
 
 	void parse();
+
+	// Scans [from, till) of the text for links, appending them to
+	// the ranges. Links never cross a paragraph bound, so an edit
+	// needs only the touched paragraphs rescanned with the cached
+	// ranges around them spliced back in (see parse()).
+	void scanRanges(
+		const QString &text,
+		int from,
+		int till,
+		const TextWithTags::Tags &tags,
+		const std::vector<Ui::InputField::MarkdownTag> &markdownTags,
+		QVector<LinkRange> &ranges) const;
 	void apply(const QString &text, const QVector<LinkRange> &ranges);
 
 	not_null<Ui::InputField*> _field;
 	rpl::variable<QStringList> _list;
 	int _lastLength = 0;
+	QString _lastText;
+	TextWithTags::Tags _lastTags;
+	std::vector<Ui::InputField::MarkdownTag> _lastMarkdownTags;
+	QVector<LinkRange> _ranges;
 	base::Timer _timer;
 	QtConnectionOwner _connection;
 
@@ -711,10 +711,6 @@ std::vector<not_null<DocumentData*>> GetListByEmoji(
 	const auto CreateRecentSortKey = [&](not_null<DocumentData*> document) {
 		return CreateSortKey(document, kSlice * 4);
 	};
-	auto myCounter = 0;
-	const auto CreateMySortKey = [&] {
-		return (kSlice * 4 - (++myCounter));
-	};
 	const auto CreateFeaturedSortKey = [&](not_null<DocumentData*> document) {
 		return CreateSortKey(document, kSlice * 2);
 	};
@@ -761,10 +757,16 @@ std::vector<not_null<DocumentData*>> GetListByEmoji(
 			}
 		}
 	}
-	const auto addList = [&](const Order &order, MTPDstickerSet::Flag skip) {
-		for (const auto setId : order) {
+	const auto rebuildIndex = [&](EmojiIndex &index) {
+		index.map.clear();
+
+		// Replays the per-emoji counters CreateMySortKey() produces
+		// when the sets are scanned for one emoji at a time.
+		auto counters = base::flat_map<EmojiPtr, int>();
+		for (const auto setId : Auth().data().stickerSetsOrder()) {
 			auto it = sets.find(setId);
-			if (it == sets.cend() || (it->flags & skip)) {
+			if (it == sets.cend()
+				|| (it->flags & MTPDstickerSet::Flag::f_archived)) {
 				continue;
 			}
 			if (it->emoji.isEmpty()) {
@@ -772,30 +774,43 @@ std::vector<not_null<DocumentData*>> GetListByEmoji(
 				it->flags |= MTPDstickerSet_ClientFlag::f_not_loaded;
 				continue;
 			}
-			auto i = it->emoji.constFind(original);
-			if (i == it->emoji.cend()) {
-				continue;
-			}
-			const auto my = (it->flags & MTPDstickerSet::Flag::f_installed_date);
-			result.reserve(result.size() + i->size());
-			for (const auto document : *i) {
-				const auto installDate = my ? it->installDate : TimeId(0);
-				const auto date = (installDate > 1)
-					? installDate
-					: my
-					? CreateMySortKey()
-					: CreateFeaturedSortKey(document);
-				add(document, date);
+			const auto my = (it->flags
+				& MTPDstickerSet::Flag::f_installed_date);
+			for (auto i = it->emoji.cbegin(); i != it->emoji.cend(); ++i) {
+				auto &list = index.map[i.key()];
+				list.reserve(list.size() + i->size());
+				for (const auto document : *i) {
+					const auto installDate = my
+						? it->installDate
+						: TimeId(0);
+					const auto date = (installDate > 1)
+						? installDate
+						: my
+						? TimeId(kSlice * 4 - (++counters[i.key()]))
+						: TimeId(0); // Seed-dependent, computed below.
+					list.push_back({ document, date });
+				}
 			}
 		}
+		index.valid = true;
 	};
-
-	addList(
-		Auth().data().stickerSetsOrder(),
-		MTPDstickerSet::Flag::f_archived);
-	//addList(
-	//	Auth().data().featuredStickerSetsOrder(),
-	//	MTPDstickerSet::Flag::f_installed_date);
+	const auto addIndexed = [&] {
+		auto &index = Auth().data().stickersByEmojiIndexRef();
+		if (!index.valid) {
+			rebuildIndex(index);
+		}
+		const auto i = index.map.find(original);
+		if (i == index.map.end()) {
+			return;
+		}
+		result.reserve(result.size() + i->second.size());
+		for (const auto &entry : i->second) {
+			add(entry.document, entry.date
+				? entry.date
+				: CreateFeaturedSortKey(entry.document));
+		}
+	};
+	addIndexed();
 
 	if (!setsToRequest.empty()) {
 		for (const auto [setId, accessHash] : setsToRequest) {
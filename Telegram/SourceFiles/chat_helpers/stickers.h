@@ -58,6 +58,21 @@ struct Set {
 };
 using Sets = QMap<uint64, Set>;
 
+struct StickerWithDate {
+	not_null<DocumentData*> document;
+	TimeId date = 0;
+};
+
+// Inverted emoji -> stickers index over the installed sets, built
+// lazily by GetListByEmoji() and reset in notifyStickersUpdated(),
+// so suggestions while typing don't rescan every set per keystroke.
+// Zero date means the sort key depends on the query seed and is
+// computed when the entry is used.
+struct EmojiIndex {
+	base::flat_map<EmojiPtr, std::vector<StickerWithDate>> map;
+	bool valid = false;
+};
+
 inline MTPInputStickerSet inputSetId(const Set &set) {
 	if (set.id && set.access) {
 		return MTP_inputStickerSetID(MTP_long(set.id), MTP_long(set.access));
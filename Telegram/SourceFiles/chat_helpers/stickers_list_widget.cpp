@@ -991,6 +991,9 @@ void StickersListWidget::fillLocalSearchRows(const QString &query) {
 	if (searchWordsList.isEmpty()) {
 		return;
 	}
+	if (!_searchIndexValid) {
+		refreshSearchIndex();
+	}
 	auto searchWordInTitle = [](
 			const QStringList &titleWords,
 			const QString &searchWord) {
@@ -1352,16 +1355,22 @@ void StickersListWidget::paintSticker(Painter &p, Set &set, int y, int index, bo
 	auto ppos = pos + QPoint((_singleSize.width() - w) / 2, (_singleSize.height() - h) / 2);
 	if (const auto image = document->getStickerSmall()) {
 		if (image->loaded()) {
-			p.drawPixmapLeft(
-				ppos,
-				width(),
-				image->pixSingle(
-					document->stickerSetOrigin(),
-					w,
-					h,
-					w,
-					h,
-					ImageRoundRadius::None));
+			auto pixmap = image->pixSingle(
+				document->stickerSetOrigin(),
+				w,
+				h,
+				w,
+				h,
+				ImageRoundRadius::None);
+			Auth().data().saveStickerFrame(document, pixmap);
+			p.drawPixmapLeft(ppos, width(), pixmap);
+		} else if (const auto frame = Auth().data().stickerFrame(
+				document,
+				w * cIntRetinaFactor(),
+				h * cIntRetinaFactor())) {
+			// While the sticker data is read and decoded show the
+			// frame persisted in the cache by a previous app run.
+			p.drawPixmapLeft(ppos, width(), *frame);
 		}
 	}
 
@@ -1713,12 +1722,12 @@ void StickersListWidget::refreshStickers() {
 	}
 	refreshMegagroupStickers(GroupStickersPlace::Hidden);
 
-	_featuredSets.clear();
-	_featuredSets.reserve(Auth().data().featuredStickerSetsOrder().size());
-
-	for_const (auto setId, Auth().data().featuredStickerSetsOrder()) {
-		const auto externalLayout = true;
-		appendSet(_featuredSets, setId, externalLayout, AppendSkip::Installed);
+	// Building the featured rows is deferred until the featured section
+	// is actually shown - the panel normally opens on the stickers section.
+	if (_section == Section::Featured) {
+		refreshFeaturedSets();
+	} else {
+		_featuredSetsDirty = true;
 	}
 
 	refreshSearchSets();
@@ -1735,8 +1744,41 @@ void StickersListWidget::refreshStickers() {
 	update();
 }
 
+void StickersListWidget::refreshFeaturedSets() {
+	_featuredSets.clear();
+	_featuredSets.reserve(Auth().data().featuredStickerSetsOrder().size());
+
+	for_const (auto setId, Auth().data().featuredStickerSetsOrder()) {
+		const auto externalLayout = true;
+		appendSet(_featuredSets, setId, externalLayout, AppendSkip::Installed);
+	}
+	_featuredSetsDirty = false;
+}
+
+bool StickersListWidget::hasFeaturedSets() const {
+	if (!_featuredSetsDirty) {
+		return !_featuredSets.empty();
+	}
+
+	// Answer without building the deferred rows,
+	// mirroring the appendSet() / AppendSkip::Installed checks.
+	const auto &sets = Auth().data().stickerSets();
+	for_const (auto setId, Auth().data().featuredStickerSetsOrder()) {
+		const auto it = sets.constFind(setId);
+		if (it == sets.cend() || it->stickers.isEmpty()) {
+			continue;
+		} else if ((it->flags & MTPDstickerSet::Flag::f_installed_date)
+			&& !(it->flags & MTPDstickerSet::Flag::f_archived)
+			&& !_installedLocallySets.contains(setId)) {
+			continue;
+		}
+		return true;
+	}
+	return false;
+}
+
 void StickersListWidget::refreshSearchSets() {
-	refreshSearchIndex();
+	_searchIndexValid = false;
 
 	const auto &sets = Auth().data().stickerSets();
 	for (auto &set : _searchSets) {
@@ -1763,6 +1805,7 @@ void StickersListWidget::refreshSearchIndex() {
 		const auto list = TextUtilities::PrepareSearchWords(string);
 		_searchIndex.emplace_back(set.id, list);
 	}
+	_searchIndexValid = true;
 }
 
 void StickersListWidget::refreshSettingsVisibility() {
@@ -2028,7 +2071,7 @@ void StickersListWidget::fillIcons(QList<StickerIcon> &icons) {
 	icons.clear();
 	icons.reserve(_mySets.size() + 1);
 	if (Auth().data().featuredStickerSetsUnreadCount()
-		&& !_featuredSets.empty()) {
+		&& hasFeaturedSets()) {
 		icons.push_back(StickerIcon(Stickers::FeaturedSetId));
 	}
 
@@ -2068,7 +2111,7 @@ void StickersListWidget::fillIcons(QList<StickerIcon> &icons) {
 	}
 
 	if (!Auth().data().featuredStickerSetsUnreadCount()
-		&& !_featuredSets.empty()) {
+		&& hasFeaturedSets()) {
 		icons.push_back(StickerIcon(Stickers::FeaturedSetId));
 	}
 }
@@ -2211,6 +2254,9 @@ void StickersListWidget::showStickerSet(uint64 setId) {
 		if (_section != Section::Featured) {
 			_section = Section::Featured;
 
+			if (_featuredSetsDirty) {
+				refreshFeaturedSets();
+			}
 			refreshRecentStickers(true);
 			refreshSettingsVisibility();
 			if (_footer) {
@@ -166,6 +166,8 @@ private:
 		const MTPInputStickerSet &input);
 	void refreshSearchSets();
 	void refreshSearchIndex();
+	void refreshFeaturedSets();
+	bool hasFeaturedSets() const;
 
 	bool setHasTitle(const Set &set) const;
 	bool stickerHasDeleteButton(const Set &set, int index) const;
@@ -246,6 +248,7 @@ private:
 	ChannelData *_megagroupSet = nullptr;
 	std::vector<Set> _mySets;
 	std::vector<Set> _featuredSets;
+	bool _featuredSetsDirty = true;
 	std::vector<Set> _searchSets;
 	base::flat_set<uint64> _installedLocallySets;
 	std::vector<bool> _custom;
@@ -281,6 +284,7 @@ private:
 
 	std::map<QString, std::vector<uint64>> _searchCache;
 	std::vector<std::pair<uint64, QStringList>> _searchIndex;
+	bool _searchIndexValid = false;
 	base::Timer _searchRequestTimer;
 	QString _searchQuery, _searchNextQuery;
 	mtpRequestId _searchRequestId = 0;
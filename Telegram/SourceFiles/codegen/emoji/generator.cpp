@@ -15,6 +15,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <QtGui/QPainter>
 #include <QtCore/QDir>
 
+#include <algorithm>
+
 #ifdef SUPPORT_IMAGE_GENERATION
 Q_IMPORT_PLUGIN(QWebpPlugin)
 #ifdef Q_OS_MAC
@@ -360,6 +362,11 @@ const std::vector<std::pair<QString, int>> GetReplacementPairs() {\n\
 }\n\
 \n\
 EmojiPtr Find(const QChar *start, const QChar *end, int *outLength) {\n\
+	if (start == end\n\
+		|| !(FindFirstCharMask[start->unicode() >> 5]\n\
+			& (uint32(1) << (start->unicode() & 0x1F)))) {\n\
+		return nullptr;\n\
+	}\n\
 	auto index = FindIndex(start, end, outLength);\n\
 	return index ? &Items[index - 1] : nullptr;\n\
 }\n\
@@ -636,6 +643,24 @@ int FindReplaceIndex(const QChar *start, const QChar *end, int *outLength) {\n\
 bool Generator::writeFind() {
 	source_->stream() << "\
 \n\
+// Bit is set for every code unit that can start an emoji id, so\n\
+// Find() rejects ordinary text with a single memory probe before\n\
+// entering the generated state machine.\n\
+constexpr uint32 FindFirstCharMask[0x10000 / 32] = {";
+	uint32 mask[0x10000 / 32] = { 0 };
+	for (const auto &item : data_.map) {
+		const auto unit = item.first[0].unicode();
+		mask[unit >> 5] |= (uint32(1) << (unit & 0x1F));
+	}
+	for (auto i = 0; i != 0x10000 / 32; ++i) {
+		if (!(i % 8)) {
+			source_->stream() << "\n\t";
+		}
+		source_->stream() << "0x" << QString::number(mask[i], 16) << ",";
+	}
+	source_->stream() << "\n\
+};\n\
+\n\
 int FindIndex(const QChar *start, const QChar *end, int *outLength) {\n\
 	auto ch = start;\n\
 \n";
@@ -783,7 +808,7 @@ bool Generator::writeFindFromDictionary(
 bool Generator::writeSuggestionsSource() {
 	suggestionsSource_ = std::make_unique<common::CppFile>(suggestionsPath_ + ".cpp", project_);
 	suggestionsSource_->stream() << "\
-#include <map>\n\
+#include <algorithm>\n\
 \n";
 	suggestionsSource_->pushNamespace("Ui").pushNamespace("Emoji").pushNamespace("internal").pushNamespace();
 	suggestionsSource_->stream() << "\
@@ -814,14 +839,13 @@ bool Generator::writeSuggestionsHeader() {
 struct Replacement {\n\
 	utf16string emoji;\n\
 	utf16string replacement;\n\
-	std::vector<utf16string> words;\n\
+	string_span words;\n\
 };\n\
 \n\
 constexpr auto kReplacementMaxLength = " << maxLength << ";\n\
 \n\
-void InitReplacements();\n\
-const std::vector<Replacement> &GetAllReplacements();\n\
-const std::vector<const Replacement*> *GetReplacements(utf16char first);\n\
+span<Replacement> GetAllReplacements();\n\
+span<const Replacement*> GetReplacements(utf16char first);\n\
 utf16string GetReplacementEmoji(utf16string replacement);\n\
 \n";
 	return header->finalize();
@@ -830,26 +854,34 @@ utf16string GetReplacementEmoji(utf16string replacement);\n\
 bool Generator::writeReplacements() {
 	QMap<QChar, QVector<int>> byCharIndices;
 	suggestionsSource_->stream() << "\
-struct ReplacementStruct {\n\
-	small emojiSize;\n\
-	small replacementSize;\n\
-	small wordsCount;\n\
-};\n\
-\n\
 const utf16char ReplacementData[] = {";
 	startBinary();
+	auto dataOffset = 0;
+	auto emojiOffsets = QVector<int>();
+	auto replacementOffsets = QVector<int>();
+	auto wordBases = QVector<int>();
+	auto wordOffsets = QVector<int>();
+	auto wordLengths = QVector<int>();
 	for (auto i = 0, size = replaces_.list.size(); i != size; ++i) {
 		auto &replace = replaces_.list[i];
+		emojiOffsets.push_back(dataOffset);
 		if (!writeStringBinary(suggestionsSource_.get(), replace.id)) {
 			return false;
 		}
+		dataOffset += replace.id.size();
+		replacementOffsets.push_back(dataOffset);
 		if (!writeStringBinary(suggestionsSource_.get(), replace.replacement)) {
 			return false;
 		}
+		dataOffset += replace.replacement.size();
+		wordBases.push_back(wordOffsets.size());
 		for (auto &word : replace.words) {
+			wordOffsets.push_back(dataOffset);
+			wordLengths.push_back(word.size());
 			if (!writeStringBinary(suggestionsSource_.get(), word)) {
 				return false;
 			}
+			dataOffset += word.size();
 			auto &index = byCharIndices[word[0]];
 			if (index.isEmpty() || index.back() != i) {
 				index.push_back(i);
@@ -858,117 +890,99 @@ const utf16char ReplacementData[] = {";
 	}
 	suggestionsSource_->stream() << " };\n\
 \n\
-const small ReplacementWordLengths[] = {";
-	startBinary();
-	for (auto &replace : replaces_.list) {
-		auto wordLengths = QStringList();
-		for (auto &word : replace.words) {
-			writeIntBinary(suggestionsSource_.get(), word.size());
-		}
+const utf16string ReplacementWords[] = {\n";
+	for (auto i = 0, size = wordOffsets.size(); i != size; ++i) {
+		suggestionsSource_->stream() << "\
+	{ ReplacementData + " << wordOffsets[i] << ", " << wordLengths[i] << " },\n";
 	}
-	suggestionsSource_->stream() << " };\n\
+	suggestionsSource_->stream() << "};\n\
 \n\
-const ReplacementStruct ReplacementInitData[] = {\n";
-	for (auto &replace : replaces_.list) {
+const Replacement ReplacementTable[] = {\n";
+	for (auto i = 0, size = replaces_.list.size(); i != size; ++i) {
+		auto &replace = replaces_.list[i];
 		suggestionsSource_->stream() << "\
-	{ small(" << replace.id.size() << "), small(" << replace.replacement.size() << "), small(" << replace.words.size() << ") },\n";
+	{ { ReplacementData + " << emojiOffsets[i] << ", " << replace.id.size() << " }, { ReplacementData + " << replacementOffsets[i] << ", " << replace.replacement.size() << " }, { ReplacementWords + " << wordBases[i] << ", " << replace.words.size() << " } },\n";
 	}
 	suggestionsSource_->stream() << "};\n\
 \n\
-const medium ReplacementIndices[] = {";
-	startBinary();
+const Replacement *const ReplacementPtrsData[] = {\n";
+	auto indicesCount = 0;
 	for (auto &byCharIndex : byCharIndices) {
 		for (auto index : byCharIndex) {
-			writeIntBinary(suggestionsSource_.get(), index);
+			suggestionsSource_->stream() << "\
+	ReplacementTable + " << index << ",\n";
+			++indicesCount;
 		}
 	}
-	suggestionsSource_->stream() << " };\n\
+	if (indicesCount >= 0x10000) {
+		logDataError() << "Too many replacement indices.";
+		return false;
+	}
+	suggestionsSource_->stream() << "};\n\
 \n\
 struct ReplacementIndexStruct {\n\
 	utf16char ch;\n\
 	medium count;\n\
+	medium offset;\n\
 };\n\
 \n\
-const internal::checksum ReplacementChecksums[] = {\n";
-	startBinary();
-	for (auto &replace : replaces_.list) {
-		writeUintBinary(suggestionsSource_.get(), countCrc32(replace.replacement.constData(), replace.replacement.size() * sizeof(QChar)));
-	}
-	suggestionsSource_->stream() << " };\n\
-\n\
 const ReplacementIndexStruct ReplacementIndexData[] = {\n";
-	startBinary();
+	auto indexOffset = 0;
 	for (auto i = byCharIndices.cbegin(), e = byCharIndices.cend(); i != e; ++i) {
 		suggestionsSource_->stream() << "\
-	{ utf16char(" << i.key().unicode() << "), medium(" << i.value().size() << ") },\n";
+	{ utf16char(" << i.key().unicode() << "), medium(" << i.value().size() << "), medium(" << indexOffset << ") },\n";
+		indexOffset += i.value().size();
 	}
 	suggestionsSource_->stream() << "};\n\
 \n\
-std::vector<Replacement> Replacements;\n\
-std::map<utf16char, std::vector<const Replacement*>> ReplacementsMap;\n\
-std::map<internal::checksum, const Replacement*> ReplacementsHash;\n\
+struct ReplacementChecksumStruct {\n\
+	internal::checksum code;\n\
+	medium index;\n\
+};\n\
+\n\
+const ReplacementChecksumStruct ReplacementChecksums[] = {\n";
+	auto checksums = QVector<QPair<uint32, int>>();
+	checksums.reserve(replaces_.list.size());
+	for (auto i = 0, size = replaces_.list.size(); i != size; ++i) {
+		auto &replace = replaces_.list[i];
+		checksums.push_back({ countCrc32(replace.replacement.constData(), replace.replacement.size() * sizeof(QChar)), i });
+	}
+	std::sort(checksums.begin(), checksums.end());
+	for (auto &entry : checksums) {
+		suggestionsSource_->stream() << "\
+	{ internal::checksum(0x" << QString::number(entry.first, 16).toUpper() << "U), medium(" << entry.second << ") },\n";
+	}
+	suggestionsSource_->stream() << "};\n\
 \n";
 	return true;
 }
 
 bool Generator::writeGetReplacements() {
 	suggestionsSource_->stream() << "\
-void InitReplacements() {\n\
-	if (!Replacements.empty()) {\n\
-		return;\n\
-	}\n\
-	auto data = ReplacementData;\n\
-	auto takeString = [&data](int size) {\n\
-		auto result = utf16string(data, size);\n\
-		data += size;\n\
-		return result;\n\
-	};\n\
-	auto wordSize = ReplacementWordLengths;\n\
-\n\
-	Replacements.reserve(" << replaces_.list.size() << ");\n\
-	for (auto item : ReplacementInitData) {\n\
-		auto emoji = takeString(item.emojiSize);\n\
-		auto replacement = takeString(item.replacementSize);\n\
-		auto words = std::vector<utf16string>();\n\
-		words.reserve(item.wordsCount);\n\
-		for (auto i = 0; i != item.wordsCount; ++i) {\n\
-			words.push_back(takeString(*wordSize++));\n\
-		}\n\
-		Replacements.push_back({ std::move(emoji), std::move(replacement), std::move(words) });\n\
-	}\n\
-\n\
-	auto indices = ReplacementIndices;\n\
-	auto items = &Replacements[0];\n\
-	for (auto item : ReplacementIndexData) {\n\
-		auto index = std::vector<const Replacement*>();\n\
-		index.reserve(item.count);\n\
-		for (auto i = 0; i != item.count; ++i) {\n\
-			index.push_back(items + (*indices++));\n\
-		}\n\
-		ReplacementsMap.emplace(item.ch, std::move(index));\n\
-	}\n\
-\n\
-	for (auto checksum : ReplacementChecksums) {\n\
-		ReplacementsHash.emplace(checksum, items++);\n\
-	}\n\
+span<Replacement> GetAllReplacements() {\n\
+	return { ReplacementTable, sizeof(ReplacementTable) / sizeof(ReplacementTable[0]) };\n\
 }\n\
 \n\
-const std::vector<const Replacement*> *GetReplacements(utf16char first) {\n\
-	if (ReplacementsMap.empty()) {\n\
-		InitReplacements();\n\
+span<const Replacement*> GetReplacements(utf16char first) {\n\
+	auto begin = ReplacementIndexData;\n\
+	auto end = begin + (sizeof(ReplacementIndexData) / sizeof(ReplacementIndexData[0]));\n\
+	auto it = std::lower_bound(begin, end, first, [](const ReplacementIndexStruct &entry, utf16char ch) {\n\
+		return entry.ch < ch;\n\
+	});\n\
+	if (it == end || it->ch != first) {\n\
+		return span<const Replacement*>();\n\
 	}\n\
-	auto it = ReplacementsMap.find(first);\n\
-	return (it == ReplacementsMap.cend()) ? nullptr : &it->second;\n\
-}\n\
-\n\
-const std::vector<Replacement> &GetAllReplacements() {\n\
-	return Replacements;\n\
+	return { ReplacementPtrsData + it->offset, it->count };\n\
 }\n\
 \n\
 utf16string GetReplacementEmoji(utf16string replacement) {\n\
 	auto code = internal::countChecksum(replacement.data(), replacement.size() * sizeof(utf16char));\n\
-	auto it = ReplacementsHash.find(code);\n\
-	return (it == ReplacementsHash.cend()) ? utf16string() : it->second->emoji;\n\
+	auto begin = ReplacementChecksums;\n\
+	auto end = begin + (sizeof(ReplacementChecksums) / sizeof(ReplacementChecksums[0]));\n\
+	auto it = std::lower_bound(begin, end, code, [](const ReplacementChecksumStruct &entry, internal::checksum code) {\n\
+		return entry.code < code;\n\
+	});\n\
+	return (it == end || it->code != code) ? utf16string() : ReplacementTable[it->index].emoji;\n\
 }\n\
 \n";
 	return true;
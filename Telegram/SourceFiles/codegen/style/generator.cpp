@@ -452,6 +452,10 @@ public:\n\
 \n\
 	int indexOfColor(color c) const;\n\
 	color colorAtIndex(int index) const;\n\
+\n\
+	// Indices of entries with values that differ from the other palette,\n\
+	// so that theme switches can notify only about changed entries.\n\
+	QVector<int> changedIndices(const palette &other) const;\n\
 \n\
 	inline const color &get_transparent() const { return _colors[0]; }; // special color\n";
 
@@ -565,7 +569,7 @@ QByteArray save();\n\
 bool load(const QByteArray &cache);\n\
 palette::SetResult setColor(QLatin1String name, uchar r, uchar g, uchar b, uchar a);\n\
 palette::SetResult setColor(QLatin1String name, QLatin1String from);\n\
-void apply(const palette &other);\n\
+QVector<int> apply(const palette &other);\n\
 void reset();\n\
 int indexOfColor(color c);\n\
 \n\
@@ -967,6 +971,19 @@ bool palette::load(const QByteArray &cache) {\n\
 	return true;\n\
 }\n\
 \n\
+QVector<int> palette::changedIndices(const palette &other) const {\n\
+	auto result = QVector<int>();\n\
+	for (auto i = 0; i != kCount; ++i) {\n\
+		const auto ready = (_status[i] != Status::Initial);\n\
+		const auto otherReady = (other._status[i] != Status::Initial);\n\
+		if (ready != otherReady\n\
+			|| (ready && data(i)->c != other.data(i)->c)) {\n\
+			result.push_back(i);\n\
+		}\n\
+	}\n\
+	return result;\n\
+}\n\
+\n\
 palette::SetResult palette::setColor(QLatin1String name, uchar r, uchar g, uchar b, uchar a) {\n\
 	auto nameIndex = getPaletteIndex(name);\n\
 	if (nameIndex < 0) return SetResult::KeyNotFound;\n\
@@ -1010,9 +1027,13 @@ palette::SetResult setColor(QLatin1String name, QLatin1String from) {\n\
 	return _palette.setColor(name, from);\n\
 }\n\
 \n\
-void apply(const palette &other) {\n\
+QVector<int> apply(const palette &other) {\n\
+	auto changed = _palette.changedIndices(other);\n\
 	_palette = other;\n\
-	style::internal::resetIcons();\n\
+	if (!changed.isEmpty()) {\n\
+		style::internal::resetIcons();\n\
+	}\n\
+	return changed;\n\
 }\n\
 \n\
 void reset() {\n\
@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "core/update_checker.h"
 #include "core/shortcuts.h"
 #include "core/sandbox.h"
+#include "core/startup_timeline.h"
 #include "core/local_url_handlers.h"
 #include "core/launcher.h"
 #include "storage/localstorage.h"
@@ -86,13 +87,26 @@ Application::Application(not_null<Launcher*> launcher)
 }
 
 void Application::run() {
-	Fonts::Start();
-
 	ThirdParty::start();
 	Global::start();
 	refreshGlobalProxy(); // Depends on Global::started().
 
+	// Font loading doesn't depend on the settings being read, so it is
+	// done on a worker while the main thread waits for the settings
+	// file I/O. The styles can't move there with it - they depend on
+	// the interface scale from the settings.
+	const auto fontsReady = std::make_shared<QSemaphore>();
+	crl::async([=] {
+		Fonts::Start();
+		fontsReady->release();
+
+		// Create mime database, so it won't be slow later.
+		QMimeDatabase().mimeTypeForName(qsl("text/plain"));
+	});
+
+	Profiling::StartupSpanStart("settings read");
 	startLocalStorage();
+	Profiling::StartupSpanEnd("settings read");
 
 	if (Local::oldSettingsVersion() < AppVersion) {
 		psNewVersion();
@@ -107,11 +121,14 @@ void Application::run() {
 	_translator = std::make_unique<Lang::Translator>();
 	QCoreApplication::instance()->installTranslator(_translator.get());
 
+	Profiling::StartupSpanStart("managers start");
+	fontsReady->acquire(); // The styles use the loaded fonts.
 	style::startManager();
 	anim::startManager();
 	Ui::InitTextOptions();
 	Ui::Emoji::Init();
 	Media::Player::start(_audio.get());
+	Profiling::StartupSpanEnd("managers start");
 
 	DEBUG_LOG(("Application Info: inited..."));
 
@@ -122,15 +139,14 @@ void Application::run() {
 
 	DEBUG_LOG(("Application Info: starting app..."));
 
-	// Create mime database, so it won't be slow later.
-	QMimeDatabase().mimeTypeForName(qsl("text/plain"));
-
+	Profiling::StartupSpanStart("window create");
 	_window = std::make_unique<MainWindow>();
 	_window->init();
 
 	auto currentGeometry = _window->geometry();
 	_mediaView = std::make_unique<MediaView>();
 	_window->setGeometry(currentGeometry);
+	Profiling::StartupSpanEnd("window create");
 
 	QCoreApplication::instance()->installEventFilter(this);
 	connect(
@@ -144,7 +160,9 @@ void Application::run() {
 	startShortcuts();
 	App::initMedia();
 
+	Profiling::StartupSpanStart("map read");
 	Local::ReadMapState state = Local::readMap(QByteArray());
+	Profiling::StartupSpanEnd("map read");
 	if (state == Local::ReadMapPassNeeded) {
 		Global::SetLocalPasscode(true);
 		Global::RefLocalPasscodeChanged().notify();
@@ -152,16 +170,22 @@ void Application::run() {
 		DEBUG_LOG(("Application Info: passcode needed..."));
 	} else {
 		DEBUG_LOG(("Application Info: local map read..."));
+		Profiling::StartupSpanStart("mtp start");
 		startMtp();
+		Profiling::StartupSpanEnd("mtp start");
 		DEBUG_LOG(("Application Info: MTP started..."));
 		if (AuthSession::Exists()) {
+			Profiling::StartupSpanStart("main setup");
 			_window->setupMain();
+			Profiling::StartupSpanEnd("main setup");
 		} else {
 			_window->setupIntro();
 		}
 	}
 	DEBUG_LOG(("Application Info: showing."));
+	Profiling::StartupSpanStart("first show");
 	_window->firstShow();
+	Profiling::StartupSpanEnd("first show");
 
 	if (cStartToSettings()) {
 		_window->showSettings();
@@ -172,6 +196,10 @@ void Application::run() {
 	for (const auto &error : Shortcuts::Errors()) {
 		LOG(("Shortcuts Error: %1").arg(error));
 	}
+
+	// The "dialogs request" span is still open here if we are
+	// authorized, the timeline is written again when it closes.
+	Profiling::WriteStartupTimeline();
 }
 
 bool Application::hideMediaView() {
@@ -710,7 +738,9 @@ void Application::writeInstallBetaVersionsSetting() {
 void Application::authSessionCreate(const MTPUser &user) {
 	Expects(_mtproto != nullptr);
 
+	Profiling::StartupSpanStart("session create");
 	_authSession = std::make_unique<AuthSession>(user);
+	Profiling::StartupSpanEnd("session create");
 	_mtproto->setUpdatesHandler(::rpcDone([](
 			const mtpPrime *from,
 			const mtpPrime *end) {
@@ -718,6 +748,11 @@ void Application::authSessionCreate(const MTPUser &user) {
 			main->updateReceived(from, end);
 		}
 	}));
+	_mtproto->setParsedUpdatesHandler([](MTPUpdates &&updates) {
+		if (const auto main = App::main()) {
+			main->updatesReceived(std::move(updates));
+		}
+	});
 	_mtproto->setGlobalFailHandler(::rpcFail([=](const RPCError &error) {
 		crl::on_main(_authSession.get(), [=] { logOut(); });
 		return true;
@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "platform/platform_specific.h"
 #include "core/crash_reports.h"
 #include "core/main_queue_processor.h"
+#include "core/sampling_profiler.h"
+#include "core/startup_timeline.h"
 #include "core/update_checker.h"
 #include "core/sandbox.h"
 #include "base/concurrent_timer.h"
@@ -225,8 +227,14 @@ int Launcher::exec() {
 	}
 
 	// both are finished in Sandbox::closeApplication
+	Profiling::StartupSpanStart("platform start");
 	Logs::start(this); // must be started before Platform is started
 	Platform::start(); // must be started before Sandbox is created
+	Profiling::StartupSpanEnd("platform start");
+
+	if (cStartProfilerAtLaunch()) {
+		Profiling::Start();
+	}
 
 	auto result = executeApplication();
 
@@ -242,6 +250,11 @@ int Launcher::exec() {
 		launchUpdater(UpdaterLaunch::JustRelaunch);
 	}
 
+	if (Profiling::Started()) {
+		Profiling::SaveCollapsed();
+		Profiling::Finish();
+	}
+
 	CrashReports::Finish();
 	Platform::finish();
 	Logs::finish();
@@ -373,6 +386,7 @@ void Launcher::processArguments() {
 	auto parseMap = std::map<QByteArray, KeyFormat> {
 		{ "-testmode"       , KeyFormat::NoValues },
 		{ "-debug"          , KeyFormat::NoValues },
+		{ "-profile"        , KeyFormat::NoValues },
 		{ "-many"           , KeyFormat::NoValues },
 		{ "-key"            , KeyFormat::OneValue },
 		{ "-autostart"      , KeyFormat::NoValues },
@@ -414,6 +428,7 @@ void Launcher::processArguments() {
 	}
 	gTestMode = parseResult.contains("-testmode");
 	Logs::SetDebugEnabled(parseResult.contains("-debug"));
+	gStartProfilerAtLaunch = parseResult.contains("-profile");
 	gManyInstance = parseResult.contains("-many");
 	gKeyFile = parseResult.value("-key", {}).join(QString()).toLower();
 	gKeyFile = gKeyFile.replace(QRegularExpression("[^a-z0-9\\-_]"), {});
@@ -18,27 +18,24 @@ MainQueueProcessor *ProcessorInstance/* = nullptr*/;
 constexpr auto kProcessorEvent = QEvent::Type(QEvent::User + 1);
 static_assert(kProcessorEvent < QEvent::MaxUser);
 
-class ProcessorEvent : public QEvent {
-public:
-	ProcessorEvent(void (*callable)(void*), void *argument);
-
-	void process();
-
-private:
-	void (*_callable)(void*) = nullptr;
-	void *_argument = nullptr;
-
+// Bulk producers (like sync) flood the queue with thousands of
+// callbacks at once and Qt drains all the already posted events in a
+// single event loop pass, keeping input and paint waiting the whole
+// time. So the callbacks are gathered in our own FIFO and processed
+// in chunks limited by a time budget, the processor event is simply
+// reposted when the budget runs out — events posted while the current
+// batch is processed are delivered only on the next pass, so the loop
+// gets back to the native input and paint events in between.
+constexpr auto kProcessChunkTimeLimit = TimeMs(8);
+
+struct Callback {
+	void (*callable)(void*) = nullptr;
+	void *argument = nullptr;
 };
 
-ProcessorEvent::ProcessorEvent(void (*callable)(void*), void *argument)
-: QEvent(kProcessorEvent)
-, _callable(callable)
-, _argument(argument) {
-}
-
-void ProcessorEvent::process() {
-	_callable(_argument);
-}
+// Guarded by ProcessorMutex.
+std::deque<Callback> ProcessorQueue;
+bool ProcessorEventPosted/* = false*/;
 
 void ProcessObservables() {
 	Global::RefHandleObservables().call();
@@ -53,8 +50,13 @@ MainQueueProcessor::MainQueueProcessor() {
 		QMutexLocker lock(&ProcessorMutex);
 
 		if (ProcessorInstance) {
-			const auto event = new ProcessorEvent(callable, argument);
-			QApplication::postEvent(ProcessorInstance, event);
+			ProcessorQueue.push_back({ callable, argument });
+			if (!ProcessorEventPosted) {
+				ProcessorEventPosted = true;
+				QApplication::postEvent(
+					ProcessorInstance,
+					new QEvent(kProcessorEvent));
+			}
 		}
 	});
 	crl::wrap_main_queue([](void (*callable)(void*), void *argument) {
@@ -68,12 +70,34 @@ MainQueueProcessor::MainQueueProcessor() {
 
 bool MainQueueProcessor::event(QEvent *event) {
 	if (event->type() == kProcessorEvent) {
-		static_cast<ProcessorEvent*>(event)->process();
+		process();
 		return true;
 	}
 	return QObject::event(event);
 }
 
+void MainQueueProcessor::process() {
+	const auto started = getms();
+	while (true) {
+		auto callback = Callback();
+		{
+			QMutexLocker lock(&ProcessorMutex);
+			if (ProcessorQueue.empty()) {
+				ProcessorEventPosted = false;
+				return;
+			} else if (getms() - started >= kProcessChunkTimeLimit) {
+				QApplication::postEvent(
+					this,
+					new QEvent(kProcessorEvent));
+				return;
+			}
+			callback = ProcessorQueue.front();
+			ProcessorQueue.pop_front();
+		}
+		callback.callable(callback.argument);
+	}
+}
+
 void MainQueueProcessor::acquire() {
 	Expects(ProcessorInstance == nullptr);
 
@@ -86,6 +110,11 @@ void MainQueueProcessor::release() {
 
 	QMutexLocker lock(&ProcessorMutex);
 	ProcessorInstance = nullptr;
+
+	// Undelivered events were dropped with the receiver before,
+	// so the still pending callbacks are dropped the same way.
+	ProcessorQueue.clear();
+	ProcessorEventPosted = false;
 }
 
 MainQueueProcessor::~MainQueueProcessor() {
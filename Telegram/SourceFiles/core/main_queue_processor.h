@@ -20,6 +20,7 @@ protected:
 private:
 	void acquire();
 	void release();
+	void process();
 
 };
 
@@ -0,0 +1,80 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/media_active_cache.h"
+
+namespace Core {
+namespace details {
+namespace {
+
+// One budget for all unpacked media instead of the former per-category
+// ceilings (128 MB for images + 32 MB for documents), so a photo-heavy
+// session may use the memory an animation-heavy one leaves free.
+constexpr auto kMediaCacheBudget = int64(160) * 1024 * 1024;
+
+std::vector<MediaActiveCacheTracker*> &Trackers() {
+	static auto result = std::vector<MediaActiveCacheTracker*>();
+	return result;
+}
+
+int64 CountTotalUsage() {
+	auto result = int64(0);
+	for (const auto tracker : Trackers()) {
+		result += tracker->usage();
+	}
+	return result;
+}
+
+} // namespace
+
+MediaActiveCacheTracker::MediaActiveCacheTracker(const char *name)
+: _name(name) {
+	Trackers().push_back(this);
+}
+
+MediaActiveCacheTracker::~MediaActiveCacheTracker() {
+	auto &trackers = Trackers();
+	trackers.erase(
+		std::remove(begin(trackers), end(trackers), this),
+		end(trackers));
+}
+
+void MediaActiveCacheTracker::increment(int64 amount) {
+	_usage += amount;
+}
+
+void MediaActiveCacheTracker::decrement(int64 amount) {
+	_usage -= amount;
+}
+
+bool MediaActiveCacheTracker::overBudget() const {
+	return CountTotalUsage() > kMediaCacheBudget;
+}
+
+} // namespace details
+
+int64 MediaCacheBudget() {
+	return details::kMediaCacheBudget;
+}
+
+int64 MediaCacheTotalUsage() {
+	return details::CountTotalUsage();
+}
+
+std::vector<MediaCacheUsage> MediaCacheUsageByCategory() {
+	auto result = std::vector<MediaCacheUsage>();
+	const auto &trackers = details::Trackers();
+	result.reserve(trackers.size());
+	for (const auto tracker : trackers) {
+		result.push_back({
+			QString::fromLatin1(tracker->name()),
+			tracker->usage() });
+	}
+	return result;
+}
+
+} // namespace Core
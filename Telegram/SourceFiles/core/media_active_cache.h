@@ -10,12 +10,49 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "base/last_used_cache.h"
 
 namespace Core {
+namespace details {
+
+// Tracks per-category usage and sums it into one process-wide budget
+// shared by all unpacked media kept in memory.
+class MediaActiveCacheTracker {
+public:
+	explicit MediaActiveCacheTracker(const char *name);
+	~MediaActiveCacheTracker();
+
+	void increment(int64 amount);
+	void decrement(int64 amount);
+	[[nodiscard]] int64 usage() const {
+		return _usage;
+	}
+	[[nodiscard]] const char *name() const {
+		return _name;
+	}
+
+	[[nodiscard]] bool overBudget() const;
+
+private:
+	const char *_name = nullptr;
+	int64 _usage = 0;
+
+};
+
+} // namespace details
+
+struct MediaCacheUsage {
+	QString name;
+	int64 bytes = 0;
+};
+
+// Process-wide byte budget for unpacked media kept in memory.
+[[nodiscard]] int64 MediaCacheBudget();
+[[nodiscard]] int64 MediaCacheTotalUsage();
+[[nodiscard]] std::vector<MediaCacheUsage> MediaCacheUsageByCategory();
 
 template <typename Type>
 class MediaActiveCache {
 public:
 	template <typename Unload>
-	MediaActiveCache(int64 limit, Unload &&unload);
+	MediaActiveCache(const char *name, Unload &&unload);
 
 	void up(Type *entry);
 	void remove(Type *entry);
@@ -29,17 +66,16 @@ private:
 	void check(Unload &&unload);
 
 	base::last_used_cache<Type*> _cache;
+	details::MediaActiveCacheTracker _tracker;
 	SingleQueuedInvokation _delayed;
-	int64 _usage = 0;
-	int64 _limit = 0;
 
 };
 
 template <typename Type>
 template <typename Unload>
-MediaActiveCache<Type>::MediaActiveCache(int64 limit, Unload &&unload)
-: _delayed([=] { check(unload); })
-, _limit(limit) {
+MediaActiveCache<Type>::MediaActiveCache(const char *name, Unload &&unload)
+: _tracker(name)
+, _delayed([=] { check(unload); }) {
 }
 
 template <typename Type>
@@ -60,18 +96,18 @@ void MediaActiveCache<Type>::clear() {
 
 template <typename Type>
 void MediaActiveCache<Type>::increment(int64 amount) {
-	_usage += amount;
+	_tracker.increment(amount);
 }
 
 template <typename Type>
 void MediaActiveCache<Type>::decrement(int64 amount) {
-	_usage -= amount;
+	_tracker.decrement(amount);
 }
 
 template <typename Type>
 template <typename Unload>
 void MediaActiveCache<Type>::check(Unload &&unload) {
-	while (_usage > _limit) {
+	while (_tracker.overBudget()) {
 		if (const auto entry = _cache.take_lowest()) {
 			unload(entry);
 		} else {
@@ -80,4 +116,4 @@ void MediaActiveCache<Type>::check(Unload &&unload) {
 	}
 }
 
-} // namespace Images
+} // namespace Core
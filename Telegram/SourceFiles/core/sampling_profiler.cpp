@@ -0,0 +1,343 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/sampling_profiler.h"
+
+#include "core/crash_reports.h"
+
+#if defined Q_OS_MAC || defined Q_OS_LINUX64 || defined Q_OS_LINUX32
+
+#define TDESKTOP_SAMPLING_PROFILER
+
+#include <execinfo.h>
+#include <dlfcn.h>
+#include <pthread.h>
+#include <signal.h>
+#include <cxxabi.h>
+#include <atomic>
+
+#endif // Q_OS_MAC || Q_OS_LINUX64 || Q_OS_LINUX32
+
+namespace Profiling {
+namespace {
+
+#ifdef TDESKTOP_SAMPLING_PROFILER
+
+constexpr auto kMaxThreads = 16;
+constexpr auto kMaxFrames = 32;
+constexpr auto kRingSize = 1 << 14; // A few seconds of samples at 1 kHz.
+constexpr auto kMaxThreadName = 16;
+
+struct RegisteredThread {
+	pthread_t handle = pthread_t();
+	char name[kMaxThreadName] = { 0 };
+	bool used = false;
+};
+
+struct Sample {
+	void *frames[kMaxFrames] = { nullptr };
+	int count = 0;
+	int thread = 0;
+};
+
+QMutex RegistryMutex;
+RegisteredThread Registry[kMaxThreads];
+
+// Filled by the signal handler on the sampled thread, copied into
+// the ring by the sampler thread. The handler only uses backtrace()
+// and a lock-free atomic, same as the crash handler above us does.
+void *HandlerFrames[kMaxFrames] = { nullptr };
+std::atomic<int> HandlerFramesCount/* = -1 means sample pending*/;
+
+QMutex RingMutex;
+std::vector<Sample> *Ring/* of size kRingSize*/ = nullptr;
+int RingNext = 0;
+bool RingWrapped = false;
+
+void SamplingSignalHandler(int signum, siginfo_t *info, void *ucontext) {
+	const auto count = backtrace(HandlerFrames, kMaxFrames);
+	HandlerFramesCount.store(count, std::memory_order_release);
+}
+
+class SamplerThread : public QThread {
+public:
+	SamplerThread(int samplesPerSecond)
+	: _interval(1000000 / samplesPerSecond) {
+	}
+
+	void finish() {
+		_finished.store(true);
+		wait();
+	}
+
+protected:
+	void run() override {
+		while (!_finished.load()) {
+			sampleRegisteredThreads();
+			usleep(_interval);
+		}
+	}
+
+private:
+	void sampleRegisteredThreads() {
+		QMutexLocker lock(&RegistryMutex);
+		for (auto i = 0; i != kMaxThreads; ++i) {
+			auto &thread = Registry[i];
+			if (!thread.used) {
+				continue;
+			}
+			HandlerFramesCount.store(-1, std::memory_order_relaxed);
+			if (pthread_kill(thread.handle, SIGPROF) != 0) {
+				// The thread is gone without unregistering itself.
+				thread.used = false;
+				continue;
+			}
+			if (waitForSample()) {
+				pushSample(i);
+			}
+		}
+	}
+
+	bool waitForSample() const {
+		// The handler runs as soon as the signal is delivered, a few
+		// microseconds normally, give up after a millisecond in case
+		// the target thread has signals blocked for some reason.
+		for (auto i = 0; i != 100; ++i) {
+			if (HandlerFramesCount.load(std::memory_order_acquire) >= 0) {
+				return true;
+			}
+			usleep(10);
+		}
+		return false;
+	}
+
+	void pushSample(int threadIndex) {
+		QMutexLocker lock(&RingMutex);
+		if (!Ring) {
+			return;
+		}
+		auto &sample = (*Ring)[RingNext];
+		sample.count = HandlerFramesCount.load(std::memory_order_acquire);
+		sample.thread = threadIndex;
+		memcpy(sample.frames, HandlerFrames, sample.count * sizeof(void*));
+		if (++RingNext == kRingSize) {
+			RingNext = 0;
+			RingWrapped = true;
+		}
+	}
+
+	int _interval = 0;
+	std::atomic<bool> _finished = false;
+
+};
+
+SamplerThread *Sampler = nullptr;
+
+QByteArray SymbolName(void *address) {
+	Dl_info info;
+	if (dladdr(address, &info)) {
+		if (info.dli_sname) {
+			auto status = 0;
+			if (const auto demangled = abi::__cxa_demangle(
+					info.dli_sname,
+					nullptr,
+					nullptr,
+					&status)) {
+				auto result = QByteArray(demangled);
+				free(demangled);
+				return result;
+			}
+			return QByteArray(info.dli_sname);
+		} else if (info.dli_fname) {
+			return QByteArray(info.dli_fname)
+				+ "+0x"
+				+ QByteArray::number(
+					qulonglong(quintptr(address) - quintptr(info.dli_fbase)),
+					16);
+		}
+	}
+	return QByteArray("0x")
+		+ QByteArray::number(qulonglong(quintptr(address)), 16);
+}
+
+#endif // TDESKTOP_SAMPLING_PROFILER
+
+} // namespace
+
+bool Supported() {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	return true;
+#else // TDESKTOP_SAMPLING_PROFILER
+	return false;
+#endif // !TDESKTOP_SAMPLING_PROFILER
+}
+
+bool Started() {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	return (Sampler != nullptr);
+#else // TDESKTOP_SAMPLING_PROFILER
+	return false;
+#endif // !TDESKTOP_SAMPLING_PROFILER
+}
+
+void Start(int samplesPerSecond) {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	Expects(samplesPerSecond > 0);
+
+	if (Sampler) {
+		return;
+	}
+
+	struct sigaction sigact;
+	sigact.sa_sigaction = SamplingSignalHandler;
+	sigemptyset(&sigact.sa_mask);
+	sigact.sa_flags = SA_RESTART | SA_SIGINFO;
+	sigaction(SIGPROF, &sigact, nullptr);
+
+	{
+		QMutexLocker lock(&RingMutex);
+		if (!Ring) {
+			Ring = new std::vector<Sample>(kRingSize);
+		}
+	}
+	RegisterCurrentThread("main");
+
+	Sampler = new SamplerThread(samplesPerSecond);
+	Sampler->start();
+
+	CrashReports::SetAnnotation(
+		"SamplingProfiler",
+		QString("%1 Hz").arg(samplesPerSecond));
+	LOG(("Profiler Info: sampling started at %1 Hz."
+		).arg(samplesPerSecond));
+#else // TDESKTOP_SAMPLING_PROFILER
+	LOG(("Profiler Warning: "
+		"stack sampling is not supported on this platform."));
+#endif // !TDESKTOP_SAMPLING_PROFILER
+}
+
+void Finish() {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	if (const auto sampler = base::take(Sampler)) {
+		sampler->finish();
+		delete sampler;
+		CrashReports::ClearAnnotation("SamplingProfiler");
+	}
+#endif // TDESKTOP_SAMPLING_PROFILER
+}
+
+void RegisterCurrentThread(const char *name) {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	QMutexLocker lock(&RegistryMutex);
+	const auto self = pthread_self();
+	for (auto &thread : Registry) {
+		if (thread.used && pthread_equal(thread.handle, self)) {
+			return;
+		}
+	}
+	for (auto &thread : Registry) {
+		if (!thread.used) {
+			thread.handle = self;
+			strncpy(thread.name, name, kMaxThreadName - 1);
+			thread.name[kMaxThreadName - 1] = 0;
+			thread.used = true;
+			return;
+		}
+	}
+	LOG(("Profiler Warning: "
+		"could not register thread '%1', too many threads."
+		).arg(name));
+#endif // TDESKTOP_SAMPLING_PROFILER
+}
+
+void UnregisterCurrentThread() {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	QMutexLocker lock(&RegistryMutex);
+	const auto self = pthread_self();
+	for (auto &thread : Registry) {
+		if (thread.used && pthread_equal(thread.handle, self)) {
+			thread.used = false;
+			return;
+		}
+	}
+#endif // TDESKTOP_SAMPLING_PROFILER
+}
+
+QByteArray CollectCollapsed() {
+#ifdef TDESKTOP_SAMPLING_PROFILER
+	auto samples = std::vector<Sample>();
+	{
+		QMutexLocker lock(&RingMutex);
+		if (!Ring) {
+			return QByteArray();
+		}
+		const auto count = RingWrapped ? kRingSize : RingNext;
+		samples.reserve(count);
+		const auto oldest = RingWrapped ? RingNext : 0;
+		for (auto i = 0; i != count; ++i) {
+			samples.push_back((*Ring)[(oldest + i) % kRingSize]);
+		}
+	}
+	char names[kMaxThreads][kMaxThreadName];
+	{
+		QMutexLocker lock(&RegistryMutex);
+		for (auto i = 0; i != kMaxThreads; ++i) {
+			memcpy(names[i], Registry[i].name, kMaxThreadName);
+		}
+	}
+
+	auto symbols = std::map<void*, QByteArray>();
+	auto aggregated = std::map<QByteArray, int>();
+	for (const auto &sample : samples) {
+		auto stack = QByteArray(names[sample.thread]);
+		// backtrace() lists the leaf frame first, while the collapsed
+		// format expects stacks written from the root to the leaf.
+		for (auto i = sample.count; i != 0;) {
+			const auto frame = sample.frames[--i];
+			auto it = symbols.find(frame);
+			if (it == symbols.end()) {
+				it = symbols.emplace(frame, SymbolName(frame)).first;
+			}
+			stack += ';';
+			stack += it->second;
+		}
+		++aggregated[stack];
+	}
+
+	auto result = QByteArray();
+	for (const auto &[stack, count] : aggregated) {
+		result += stack;
+		result += ' ';
+		result += QByteArray::number(count);
+		result += '\n';
+	}
+	return result;
+#else // TDESKTOP_SAMPLING_PROFILER
+	return QByteArray();
+#endif // !TDESKTOP_SAMPLING_PROFILER
+}
+
+QString SaveCollapsed() {
+	const auto collapsed = CollectCollapsed();
+	if (collapsed.isEmpty()) {
+		return QString();
+	}
+	const auto path = cWorkingDir()
+		+ qsl("tdata/profile_%1.folded"
+		).arg(QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss"));
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		LOG(("Profiler Error: could not open '%1' for writing.").arg(path));
+		return QString();
+	}
+	file.write(collapsed);
+	LOG(("Profiler Info: %1 bytes of samples saved to '%2'."
+		).arg(collapsed.size()).arg(path));
+	return path;
+}
+
+} // namespace Profiling
@@ -0,0 +1,37 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Profiling {
+
+// Whether stack sampling is implemented for this platform.
+bool Supported();
+
+bool Started();
+
+// Installs the sampling signal handler, registers the calling thread
+// as "main" and spawns the sampler thread. Samples are kept in a fixed
+// ring buffer, the oldest ones are overwritten once it wraps around.
+void Start(int samplesPerSecond = 1000);
+
+// Stops the sampler thread. The collected samples stay available.
+void Finish();
+
+// Threads call these on themselves to become sampling targets.
+void RegisterCurrentThread(const char *name);
+void UnregisterCurrentThread();
+
+// Aggregated samples in the collapsed stack format
+// ("thread;frame;...;frame count\n") understood by flame graph tools.
+QByteArray CollectCollapsed();
+
+// Writes CollectCollapsed() result to a file in tdata,
+// returns the path or an empty string if it could not be written.
+QString SaveCollapsed();
+
+} // namespace Profiling
@@ -0,0 +1,81 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "core/startup_timeline.h"
+
+namespace Profiling {
+namespace {
+
+struct StartupSpanEvent {
+	const char *name = nullptr;
+	char phase = 0; // 'B' begins a span, 'E' ends it.
+	qint64 microseconds = 0;
+};
+
+std::vector<StartupSpanEvent> StartupEvents;
+std::vector<const char*> StartupOpenSpans;
+
+qint64 StartupMicroseconds() {
+	static auto clock = [] {
+		auto result = QElapsedTimer();
+		result.start();
+		return result;
+	}();
+	return clock.nsecsElapsed() / 1000;
+}
+
+} // namespace
+
+void StartupSpanStart(const char *name) {
+	const auto now = StartupMicroseconds();
+	StartupEvents.push_back({ name, 'B', now });
+	StartupOpenSpans.push_back(name);
+}
+
+bool StartupSpanEnd(const char *name) {
+	const auto i = ranges::find_if(StartupOpenSpans, [&](const char *open) {
+		return !strcmp(open, name);
+	});
+	if (i == end(StartupOpenSpans)) {
+		return false;
+	}
+	StartupOpenSpans.erase(i);
+	StartupEvents.push_back({ name, 'E', StartupMicroseconds() });
+	return true;
+}
+
+QString WriteStartupTimeline() {
+	if (StartupEvents.empty()) {
+		return QString();
+	}
+	auto json = QByteArray();
+	json.append("[\n");
+	auto first = true;
+	for (const auto &event : StartupEvents) {
+		if (!first) {
+			json.append(",\n");
+		}
+		first = false;
+		json.append(QString("\t{ \"name\": \"%1\", \"ph\": \"%2\", "
+			"\"ts\": %3, \"pid\": 1, \"tid\": 1 }"
+		).arg(event.name
+		).arg(event.phase
+		).arg(event.microseconds).toUtf8());
+	}
+	json.append("\n]\n");
+
+	const auto path = cWorkingDir() + qsl("tdata/startup_trace.json");
+	QFile file(path);
+	if (!file.open(QIODevice::WriteOnly)) {
+		LOG(("Profiler Error: could not open '%1' for writing.").arg(path));
+		return QString();
+	}
+	file.write(json);
+	return path;
+}
+
+} // namespace Profiling
@@ -0,0 +1,26 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Profiling {
+
+// Startup phase tracing. Spans are collected from process launch and
+// written to tdata/startup_trace.json in the chrome://tracing event
+// format, so a startup regression can be attributed to a phase.
+
+void StartupSpanStart(const char *name);
+
+// Returns true if it closed a span opened by StartupSpanStart(),
+// repeated calls for an already closed span are ignored.
+bool StartupSpanEnd(const char *name);
+
+// Writes everything collected so far, overwriting the previous file.
+// Returns the path or an empty string if it could not be written.
+QString WriteStartupTimeline();
+
+} // namespace Profiling
@@ -176,12 +176,37 @@ const Set &Full::setOrDefault(Source source, Type type) const {
 	return result;
 }
 
+void Full::refreshEffectiveLimits() const {
+	for (const auto source : enums_view<Source>(kSourcesCount)) {
+		for (const auto type : enums_view<Type>(kTypesCount)) {
+			const auto limit = setOrDefault(source, type).bytesLimit(type);
+			_effectiveLimits[static_cast<int>(source)][static_cast<int>(type)]
+				= limit;
+		}
+	}
+	_effectiveLimitsDirty = false;
+}
+
 void Full::setBytesLimit(Source source, Type type, int bytesLimit) {
 	set(source).setBytesLimit(type, bytesLimit);
+	_effectiveLimitsDirty = true;
 }
 
 bool Full::shouldDownload(Source source, Type type, int fileSize) const {
-	return setOrDefault(source, type).shouldDownload(type, fileSize);
+	Expects(static_cast<int>(source) >= 0
+		&& static_cast<int>(source) < kSourcesCount);
+	Expects(static_cast<int>(type) >= 0
+		&& static_cast<int>(type) < kTypesCount);
+
+	// Refreshed lazily and not in the constructor, so constructing
+	// the static Defaults() never queries itself back.
+	if (_effectiveLimitsDirty) {
+		refreshEffectiveLimits();
+	}
+	const auto limit = _effectiveLimits
+		[static_cast<int>(source)]
+		[static_cast<int>(type)];
+	return (limit > 0) && (fileSize <= limit);
 }
 
 int Full::bytesLimit(Source source, Type type) const {
@@ -231,6 +256,7 @@ bool Full::setFromSerialized(const QByteArray &serialized) {
 		}
 	}
 	_data = temp._data;
+	_effectiveLimitsDirty = true;
 	return true;
 }
 
@@ -89,9 +89,18 @@ private:
 	const Set &set(Source source) const;
 	Set &set(Source source);
 	const Set &setOrDefault(Source source, Type type) const;
+	void refreshEffectiveLimits() const;
 
 	std::array<Set, kSourcesCount> _data;
 
+	// Per (source, type) byte limits with the defaults merged in,
+	// regenerated when the settings change, so the check that runs
+	// for every attachment at sync time is a plain table load.
+	mutable std::array<
+		std::array<int, kTypesCount>,
+		kSourcesCount> _effectiveLimits;
+	mutable bool _effectiveLimitsDirty = true;
+
 };
 
 bool Should(
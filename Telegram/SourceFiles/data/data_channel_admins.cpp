@@ -19,20 +19,41 @@ ChannelAdminChanges::ChannelAdminChanges(not_null<ChannelData*> channel)
 }
 
 void ChannelAdminChanges::feed(UserId userId, bool isAdmin) {
-	if (isAdmin && !_admins.contains(userId)) {
-		_admins.insert(userId);
-		_changes.emplace(userId, true);
-	} else if (!isAdmin && _admins.contains(userId)) {
-		_admins.remove(userId);
-		_changes.emplace(userId, false);
+	if (isAdmin != _admins.contains(userId)) {
+		_changes[userId] = isAdmin;
+	} else {
+		_changes.remove(userId);
 	}
 }
 
 ChannelAdminChanges::~ChannelAdminChanges() {
-	if (!_changes.empty()) {
-		if (const auto history = _channel->owner().historyLoaded(_channel)) {
-			history->applyGroupAdminChanges(_changes);
+	if (_changes.empty()) {
+		return;
+	}
+
+	// A full admin list reload feeds a change per admin, so the set
+	// is rebuilt in one merge pass over the two sorted sequences
+	// instead of shifting the stored vector for every user.
+	auto result = std::vector<UserId>();
+	result.reserve(_admins.size() + _changes.size());
+	auto i = begin(_admins);
+	const auto e = end(_admins);
+	for (const auto &[userId, isAdmin] : _changes) {
+		while (i != e && *i < userId) {
+			result.push_back(*i++);
+		}
+		if (i != e && *i == userId) {
+			++i;
 		}
+		if (isAdmin) {
+			result.push_back(userId);
+		}
+	}
+	std::copy(i, e, std::back_inserter(result));
+	_admins = base::flat_set<UserId>(result.begin(), result.end());
+
+	if (const auto history = _channel->owner().historyLoaded(_channel)) {
+		history->applyGroupAdminChanges(_changes);
 	}
 }
 
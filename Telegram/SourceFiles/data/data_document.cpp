@@ -30,11 +30,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
-constexpr auto kMemoryForCache = 32 * 1024 * 1024;
-
 Core::MediaActiveCache<DocumentData> &ActiveCache() {
 	static auto Instance = Core::MediaActiveCache<DocumentData>(
-		kMemoryForCache,
+		"documents",
 		[](DocumentData *document) { document->unload(); });
 	return Instance;
 }
@@ -740,6 +738,13 @@ void DocumentData::automaticLoad(
 		_actionOnLoadMsgId,
 		loadFromCloud,
 		true);
+	if (_loader) {
+		// With an item this is called from the drawing code, so the
+		// media is visible, otherwise it is a predictive preload.
+		_loader->setLoadPriority(item
+			? LoadPriority::Visible
+			: LoadPriority::Preload);
+	}
 }
 
 void DocumentData::automaticLoadSettingsChanged() {
@@ -1088,6 +1093,19 @@ QByteArray DocumentData::data() const {
 	return _data;
 }
 
+QByteArray DocumentData::downloadedPrefix() const {
+	if (!loading()) {
+		return QByteArray();
+	}
+	const auto &result = _loader->bytes();
+	if (_loader->currentOffset() != result.size()) {
+		// Either the load goes straight to a file or the parts
+		// were received out of order and the data has holes in it.
+		return QByteArray();
+	}
+	return result;
+}
+
 const FileLocation &DocumentData::location(bool check) const {
 	if (check && !_location.check()) {
 		const_cast<DocumentData*>(this)->_location = Local::readFileLocation(mediaKey());
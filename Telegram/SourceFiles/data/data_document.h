@@ -161,6 +161,7 @@ public:
 	[[nodiscard]] bool isImage() const;
 	void recountIsImage();
 	[[nodiscard]] bool supportsStreaming() const;
+	[[nodiscard]] QByteArray downloadedPrefix() const;
 	void setData(const QByteArray &data) {
 		_data = data;
 	}
@@ -18,6 +18,46 @@ namespace {
 
 constexpr auto kGoodThumbQuality = 87;
 constexpr auto kWallPaperSize = 960;
+constexpr auto kMaxGenerationsAtOnce = 2;
+
+struct GenerationTask {
+	base::binary_guard guard;
+	Fn<void(base::binary_guard &&guard)> work;
+};
+
+// Generation requests come in when a thumbnail is first painted, so the
+// newest entries belong to what is on the screen right now. The pending
+// list is served newest-first and bounded, scrolling through a media
+// heavy chat doesn't stall the visible items behind offscreen ones.
+std::vector<GenerationTask> GenerationsPending;
+int GenerationsRunningCount = 0;
+
+void CheckStartGenerations() {
+	while (GenerationsRunningCount < kMaxGenerationsAtOnce
+		&& !GenerationsPending.empty()) {
+		auto task = std::move(GenerationsPending.back());
+		GenerationsPending.pop_back();
+		if (!task.guard) {
+			continue;
+		}
+		++GenerationsRunningCount;
+		task.work(std::move(task.guard));
+	}
+}
+
+void ScheduleGeneration(
+		base::binary_guard &&guard,
+		Fn<void(base::binary_guard &&guard)> work) {
+	GenerationsPending.push_back({ std::move(guard), std::move(work) });
+	CheckStartGenerations();
+}
+
+void FinishGeneration() {
+	Expects(GenerationsRunningCount > 0);
+
+	--GenerationsRunningCount;
+	CheckStartGenerations();
+}
 
 QImage Prepare(
 		const QString &path,
@@ -65,39 +105,41 @@ void GoodThumbSource::generate(base::binary_guard &&guard) {
 	}
 	const auto data = _document->data();
 	const auto isWallPaper = _document->isWallPaper();
-	auto location = _document->location().isEmpty()
-		? nullptr
-		: std::make_unique<FileLocation>(_document->location());
+	const auto location = _document->location().isEmpty()
+		? std::shared_ptr<FileLocation>()
+		: std::make_shared<FileLocation>(_document->location());
 	if (data.isEmpty() && !location) {
 		_empty = true;
 		return;
 	}
-	crl::async([
-		=,
-		guard = std::move(guard),
-		location = std::move(location)
-	]() mutable {
-		const auto filepath = (location && location->accessEnable())
-			? location->name()
-			: QString();
-		auto result = Prepare(filepath, data, isWallPaper);
-		auto bytes = QByteArray();
-		if (!result.isNull()) {
-			auto buffer = QBuffer(&bytes);
-			const auto format = (isWallPaper && result.hasAlphaChannel())
-				? "PNG"
-				: "JPG";
-			result.save(&buffer, format, kGoodThumbQuality);
-		}
-		if (!filepath.isEmpty()) {
-			location->accessDisable();
-		}
-		const auto bytesSize = bytes.size();
-		ready(
-			std::move(guard),
-			std::move(result),
-			bytesSize,
-			std::move(bytes));
+	ScheduleGeneration(std::move(guard), [=](
+			base::binary_guard &&guard) {
+		crl::async([=, guard = std::move(guard)]() mutable {
+			const auto filepath = (location && location->accessEnable())
+				? location->name()
+				: QString();
+			auto result = Prepare(filepath, data, isWallPaper);
+			auto bytes = QByteArray();
+			if (!result.isNull()) {
+				auto buffer = QBuffer(&bytes);
+				const auto format = (isWallPaper && result.hasAlphaChannel())
+					? "PNG"
+					: "JPG";
+				result.save(&buffer, format, kGoodThumbQuality);
+			}
+			if (!filepath.isEmpty()) {
+				location->accessDisable();
+			}
+			const auto bytesSize = bytes.size();
+			ready(
+				std::move(guard),
+				std::move(result),
+				bytesSize,
+				std::move(bytes));
+			crl::on_main([] {
+				FinishGeneration();
+			});
+		});
 	});
 }
 
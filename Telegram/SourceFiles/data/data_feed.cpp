@@ -79,7 +79,7 @@ void Feed::indexNameParts() {
 
 void Feed::registerOne(not_null<ChannelData*> channel) {
 	const auto history = owner().history(channel);
-	if (!base::contains(_channels, history)) {
+	if (_channelsIndex.emplace(history).second) {
 		const auto invisible = (_channels.size() < 2);
 		_channels.push_back(history);
 		session().storage().invalidate(
@@ -125,6 +125,7 @@ void Feed::unregisterOne(not_null<ChannelData*> channel) {
 	if (i != end(_channels)) {
 		const auto visible = (_channels.size() > 1);
 		_channels.erase(i, end(_channels));
+		_channelsIndex.remove(history);
 		session().storage().remove(
 			Storage::FeedMessagesRemoveAll(_id, channel->bareId()));
 
@@ -230,11 +231,7 @@ void Feed::setChannels(std::vector<not_null<ChannelData*>> channels) {
 	const auto add = ranges::view::all(
 		channels
 	) | ranges::view::filter([&](not_null<ChannelData*> channel) {
-		return ranges::find(
-			_channels,
-			channel.get(),
-			[](auto history) { return history->peer->asChannel(); }
-		) == end(_channels);
+		return !_channelsIndex.contains(owner().history(channel));
 	}) | ranges::view::transform([](ChannelData *channel) {
 		return not_null<ChannelData*>(channel);
 	}) | ranges::to_vector;
@@ -297,23 +294,21 @@ void Feed::requestChatListMessage() {
 }
 
 void Feed::recountChatListMessage() {
+	// A single pass over the cached last messages: the maximum is
+	// tracked while checking that every channel has its answer ready.
 	_chatListMessage = std::nullopt;
+	auto best = (HistoryItem*)nullptr;
 	for (const auto history : _channels) {
 		if (!history->chatListMessageKnown()) {
 			requestChatListMessage();
 			return;
+		} else if (const auto last = history->chatListMessage()) {
+			if (!best || best->position() < last->position()) {
+				best = last;
+			}
 		}
 	}
-	setChatListMessageFromChannels();
-}
-
-void Feed::setChatListMessageFromChannels() {
-	_chatListMessage = nullptr;
-	for (const auto history : _channels) {
-		if (const auto last = history->chatListMessage()) {
-			justUpdateChatListMessage(last);
-		}
-	}
+	_chatListMessage = best;
 	updateChatListDate();
 }
 
@@ -93,7 +93,6 @@ public:
 private:
 	void indexNameParts();
 	void recountChatListMessage();
-	void setChatListMessageFromChannels();
 	bool justUpdateChatListMessage(not_null<HistoryItem*> item);
 	void updateChatListDate();
 	void changeChannelsList(
@@ -106,6 +105,10 @@ private:
 	FeedId _id = 0;
 	not_null<Data::Session*> _owner;
 	std::vector<not_null<History*>> _channels;
+
+	// Sorted membership index, so that registering channels one by one
+	// doesn't make the feed setup quadratic in the channels count.
+	base::flat_set<not_null<History*>> _channelsIndex;
 	bool _settingChannels = false;
 	bool _channelsLoaded = false;
 
@@ -437,7 +437,7 @@ void PeerData::updateFull() {
 }
 
 void PeerData::updateFullForced() {
-	session().api().requestFullPeer(this);
+	session().api().requestFullPeer(this, true);
 	if (const auto channel = asChannel()) {
 		if (!channel->amCreator() && !channel->inviter) {
 			session().api().requestSelfParticipant(channel);
@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "data/data_peer_values.h"
 
+#include "base/frame_coalesce.h"
 #include "lang/lang_keys.h"
 #include "data/data_channel.h"
 #include "data/data_chat.h"
@@ -198,7 +199,7 @@ rpl::producer<bool> CanWriteValue(ChatData *chat) {
 				&& ((flags & MTPDchat::Flag::f_creator)
 					|| (adminRights.value != MTPDchatAdminRights::Flags(0))
 					|| !defaultSendMessagesRestriction);
-		});
+		}) | base::coalesce_frames();
 }
 
 rpl::producer<bool> CanWriteValue(ChannelData *channel) {
@@ -232,7 +233,7 @@ rpl::producer<bool> CanWriteValue(ChannelData *channel) {
 					|| (!(flags & MTPDchannel::Flag::f_broadcast)
 						&& !sendMessagesRestriction
 						&& !defaultSendMessagesRestriction));
-		});
+		}) | base::coalesce_frames();
 }
 
 rpl::producer<bool> CanWriteValue(not_null<PeerData*> peer) {
@@ -341,7 +341,8 @@ void SearchController::restoreState(SavedState &&state) {
 void SearchController::requestMore(
 		const SparseIdsSliceBuilder::AroundData &key,
 		const Query &query,
-		Data *listData) {
+		Data *listData,
+		bool prefetched) {
 	if (listData->requests.contains(key)) {
 		return;
 	}
@@ -359,16 +360,38 @@ void SearchController::requestMore(
 			key.aroundId,
 			key.direction,
 			result);
+		const auto hadResults = !parsed.messageIds.empty();
 		listData->list.addSlice(
 			std::move(parsed.messageIds),
 			parsed.noSkipRange,
 			parsed.fullCount);
+		if (!prefetched && hadResults) {
+			prefetchNextPage(parsed.noSkipRange.from, query, listData);
+		}
 	}).send();
 	listData->requests.emplace(key, [=] {
 		request(requestId).cancel();
 	});
 }
 
+void SearchController::prefetchNextPage(
+		MsgId till,
+		const Query &query,
+		Data *listData) {
+	// Ask for the next older page right after one was applied, so that
+	// by the time the user scrolls to the end of the loaded results the
+	// continuation is already there. Prefetched pages don't chain, one
+	// page is kept ready beyond what the viewport has asked for.
+	if (till <= 1) {
+		return;
+	}
+	requestMore(
+		{ till, ::Data::LoadDirection::Before },
+		query,
+		listData,
+		true);
+}
+
 DelayedSearchController::DelayedSearchController() {
 	_timer.setCallback([this] { setQueryFast(_nextQuery); });
 }
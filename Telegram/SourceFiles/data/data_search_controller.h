@@ -122,6 +122,11 @@ private:
 	void requestMore(
 		const SparseIdsSliceBuilder::AroundData &key,
 		const Query &query,
+		Data *listData,
+		bool prefetched = false);
+	void prefetchNextPage(
+		MsgId till,
+		const Query &query,
 		Data *listData);
 
 	Cache _cache;
@@ -45,8 +45,18 @@ namespace Data {
 namespace {
 
 constexpr auto kMaxNotifyCheckDelay = 24 * 3600 * TimeMs(1000);
+constexpr auto kLocalSearchIndexMaxAge = TimeId(30 * 24 * 60 * 60);
 constexpr auto kMaxWallpaperSize = 10 * 1024 * 1024;
 
+// Hash table space reserved up front, so that update floods don't
+// pay for incremental rehashes of the peers / histories storage.
+constexpr auto kPeersReserved = 4096;
+
+// How often the idle layout garbage collection pass runs and how many
+// passes a closed chat may stay unused before its view tree is freed.
+constexpr auto kLayoutGcPeriod = 60 * TimeMs(1000);
+constexpr auto kLayoutGcCollectAfter = 30;
+
 using ViewElement = HistoryView::Element;
 
 // s: box 100x100
@@ -148,9 +158,14 @@ Session::Session(not_null<AuthSession*> session)
 , _selfDestructTimer([=] { checkSelfDestructItems(); })
 , _a_sendActions(animation(this, &Session::step_typings))
 , _groups(this)
-, _unmuteByFinishedTimer([=] { unmuteByFinished(); }) {
+, _unmuteByFinishedTimer([=] { unmuteByFinished(); })
+, _layoutGcTimer([=] { collectUnusedLayouts(); }) {
 	_cache->open(Local::cacheKey());
 
+	_peers.reserve(kPeersReserved);
+	_histories.reserve(kPeersReserved);
+	_layoutGcTimer.callEach(kLayoutGcPeriod);
+
 	setupContactViewsViewer();
 	setupChannelLeavingViewer();
 }
@@ -162,6 +177,7 @@ void Session::clear() {
 		history->unloadBlocks();
 	}
 	App::historyClearMsgs();
+	_layoutGcGenerations.clear();
 	_histories.clear();
 
 	App::historyClearItems();
@@ -617,6 +633,7 @@ not_null<PeerData*> Session::processChat(const MTPChat &data) {
 
 UserData *Session::processUsers(const MTPVector<MTPUser> &data) {
 	auto result = (UserData*)nullptr;
+	_peers.reserve(_peers.size() + data.v.size());
 	for (const auto &user : data.v) {
 		result = processUser(user);
 	}
@@ -625,6 +642,7 @@ UserData *Session::processUsers(const MTPVector<MTPUser> &data) {
 
 PeerData *Session::processChats(const MTPVector<MTPChat> &data) {
 	auto result = (PeerData*)nullptr;
+	_peers.reserve(_peers.size() + data.v.size());
 	for (const auto &chat : data.v) {
 		result = processChat(chat);
 	}
@@ -954,6 +972,70 @@ void Session::requestDocumentViewRepaint(
 	}
 }
 
+const QPixmap *Session::stickerFrame(
+		not_null<DocumentData*> document,
+		int width,
+		int height) {
+	const auto key = StickerFrameKey(
+		document->id,
+		(uint32(width) << 16) | uint32(height));
+	const auto i = _stickerFrames.find(key);
+	if (i != end(_stickerFrames)) {
+		return &i->second;
+	} else if (!_stickerFramesRequested.emplace(key).second) {
+		return nullptr;
+	}
+	const auto weak = base::make_weak(_session.get());
+	cache().get(Data::StickerFrameCacheKey(document->id, width, height), [=](
+			QByteArray &&value) {
+		if (value.isEmpty()) {
+			return;
+		}
+		crl::async([=, value = std::move(value)]() mutable {
+			auto image = App::readImage(value, nullptr, false);
+			if (image.isNull()) {
+				return;
+			}
+			crl::on_main(weak, [=, image = std::move(image)]() mutable {
+				image.setDevicePixelRatio(cRetinaFactor());
+				weak->data()._stickerFrames[key]
+					= App::pixmapFromImageInPlace(std::move(image));
+				weak->downloaderTaskFinished().notify();
+			});
+		});
+	});
+	return nullptr;
+}
+
+void Session::saveStickerFrame(
+		not_null<DocumentData*> document,
+		const QPixmap &frame) {
+	const auto width = frame.width();
+	const auto height = frame.height();
+	const auto key = StickerFrameKey(
+		document->id,
+		(uint32(width) << 16) | uint32(height));
+	if (_stickerFrames.find(key) != end(_stickerFrames)) {
+		return;
+	}
+	_stickerFramesRequested.emplace(key);
+	_stickerFrames.emplace(key, frame);
+	const auto id = document->id;
+	const auto weak = base::make_weak(_session.get());
+	crl::async([=, image = frame.toImage()] {
+		auto bytes = QByteArray();
+		auto buffer = QBuffer(&bytes);
+		image.save(&buffer, "PNG");
+		crl::on_main(weak, [=, bytes = std::move(bytes)]() mutable {
+			weak->data().cache().putIfEmpty(
+				Data::StickerFrameCacheKey(id, width, height),
+				Storage::Cache::Database::TaggedValue(
+					std::move(bytes),
+					Data::kStickerCacheTag));
+		});
+	});
+}
+
 void Session::requestPollViewRepaint(not_null<const PollData*> poll) {
 	if (const auto i = _pollViews.find(poll); i != _pollViews.end()) {
 		for (const auto view : i->second) {
@@ -1177,6 +1259,8 @@ rpl::producer<FeedUpdate> Session::feedUpdated() const {
 }
 
 void Session::notifyStickersUpdated() {
+	_stickersByEmojiIndex.map.clear();
+	_stickersByEmojiIndex.valid = false;
 	_stickersUpdated.fire({});
 }
 
@@ -1429,6 +1513,86 @@ HistoryItem *Session::addNewMessage(
 	return result;
 }
 
+std::vector<not_null<HistoryItem*>> Session::searchLoadedMessages(
+		const QString &query,
+		int limit) {
+	if (!_localSearchIndexBuilt) {
+		_localSearchIndexBuilt = true;
+		buildLocalSearchIndex();
+	}
+	const auto words = TextUtilities::PrepareSearchWords(query);
+	if (words.isEmpty()) {
+		return {};
+	}
+	auto matches = base::flat_set<FullMsgId>();
+	auto first = true;
+	for (const auto &word : words) {
+		auto wordMatches = base::flat_set<FullMsgId>();
+		for (auto i = _localSearchIndex.lower_bound(word)
+			; (i != _localSearchIndex.end()) && i->first.startsWith(word)
+			; ++i) {
+			for (const auto &id : i->second) {
+				wordMatches.emplace(id);
+			}
+		}
+		if (first) {
+			matches = std::move(wordMatches);
+			first = false;
+		} else {
+			auto intersected = base::flat_set<FullMsgId>();
+			for (const auto &id : matches) {
+				if (wordMatches.contains(id)) {
+					intersected.emplace(id);
+				}
+			}
+			matches = std::move(intersected);
+		}
+		if (matches.empty()) {
+			return {};
+		}
+	}
+	auto result = std::vector<not_null<HistoryItem*>>();
+	result.reserve(std::min(int(matches.size()), limit));
+	for (const auto &id : matches) {
+		if (const auto item = App::histItemById(id)) {
+			result.push_back(item);
+		}
+	}
+	// Newest first, the way server search results are ordered.
+	ranges::sort(result, std::greater<>(), [](not_null<HistoryItem*> item) {
+		return item->date();
+	});
+	if (int(result.size()) > limit) {
+		result.resize(limit);
+	}
+	return result;
+}
+
+void Session::indexItemText(not_null<HistoryItem*> item) {
+	if (!_localSearchIndexBuilt || !IsServerMsgId(item->id)) {
+		return;
+	} else if (item->date() + kLocalSearchIndexMaxAge < unixtime()) {
+		return;
+	}
+	const auto text = item->originalText().text;
+	if (text.isEmpty()) {
+		return;
+	}
+	for (const auto &word : TextUtilities::PrepareSearchWords(text)) {
+		_localSearchIndex[word].emplace(item->fullId());
+	}
+}
+
+void Session::buildLocalSearchIndex() {
+	for (const auto &[peerId, history] : _histories) {
+		for (const auto &block : history->blocks) {
+			for (const auto &message : block->messages) {
+				indexItemText(message->data());
+			}
+		}
+	}
+}
+
 auto Session::sendActionAnimationUpdated() const
 -> rpl::producer<SendActionAnimationUpdate> {
 	return _sendActionAnimationUpdate.events();
@@ -1527,7 +1691,7 @@ void Session::unreadIncrement(int count, bool muted) {
 	}
 	if (_session->settings().countUnreadMessages()) {
 		if (!muted || _session->settings().includeMutedCounter()) {
-			Notify::unreadCounterUpdated();
+			notifyUnreadBadgeChanged();
 		}
 	}
 }
@@ -1544,7 +1708,7 @@ void Session::unreadMuteChanged(int count, bool muted) {
 		const auto changed = !_session->settings().includeMutedCounter()
 			|| (wasAll != nowAll);
 		if (changed) {
-			Notify::unreadCounterUpdated();
+			notifyUnreadBadgeChanged();
 		}
 	}
 }
@@ -1566,11 +1730,20 @@ void Session::unreadEntriesChanged(
 		const auto withoutMutedChanged = !withMuted
 			&& (withUnreadDelta != mutedWithUnreadDelta);
 		if (withMutedChanged || withoutMutedChanged) {
-			Notify::unreadCounterUpdated();
+			notifyUnreadBadgeChanged();
 		}
 	}
 }
 
+rpl::producer<> Session::unreadBadgeChanges() const {
+	return _unreadBadgeChanges.events();
+}
+
+void Session::notifyUnreadBadgeChanged() {
+	_unreadBadgeChanges.fire({});
+	Notify::unreadCounterUpdated();
+}
+
 void Session::selfDestructIn(not_null<HistoryItem*> item, TimeMs delay) {
 	_selfDestructItems.push_back(item->fullId());
 	if (!_selfDestructTimer.isActive()
@@ -1603,6 +1776,44 @@ void Session::checkSelfDestructItems() {
 	}
 }
 
+void Session::collectUnusedLayouts() {
+	const auto main = App::main();
+	if (!main) {
+		return;
+	}
+	++_layoutGcGeneration;
+	const auto activePeer = main->peer();
+	const auto activeMigrated = activePeer
+		? activePeer->migrateFrom()
+		: nullptr;
+	auto collectedHistories = 0;
+	auto collectedMessages = 0;
+	for (const auto &[peerId, history] : _histories) {
+		const auto raw = history.get();
+		if (raw->isEmpty()) {
+			_layoutGcGenerations.remove(raw);
+			continue;
+		} else if (raw->peer == activePeer || raw->peer == activeMigrated) {
+			_layoutGcGenerations[raw] = _layoutGcGeneration;
+			continue;
+		}
+		const auto i = _layoutGcGenerations.find(raw);
+		if (i == _layoutGcGenerations.end()) {
+			_layoutGcGenerations.emplace(raw, _layoutGcGeneration);
+		} else if (_layoutGcGeneration - i->second >= kLayoutGcCollectAfter) {
+			collectedMessages += raw->loadedMessagesCount();
+			++collectedHistories;
+			raw->unloadBlocks();
+			_layoutGcGenerations.erase(i);
+		}
+	}
+	if (collectedHistories > 0) {
+		DEBUG_LOG(("Layout GC: Unloaded %1 messages from %2 chats."
+			).arg(collectedMessages
+			).arg(collectedHistories));
+	}
+}
+
 not_null<PhotoData*> Session::photo(PhotoId id) {
 	auto i = _photos.find(id);
 	if (i == _photos.end()) {
@@ -2047,6 +2258,17 @@ void Session::documentApplyFields(
 	document->setattributes(attributes);
 	if (dc != 0 && access != 0) {
 		document->setRemoteLocation(dc, access, fileReference);
+
+		// Documents we parse are likely to get requested soon, so ask
+		// for a download session in advance - if we don't have an auth
+		// key for that dc yet the key exchange runs in the background
+		// and the first file part request costs pure network time.
+		if (!_warmedMediaDcs.contains(dc)) {
+			_warmedMediaDcs.emplace(dc);
+			if (const auto mtp = Core::App().mtp()) {
+				mtp->warmupMediaDc(dc);
+			}
+		}
 	}
 	document->date = date;
 	document->setMimeString(mime);
@@ -2349,7 +2571,7 @@ not_null<PollData*> Session::processPoll(const MTPPoll &data) {
 		const auto result = poll(id);
 		const auto changed = result->applyChanges(data);
 		if (changed) {
-			notifyPollUpdateDelayed(result);
+			notifyPollUpdateDelayed(result, true);
 		}
 		return result;
 	});
@@ -2687,9 +2909,10 @@ void Session::notifyGameUpdateDelayed(not_null<GameData*> game) {
 	}
 }
 
-void Session::notifyPollUpdateDelayed(not_null<PollData*> poll) {
+void Session::notifyPollUpdateDelayed(not_null<PollData*> poll, bool reflow) {
 	const auto invoke = !hasPendingWebPageGamePollNotification();
-	_pollsUpdated.insert(poll);
+	auto &entry = _pollsUpdated[poll];
+	entry = entry || reflow;
 	if (invoke) {
 		crl::on_main(_session, [=] { sendWebPageGamePollNotifications(); });
 	}
@@ -2711,10 +2934,16 @@ void Session::sendWebPageGamePollNotifications() {
 			}
 		}
 	}
-	for (const auto poll : base::take(_pollsUpdated)) {
+	for (const auto &[poll, reflow] : base::take(_pollsUpdated)) {
 		if (const auto i = _pollViews.find(poll); i != _pollViews.end()) {
 			for (const auto view : i->second) {
-				requestViewResize(view);
+				// Vote counts don't change the item height, so
+				// results-only updates need just a repaint.
+				if (reflow) {
+					requestViewResize(view);
+				} else {
+					requestViewRepaint(view);
+				}
 			}
 		}
 	}
@@ -250,6 +250,9 @@ public:
 	Stickers::Sets &stickerSetsRef() {
 		return _stickerSets;
 	}
+	Stickers::EmojiIndex &stickersByEmojiIndexRef() {
+		return _stickersByEmojiIndex;
+	}
 	const Stickers::Order &stickerSetsOrder() const {
 		return _stickerSetsOrder;
 	}
@@ -305,8 +308,29 @@ public:
 	void markMediaRead(not_null<const DocumentData*> document);
 	void requestPollViewRepaint(not_null<const PollData*> poll);
 
+	// Decoded-and-scaled first frames for the sticker panel, persisted
+	// in cache() so the panel doesn't re-decode them on every start.
+	// Sizes are in device pixels, the result is owned by the session.
+	[[nodiscard]] const QPixmap *stickerFrame(
+		not_null<DocumentData*> document,
+		int width,
+		int height);
+	void saveStickerFrame(
+		not_null<DocumentData*> document,
+		const QPixmap &frame);
+
 	HistoryItem *addNewMessage(const MTPMessage &data, NewMessageType type);
 
+	// Local inverted index over the text of recently loaded messages,
+	// so repeated searches in recent history are answered without a
+	// server round trip. The index is built lazily on the first query
+	// and maintained incrementally while messages are added, so it
+	// costs nothing until local search is actually used.
+	[[nodiscard]] std::vector<not_null<HistoryItem*>> searchLoadedMessages(
+		const QString &query,
+		int limit);
+	void indexItemText(not_null<HistoryItem*> item);
+
 	struct SendActionAnimationUpdate {
 		not_null<History*> history;
 		int width = 0;
@@ -323,6 +347,11 @@ public:
 	bool unreadBadgeMutedIgnoreOne(History *history) const;
 	int unreadOnlyMutedBadge() const;
 
+	// Fired whenever the aggregated unread badge value may have
+	// changed, so consumers read the incrementally maintained
+	// totals instead of rescanning histories.
+	[[nodiscard]] rpl::producer<> unreadBadgeChanges() const;
+
 	void unreadIncrement(int count, bool muted);
 	void unreadMuteChanged(int count, bool muted);
 	void unreadEntriesChanged(
@@ -483,7 +512,7 @@ public:
 
 	void notifyWebPageUpdateDelayed(not_null<WebPageData*> page);
 	void notifyGameUpdateDelayed(not_null<GameData*> game);
-	void notifyPollUpdateDelayed(not_null<PollData*> poll);
+	void notifyPollUpdateDelayed(not_null<PollData*> poll, bool reflow = false);
 	bool hasPendingWebPageGamePollNotification() const;
 	void sendWebPageGamePollNotifications();
 
@@ -562,6 +591,7 @@ private:
 		int muted,
 		int entriesFull,
 		int entriesMuted) const;
+	void notifyUnreadBadgeChanged();
 
 	void photoApplyFields(
 		not_null<PhotoData*> photo,
@@ -651,6 +681,8 @@ private:
 	void unmuteByFinishedDelayed(TimeMs delay);
 	void updateNotifySettingsLocal(not_null<PeerData*> peer);
 
+	void collectUnusedLayouts();
+
 	template <typename Method>
 	void enumerateItemViews(
 		not_null<const HistoryItem*> item,
@@ -699,6 +731,11 @@ private:
 	rpl::event_stream<MegagroupParticipant> _megagroupParticipantAdded;
 	rpl::event_stream<FeedUpdate> _feedUpdates;
 
+	// Key: (document id, (width << 16) | height) in device pixels.
+	using StickerFrameKey = std::pair<uint64, uint32>;
+	base::flat_map<StickerFrameKey, QPixmap> _stickerFrames;
+	base::flat_set<StickerFrameKey> _stickerFramesRequested;
+
 	rpl::event_stream<> _stickersUpdated;
 	rpl::event_stream<> _savedGifsUpdated;
 	TimeMs _lastStickersUpdate = 0;
@@ -708,6 +745,7 @@ private:
 	TimeMs _lastSavedGifsUpdate = 0;
 	rpl::variable<int> _featuredStickerSetsUnreadCount = 0;
 	Stickers::Sets _stickerSets;
+	Stickers::EmojiIndex _stickersByEmojiIndex;
 	Stickers::Order _stickerSetsOrder;
 	Stickers::Order _featuredStickerSetsOrder;
 	Stickers::Order _archivedStickerSetsOrder;
@@ -717,10 +755,18 @@ private:
 	int _unreadMuted = 0;
 	int _unreadEntriesFull = 0;
 	int _unreadEntriesMuted = 0;
+	rpl::event_stream<> _unreadBadgeChanges;
 
 	base::Timer _selfDestructTimer;
 	std::vector<FullMsgId> _selfDestructItems;
 
+	void buildLocalSearchIndex();
+
+	// word -> ids of loaded messages containing it. Ids of messages
+	// that were unloaded meanwhile are dropped lazily while querying.
+	base::flat_map<QString, base::flat_set<FullMsgId>> _localSearchIndex;
+	bool _localSearchIndexBuilt = false;
+
 	// When typing in this history started.
 	base::flat_map<not_null<History*>, TimeMs> _sendActions;
 	BasicAnimation _a_sendActions;
@@ -737,6 +783,7 @@ private:
 	std::unordered_map<
 		not_null<const DocumentData*>,
 		base::flat_set<not_null<HistoryItem*>>> _documentItems;
+	base::flat_set<int32> _warmedMediaDcs;
 	std::unordered_map<
 		WebPageId,
 		std::unique_ptr<WebPageData>> _webpages;
@@ -773,7 +820,9 @@ private:
 
 	base::flat_set<not_null<WebPageData*>> _webpagesUpdated;
 	base::flat_set<not_null<GameData*>> _gamesUpdated;
-	base::flat_set<not_null<PollData*>> _pollsUpdated;
+	// Value is true when the update changed the question or the
+	// answers, so the views need a relayout and not just a repaint.
+	base::flat_map<not_null<PollData*>, bool> _pollsUpdated;
 
 	std::deque<Dialogs::Key> _pinnedDialogs;
 	base::flat_map<FeedId, std::unique_ptr<Feed>> _feeds;
@@ -797,6 +846,13 @@ private:
 	std::unordered_map<PeerId, std::unique_ptr<PeerData>> _peers;
 	std::unordered_map<PeerId, std::unique_ptr<History>> _histories;
 
+	// The generation each history was last seen in use. Histories that
+	// lag too many generations behind get their view trees unloaded
+	// while all the data records are kept.
+	base::flat_map<not_null<History*>, int> _layoutGcGenerations;
+	int _layoutGcGeneration = 0;
+	base::Timer _layoutGcTimer;
+
 	MessageIdsList _mimeForwardIds;
 
 	using CredentialsWithGeneration = std::pair<
@@ -29,6 +29,9 @@ constexpr auto kUrlCacheTag = 0x0000030000000000ULL;
 constexpr auto kUrlCacheMask = 0x000000FFFFFFFFFFULL;
 constexpr auto kGeoPointCacheTag = 0x0000040000000000ULL;
 constexpr auto kGeoPointCacheMask = 0x000000FFFFFFFFFFULL;
+constexpr auto kDownloadResumeCacheTag = 0x0000050000000000ULL;
+constexpr auto kDownloadResumeCacheMask = 0x00000000000000FFULL;
+constexpr auto kStickerFrameCacheTag = 0x0000060000000000ULL;
 
 } // namespace
 
@@ -53,6 +56,14 @@ Storage::Cache::Key DocumentCacheKey(int32 dcId, uint64 id) {
 	};
 }
 
+Storage::Cache::Key DownloadResumeCacheKey(int32 dcId, uint64 id) {
+	return Storage::Cache::Key{
+		Data::kDownloadResumeCacheTag
+			| (uint64(dcId) & Data::kDownloadResumeCacheMask),
+		id
+	};
+}
+
 Storage::Cache::Key DocumentThumbCacheKey(int32 dcId, uint64 id) {
 	const auto part = (uint64(dcId) & Data::kDocumentThumbCacheMask);
 	return Storage::Cache::Key{
@@ -61,6 +72,15 @@ Storage::Cache::Key DocumentThumbCacheKey(int32 dcId, uint64 id) {
 	};
 }
 
+Storage::Cache::Key StickerFrameCacheKey(uint64 id, int width, int height) {
+	const auto widthheight = ((uint32(width) & 0xFFFFU) << 16)
+		| (uint32(height) & 0xFFFFU);
+	return Storage::Cache::Key{
+		Data::kStickerFrameCacheTag | widthheight,
+		id
+	};
+}
+
 Storage::Cache::Key StorageCacheKey(const StorageImageLocation &location) {
 	const auto dcId = uint64(location.dc()) & 0xFFULL;
 	return Storage::Cache::Key{
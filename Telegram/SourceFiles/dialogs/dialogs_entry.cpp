@@ -76,11 +76,19 @@ void Entry::updateChatListSortPosition() {
 		updateChatListEntry();
 		return;
 	}
-	_sortKeyInChatList = useProxyPromotion()
+	const auto position = useProxyPromotion()
 		? ProxyPromotedDialogPos()
 		: isPinnedDialog()
 		? PinnedDialogPos(_pinnedIndex)
 		: DialogPosFromDate(adjustChatListTimeId());
+	if (position == _sortKeyInChatList
+		&& inChatList(Dialogs::Mode::All)) {
+		// Pinned and promoted rows keep their keys on new messages,
+		// so the relink would be a no-op - only the row repaints.
+		updateChatListEntry();
+		return;
+	}
+	_sortKeyInChatList = position;
 	if (needUpdateInChatList()) {
 		setChatListExistence(true);
 	}
@@ -191,10 +199,12 @@ void Entry::addChatListEntryByLetter(
 void Entry::updateChatListEntry() const {
 	if (const auto main = App::main()) {
 		if (inChatList(Mode::All)) {
+			mainChatListLink(Mode::All)->invalidatePaintCache();
 			main->repaintDialogRow(
 				Mode::All,
 				mainChatListLink(Mode::All));
 			if (inChatList(Mode::Important)) {
+				mainChatListLink(Mode::Important)->invalidatePaintCache();
 				main->repaintDialogRow(
 					Mode::Important,
 					mainChatListLink(Mode::Important));
@@ -12,6 +12,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "history/history.h"
 
 namespace Dialogs {
+namespace {
+
+// Words shorter than this are served from the per-letter index.
+constexpr auto kPrefixLengthLimit = 3;
+
+} // namespace
 
 IndexedList::IndexedList(SortMode sortMode)
 : _sortMode(sortMode)
@@ -32,6 +38,7 @@ RowsByLetter IndexedList::addToEnd(Key key) {
 			}
 			result.emplace(ch, j->second->addToEnd(key));
 		}
+		addToPrefixIndex(key);
 	}
 	return result;
 }
@@ -51,6 +58,7 @@ Row *IndexedList::addByName(Key key) {
 		}
 		j->second->addByName(key);
 	}
+	addToPrefixIndex(key);
 	return result;
 }
 
@@ -73,6 +81,13 @@ void IndexedList::moveToTop(Key key) {
 				it->second->moveToTop(key);
 			}
 		}
+		if (auto i = _prefixesByKey.find(key); i != _prefixesByKey.cend()) {
+			for (const auto &prefix : i->second) {
+				if (auto it = _prefixIndex.find(prefix); it != _prefixIndex.cend()) {
+					it->second->moveToTop(key);
+				}
+			}
+		}
 	}
 }
 
@@ -150,6 +165,7 @@ void IndexedList::adjustByName(
 			j->second->addByName(key);
 		}
 	}
+	refreshPrefixIndex(key);
 }
 
 void IndexedList::adjustNames(
@@ -190,6 +206,7 @@ void IndexedList::adjustNames(
 			history->addChatListEntryByLetter(list, ch, row);
 		}
 	}
+	refreshPrefixIndex(key);
 }
 
 void IndexedList::del(Key key, Row *replacedBy) {
@@ -199,11 +216,110 @@ void IndexedList::del(Key key, Row *replacedBy) {
 				it->second->del(key, replacedBy);
 			}
 		}
+		delFromPrefixIndex(key, replacedBy);
 	}
 }
 
 void IndexedList::clear() {
 	_index.clear();
+	_prefixIndex.clear();
+	_prefixesByKey.clear();
+}
+
+const List *IndexedList::filteredByPrefix(const QString &word) const {
+	if (word.size() < kPrefixLengthLimit) {
+		return nullptr;
+	}
+	const auto prefix = word.left(kPrefixLengthLimit);
+	if (auto it = _prefixIndex.find(prefix); it != _prefixIndex.cend()) {
+		return it->second.get();
+	}
+	return &_empty;
+}
+
+base::flat_set<QString> IndexedList::namePrefixes(Key key) const {
+	auto result = base::flat_set<QString>();
+	for (const auto &word : key.entry()->chatListNameWords()) {
+		if (word.size() >= kPrefixLengthLimit) {
+			result.emplace(word.left(kPrefixLengthLimit));
+		}
+	}
+	return result;
+}
+
+void IndexedList::addToPrefixIndex(Key key) {
+	auto prefixes = namePrefixes(key);
+	for (const auto &prefix : prefixes) {
+		auto j = _prefixIndex.find(prefix);
+		if (j == _prefixIndex.cend()) {
+			j = _prefixIndex.emplace(
+				prefix,
+				std::make_unique<List>(_sortMode)).first;
+		}
+		if (_sortMode == SortMode::Name) {
+			j->second->addByName(key);
+		} else {
+			j->second->addToEnd(key);
+		}
+	}
+	if (!prefixes.empty()) {
+		_prefixesByKey[key] = std::move(prefixes);
+	}
+}
+
+void IndexedList::refreshPrefixIndex(Key key) {
+	const auto mainRow = _list.getRow(key);
+	if (!mainRow) {
+		return;
+	}
+	auto toRemove = base::flat_set<QString>();
+	if (auto i = _prefixesByKey.find(key); i != _prefixesByKey.cend()) {
+		toRemove = std::move(i->second);
+		_prefixesByKey.erase(i);
+	}
+	auto prefixes = namePrefixes(key);
+	for (const auto &prefix : prefixes) {
+		auto j = toRemove.find(prefix);
+		if (j != toRemove.cend()) {
+			toRemove.erase(j);
+			if (_sortMode == SortMode::Name) {
+				if (auto it = _prefixIndex.find(prefix); it != _prefixIndex.cend()) {
+					it->second->adjustByName(key);
+				}
+			}
+			continue;
+		}
+		auto it = _prefixIndex.find(prefix);
+		if (it == _prefixIndex.cend()) {
+			it = _prefixIndex.emplace(
+				prefix,
+				std::make_unique<List>(_sortMode)).first;
+		}
+		if (_sortMode == SortMode::Name) {
+			it->second->addByName(key);
+		} else {
+			it->second->addToEnd(key);
+		}
+	}
+	for (const auto &prefix : toRemove) {
+		if (auto it = _prefixIndex.find(prefix); it != _prefixIndex.cend()) {
+			it->second->del(key, mainRow);
+		}
+	}
+	if (!prefixes.empty()) {
+		_prefixesByKey[key] = std::move(prefixes);
+	}
+}
+
+void IndexedList::delFromPrefixIndex(Key key, Row *replacedBy) {
+	if (auto i = _prefixesByKey.find(key); i != _prefixesByKey.cend()) {
+		for (const auto &prefix : i->second) {
+			if (auto it = _prefixIndex.find(prefix); it != _prefixIndex.cend()) {
+				it->second->del(key, replacedBy);
+			}
+		}
+		_prefixesByKey.erase(i);
+	}
 }
 
 IndexedList::~IndexedList() {
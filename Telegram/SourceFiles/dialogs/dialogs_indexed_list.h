@@ -50,6 +50,12 @@ public:
 		return &_empty;
 	}
 
+	// Narrow candidates bucket for a filter word, maintained
+	// incrementally so that keystroke filtering does not walk
+	// the whole per-letter bucket on large dialog lists.
+	// Returns nullptr if the word is too short for the index.
+	const List *filteredByPrefix(const QString &word) const;
+
 	~IndexedList();
 
 	// Part of List interface is duplicated here for all() list.
@@ -83,9 +89,16 @@ private:
 		not_null<History*> history,
 		const base::flat_set<QChar> &oldChars);
 
+	base::flat_set<QString> namePrefixes(Key key) const;
+	void addToPrefixIndex(Key key);
+	void refreshPrefixIndex(Key key);
+	void delFromPrefixIndex(Key key, Row *replacedBy = nullptr);
+
 	SortMode _sortMode;
 	List _list, _empty;
 	base::flat_map<QChar, std::unique_ptr<List>> _index;
+	base::flat_map<QString, std::unique_ptr<List>> _prefixIndex;
+	base::flat_map<Key, base::flat_set<QString>> _prefixesByKey;
 
 };
 
@@ -72,6 +72,7 @@ DialogsInner::DialogsInner(QWidget *parent, not_null<Window::Controller*> contro
 , _contactsNoDialogs(std::make_unique<Dialogs::IndexedList>(Dialogs::SortMode::Name))
 , _contacts(std::make_unique<Dialogs::IndexedList>(Dialogs::SortMode::Name))
 , _a_pinnedShifting(animation(this, &DialogsInner::step_pinnedShifting))
+, _loadPeerPhotos([this] { loadPeerPhotos(); })
 , _addContactLnk(this, lang(lng_add_contact_button))
 , _cancelSearchInChat(this, st::dialogsCancelSearchInPeer)
 , _cancelSearchFromUser(this, st::dialogsCancelSearchInPeer) {
@@ -131,6 +132,7 @@ DialogsInner::DialogsInner(QWidget *parent, not_null<Window::Controller*> contro
 	subscribe(Window::Theme::Background(), [=](const Window::Theme::BackgroundUpdate &data) {
 		if (data.paletteChanged()) {
 			Dialogs::Layout::clearUnreadBadgesCache();
+			Dialogs::Layout::invalidateRowPaintCaches();
 		}
 	});
 
@@ -141,27 +143,35 @@ DialogsInner::DialogsInner(QWidget *parent, not_null<Window::Controller*> contro
 		| UpdateFlag::UserIsContact
 		| UpdateFlag::UserOccupiedChanged
 		| UpdateFlag::MigrationChanged;
-	subscribe(Notify::PeerUpdated(), Notify::PeerUpdatedHandler(changes, [=](const Notify::PeerUpdate &update) {
-		if (update.flags & UpdateFlag::ChatPinnedChanged) {
-			stopReorderPinned();
-		}
-		if (update.flags & UpdateFlag::NameChanged) {
-			handlePeerNameChange(update.peer, update.oldNameFirstLetters);
+	subscribe(Notify::PeerUpdatedBatch(), Notify::PeerUpdatedBatchHandler(changes, [=](const Notify::PeerUpdates &updates) {
+		auto updateWholeList = false;
+		for (const auto &update : updates) {
+			if (update.flags & UpdateFlag::ChatPinnedChanged) {
+				stopReorderPinned();
+			}
+			if (update.flags & UpdateFlag::NameChanged) {
+				handlePeerNameChange(update.peer, update.oldNameFirstLetters);
+			}
+			if (update.flags & (UpdateFlag::PhotoChanged | UpdateFlag::UserOccupiedChanged)) {
+				updateWholeList = true;
+			}
+			if (update.flags & UpdateFlag::UserIsContact) {
+				if (const auto user = update.peer->asUser()) {
+					userIsContactUpdated(user);
+				}
+			}
+			if (update.flags & UpdateFlag::MigrationChanged) {
+				if (const auto chat = update.peer->asChat()) {
+					handleChatMigration(chat);
+				}
+			}
 		}
-		if (update.flags & (UpdateFlag::PhotoChanged | UpdateFlag::UserOccupiedChanged)) {
+		if (updateWholeList) {
+			// A sync can bring thousands of photo updates in one batch,
+			// repaint the list once for all of them.
 			this->update();
 			emit App::main()->dialogsUpdated();
 		}
-		if (update.flags & UpdateFlag::UserIsContact) {
-			if (const auto user = update.peer->asUser()) {
-				userIsContactUpdated(user);
-			}
-		}
-		if (update.flags & UpdateFlag::MigrationChanged) {
-			if (const auto chat = update.peer->asChat()) {
-				handleChatMigration(chat);
-			}
-		}
 	}));
 	Auth().data().feedUpdated(
 	) | rpl::start_with_next([=](const Data::FeedUpdate &update) {
@@ -1675,7 +1685,10 @@ void DialogsInner::applyFilterUpdate(QString newFilter, bool force) {
 				const Dialogs::List *toFilter = nullptr;
 				if (!_dialogs->isEmpty()) {
 					for (fi = fb; fi != fe; ++fi) {
-						auto found = _dialogs->filtered(fi->at(0));
+						auto found = _dialogs->filteredByPrefix(*fi);
+						if (!found) {
+							found = _dialogs->filtered(fi->at(0));
+						}
 						if (found->isEmpty()) {
 							toFilter = nullptr;
 							break;
@@ -1688,7 +1701,10 @@ void DialogsInner::applyFilterUpdate(QString newFilter, bool force) {
 				const Dialogs::List *toFilterContacts = nullptr;
 				if (!_contactsNoDialogs->isEmpty()) {
 					for (fi = fb; fi != fe; ++fi) {
-						auto found = _contactsNoDialogs->filtered(fi->at(0));
+						auto found = _contactsNoDialogs->filteredByPrefix(*fi);
+						if (!found) {
+							found = _contactsNoDialogs->filtered(fi->at(0));
+						}
 						if (found->isEmpty()) {
 							toFilterContacts = nullptr;
 							break;
@@ -1827,7 +1843,9 @@ void DialogsInner::visibleTopBottomUpdated(
 		int visibleBottom) {
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
-	loadPeerPhotos();
+	// Scrolling sends a stream of these updates, so the userpic
+	// preload walk is coalesced to one pass per event loop cycle.
+	_loadPeerPhotos.call();
 	if (_visibleTop + PreloadHeightsCount * (_visibleBottom - _visibleTop) >= height()) {
 		if (_loadMoreCallback) {
 			_loadMoreCallback();
@@ -2023,6 +2041,24 @@ bool DialogsInner::searchReceived(
 	return lastDateFound != 0;
 }
 
+void DialogsInner::setLocalSearchResults(
+		const std::vector<not_null<HistoryItem*>> &items) {
+	if (_state != State::Filtered) {
+		return;
+	}
+
+	// Shown right away from the local message index, the server
+	// response replaces them when it arrives.
+	clearSearchResults(false);
+	for (const auto item : items) {
+		_searchResults.push_back(std::make_unique<Dialogs::FakeRow>(
+			_searchInChat,
+			item));
+	}
+	_searchedCount = _searchResults.size();
+	refresh();
+}
+
 void DialogsInner::peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -2179,7 +2215,7 @@ void DialogsInner::refresh(bool toTop) {
 	if (toTop) {
 		stopReorderPinned();
 		emit mustScrollTo(0, 0);
-		loadPeerPhotos();
+		_loadPeerPhotos.call();
 	}
 	_controller->dialogsListDisplayForced().set(
 		_searchInChat || !_filter.isEmpty(),
@@ -41,6 +41,8 @@ public:
 		const QVector<MTPMessage> &result,
 		DialogsSearchRequestType type,
 		int fullCount);
+	void setLocalSearchResults(
+		const std::vector<not_null<HistoryItem*>> &items);
 	void peerSearchReceived(
 		const QString &query,
 		const QVector<MTPPeer> &my,
@@ -321,6 +323,7 @@ private:
 
 	int _visibleTop = 0;
 	int _visibleBottom = 0;
+	SingleQueuedInvokation _loadPeerPhotos;
 	QString _filter, _hashtagFilter;
 
 	std::vector<std::unique_ptr<HashtagResult>> _hashtagResults;
@@ -29,6 +29,10 @@ namespace {
 // Show all dates that are in the last 20 hours in time format.
 constexpr int kRecentlyInSeconds = 20 * 3600;
 
+// Mixed into every row paint cache key, bumped to drop all caches
+// at once when the palette changes.
+auto RowPaintCacheGeneration = uint64(1);
+
 void paintRowTopRight(Painter &p, const QString &text, QRect &rectForName, bool active, bool selected) {
 	const auto width = st::dialogsDateFont->width(text);
 	rectForName.setWidth(rectForName.width() - width - st::dialogsDateSkip);
@@ -387,9 +391,16 @@ void paintRow(
 	}
 }
 
+constexpr auto kRenderedBadgeCacheLimit = 64;
+
 struct UnreadBadgeSizeData {
 	QImage circle;
 	QPixmap left[6], right[6];
+
+	// Fully rendered badges with their text, keyed by the text.
+	// The same counts repeat all over the interface, so they're
+	// rendered once and blitted from here on the next paints.
+	QMap<QString, QPixmap> rendered[6];
 };
 class UnreadBadgeStyleData : public Data::AbstractStructure {
 public:
@@ -515,12 +526,39 @@ void paintUnreadCount(
 		*outUnreadWidth = unreadRectWidth;
 	}
 
-	paintUnreadBadge(p, QRect(unreadRectLeft, unreadRectTop, unreadRectWidth, unreadRectHeight), st);
-
-	auto textTop = st.textTop ? st.textTop : (unreadRectHeight - st.font->height) / 2;
-	p.setFont(st.font);
-	p.setPen(st.active ? st::dialogsUnreadFgActive : (st.selected ? st::dialogsUnreadFgOver : st::dialogsUnreadFg));
-	p.drawText(unreadRectLeft + (unreadRectWidth - unreadWidth) / 2, unreadRectTop + textTop + st.font->ascent, text);
+	unreadBadgeStyle.createIfNull();
+	auto badgeData = unreadBadgeStyle->sizes;
+	if (st.sizeId > 0) {
+		Assert(st.sizeId < UnreadBadgeSizesCount);
+		badgeData = &unreadBadgeStyle->sizes[st.sizeId];
+	}
+	int index = (st.muted ? 0x03 : 0x00) + (st.active ? 0x02 : (st.selected ? 0x01 : 0x00));
+	auto &cache = badgeData->rendered[index];
+	const auto key = QString::number(st.textTop) + '_' + text;
+	auto i = cache.find(key);
+	if (i == cache.end()
+		|| (i->size()
+			!= QSize(unreadRectWidth, unreadRectHeight)
+				* cIntRetinaFactor())) {
+		if (cache.size() >= kRenderedBadgeCacheLimit) {
+			cache.clear();
+		}
+		auto image = QImage(
+			QSize(unreadRectWidth, unreadRectHeight) * cIntRetinaFactor(),
+			QImage::Format_ARGB32_Premultiplied);
+		image.setDevicePixelRatio(cRetinaFactor());
+		image.fill(Qt::transparent);
+		{
+			Painter q(&image);
+			paintUnreadBadge(q, QRect(0, 0, unreadRectWidth, unreadRectHeight), st);
+			auto textTop = st.textTop ? st.textTop : (unreadRectHeight - st.font->height) / 2;
+			q.setFont(st.font);
+			q.setPen(st.active ? st::dialogsUnreadFgActive : (st.selected ? st::dialogsUnreadFgOver : st::dialogsUnreadFg));
+			q.drawText((unreadRectWidth - unreadWidth) / 2, textTop + st.font->ascent, text);
+		}
+		i = cache.insert(key, App::pixmapFromImageInPlace(std::move(image)));
+	}
+	p.drawPixmap(unreadRectLeft, unreadRectTop, *i);
 }
 
 void RowPainter::paint(
@@ -590,76 +628,126 @@ void RowPainter::paint(
 		| (selected ? Flag::Selected : Flag(0))
 		| (onlyBackground ? Flag::OnlyBackground : Flag(0))
 		| (peer && peer->isSelf() ? Flag::SavedMessages : Flag(0));
-	const auto paintItemCallback = [&](int nameleft, int namewidth) {
-		const auto texttop = st::dialogsPadding.y()
-			+ st::msgNameFont->height
-			+ st::dialogsSkip;
-		const auto availableWidth = PaintWideCounter(
-			p,
-			texttop,
-			namewidth,
-			fullWidth,
-			displayUnreadCounter,
-			displayUnreadMark,
-			displayMentionBadge,
-			displayPinnedIcon,
-			unreadCount,
-			active,
-			selected,
-			unreadMuted);
-		const auto &color = active
-			? st::dialogsTextFgServiceActive
-			: (selected
-				? st::dialogsTextFgServiceOver
-				: st::dialogsTextFgService);
-		const auto actionWasPainted = history ? history->paintSendAction(
-			p,
-			nameleft,
-			texttop,
-			availableWidth,
-			fullWidth,
-			color,
-			ms) : false;
-		if (!actionWasPainted) {
-			const auto itemRect = QRect(
+	const auto paintContent = [&](Painter &p) {
+		const auto paintItemCallback = [&](int nameleft, int namewidth) {
+			const auto texttop = st::dialogsPadding.y()
+				+ st::msgNameFont->height
+				+ st::dialogsSkip;
+			const auto availableWidth = PaintWideCounter(
+				p,
+				texttop,
+				namewidth,
+				fullWidth,
+				displayUnreadCounter,
+				displayUnreadMark,
+				displayMentionBadge,
+				displayPinnedIcon,
+				unreadCount,
+				active,
+				selected,
+				unreadMuted);
+			const auto &color = active
+				? st::dialogsTextFgServiceActive
+				: (selected
+					? st::dialogsTextFgServiceOver
+					: st::dialogsTextFgService);
+			const auto actionWasPainted = history ? history->paintSendAction(
+				p,
 				nameleft,
 				texttop,
 				availableWidth,
-				st::dialogsTextFont->height);
-			item->drawInDialog(
+				fullWidth,
+				color,
+				ms) : false;
+			if (!actionWasPainted) {
+				const auto itemRect = QRect(
+					nameleft,
+					texttop,
+					availableWidth,
+					st::dialogsTextFont->height);
+				item->drawInDialog(
+					p,
+					itemRect,
+					active,
+					selected,
+					HistoryItem::DrawInDialog::Normal,
+					entry->textCachedFor,
+					entry->lastItemTextCache);
+			}
+		};
+		const auto paintCounterCallback = [&] {
+			PaintNarrowCounter(
 				p,
-				itemRect,
+				displayUnreadCounter,
+				displayUnreadMark,
+				displayMentionBadge,
+				unreadCount,
 				active,
-				selected,
-				HistoryItem::DrawInDialog::Normal,
-				entry->textCachedFor,
-				entry->lastItemTextCache);
-		}
-	};
-	const auto paintCounterCallback = [&] {
-		PaintNarrowCounter(
+				unreadMuted);
+		};
+		paintRow(
 			p,
-			displayUnreadCounter,
-			displayUnreadMark,
-			displayMentionBadge,
-			unreadCount,
-			active,
-			unreadMuted);
+			row,
+			entry,
+			row->key(),
+			from,
+			item,
+			cloudDraft,
+			displayDate,
+			fullWidth,
+			flags,
+			ms,
+			paintItemCallback,
+			paintCounterCallback);
 	};
-	paintRow(
-		p,
-		row,
-		entry,
-		row->key(),
-		from,
-		item,
-		cloudDraft,
-		displayDate,
-		fullWidth,
-		flags,
-		ms,
-		paintItemCallback,
-		paintCounterCallback);
+	if (!onlyBackground) {
+		// A row with an animating ripple or send action is repainted
+		// each frame, caching it would only add a copy to every frame.
+		const auto animating = row->rippleShown()
+			|| (history && history->hasActiveSendAction());
+		if (animating) {
+			row->invalidatePaintCache();
+		} else {
+			const auto key = [&] {
+				auto result = RowPaintCacheGeneration;
+				const auto mix = [&](uint64 value) {
+					result = (result * 0x100000001B3ULL) ^ value;
+				};
+				mix(uint64(fullWidth));
+				mix((active ? 1 : 0)
+					| (selected ? 2 : 0)
+					| (displayUnreadMark ? 4 : 0)
+					| (displayMentionBadge ? 8 : 0)
+					| (displayPinnedIcon ? 16 : 0)
+					| (unreadMuted ? 32 : 0));
+				mix(uint64(unreadCount));
+				mix(item ? uint64(item->fullId().msg) : 0);
+				mix(cloudDraft ? uint64(cloudDraft->date) : 0);
+				mix(displayDate.isValid()
+					? uint64(displayDate.toMSecsSinceEpoch())
+					: 0);
+				return result;
+			}();
+			auto &cache = row->paintCache();
+			if (cache.key != key || cache.frame.isNull()) {
+				auto frame = QImage(
+					QSize(fullWidth, st::dialogsRowHeight)
+						* cIntRetinaFactor(),
+					QImage::Format_ARGB32_Premultiplied);
+				frame.setDevicePixelRatio(cRetinaFactor());
+				frame.fill(Qt::transparent);
+				{
+					Painter q(&frame);
+					paintContent(q);
+				}
+				cache.frame = std::move(frame);
+				cache.key = key;
+			}
+			p.drawImage(0, 0, cache.frame);
+			return;
+		}
+	}
+	paintContent(p);
 }
 
 void RowPainter::paint(
@@ -822,6 +910,10 @@ void paintImportantSwitch(Painter &p, Mode current, int fullWidth, bool selected
 	}
 }
 
+void invalidateRowPaintCaches() {
+	++RowPaintCacheGeneration;
+}
+
 void clearUnreadBadgesCache() {
 	if (unreadBadgeStyle) {
 		for (auto &data : unreadBadgeStyle->sizes) {
@@ -831,6 +923,9 @@ void clearUnreadBadgesCache() {
 			for (auto &right : data.right) {
 				right = QPixmap();
 			}
+			for (auto &rendered : data.rendered) {
+				rendered.clear();
+			}
 		}
 	}
 }
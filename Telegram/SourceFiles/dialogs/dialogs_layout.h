@@ -91,6 +91,7 @@ void paintUnreadCount(
 	int *outUnreadWidth = nullptr);
 
 void clearUnreadBadgesCache();
+void invalidateRowPaintCaches();
 
 } // namespace Layout
 } // namespace Dialogs
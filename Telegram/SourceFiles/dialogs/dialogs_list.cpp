@@ -155,6 +155,10 @@ Row *List::addByName(Key key) {
 void List::adjustByPos(Row *row) {
 	if (_sortMode != SortMode::Date || !_begin) return;
 
+	if ((!row->_prev || row->_prev->sortKey() >= row->sortKey())
+		&& (row->_next == _end || row->_next->sortKey() <= row->sortKey())) {
+		return;
+	}
 	Row *change = row;
 	if (change != _begin && _begin->sortKey() < row->sortKey()) {
 		change = _begin;
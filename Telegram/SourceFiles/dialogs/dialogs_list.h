@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #pragma once
 
+#include "base/flat_map.h"
 #include "dialogs/dialogs_row.h"
 
 class PeerData;
@@ -117,7 +118,7 @@ private:
 	SortMode _sortMode;
 	int _count = 0;
 
-	std::map<Key, not_null<Row*>> _rowByKey;
+	base::flat_map<Key, not_null<Row*>> _rowByKey;
 
 	mutable Row *_current; // cache
 
@@ -40,6 +40,10 @@ void RippleRow::paintRipple(Painter &p, int x, int y, int outerWidth, TimeMs ms,
 	}
 }
 
+bool RippleRow::rippleShown() const {
+	return _ripple && !_ripple->empty();
+}
+
 uint64 Row::sortKey() const {
 	return _id.entry()->sortKeyInChatList();
 }
@@ -32,6 +32,8 @@ public:
 
 	void paintRipple(Painter &p, int x, int y, int outerWidth, TimeMs ms, const QColor *colorOverride = nullptr) const;
 
+	bool rippleShown() const;
+
 private:
 	mutable std::unique_ptr<Ui::RippleAnimation> _ripple;
 
@@ -66,6 +68,20 @@ public:
 	}
 	uint64 sortKey() const;
 
+	// Rendered row contents, rebuilt by Layout::RowPainter when
+	// the state key changes and reset from updateChatListEntry().
+	struct PaintCache {
+		QImage frame;
+		uint64 key = 0;
+	};
+	PaintCache &paintCache() const {
+		return _paintCache;
+	}
+	void invalidatePaintCache() const {
+		_paintCache.frame = QImage();
+		_paintCache.key = 0;
+	}
+
 	// for any attached data, for example View in contacts list
 	void *attached = nullptr;
 
@@ -76,6 +92,7 @@ private:
 	Row *_prev = nullptr;
 	Row *_next = nullptr;
 	int _pos = 0;
+	mutable PaintCache _paintCache;
 
 };
 
@@ -11,7 +11,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "dialogs/dialogs_search_from_controllers.h"
 #include "dialogs/dialogs_key.h"
 #include "dialogs/dialogs_entry.h"
+#include "dialogs/dialogs_indexed_list.h"
 #include "history/history.h"
+#include "history/history_item.h"
 #include "history/feed/history_feed_section.h"
 #include "ui/widgets/buttons.h"
 #include "ui/widgets/input_fields.h"
@@ -24,6 +26,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "auth_session.h"
 #include "apiwrap.h"
 #include "core/application.h"
+#include "core/startup_timeline.h"
 #include "boxes/peer_list_box.h"
 #include "boxes/peers/edit_participants_box.h"
 #include "window/window_controller.h"
@@ -42,6 +45,7 @@ namespace {
 
 constexpr auto kDialogsFirstLoad = 20;
 constexpr auto kDialogsPerPage = 500;
+constexpr auto kSnapshotDialogsLimit = 40;
 
 QString SwitchToChooseFromQuery() {
 	return qsl("from:");
@@ -461,12 +465,24 @@ void DialogsWidget::dialogsReceived(
 
 	updateDialogsOffset(*dialogsList, *messagesList);
 
+	// The next page offset is known now, so its request goes out before
+	// the received page is applied - feeding the messages and indexing
+	// the entries then overlaps the server round trip. The last page
+	// keeps the old order so the saved peers finalization in
+	// loadDialogs() still runs after everything was applied.
+	_dialogsRequestId = 0;
+	if (!_dialogsFull) {
+		loadDialogs();
+	}
+
 	applyReceivedDialogs(*dialogsList, *messagesList);
 
-	_dialogsRequestId = 0;
-	loadDialogs();
+	if (Profiling::StartupSpanEnd("dialogs request")) {
+		Profiling::WriteStartupTimeline();
+	}
 
 	if (!_dialogsRequestId) {
+		loadDialogs();
 		refreshLoadMoreButton();
 	}
 
@@ -691,6 +707,26 @@ bool DialogsWidget::onSearchMessages(bool searchCache) {
 				rpcFail(&DialogsWidget::searchFailed, DialogsSearchFromStart));
 		}
 		_searchQueries.insert(_searchRequest, _searchQuery);
+		if (Auth().supportMode()) {
+			// Answer from the local message index right away, the
+			// server response will replace these rows on arrival.
+			auto local = Auth().data().searchLoadedMessages(
+				_searchQuery,
+				SearchPerPage);
+			if (const auto peer = _searchInChat.peer()) {
+				local.erase(
+					std::remove_if(
+						local.begin(),
+						local.end(),
+						[&](not_null<HistoryItem*> item) {
+							return item->history()->peer != peer;
+						}),
+					local.end());
+			}
+			if (!local.empty()) {
+				_inner->setLocalSearchResults(local);
+			}
+		}
 	}
 	if (searchForPeersRequired(q)) {
 		if (searchCache) {
@@ -879,6 +915,9 @@ void DialogsWidget::loadDialogs() {
 	}
 
 	const auto firstLoad = !_dialogsOffsetDate;
+	if (firstLoad) {
+		Profiling::StartupSpanStart("dialogs request");
+	}
 	const auto loadCount = firstLoad ? kDialogsFirstLoad : kDialogsPerPage;
 	const auto flags = MTPmessages_GetDialogs::Flag::f_exclude_pinned;
 	const auto feedId = 0;
@@ -909,6 +948,59 @@ void DialogsWidget::loadPinnedDialogs() {
 	_pinnedDialogsRequestId = MTP::send(MTPmessages_GetPinnedDialogs(), rpcDone(&DialogsWidget::pinnedDialogsReceived), rpcFail(&DialogsWidget::dialogsFailed));
 }
 
+void DialogsWidget::restoreDialogsSnapshot() {
+	const auto list = Local::readDialogsSnapshot();
+	if (list.empty()) {
+		return;
+	}
+	for (const auto &entry : list) {
+		const auto history = Auth().data().history(entry.peer->id);
+		history->setUnreadCount(entry.unreadCount);
+		history->setChatListTimeId(entry.date);
+		_restoredFromSnapshot.push_back(history);
+	}
+
+	// When the full dialogs list was received from the server the rows
+	// that came only from the snapshot and were not confirmed by any
+	// dialog from the server are stale and should be removed.
+	subscribe(Auth().data().allChatsLoaded(), [this](bool loaded) {
+		if (loaded) {
+			removeStaleSnapshotRows();
+		}
+	});
+	_inner->refresh();
+}
+
+std::vector<Local::SnapshotDialog> DialogsWidget::collectDialogsSnapshot() const {
+	auto result = std::vector<Local::SnapshotDialog>();
+	const auto list = _inner->dialogsList();
+	result.reserve(std::min(list->size(), kSnapshotDialogsLimit));
+	for (const auto row : *list) {
+		const auto history = row->history();
+		if (!history || !history->chatListTimeId()) {
+			continue;
+		}
+		Local::SnapshotDialog entry;
+		entry.peer = history->peer;
+		entry.unreadCount = history->unreadCount();
+		entry.date = history->chatListTimeId();
+		result.push_back(entry);
+		if (int(result.size()) >= kSnapshotDialogsLimit) {
+			break;
+		}
+	}
+	return result;
+}
+
+void DialogsWidget::removeStaleSnapshotRows() {
+	for (const auto history : base::take(_restoredFromSnapshot)) {
+		if (!history->lastMessageKnown()) {
+			history->setUnreadCount(0);
+			removeDialog(history);
+		}
+	}
+}
+
 void DialogsWidget::searchReceived(
 		DialogsSearchRequestType type,
 		const MTPmessages_Messages &result,
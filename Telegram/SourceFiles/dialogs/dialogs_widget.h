@@ -21,6 +21,10 @@ class IndexedList;
 class Key;
 } // namespace Dialogs
 
+namespace Local {
+struct SnapshotDialog;
+} // namespace Local
+
 namespace Ui {
 class IconButton;
 class PopupMenu;
@@ -58,6 +62,12 @@ public:
 
 	void loadDialogs();
 	void loadPinnedDialogs();
+
+	// Shows the dialogs list saved at the last shutdown right away,
+	// so that something renders before the first server round trip.
+	void restoreDialogsSnapshot();
+	std::vector<Local::SnapshotDialog> collectDialogsSnapshot() const;
+
 	void createDialog(Dialogs::Key key);
 	void removeDialog(Dialogs::Key key);
 	void repaintDialogRow(Dialogs::Mode list, not_null<Dialogs::Row*> row);
@@ -167,6 +177,7 @@ private:
 	bool loadingBlockedByDate() const;
 	void refreshLoadMoreButton();
 	void loadMoreBlockedByDateChats();
+	void removeStaleSnapshotRows();
 
 	bool dialogsFailed(const RPCError &error, mtpRequestId req);
 	bool searchFailed(DialogsSearchRequestType type, const RPCError &error, mtpRequestId req);
@@ -184,6 +195,7 @@ private:
 	mtpRequestId _dialogsRequestId = 0;
 	mtpRequestId _pinnedDialogsRequestId = 0;
 	bool _pinnedDialogsReceived = false;
+	std::vector<not_null<History*>> _restoredFromSnapshot;
 
 	object_ptr<Ui::IconButton> _forwardCancel = { nullptr };
 	object_ptr<Ui::IconButton> _mainMenuToggle;
@@ -14,6 +14,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/rpc_sender.h"
 #include "base/value_ordering.h"
 #include "base/bytes.h"
+#include <QtCore/QDir>
+#include <QtCore/QFileInfo>
 #include <set>
 #include <deque>
 
@@ -23,6 +25,7 @@ namespace {
 constexpr auto kUserpicsSliceLimit = 100;
 constexpr auto kFileChunkSize = 128 * 1024;
 constexpr auto kFileRequestsCount = 2;
+constexpr auto kConcurrentFileDownloads = 4;
 constexpr auto kFileNextRequestDelay = TimeMs(20);
 constexpr auto kChatsSliceLimit = 100;
 constexpr auto kMessagesSliceLimit = 100;
@@ -167,6 +170,7 @@ struct ApiWrap::FileProcess {
 };
 
 struct ApiWrap::FileProgress {
+	QString path;
 	int ready = 0;
 	int total = 0;
 };
@@ -209,7 +213,21 @@ struct ApiWrap::ChatProcess {
 	Data::ParseMediaContext context;
 	std::optional<Data::MessagesSlice> slice;
 	bool lastSlice = false;
-	int fileIndex = 0;
+
+	// The next slice is requested while the files of the current one
+	// are still downloading, so the messages round trip is hidden
+	// behind the media downloads and the writer.
+	std::optional<Data::MessagesSlice> nextSlice;
+	bool nextRequested = false;
+	bool nextLastSlice = false;
+	bool sliceWaiting = false;
+
+	struct FileLoad {
+		int index = 0;
+		bool thumb = false;
+	};
+	std::deque<FileLoad> filesQueue;
+	int filesLoading = 0;
 };
 
 
@@ -321,6 +339,131 @@ std::optional<QString> ApiWrap::LoadedFileCache::find(
 	return std::nullopt;
 }
 
+// Appends progress entries to <path>/checkpoint.txt as the export goes,
+// so an export restarted after a crash or a reboot can reuse the media
+// files the unfinished run already downloaded instead of refetching them.
+// The file is removed when the export finishes successfully.
+class ApiWrap::Checkpoint {
+public:
+	explicit Checkpoint(const QString &path);
+
+	void loadPrevious(const QString &previousPath);
+	std::optional<QString> findFile(
+		const Data::FileLocation &location,
+		int size) const;
+	void writeFile(
+		const Data::FileLocation &location,
+		int size,
+		const QString &relativePath);
+	void writeDialog(Data::PeerId peerId, int32 lastMessageId);
+	void finish();
+
+	static QString FilePath(const QString &folder);
+
+private:
+	struct PreviousFile {
+		int size = 0;
+		QString absolutePath;
+	};
+
+	void append(const QString &line);
+
+	QString _path;
+	QFile _output;
+	std::map<LocationKey, PreviousFile> _previous;
+
+};
+
+QString ApiWrap::Checkpoint::FilePath(const QString &folder) {
+	return folder + qstr("checkpoint.txt");
+}
+
+ApiWrap::Checkpoint::Checkpoint(const QString &path)
+: _path(path)
+, _output(FilePath(path)) {
+}
+
+void ApiWrap::Checkpoint::loadPrevious(const QString &previousPath) {
+	QFile file(FilePath(previousPath));
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		return;
+	}
+	const auto lines = QString::fromUtf8(file.readAll()).split('\n');
+	for (const auto &line : lines) {
+		const auto parts = line.split(' ');
+		if (parts.size() >= 5 && parts[0] == qstr("file")) {
+			auto key = LocationKey();
+			key.type = parts[1].toULongLong(nullptr, 16);
+			key.id = parts[2].toULongLong(nullptr, 16);
+			_previous[key] = PreviousFile{
+				parts[3].toInt(),
+				previousPath + QStringList(parts.mid(4)).join(' ') };
+		}
+	}
+}
+
+std::optional<QString> ApiWrap::Checkpoint::findFile(
+		const Data::FileLocation &location,
+		int size) const {
+	if (!location) {
+		return std::nullopt;
+	}
+	const auto i = _previous.find(ComputeLocationKey(location));
+	if (i == end(_previous)) {
+		return std::nullopt;
+	}
+	// Only the size is validated, hashing gigabytes of media on every
+	// resume would cost almost as much as downloading them again.
+	const auto &file = i->second;
+	if (size > 0 && file.size != size) {
+		return std::nullopt;
+	}
+	const auto info = QFileInfo(file.absolutePath);
+	if (!info.exists() || info.size() != file.size) {
+		return std::nullopt;
+	}
+	return file.absolutePath;
+}
+
+void ApiWrap::Checkpoint::writeFile(
+		const Data::FileLocation &location,
+		int size,
+		const QString &relativePath) {
+	if (!location) {
+		return;
+	}
+	const auto key = ComputeLocationKey(location);
+	append(QString("file %1 %2 %3 %4"
+		).arg(key.type, 0, 16
+		).arg(key.id, 0, 16
+		).arg(size
+		).arg(relativePath));
+}
+
+void ApiWrap::Checkpoint::writeDialog(
+		Data::PeerId peerId,
+		int32 lastMessageId) {
+	append(QString("dialog %1 %2").arg(peerId).arg(lastMessageId));
+}
+
+void ApiWrap::Checkpoint::append(const QString &line) {
+	if (!_output.isOpen()) {
+		QDir().mkpath(_path);
+		if (!_output.open(QIODevice::Append | QIODevice::Text)) {
+			return;
+		}
+	}
+	_output.write((line + '\n').toUtf8());
+	_output.flush();
+}
+
+void ApiWrap::Checkpoint::finish() {
+	if (_output.isOpen()) {
+		_output.close();
+	}
+	QFile::remove(FilePath(_path));
+}
+
 ApiWrap::FileProcess::FileProcess(const QString &path, Output::Stats *stats)
 : file(path, stats) {
 }
@@ -351,7 +494,10 @@ auto ApiWrap::splitRequest(int index, Request &&request) {
 		std::forward<Request>(request)));
 }
 
-auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
+auto ApiWrap::fileRequest(
+		not_null<FileProcess*> process,
+		const Data::FileLocation &location,
+		int offset) {
 	Expects(location.dcId != 0
 		|| location.data.type() == mtpc_inputTakeoutFileLocation);
 	Expects(_takeoutId.has_value());
@@ -365,12 +511,12 @@ auto ApiWrap::fileRequest(const Data::FileLocation &location, int offset) {
 	)).fail([=](RPCError &&result) {
 		if (result.type() == qstr("TAKEOUT_FILE_EMPTY")
 			&& _otherDataProcess != nullptr) {
-			filePartDone(0, MTP_upload_file(MTP_storage_filePartial(),
+			filePartDone(process, 0, MTP_upload_file(MTP_storage_filePartial(),
 				MTP_int(0),
 				MTP_bytes(QByteArray())));
 		} else if (result.type() == qstr("LOCATION_INVALID")
 			|| result.type() == qstr("VERSION_INVALID")) {
-			filePartUnavailable();
+			filePartUnavailable(process);
 		} else {
 			error(std::move(result));
 		}
@@ -399,6 +545,10 @@ void ApiWrap::startExport(
 
 	_settings = std::make_unique<Settings>(settings);
 	_stats = stats;
+	_checkpoint = std::make_unique<Checkpoint>(_settings->path);
+	if (!_settings->resumePath.isEmpty()) {
+		_checkpoint->loadPrevious(_settings->resumePath);
+	}
 	_startProcess = std::make_unique<StartProcess>();
 	_startProcess->done = std::move(done);
 
@@ -787,7 +937,6 @@ void ApiWrap::finishUserpicsSlice() {
 }
 
 bool ApiWrap::loadUserpicProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
 	Expects(_userpicsProcess != nullptr);
 	Expects(_userpicsProcess->slice.has_value());
 	Expects((_userpicsProcess->fileIndex >= 0)
@@ -795,7 +944,7 @@ bool ApiWrap::loadUserpicProgress(FileProgress progress) {
 			< _userpicsProcess->slice->list.size()));
 
 	return _userpicsProcess->fileProgress(DownloadProgress{
-		_fileProcess->relativePath,
+		progress.path,
 		_userpicsProcess->fileIndex,
 		progress.ready,
 		progress.total });
@@ -996,6 +1145,9 @@ void ApiWrap::messagesCountLoaded(int localSplitIndex, int count) {
 void ApiWrap::finishExport(FnMut<void()> done) {
 	const auto guard = gsl::finally([&] { _takeoutId = std::nullopt; });
 
+	if (const auto checkpoint = base::take(_checkpoint)) {
+		checkpoint->finish();
+	}
 	mainRequest(MTPaccount_FinishTakeoutSession(
 		MTP_flags(MTPaccount_FinishTakeoutSession::Flag::f_success)
 	)).done(std::move(done)).send();
@@ -1246,30 +1398,53 @@ void ApiWrap::requestMessagesSlice() {
 		loadMessagesFiles({});
 		return;
 	}
+	_chatProcess->sliceWaiting = true;
+	requestMessagesSliceAhead(_chatProcess->largestIdPlusOne);
+}
+
+void ApiWrap::requestMessagesSliceAhead(int32 offsetId) {
+	Expects(_chatProcess != nullptr);
+	Expects(!_chatProcess->nextRequested);
+	Expects(!_chatProcess->nextSlice.has_value());
+
+	_chatProcess->nextRequested = true;
 	requestChatMessages(
 		_chatProcess->info.splits[_chatProcess->localSplitIndex],
-		_chatProcess->largestIdPlusOne,
+		offsetId,
 		-kMessagesSliceLimit,
 		kMessagesSliceLimit,
 		[=](const MTPmessages_Messages &result) {
 		Expects(_chatProcess != nullptr);
 
+		_chatProcess->nextRequested = false;
 		result.match([&](const MTPDmessages_messagesNotModified &data) {
 			error("Unexpected messagesNotModified received.");
 		}, [&](const auto &data) {
 			if constexpr (MTPDmessages_messages::Is<decltype(data)>()) {
-				_chatProcess->lastSlice = true;
+				_chatProcess->nextLastSlice = true;
 			}
-			loadMessagesFiles(Data::ParseMessagesSlice(
+			_chatProcess->nextSlice = Data::ParseMessagesSlice(
 				_chatProcess->context,
 				data.vmessages,
 				data.vusers,
 				data.vchats,
-				_chatProcess->info.relativePath));
+				_chatProcess->info.relativePath);
+			if (_chatProcess->sliceWaiting) {
+				consumeMessagesSliceAhead();
+			}
 		});
 	});
 }
 
+void ApiWrap::consumeMessagesSliceAhead() {
+	Expects(_chatProcess != nullptr);
+	Expects(_chatProcess->nextSlice.has_value());
+
+	_chatProcess->sliceWaiting = false;
+	_chatProcess->lastSlice = base::take(_chatProcess->nextLastSlice);
+	loadMessagesFiles(*base::take(_chatProcess->nextSlice));
+}
+
 void ApiWrap::requestChatMessages(
 		int splitIndex,
 		int offsetId,
@@ -1337,51 +1512,62 @@ void ApiWrap::requestChatMessages(
 void ApiWrap::loadMessagesFiles(Data::MessagesSlice &&slice) {
 	Expects(_chatProcess != nullptr);
 	Expects(!_chatProcess->slice.has_value());
+	Expects(_chatProcess->filesQueue.empty());
+	Expects(_chatProcess->filesLoading == 0);
 
 	if (slice.list.empty()) {
 		_chatProcess->lastSlice = true;
 	}
 	_chatProcess->slice = std::move(slice);
-	_chatProcess->fileIndex = 0;
+	if (!_chatProcess->lastSlice
+		&& !_chatProcess->nextRequested
+		&& !_chatProcess->nextSlice.has_value()) {
+		// Pipeline: request the next slice right away, it will be
+		// consumed when the files of this one are done.
+		requestMessagesSliceAhead(_chatProcess->slice->list.back().id + 1);
+	}
+	auto &list = _chatProcess->slice->list;
+	for (auto index = 0; index != int(list.size()); ++index) {
+		if (Data::SkipMessageByDate(list[index], *_settings)) {
+			continue;
+		}
+		_chatProcess->filesQueue.push_back({ index, false });
+		_chatProcess->filesQueue.push_back({ index, true });
+	}
 
-	loadNextMessageFile();
+	loadNextMessageFiles();
 }
 
-void ApiWrap::loadNextMessageFile() {
+void ApiWrap::loadNextMessageFiles() {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
 
-	for (auto &list = _chatProcess->slice->list
-		; _chatProcess->fileIndex < list.size()
-		; ++_chatProcess->fileIndex) {
-		const auto &message = list[_chatProcess->fileIndex];
-		if (Data::SkipMessageByDate(message, *_settings)) {
-			continue;
-		}
+	// Several files of the slice are loaded at the same time, the
+	// slice itself is written out only when all of them are finished,
+	// so message iteration order doesn't gate the downloads anymore.
+	auto &queue = _chatProcess->filesQueue;
+	while (!queue.empty()
+		&& _chatProcess->filesLoading < kConcurrentFileDownloads) {
+		const auto load = queue.front();
+		queue.pop_front();
+		auto &message = _chatProcess->slice->list[load.index];
 		const auto fileProgress = [=](FileProgress value) {
-			return loadMessageFileProgress(value);
+			return loadMessageFileProgress(load.index, value);
 		};
 		const auto ready = processFileLoad(
-			list[_chatProcess->fileIndex].file(),
+			load.thumb ? message.thumb().file : message.file(),
 			fileProgress,
-			[=](const QString &path) { loadMessageFileDone(path); },
-			&list[_chatProcess->fileIndex]);
+			[=](const QString &path) {
+				loadMessageFileDone(load.index, load.thumb, path);
+			},
+			&message);
 		if (!ready) {
-			return;
-		}
-		const auto thumbProgress = [=](FileProgress value) {
-			return loadMessageThumbProgress(value);
-		};
-		const auto thumbReady = processFileLoad(
-			list[_chatProcess->fileIndex].thumb().file,
-			thumbProgress,
-			[=](const QString &path) { loadMessageThumbDone(path); },
-			&list[_chatProcess->fileIndex]);
-		if (!thumbReady) {
-			return;
+			++_chatProcess->filesLoading;
 		}
 	}
-	finishMessagesSlice();
+	if (queue.empty() && !_chatProcess->filesLoading) {
+		finishMessagesSlice();
+	}
 }
 
 void ApiWrap::finishMessagesSlice() {
@@ -1394,6 +1580,11 @@ void ApiWrap::finishMessagesSlice() {
 		if (!_chatProcess->handleSlice(std::move(slice))) {
 			return;
 		}
+		if (_checkpoint) {
+			_checkpoint->writeDialog(
+				_chatProcess->info.peerId,
+				_chatProcess->largestIdPlusOne - 1);
+		}
 	}
 	if (_chatProcess->lastSlice
 		&& (++_chatProcess->localSplitIndex
@@ -1402,58 +1593,49 @@ void ApiWrap::finishMessagesSlice() {
 		_chatProcess->largestIdPlusOne = 1;
 	}
 	if (!_chatProcess->lastSlice) {
-		requestMessagesSlice();
+		if (_chatProcess->nextSlice.has_value()) {
+			consumeMessagesSliceAhead();
+		} else if (_chatProcess->nextRequested) {
+			_chatProcess->sliceWaiting = true;
+		} else {
+			requestMessagesSlice();
+		}
 	} else {
 		finishMessages();
 	}
 }
 
-bool ApiWrap::loadMessageFileProgress(FileProgress progress) {
-	Expects(_fileProcess != nullptr);
+bool ApiWrap::loadMessageFileProgress(int index, FileProgress progress) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects((index >= 0)
+		&& (index < _chatProcess->slice->list.size()));
 
 	return _chatProcess->fileProgress(DownloadProgress{
-		_fileProcess->relativePath,
-		_chatProcess->fileIndex,
+		progress.path,
+		index,
 		progress.ready,
 		progress.total });
 }
 
-void ApiWrap::loadMessageFileDone(const QString &relativePath) {
-	Expects(_chatProcess != nullptr);
-	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
-
-	const auto index = _chatProcess->fileIndex;
-	auto &file = _chatProcess->slice->list[index].file();
-	file.relativePath = relativePath;
-	if (relativePath.isEmpty()) {
-		file.skipReason = Data::File::SkipReason::Unavailable;
-	}
-	loadNextMessageFile();
-}
-
-bool ApiWrap::loadMessageThumbProgress(FileProgress progress) {
-	return loadMessageFileProgress(progress);
-}
-
-void ApiWrap::loadMessageThumbDone(const QString &relativePath) {
+void ApiWrap::loadMessageFileDone(
+		int index,
+		bool thumb,
+		const QString &relativePath) {
 	Expects(_chatProcess != nullptr);
 	Expects(_chatProcess->slice.has_value());
-	Expects((_chatProcess->fileIndex >= 0)
-		&& (_chatProcess->fileIndex < _chatProcess->slice->list.size()));
+	Expects((index >= 0)
+		&& (index < _chatProcess->slice->list.size()));
+	Expects(_chatProcess->filesLoading > 0);
 
-	const auto index = _chatProcess->fileIndex;
-	auto &file = _chatProcess->slice->list[index].thumb().file;
+	auto &message = _chatProcess->slice->list[index];
+	auto &file = thumb ? message.thumb().file : message.file();
 	file.relativePath = relativePath;
 	if (relativePath.isEmpty()) {
 		file.skipReason = Data::File::SkipReason::Unavailable;
 	}
-	loadNextMessageFile();
+	--_chatProcess->filesLoading;
+	loadNextMessageFiles();
 }
 
 void ApiWrap::finishMessages() {
@@ -1525,9 +1707,15 @@ bool ApiWrap::writePreloadedFile(Data::File &file) {
 	if (const auto path = _fileCache->find(file.location)) {
 		file.relativePath = *path;
 		return true;
+	} else if (copyCheckpointFile(file)) {
+		return true;
 	} else if (!file.content.isEmpty()) {
 		const auto process = prepareFileProcess(file);
-		if (const auto result = process->file.writeBlock(file.content)) {
+		auto result = process->file.writeBlock(file.content);
+		if (result) {
+			result = process->file.flush();
+		}
+		if (result) {
 			file.relativePath = process->relativePath;
 			_fileCache->save(file.location, file.relativePath);
 		} else {
@@ -1538,29 +1726,54 @@ bool ApiWrap::writePreloadedFile(Data::File &file) {
 	return false;
 }
 
+bool ApiWrap::copyCheckpointFile(Data::File &file) {
+	Expects(_settings != nullptr);
+
+	if (!_checkpoint) {
+		return false;
+	}
+	const auto previous = _checkpoint->findFile(file.location, file.size);
+	if (!previous) {
+		return false;
+	}
+	const auto relativePath = Output::File::PrepareRelativePath(
+		_settings->path,
+		file.suggestedPath);
+	const auto absolutePath = _settings->path + relativePath;
+	QDir().mkpath(QFileInfo(absolutePath).absolutePath());
+	if (!QFile::copy(*previous, absolutePath)) {
+		return false;
+	}
+	file.relativePath = relativePath;
+	_fileCache->save(file.location, relativePath);
+	_checkpoint->writeFile(file.location, file.size, relativePath);
+	return true;
+}
+
 void ApiWrap::loadFile(
 		const Data::File &file,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done) {
-	Expects(_fileProcess == nullptr);
 	Expects(file.location.dcId != 0
 		|| file.location.data.type() == mtpc_inputTakeoutFileLocation);
 
-	_fileProcess = prepareFileProcess(file);
-	_fileProcess->progress = std::move(progress);
-	_fileProcess->done = std::move(done);
+	_fileProcesses.push_back(prepareFileProcess(file));
+	const auto process = _fileProcesses.back().get();
+	process->progress = std::move(progress);
+	process->done = std::move(done);
 
-	if (_fileProcess->progress) {
+	if (process->progress) {
 		const auto progress = FileProgress{
-			_fileProcess->file.size(),
-			_fileProcess->size
+			process->relativePath,
+			process->file.size(),
+			process->size
 		};
-		if (!_fileProcess->progress(progress)) {
+		if (!process->progress(progress)) {
 			return;
 		}
 	}
 
-	loadFilePart();
+	loadFilePart(process);
 }
 
 auto ApiWrap::prepareFileProcess(const Data::File &file) const
@@ -1579,26 +1792,26 @@ auto ApiWrap::prepareFileProcess(const Data::File &file) const
 	return result;
 }
 
-void ApiWrap::loadFilePart() {
-	if (!_fileProcess
-		|| _fileProcess->requests.size() >= kFileRequestsCount
-		|| (_fileProcess->size > 0
-			&& _fileProcess->offset >= _fileProcess->size)) {
+void ApiWrap::loadFilePart(not_null<FileProcess*> process) {
+	if (process->requests.size() >= kFileRequestsCount
+		|| (process->size > 0
+			&& process->offset >= process->size)) {
 		return;
 	}
 
-	const auto offset = _fileProcess->offset;
-	_fileProcess->requests.push_back({ offset });
+	const auto offset = process->offset;
+	process->requests.push_back({ offset });
 	fileRequest(
-		_fileProcess->location,
-		_fileProcess->offset
+		process,
+		process->location,
+		process->offset
 	).done([=](const MTPupload_File &result) {
-		filePartDone(offset, result);
+		filePartDone(process, offset, result);
 	}).send();
-	_fileProcess->offset += kFileChunkSize;
+	process->offset += kFileChunkSize;
 
-	if (_fileProcess->size > 0
-		&& _fileProcess->requests.size() < kFileRequestsCount) {
+	if (process->size > 0
+		&& process->requests.size() < kFileRequestsCount) {
 		//const auto runner = _runner;
 		//crl::on_main([=] {
 		//	QTimer::singleShot(kFileNextRequestDelay, [=] {
@@ -1610,9 +1823,11 @@ void ApiWrap::loadFilePart() {
 	}
 }
 
-void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartDone(
+		not_null<FileProcess*> process,
+		int offset,
+		const MTPupload_File &result) {
+	Expects(!process->requests.empty());
 
 	if (result.type() == mtpc_upload_fileCdnRedirect) {
 		error("Cdn redirect is not supported.");
@@ -1620,18 +1835,18 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 	}
 	const auto &data = result.c_upload_file();
 	if (data.vbytes.v.isEmpty()) {
-		if (_fileProcess->size > 0) {
+		if (process->size > 0) {
 			error("Empty bytes received in file part.");
 			return;
 		}
-		const auto result = _fileProcess->file.writeBlock({});
+		const auto result = process->file.writeBlock({});
 		if (!result) {
 			ioError(result);
 			return;
 		}
 	} else {
 		using Request = FileProcess::Request;
-		auto &requests = _fileProcess->requests;
+		auto &requests = process->requests;
 		const auto i = ranges::find(
 			requests,
 			offset,
@@ -1640,7 +1855,7 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 
 		i->bytes = data.vbytes.v;
 
-		auto &file = _fileProcess->file;
+		auto &file = process->file;
 		while (!requests.empty() && !requests.front().bytes.isEmpty()) {
 			const auto &bytes = requests.front().bytes;
 			if (const auto result = file.writeBlock(bytes); !result) {
@@ -1650,33 +1865,58 @@ void ApiWrap::filePartDone(int offset, const MTPupload_File &result) {
 			requests.pop_front();
 		}
 
-		if (_fileProcess->progress) {
-			_fileProcess->progress(FileProgress{
+		if (process->progress) {
+			process->progress(FileProgress{
+				process->relativePath,
 				file.size(),
-				_fileProcess->size });
+				process->size });
 		}
 
 		if (!requests.empty()
-			|| !_fileProcess->size
-			|| _fileProcess->size > _fileProcess->offset) {
-			loadFilePart();
+			|| !process->size
+			|| process->size > process->offset) {
+			loadFilePart(process);
 			return;
 		}
 	}
 
-	auto process = base::take(_fileProcess);
-	const auto relativePath = process->relativePath;
-	_fileCache->save(process->location, relativePath);
-	process->done(process->relativePath);
+	const auto owned = takeFileProcess(process);
+	if (const auto result = owned->file.flush(); !result) {
+		ioError(result);
+		return;
+	}
+	const auto relativePath = owned->relativePath;
+	_fileCache->save(owned->location, relativePath);
+	if (_checkpoint) {
+		_checkpoint->writeFile(
+			owned->location,
+			owned->file.size(),
+			relativePath);
+	}
+	owned->done(relativePath);
 }
 
-void ApiWrap::filePartUnavailable() {
-	Expects(_fileProcess != nullptr);
-	Expects(!_fileProcess->requests.empty());
+void ApiWrap::filePartUnavailable(not_null<FileProcess*> process) {
+	Expects(!process->requests.empty());
 
 	LOG(("Export Error: File unavailable."));
 
-	base::take(_fileProcess)->done(QString());
+	takeFileProcess(process)->done(QString());
+}
+
+auto ApiWrap::takeFileProcess(not_null<FileProcess*> process)
+-> std::unique_ptr<FileProcess> {
+	const auto i = ranges::find(
+		_fileProcesses,
+		process.get(),
+		[](const std::unique_ptr<FileProcess> &owned) {
+			return owned.get();
+		});
+	Assert(i != end(_fileProcesses));
+
+	auto result = std::move(*i);
+	_fileProcesses.erase(i);
+	return result;
 }
 
 void ApiWrap::error(RPCError &&error) {
@@ -88,6 +88,7 @@ public:
 
 private:
 	class LoadedFileCache;
+	class Checkpoint;
 	struct StartProcess;
 	struct ContactsProcess;
 	struct UserpicsProcess;
@@ -144,6 +145,8 @@ private:
 	void checkFirstMessageDate(int localSplitIndex, int count);
 	void messagesCountLoaded(int localSplitIndex, int count);
 	void requestMessagesSlice();
+	void requestMessagesSliceAhead(int32 offsetId);
+	void consumeMessagesSliceAhead();
 	void requestChatMessages(
 		int splitIndex,
 		int offsetId,
@@ -151,11 +154,12 @@ private:
 		int limit,
 		FnMut<void(MTPmessages_Messages&&)> done);
 	void loadMessagesFiles(Data::MessagesSlice &&slice);
-	void loadNextMessageFile();
-	bool loadMessageFileProgress(FileProgress value);
-	void loadMessageFileDone(const QString &relativePath);
-	bool loadMessageThumbProgress(FileProgress value);
-	void loadMessageThumbDone(const QString &relativePath);
+	void loadNextMessageFiles();
+	bool loadMessageFileProgress(int index, FileProgress value);
+	void loadMessageFileDone(
+		int index,
+		bool thumb,
+		const QString &relativePath);
 	void finishMessagesSlice();
 	void finishMessages();
 
@@ -167,13 +171,19 @@ private:
 	std::unique_ptr<FileProcess> prepareFileProcess(
 		const Data::File &file) const;
 	bool writePreloadedFile(Data::File &file);
+	bool copyCheckpointFile(Data::File &file);
 	void loadFile(
 		const Data::File &file,
 		Fn<bool(FileProgress)> progress,
 		FnMut<void(QString)> done);
-	void loadFilePart();
-	void filePartDone(int offset, const MTPupload_File &result);
-	void filePartUnavailable();
+	void loadFilePart(not_null<FileProcess*> process);
+	void filePartDone(
+		not_null<FileProcess*> process,
+		int offset,
+		const MTPupload_File &result);
+	void filePartUnavailable(not_null<FileProcess*> process);
+	std::unique_ptr<FileProcess> takeFileProcess(
+		not_null<FileProcess*> process);
 
 	template <typename Request>
 	class RequestBuilder;
@@ -185,6 +195,7 @@ private:
 	[[nodiscard]] auto splitRequest(int index, Request &&request);
 
 	[[nodiscard]] auto fileRequest(
+		not_null<FileProcess*> process,
 		const Data::FileLocation &location,
 		int offset);
 
@@ -201,10 +212,11 @@ private:
 
 	std::unique_ptr<StartProcess> _startProcess;
 	std::unique_ptr<LoadedFileCache> _fileCache;
+	std::unique_ptr<Checkpoint> _checkpoint;
 	std::unique_ptr<ContactsProcess> _contactsProcess;
 	std::unique_ptr<UserpicsProcess> _userpicsProcess;
 	std::unique_ptr<OtherDataProcess> _otherDataProcess;
-	std::unique_ptr<FileProcess> _fileProcess;
+	std::vector<std::unique_ptr<FileProcess>> _fileProcesses;
 	std::unique_ptr<LeftChannelsProcess> _leftChannelsProcess;
 	std::unique_ptr<DialogsProcess> _dialogsProcess;
 	std::unique_ptr<ChatProcess> _chatProcess;
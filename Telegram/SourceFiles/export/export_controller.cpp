@@ -14,11 +14,28 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "export/output/export_output_result.h"
 #include "export/output/export_output_stats.h"
 
+#include <QtCore/QDir>
+
 namespace Export {
 namespace {
 
 const auto kNullStateCallback = [](ProcessingState&) {};
 
+QString FindUnfinishedExport(
+		const QString &basePath,
+		const QString &exceptPath) {
+	const auto filter = QDir::Dirs | QDir::NoDotAndDotDot;
+	const auto list = QDir(basePath).entryInfoList(filter, QDir::Time);
+	for (const auto &info : list) {
+		const auto folder = info.absoluteFilePath() + '/';
+		if (folder != exceptPath
+			&& QFile::exists(folder + qstr("checkpoint.txt"))) {
+			return folder;
+		}
+	}
+	return QString();
+}
+
 Settings NormalizeSettings(const Settings &settings) {
 	if (!settings.onlySinglePeer()) {
 		return base::duplicate(settings);
@@ -237,7 +254,13 @@ void Controller::startExport(
 	_settings = NormalizeSettings(settings);
 	_environment = environment;
 
+	const auto basePath = QDir(_settings.path).absolutePath() + '/';
 	_settings.path = Output::NormalizePath(_settings);
+
+	// A checkpoint in a sibling folder means an export didn't finish,
+	// let the new one reuse the media files it already downloaded.
+	_settings.resumePath = FindUnfinishedExport(basePath, _settings.path);
+
 	_writer = Output::CreateWriter(_settings.format);
 	fillExportSteps();
 	exportNext();
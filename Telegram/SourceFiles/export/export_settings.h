@@ -73,6 +73,10 @@ struct Settings {
 	bool forceSubPath = false;
 	Output::Format format = Output::Format();
 
+	// Folder of an unfinished export to reuse downloaded files from.
+	// Filled when the export starts, not serialized with the rest.
+	QString resumePath;
+
 	Types types = DefaultTypes();
 	Types fullChats = DefaultFullChats();
 	MediaSettings media;
@@ -17,48 +17,77 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Export {
 namespace Output {
+namespace {
+
+// Small writes coming from the serializers are collected in memory
+// and written out in chunks of that size, the buffer is reused between
+// the flushes so formatting a chat doesn't reallocate per message.
+constexpr auto kFlushThreshold = 256 * 1024;
+
+} // namespace
 
 File::File(const QString &path, Stats *stats) : _path(path), _stats(stats) {
 }
 
 int File::size() const {
-	return _offset;
+	return _offset + _buffer.size();
 }
 
 bool File::empty() const {
-	return !_offset;
+	return !_offset && _buffer.isEmpty();
 }
 
 Result File::writeBlock(const QByteArray &block) {
-	const auto result = writeBlockAttempt(block);
+	if (_stats && !_inStats) {
+		_inStats = true;
+		_stats->incrementFiles();
+	}
+	if (_buffer.isEmpty()) {
+		_buffer.reserve(kFlushThreshold);
+	}
+	_touched = true;
+	_buffer.append(block);
+	return (_buffer.size() >= kFlushThreshold)
+		? flush()
+		: Result::Success();
+}
+
+Result File::flush() {
+	const auto result = flushAttempt();
 	if (!result) {
 		_file.reset();
 	}
 	return result;
 }
 
-Result File::writeBlockAttempt(const QByteArray &block) {
-	if (_stats && !_inStats) {
-		_inStats = true;
-		_stats->incrementFiles();
+Result File::flushAttempt() {
+	if (!_touched) {
+		// Nothing was ever written, don't create the file on disk.
+		return Result::Success();
 	}
 	if (const auto result = reopen(); !result) {
 		return result;
 	}
-	const auto size = block.size();
+	const auto size = _buffer.size();
 	if (!size) {
 		return Result::Success();
 	}
-	if (_file->write(block) == size && _file->flush()) {
+	if (_file->write(_buffer) == size && _file->flush()) {
 		_offset += size;
 		if (_stats) {
 			_stats->incrementBytes(size);
 		}
+		// Keeps the allocation for the next chunk.
+		_buffer.resize(0);
 		return Result::Success();
 	}
 	return error();
 }
 
+File::~File() {
+	(void)flush();
+}
+
 Result File::reopen() {
 	if (_file && _file->isOpen()) {
 		return Result::Success();
@@ -132,7 +161,11 @@ Result File::Copy(
 	if (bytes.size() != f.size()) {
 		return Result(Result::Type::FatalError, source);
 	}
-	return File(path, stats).writeBlock(bytes);
+	auto file = File(path, stats);
+	if (const auto result = file.writeBlock(bytes); !result) {
+		return result;
+	}
+	return file.flush();
 }
 
 } // namespace Output
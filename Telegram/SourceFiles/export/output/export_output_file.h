@@ -28,6 +28,13 @@ public:
 
 	[[nodiscard]] Result writeBlock(const QByteArray &block);
 
+	// Pending blocks are accumulated in a reused memory buffer and hit
+	// the disk only here or when the buffer outgrows the threshold, so
+	// callers must flush explicitly before relying on the file content.
+	[[nodiscard]] Result flush();
+
+	~File();
+
 	[[nodiscard]] static QString PrepareRelativePath(
 		const QString &folder,
 		const QString &suggested);
@@ -39,17 +46,19 @@ public:
 
 private:
 	[[nodiscard]] Result reopen();
-	[[nodiscard]] Result writeBlockAttempt(const QByteArray &block);
+	[[nodiscard]] Result flushAttempt();
 
 	[[nodiscard]] Result error() const;
 	[[nodiscard]] Result fatalError() const;
 
 	QString _path;
 	int _offset = 0;
+	QByteArray _buffer;
 	std::optional<QFile> _file;
 
 	Stats *_stats = nullptr;
 	bool _inStats = false;
+	bool _touched = false;
 
 };
 
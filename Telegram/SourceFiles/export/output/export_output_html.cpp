@@ -98,21 +98,37 @@ QByteArray SerializeString(const QByteArray &value) {
 
 	auto result = QByteArray();
 	result.reserve(size * 6);
+
+	// Characters that need no escaping are copied over in whole runs
+	// instead of one by one, almost all of the text is passed through
+	// by a couple of memcpy-s that way.
+	auto from = begin;
+	const auto plain = [&](const char *till) {
+		if (till > from) {
+			result.append(from, till - from);
+		}
+	};
+	const auto escaped = [&](const char *p, const char *text, int length) {
+		plain(p);
+		result.append(text, length);
+		from = p + 1;
+	};
 	for (auto p = begin; p != end; ++p) {
 		const auto ch = *p;
 		if (ch == '\n') {
-			result.append("<br>", 4);
+			escaped(p, "<br>", 4);
 		} else if (ch == '"') {
-			result.append("&quot;", 6);
+			escaped(p, "&quot;", 6);
 		} else if (ch == '&') {
-			result.append("&amp;", 5);
+			escaped(p, "&amp;", 5);
 		} else if (ch == '\'') {
-			result.append("&apos;", 6);
+			escaped(p, "&apos;", 6);
 		} else if (ch == '<') {
-			result.append("&lt;", 4);
+			escaped(p, "&lt;", 4);
 		} else if (ch == '>') {
-			result.append("&gt;", 4);
+			escaped(p, "&gt;", 4);
 		} else if (ch >= 0 && ch < 32) {
+			plain(p);
 			result.append("&#x", 3).append('0' + (ch >> 4));
 			const auto left = (ch & 0x0F);
 			if (left >= 10) {
@@ -121,20 +137,19 @@ QByteArray SerializeString(const QByteArray &value) {
 				result.append('0' + left);
 			}
 			result.append(';');
+			from = p + 1;
 		} else if (ch == char(0xE2)
 			&& (p + 2 < end)
-			&& *(p + 1) == char(0x80)) {
-			if (*(p + 2) == char(0xA8)) { // Line separator.
-				result.append("<br>", 4);
-			} else if (*(p + 2) == char(0xA9)) { // Paragraph separator.
-				result.append("<br>", 4);
-			} else {
-				result.append(ch);
-			}
-		} else {
-			result.append(ch);
+			&& *(p + 1) == char(0x80)
+			&& (*(p + 2) == char(0xA8) // Line separator.
+				|| *(p + 2) == char(0xA9))) { // Paragraph separator.
+			plain(p);
+			result.append("<br>", 4);
+			p += 2;
+			from = p + 1;
 		}
 	}
+	plain(end);
 	return result;
 }
 
@@ -1740,7 +1755,10 @@ Result HtmlWriter::Wrap::close() {
 		while (!_context.empty()) {
 			block.append(_context.popTag());
 		}
-		return _file.writeBlock(block);
+		if (const auto result = _file.writeBlock(block); !result) {
+			return result;
+		}
+		return _file.flush();
 	}
 	return Result::Success();
 }
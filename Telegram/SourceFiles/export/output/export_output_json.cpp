@@ -31,19 +31,35 @@ QByteArray SerializeString(const QByteArray &value) {
 	auto result = QByteArray();
 	result.reserve(2 + size * 4);
 	result.append('"');
+
+	// Characters that need no escaping are copied over in whole runs
+	// instead of one by one, almost all of the text is passed through
+	// by a couple of memcpy-s that way.
+	auto from = begin;
+	const auto plain = [&](const char *till) {
+		if (till > from) {
+			result.append(from, till - from);
+		}
+	};
+	const auto escaped = [&](const char *p, const char *text, int length) {
+		plain(p);
+		result.append(text, length);
+		from = p + 1;
+	};
 	for (auto p = begin; p != end; ++p) {
 		const auto ch = *p;
 		if (ch == '\n') {
-			result.append("\\n", 2);
+			escaped(p, "\\n", 2);
 		} else if (ch == '\r') {
-			result.append("\\r", 2);
+			escaped(p, "\\r", 2);
 		} else if (ch == '\t') {
-			result.append("\\t", 2);
+			escaped(p, "\\t", 2);
 		} else if (ch == '"') {
-			result.append("\\\"", 2);
+			escaped(p, "\\\"", 2);
 		} else if (ch == '\\') {
-			result.append("\\\\", 2);
+			escaped(p, "\\\\", 2);
 		} else if (ch >= 0 && ch < 32) {
+			plain(p);
 			result.append("\\x", 2).append('0' + (ch >> 4));
 			const auto left = (ch & 0x0F);
 			if (left >= 10) {
@@ -51,20 +67,24 @@ QByteArray SerializeString(const QByteArray &value) {
 			} else {
 				result.append('0' + left);
 			}
+			from = p + 1;
 		} else if (ch == char(0xE2)
 			&& (p + 2 < end)
 			&& *(p + 1) == char(0x80)) {
 			if (*(p + 2) == char(0xA8)) { // Line separator.
+				plain(p);
 				result.append("\\u2028", 6);
+				p += 2;
+				from = p + 1;
 			} else if (*(p + 2) == char(0xA9)) { // Paragraph separator.
+				plain(p);
 				result.append("\\u2029", 6);
-			} else {
-				result.append(ch);
+				p += 2;
+				from = p + 1;
 			}
-		} else {
-			result.append(ch);
 		}
 	}
+	plain(end);
 	result.append('"');
 	return result;
 }
@@ -1090,7 +1110,10 @@ Result JsonWriter::finish() {
 
 	auto block = popNesting();
 	Assert(_context.nesting.empty());
-	return _output->writeBlock(block);
+	if (const auto result = _output->writeBlock(block); !result) {
+		return result;
+	}
+	return _output->flush();
 }
 
 QString JsonWriter::mainFilePath() {
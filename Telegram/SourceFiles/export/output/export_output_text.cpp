@@ -552,7 +552,9 @@ Result TextWriter::writeUserpicsSlice(const Data::UserpicsSlice &data) {
 }
 
 Result TextWriter::writeUserpicsEnd() {
-	_userpics = nullptr;
+	if (const auto userpics = base::take(_userpics)) {
+		return userpics->flush();
+	}
 	return Result::Success();
 }
 
@@ -600,6 +602,8 @@ Result TextWriter::writeSavedContacts(const Data::ContactsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto flushed = file->flush(); !flushed) {
+		return flushed;
 	}
 
 	const auto header = "Contacts "
@@ -679,6 +683,8 @@ Result TextWriter::writeFrequentContacts(const Data::ContactsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto flushed = file->flush(); !flushed) {
+		return flushed;
 	}
 
 	const auto header = "Frequent contacts "
@@ -735,6 +741,8 @@ Result TextWriter::writeSessions(const Data::SessionsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto flushed = file->flush(); !flushed) {
+		return flushed;
 	}
 
 	const auto header = "Sessions "
@@ -783,6 +791,8 @@ Result TextWriter::writeWebSessions(const Data::SessionsList &data) {
 		+ JoinList(kLineBreak, list);
 	if (const auto result = file->writeBlock(full); !result) {
 		return result;
+	} else if (const auto flushed = file->flush(); !flushed) {
+		return flushed;
 	}
 
 	const auto header = "Web sessions "
@@ -871,7 +881,9 @@ Result TextWriter::writeDialogEnd() {
 	Expects(_chats != nullptr);
 	Expects(_chat != nullptr);
 
-	_chat = nullptr;
+	if (const auto result = base::take(_chat)->flush(); !result) {
+		return result;
+	}
 
 	using Type = Data::DialogInfo::Type;
 	const auto TypeString = [](Type type) {
@@ -960,12 +972,16 @@ Result TextWriter::writeChatsStart(
 }
 
 Result TextWriter::writeChatsEnd() {
-	_chats = nullptr;
+	if (const auto chats = base::take(_chats)) {
+		return chats->flush();
+	}
 	return Result::Success();
 }
 
 Result TextWriter::finish() {
-	return Result::Success();
+	Expects(_summary != nullptr);
+
+	return _summary->flush();
 }
 
 QString TextWriter::mainFilePath() {
@@ -467,6 +467,7 @@ struct Data {
 } // namespace Global
 
 Global::internal::Data *GlobalData = nullptr;
+std::shared_ptr<const Global::ProxyConfig> GlobalProxyConfig;
 
 namespace Global {
 
@@ -476,11 +477,15 @@ bool started() {
 
 void start() {
 	GlobalData = new internal::Data();
+	RefreshProxyConfig();
 }
 
 void finish() {
 	delete GlobalData;
 	GlobalData = nullptr;
+	std::atomic_store(
+		&GlobalProxyConfig,
+		std::shared_ptr<const ProxyConfig>());
 }
 
 DefineRefVar(Global, SingleQueuedInvokation, HandleUnreadCounterUpdate);
@@ -574,13 +579,56 @@ DefineVar(Global, int, NotificationsCount);
 DefineVar(Global, Notify::ScreenCorner, NotificationsCorner);
 DefineVar(Global, bool, NotificationsDemoIsShown);
 
-DefineVar(Global, bool, TryIPv6);
 DefineVar(Global, std::vector<ProxyData>, ProxiesList);
-DefineVar(Global, ProxyData, SelectedProxy);
-DefineVar(Global, ProxyData::Settings, ProxySettings);
-DefineVar(Global, bool, UseProxyForCalls);
+DefineRefVar(Global, bool, TryIPv6);
+DefineRefVar(Global, ProxyData, SelectedProxy);
+DefineRefVar(Global, ProxyData::Settings, ProxySettings);
+DefineRefVar(Global, bool, UseProxyForCalls);
 DefineRefVar(Global, base::Observable<void>, ConnectionTypeChanged);
 
+std::shared_ptr<const ProxyConfig> CurrentProxyConfig() {
+	if (auto result = std::atomic_load(&GlobalProxyConfig)) {
+		return result;
+	}
+	return std::make_shared<const ProxyConfig>();
+}
+
+void RefreshProxyConfig() {
+	AssertCustom(GlobalData != nullptr, "GlobalData != nullptr in Global::RefreshProxyConfig");
+	auto config = std::make_shared<ProxyConfig>();
+	config->selected = GlobalData->SelectedProxy;
+	config->settings = GlobalData->ProxySettings;
+	config->useForCalls = GlobalData->UseProxyForCalls;
+	config->tryIPv6 = GlobalData->TryIPv6;
+	std::atomic_store(
+		&GlobalProxyConfig,
+		std::shared_ptr<const ProxyConfig>(std::move(config)));
+}
+
+void SetTryIPv6(const bool &TryIPv6) {
+	AssertCustom(GlobalData != nullptr, "GlobalData != nullptr in Global::SetTryIPv6");
+	GlobalData->TryIPv6 = TryIPv6;
+	RefreshProxyConfig();
+}
+
+void SetSelectedProxy(const ProxyData &SelectedProxy) {
+	AssertCustom(GlobalData != nullptr, "GlobalData != nullptr in Global::SetSelectedProxy");
+	GlobalData->SelectedProxy = SelectedProxy;
+	RefreshProxyConfig();
+}
+
+void SetProxySettings(const ProxyData::Settings &ProxySettings) {
+	AssertCustom(GlobalData != nullptr, "GlobalData != nullptr in Global::SetProxySettings");
+	GlobalData->ProxySettings = ProxySettings;
+	RefreshProxyConfig();
+}
+
+void SetUseProxyForCalls(const bool &UseProxyForCalls) {
+	AssertCustom(GlobalData != nullptr, "GlobalData != nullptr in Global::SetUseProxyForCalls");
+	GlobalData->UseProxyForCalls = UseProxyForCalls;
+	RefreshProxyConfig();
+}
+
 DefineVar(Global, int, AutoLock);
 DefineVar(Global, bool, LocalPasscode);
 DefineRefVar(Global, base::Observable<void>, LocalPasscodeChanged);
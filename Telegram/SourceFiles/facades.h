@@ -293,6 +293,21 @@ DeclareVar(ProxyData::Settings, ProxySettings);
 DeclareVar(bool, UseProxyForCalls);
 DeclareRefVar(base::Observable<void>, ConnectionTypeChanged);
 
+// Immutable snapshot of the proxy configuration above. The setters
+// rebuild it and publish it with an atomic pointer swap, so connection
+// code can read a consistent set of values with a single load instead
+// of several facade calls into globals the main thread may be writing.
+struct ProxyConfig {
+	ProxyData selected;
+	ProxyData::Settings settings = ProxyData::Settings::System;
+	bool useForCalls = false;
+	bool tryIPv6 = true;
+};
+std::shared_ptr<const ProxyConfig> CurrentProxyConfig();
+
+// Must be called after mutating the proxy data through Ref accessors.
+void RefreshProxyConfig();
+
 DeclareVar(int, AutoLock);
 DeclareVar(bool, LocalPasscode);
 DeclareRefVar(base::Observable<void>, LocalPasscodeChanged);
@@ -50,6 +50,11 @@ constexpr auto kScrollDateHideTimeout = 1000;
 constexpr auto kEventsFirstPage = 20;
 constexpr auto kEventsPerPage = 50;
 
+// Building items and their layouts for a whole page of a large log
+// freezes the UI, so the received events are processed in chunks of
+// this size, one chunk per event loop iteration.
+constexpr auto kEventsPerTick = 10;
+
 } // namespace
 
 template <InnerWidget::EnumItemsDirection direction, typename Method>
@@ -225,6 +230,7 @@ InnerWidget::InnerWidget(
 , _idManager(_history->adminLogIdManager()) {
 	setMouseTracking(true);
 	_scrollDateHideTimer.setCallback([this] { scrollDateHideByTimer(); });
+	_processEventsTimer.setCallback([this] { processPendingEvents(); });
 	Auth().data().viewRepaintRequest(
 	) | rpl::start_with_next([this](auto view) {
 		if (view->delegate() == this) {
@@ -539,6 +545,8 @@ void InnerWidget::saveState(not_null<SectionMemento*> memento) {
 		memento->setIdManager(base::take(_idManager));
 		base::take(_itemsByData);
 	}
+	_pendingEvents.clear();
+	_processEventsTimer.cancel();
 	_upLoaded = _downLoaded = true; // Don't load or handle anything anymore.
 }
 
@@ -626,6 +634,29 @@ void InnerWidget::addEvents(Direction direction, const QVector<MTPChannelAdminLo
 		update();
 		return;
 	}
+	_pendingEvents.push_back({ direction, events });
+	if (!_processEventsTimer.isActive()) {
+		processPendingEvents();
+	}
+}
+
+void InnerWidget::processPendingEvents() {
+	Expects(!_pendingEvents.empty());
+
+	auto &pending = _pendingEvents.front();
+	const auto direction = pending.direction;
+	const auto fullCount = pending.events.size();
+	const auto left = fullCount - pending.processed;
+	const auto take = std::min(left, kEventsPerTick);
+
+	// Events inside one page go from newest to oldest, so when adding
+	// below the loaded part the chunks are taken from the back of the
+	// page - this way every committed chunk is adjacent to the part
+	// that is already shown.
+	const auto from = (direction == Direction::Up)
+		? pending.processed
+		: (left - take);
+	const auto till = from + take;
 
 	// When loading items up we just add them to the back of the _items vector.
 	// When loading items down we add them to a new vector and copy _items after them.
@@ -634,9 +665,9 @@ void InnerWidget::addEvents(Direction direction, const QVector<MTPChannelAdminLo
 	auto &addToItems = (direction == Direction::Up)
 		? _items
 		: newItemsForDownDirection;
-	addToItems.reserve(oldItemsCount + events.size() * 2);
-	for (const auto &event : events) {
-		event.match([&](const MTPDchannelAdminLogEvent &data) {
+	addToItems.reserve(oldItemsCount + take * 2);
+	for (auto index = from; index != till; ++index) {
+		pending.events[index].match([&](const MTPDchannelAdminLogEvent &data) {
 			const auto id = data.vid.v;
 			if (_eventIds.find(id) != _eventIds.end()) {
 				return;
@@ -677,6 +708,13 @@ void InnerWidget::addEvents(Direction direction, const QVector<MTPChannelAdminLo
 		updateMinMaxIds();
 		itemsAdded(direction, newItemsCount - oldItemsCount);
 	}
+	pending.processed += take;
+	if (pending.processed == fullCount) {
+		_pendingEvents.pop_front();
+	}
+	if (!_pendingEvents.empty()) {
+		_processEventsTimer.callOnce(0);
+	}
 	update();
 }
 
@@ -854,6 +892,8 @@ void InnerWidget::clearAfterFilterChange() {
 	_selectedItem = nullptr;
 	_selectedText = TextSelection();
 	_filterChanged = false;
+	_pendingEvents.clear();
+	_processEventsTimer.cancel();
 	_items.clear();
 	_eventIds.clear();
 	_itemsByData.clear();
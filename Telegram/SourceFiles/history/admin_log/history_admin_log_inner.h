@@ -169,6 +169,7 @@ private:
 	void clearAfterFilterChange();
 	void clearAndRequestLog();
 	void addEvents(Direction direction, const QVector<MTPChannelAdminLogEvent> &events);
+	void processPendingEvents();
 	Element *viewForItem(const HistoryItem *item);
 
 	void toggleScrollDateShown();
@@ -231,6 +232,17 @@ private:
 	mtpRequestId _preloadUpRequestId = 0;
 	mtpRequestId _preloadDownRequestId = 0;
 
+	// Received events are turned into items in chunks, so that a
+	// whole page of a large log doesn't freeze the UI while the
+	// layouts are being built.
+	struct EventsBatch {
+		Direction direction = Direction::Up;
+		QVector<MTPChannelAdminLogEvent> events;
+		int processed = 0;
+	};
+	std::deque<EventsBatch> _pendingEvents;
+	base::Timer _processEventsTimer;
+
 	// Don't load anything until the memento was read.
 	bool _upLoaded = true;
 	bool _downLoaded = true;
@@ -155,7 +155,11 @@ void History::checkChatListMessageRemoved(not_null<HistoryItem*> item) {
 		return;
 	}
 	_chatListMessage = std::nullopt;
-	refreshChatListMessage();
+	if (!_destroyingUpTill) {
+		// clearUpTill() requests the chat list message once
+		// for the whole destroyed range when it is done.
+		refreshChatListMessage();
+	}
 	if (const auto channel = peer->asChannel()) {
 		if (const auto feed = channel->feed()) {
 			// Must be after history->chatListMessage() is updated.
@@ -170,10 +174,12 @@ void History::itemVanished(not_null<HistoryItem*> item) {
 	if (lastKeyboardId == item->id) {
 		clearLastKeyboard();
 	}
-	if ((!item->out() || item->isPost())
-		&& item->unread()
-		&& unreadCount() > 0) {
-		changeUnreadCount(-1);
+	if ((!item->out() || item->isPost()) && item->unread()) {
+		if (_destroyingUpTill) {
+			++_destroyedUnreadCount;
+		} else if (unreadCount() > 0) {
+			changeUnreadCount(-1);
+		}
 	}
 	if (peer->pinnedMessageId() == item->id) {
 		peer->clearPinnedMessage();
@@ -1211,6 +1217,8 @@ void History::addItemToBlock(not_null<HistoryItem*> item) {
 	const auto view = block->messages.back().get();
 	view->attachToBlock(block, block->messages.size() - 1);
 
+	owner().indexItemText(item);
+
 	if (isBuildingFrontBlock() && _buildingFrontBlock->expectedItemsCount > 0) {
 		--_buildingFrontBlock->expectedItemsCount;
 	}
@@ -1478,6 +1486,7 @@ void History::inboxRead(MsgId upTo) {
 		changeUnreadCount(countUnread(upTo) - nowUnreadCount);
 	}
 	setInboxReadTill(upTo);
+	Local::writeReadStateDelayed(peer->id, unreadCount());
 	updateChatListEntry();
 	if (peer->migrateTo()) {
 		if (auto migrateTo = peer->owner().historyLoaded(peer->migrateTo()->id)) {
@@ -1885,9 +1894,36 @@ not_null<HistoryItem*> History::addNewInTheMiddle(
 		(*it)->nextInBlocksRemoved();
 	}
 
+	if (int(block->messages.size()) >= 2 * kNewBlockEachMessage) {
+		splitBlock(blockIndex);
+	}
+
 	return item;
 }
 
+void History::splitBlock(int blockIndex) {
+	Expects(blockIndex >= 0);
+	Expects(blockIndex < blocks.size());
+	Expects(!isBuildingFrontBlock());
+
+	const auto block = blocks[blockIndex].get();
+	const auto half = int(block->messages.size()) / 2;
+	auto added = std::make_unique<HistoryBlock>(this);
+	added->messages.reserve(block->messages.size() - half);
+	for (auto i = half, l = int(block->messages.size()); i != l; ++i) {
+		added->messages.push_back(std::move(block->messages[i]));
+		added->messages.back()->moveToBlock(
+			added.get(),
+			int(added->messages.size()) - 1);
+	}
+	block->messages.resize(half);
+	block->setPendingResize();
+	blocks.insert(blocks.begin() + blockIndex + 1, std::move(added));
+	for (auto i = blockIndex + 1, l = int(blocks.size()); i != l; ++i) {
+		blocks[i]->setIndexInHistory(i);
+	}
+}
+
 History *History::migrateSibling() const {
 	const auto addFromId = [&] {
 		if (const auto from = peer->migrateFrom()) {
@@ -2868,6 +2904,83 @@ void History::unloadBlocks() {
 	clearBlocks(true);
 }
 
+int History::loadedMessagesCount() const {
+	auto result = 0;
+	for (const auto &block : blocks) {
+		result += int(block->messages.size());
+	}
+	return result;
+}
+
+bool History::unloadOldestBlocks(int keepMessagesCount) {
+	auto count = loadedMessagesCount();
+	auto unloadCount = 0;
+	while (unloadCount + 1 < int(blocks.size())) {
+		const auto take = int(blocks[unloadCount]->messages.size());
+		if (count - take < keepMessagesCount) {
+			break;
+		}
+		count -= take;
+		++unloadCount;
+	}
+	if (!unloadCount) {
+		return false;
+	}
+	const auto unloading = [&](Element *view) {
+		return view && (view->block()->indexInHistory() < unloadCount);
+	};
+	if (unloading(_unreadBarView)) {
+		_unreadBarView = nullptr;
+	}
+	if (unloading(_firstUnreadView)) {
+		_firstUnreadView = nullptr;
+	}
+	if (unloading(scrollTopItem)) {
+		forgetScrollState();
+	}
+	blocks.erase(begin(blocks), begin(blocks) + unloadCount);
+	for (auto i = 0, l = int(blocks.size()); i != l; ++i) {
+		blocks[i]->setIndexInHistory(i);
+	}
+	_loadedAtTop = false;
+	blocks.front()->messages.front()->previousInBlocksChanged();
+	_owner->notifyHistoryChangeDelayed(this);
+	return true;
+}
+
+bool History::unloadNewestBlocks(int keepMessagesCount) {
+	auto count = loadedMessagesCount();
+	auto unloadFrom = int(blocks.size());
+	while (unloadFrom > 1) {
+		const auto take = int(blocks[unloadFrom - 1]->messages.size());
+		if (count - take < keepMessagesCount) {
+			break;
+		}
+		count -= take;
+		--unloadFrom;
+	}
+	if (unloadFrom == int(blocks.size())) {
+		return false;
+	}
+	const auto unloading = [&](Element *view) {
+		return view && (view->block()->indexInHistory() >= unloadFrom);
+	};
+	if (unloading(_unreadBarView)) {
+		_unreadBarView = nullptr;
+	}
+	if (unloading(_firstUnreadView)) {
+		_firstUnreadView = nullptr;
+	}
+	if (unloading(scrollTopItem)) {
+		forgetScrollState();
+	}
+	blocks.erase(begin(blocks) + unloadFrom, end(blocks));
+	setNotLoadedAtBottom();
+	blocks.back()->messages.back()->nextInBlocksRemoved();
+	_owner->notifyHistoryChangeDelayed(this);
+	return true;
+}
+
 void History::clearBlocks(bool leaveItems) {
 	_unreadBarView = nullptr;
 	_firstUnreadView = nullptr;
@@ -2915,6 +3028,7 @@ void History::clearUpTill(MsgId availableMinId) {
 	if (!minId || minId > availableMinId) {
 		return;
 	}
+	_destroyingUpTill = true;
 	do {
 		const auto item = blocks.front()->messages.front()->data();
 		const auto itemId = item->id;
@@ -2936,7 +3050,14 @@ void History::clearUpTill(MsgId availableMinId) {
 		}
 		item->destroy();
 	} while (!isEmpty());
+	_destroyingUpTill = false;
 
+	if (const auto unread = base::take(_destroyedUnreadCount)) {
+		changeUnreadCount(-qMin(unread, unreadCount()));
+	}
+	if (!isEmpty()) {
+		blocks.front()->messages.front()->previousInBlocksChanged();
+	}
 	requestChatListMessage();
 	_owner->sendHistoryChangeNotifications();
 }
@@ -2978,7 +3099,11 @@ void History::removeBlock(not_null<HistoryBlock*> block) {
 
 	int index = block->indexInHistory();
 	blocks.erase(blocks.begin() + index);
-	if (index < blocks.size()) {
+	if (_destroyingUpTill) {
+		for (int i = index, l = blocks.size(); i < l; ++i) {
+			blocks[i]->setIndexInHistory(i);
+		}
+	} else if (index < blocks.size()) {
 		for (int i = index, l = blocks.size(); i < l; ++i) {
 			blocks[i]->setIndexInHistory(i);
 		}
@@ -2995,6 +3120,13 @@ HistoryBlock::HistoryBlock(not_null<History*> history)
 }
 
 int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
+	if (!resizeAllItems && !_pendingResize) {
+		// All heights in this block are cached from the last layout
+		// pass at this width, no need to walk the messages at all.
+		return _height;
+	}
+	_pendingResize = false;
+
 	auto y = 0;
 	for (const auto &message : messages) {
 		message->setY(y);
@@ -3011,6 +3143,7 @@ int HistoryBlock::resizeGetHeight(int newWidth, bool resizeAllItems) {
 void HistoryBlock::remove(not_null<Element*> view) {
 	Expects(view->block() == this);
 
+	setPendingResize();
 	_history->mainViewRemoved(this, view);
 
 	const auto blockIndex = indexInHistory();
@@ -3024,6 +3157,9 @@ void HistoryBlock::remove(not_null<Element*> view) {
 	if (messages.empty()) {
 		// Deletes this.
 		_history->removeBlock(this);
+	} else if (_history->_destroyingUpTill) {
+		// The next message is either destroyed as well or gets
+		// a previousInBlocksChanged() call from clearUpTill().
 	} else if (itemIndex < messages.size()) {
 		messages[itemIndex]->previousInBlocksChanged();
 	} else if (blockIndex + 1 < _history->blocks.size()) {
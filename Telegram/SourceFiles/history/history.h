@@ -89,6 +89,15 @@ public:
 	void unloadBlocks();
 	void clearUpTill(MsgId availableMinId);
 
+	// Drop whole blocks from one of the edges when the loaded part
+	// of the history grows too large while the user scrolls through
+	// it. At least keepMessagesCount messages (and always at least
+	// one block) are kept, the unloaded part is simply requested
+	// again when the user scrolls back to it.
+	bool unloadOldestBlocks(int keepMessagesCount);
+	bool unloadNewestBlocks(int keepMessagesCount);
+	int loadedMessagesCount() const;
+
 	void applyGroupAdminChanges(
 		const base::flat_map<UserId, bool> &changes);
 
@@ -217,6 +226,9 @@ public:
 
 	bool mySendActionUpdated(SendAction::Type type, bool doing);
 	bool paintSendAction(Painter &p, int x, int y, int availableWidth, int outerWidth, style::color color, TimeMs ms);
+	bool hasActiveSendAction() const {
+		return !_typing.isEmpty() || !_sendActions.isEmpty();
+	}
 
 	// Interface for Histories
 	bool updateSendActionNeedsAnimating(TimeMs ms, bool force = false);
@@ -379,6 +391,11 @@ private:
 		int blockIndex,
 		int itemIndex);
 
+	// Splits an oversized block in two, so that the per-insertion
+	// reindexing cost of middle insertions stays bounded by the
+	// normal block size instead of growing with every insertion.
+	void splitBlock(int blockIndex);
+
 	// All this methods add a new item to the first or last block
 	// depending on if we are in isBuildingFronBlock() state.
 	// The last block is created on the go if it is needed.
@@ -473,6 +490,12 @@ private:
 
 	bool _unreadMark = false;
 
+	// Set while clearUpTill() destroys a range of messages one by one,
+	// so that the per-message dialogs list, unread count and neighbour
+	// layout updates can be done once for the whole range instead.
+	bool _destroyingUpTill = false;
+	int _destroyedUnreadCount = 0;
+
 	// A pointer to the block that is currently being built.
 	// We hold this pointer so we can destroy it while building
 	// and then create a new one if it is necessary.
@@ -516,6 +539,9 @@ public:
 	void refreshView(not_null<Element*> view);
 
 	int resizeGetHeight(int newWidth, bool resizeAllItems);
+	void setPendingResize() {
+		_pendingResize = true;
+	}
 	int y() const {
 		return _y;
 	}
@@ -560,5 +586,6 @@ protected:
 	int _y = 0;
 	int _height = 0;
 	int _indexInHistory = -1;
+	bool _pendingResize = true;
 
 };
@@ -51,6 +51,10 @@ namespace {
 
 constexpr auto kScrollDateHideTimeout = 1000;
 
+// The kinetic scroll is stepped by the shared animation clock, but
+// not more often than it was with its own timer before.
+constexpr auto kTouchScrollStep = TimeMs(15);
+
 // Helper binary search for an item in a list that is not completely
 // above the given top of the visible area or below the given bottom of the visible area
 // is applied once for blocks list in a history and once for items list in the found block.
@@ -124,13 +128,13 @@ HistoryInner::HistoryInner(
 , _migrated(history->migrateFrom())
 , _widget(historyWidget)
 , _scroll(scroll)
+, _a_touchScroll(animation(this, &HistoryInner::step_touchScroll))
 , _scrollDateCheck([this] { scrollDateCheck(); })
 , _scrollDateHideTimer([this] { scrollDateHideByTimer(); }) {
 	_touchSelectTimer.setSingleShot(true);
 	connect(&_touchSelectTimer, SIGNAL(timeout()), this, SLOT(onTouchSelect()));
 
 	setAttribute(Qt::WA_AcceptTouchEvents);
-	connect(&_touchScrollTimer, SIGNAL(timeout()), this, SLOT(onTouchScrollTimer()));
 
 	_trippleClickTimer.setSingleShot(true);
 
@@ -543,6 +547,12 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 	auto clip = e->rect();
 	auto ms = getms();
 
+	// The clip is the bounding rect of the update region, so when two
+	// small animations invalidate their rects on the opposite ends of
+	// the viewport every item in between falls inside the clip. Check
+	// the items against the region itself to skip the clean ones.
+	const auto &region = e->region();
+
 	const auto historyDisplayedEmpty = _history->isDisplayedEmpty()
 		&& (!_migrated || _migrated->isDisplayedEmpty());
 	bool noHistoryDisplayed = _firstLoading || historyDisplayedEmpty;
@@ -594,21 +604,22 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 			p.save();
 			p.translate(0, y);
 			if (clip.y() < y + view->height()) while (y < drawToY) {
-				const auto selection = itemRenderSelection(
-					view,
-					selfromy - mtop,
-					seltoy - mtop);
-				view->draw(p, clip.translated(0, -y), selection, ms);
-
-				if (item->hasViews()) {
-					App::main()->scheduleViewIncrement(item);
-				}
-				if (item->isUnreadMention() && !item->isUnreadMedia()) {
-					readMentions.insert(item);
-					_widget->enqueueMessageHighlight(view);
-				}
-
 				int32 h = view->height();
+				if (region.intersects(QRect(0, y, width(), h))) {
+					const auto selection = itemRenderSelection(
+						view,
+						selfromy - mtop,
+						seltoy - mtop);
+					view->draw(p, clip.translated(0, -y), selection, ms);
+
+					if (item->hasViews()) {
+						App::main()->scheduleViewIncrement(item);
+					}
+					if (item->isUnreadMention() && !item->isUnreadMedia()) {
+						readMentions.insert(item);
+						_widget->enqueueMessageHighlight(view);
+					}
+				}
 				p.translate(0, h);
 				y += h;
 
@@ -639,7 +650,9 @@ void HistoryInner::paintEvent(QPaintEvent *e) {
 			p.translate(0, y);
 			while (y < drawToY) {
 				auto h = view->height();
-				if (hclip.y() < y + h && hdrawtop < y + h) {
+				if (hclip.y() < y + h
+					&& hdrawtop < y + h
+					&& region.intersects(QRect(0, y, width(), h))) {
 					const auto selection = itemRenderSelection(
 						view,
 						selfromy - htop,
@@ -765,24 +778,31 @@ bool HistoryInner::eventHook(QEvent *e) {
 	return RpWidget::eventHook(e);
 }
 
-void HistoryInner::onTouchScrollTimer() {
-	auto nowTime = getms();
-	if (_touchScrollState == Ui::TouchScrollState::Acceleration && _touchWaitingAcceleration && (nowTime - _touchAccelerationTime) > 40) {
+void HistoryInner::step_touchScroll(TimeMs ms, bool timer) {
+	if (_touchScrollState == Ui::TouchScrollState::Acceleration && _touchWaitingAcceleration && (ms - _touchAccelerationTime) > 40) {
 		_touchScrollState = Ui::TouchScrollState::Manual;
 		touchResetSpeed();
+		_a_touchScroll.stop();
 	} else if (_touchScrollState == Ui::TouchScrollState::Auto || _touchScrollState == Ui::TouchScrollState::Acceleration) {
-		int32 elapsed = int32(nowTime - _touchTime);
+		int32 elapsed = int32(ms - _touchTime);
+		if (elapsed < kTouchScrollStep) {
+			// The shared animation clock ticks more often than the
+			// kinetic scroll step, wait for the next step to come.
+			return;
+		}
 		QPoint delta = _touchSpeed * elapsed / 1000;
 		bool hasScrolled = _widget->touchScroll(delta);
 
 		if (_touchSpeed.isNull() || !hasScrolled) {
 			_touchScrollState = Ui::TouchScrollState::Manual;
 			_touchScroll = false;
-			_touchScrollTimer.stop();
+			_a_touchScroll.stop();
 		} else {
-			_touchTime = nowTime;
+			_touchTime = ms;
 		}
 		touchDeaccelerate(elapsed);
+	} else {
+		_a_touchScroll.stop();
 	}
 }
 
@@ -913,7 +933,7 @@ void HistoryInner::touchEvent(QTouchEvent *e) {
 			if (_touchScrollState == Ui::TouchScrollState::Manual) {
 				_touchScrollState = Ui::TouchScrollState::Auto;
 				_touchPrevPosValid = false;
-				_touchScrollTimer.start(15);
+				_a_touchScroll.start();
 				_touchTime = getms();
 			} else if (_touchScrollState == Ui::TouchScrollState::Auto) {
 				_touchScrollState = Ui::TouchScrollState::Manual;
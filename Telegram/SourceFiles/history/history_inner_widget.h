@@ -127,7 +127,6 @@ public slots:
 	void onParentGeometryChanged();
 
 	void onTouchSelect();
-	void onTouchScrollTimer();
 
 private:
 	class BotAbout;
@@ -222,6 +221,7 @@ private:
 	void viewRemoved(not_null<const Element*> view);
 	void refreshView(not_null<HistoryItem*> item);
 
+	void step_touchScroll(TimeMs ms, bool timer);
 	void touchResetSpeed();
 	void touchUpdateSpeed();
 	void touchDeaccelerate(int32 elapsed);
@@ -351,7 +351,7 @@ private:
 	TimeMs _touchSpeedTime = 0;
 	TimeMs _touchAccelerationTime = 0;
 	TimeMs _touchTime = 0;
-	QTimer _touchScrollTimer;
+	BasicAnimation _a_touchScroll;
 
 	base::unique_qptr<Ui::PopupMenu> _menu;
 
@@ -29,12 +29,19 @@ void HistoryMessageVia::create(UserId userId) {
 	bot = Auth().data().user(userId);
 	maxWidth = st::msgServiceNameFont->width(
 		lng_inline_bot_via(lt_inline_bot, '@' + bot->username));
+	lastAvailWidth = std::numeric_limits<int>::min();
 	link = std::make_shared<LambdaClickHandler>([bot = this->bot] {
 		App::insertBotCommand('@' + bot->username);
 	});
 }
 
 void HistoryMessageVia::resize(int32 availw) const {
+	if (availw == lastAvailWidth
+		|| (availw < 0 && lastAvailWidth < 0)
+		|| (availw >= maxWidth && lastAvailWidth >= maxWidth)) {
+		return;
+	}
+	lastAvailWidth = availw;
 	if (availw < 0) {
 		text = QString();
 		width = 0;
@@ -43,7 +50,7 @@ void HistoryMessageVia::resize(int32 availw) const {
 		if (availw < maxWidth) {
 			text = st::msgServiceNameFont->elided(text, availw);
 			width = st::msgServiceNameFont->width(text);
-		} else if (width < maxWidth) {
+		} else {
 			width = maxWidth;
 		}
 	}
@@ -588,7 +595,9 @@ void ReplyKeyboard::clickHandlerPressedChanged(
 				button.ripple = std::make_unique<Ui::RippleAnimation>(
 					_st->_st->ripple,
 					std::move(mask),
-					[this] { _st->repaint(_item); });
+					[this, i = coords.i, j = coords.j] {
+						_st->repaintPart(_item, _rows[i][j].rect);
+					});
 			}
 			button.ripple->add(_savedCoords - button.rect.topLeft());
 		} else {
@@ -621,6 +630,7 @@ void ReplyKeyboard::step_selected(TimeMs ms, bool timer) {
 	if (anim::Disabled()) {
 		ms += st::botKbDuration;
 	}
+	auto repaintRect = QRect();
 	for (auto i = _animations.begin(); i != _animations.end();) {
 		const auto index = std::abs(i->first) - 1;
 		const auto row = (index / MatrixRowShift);
@@ -633,8 +643,13 @@ void ReplyKeyboard::step_selected(TimeMs ms, bool timer) {
 			_rows[row][col].howMuchOver = (i->first > 0) ? dt : (1 - dt);
 			++i;
 		}
+		repaintRect = repaintRect.united(_rows[row][col].rect);
+	}
+	if (timer && !repaintRect.isEmpty()) {
+		// Only the animating buttons change, repainting the whole
+		// keyboard each frame is wasteful on large layouts.
+		_st->repaintPart(_item, repaintRect);
 	}
-	if (timer) _st->repaint(_item);
 	if (_animations.empty()) {
 		_a_selected.stop();
 	}
@@ -24,6 +24,9 @@ struct HistoryMessageVia : public RuntimeComponent<HistoryMessageVia, HistoryIte
 	mutable QString text;
 	mutable int width = 0;
 	mutable int maxWidth = 0;
+	// Last width given to resize(), the phrase is rebuilt and
+	// elided only when it changes or the bot is recreated.
+	mutable int lastAvailWidth = std::numeric_limits<int>::min();
 	ClickHandlerPtr link;
 };
 
@@ -234,6 +237,14 @@ public:
 		virtual int buttonRadius() const = 0;
 
 		virtual void repaint(not_null<const HistoryItem*> item) const = 0;
+		// Partial invalidation for hover and ripple animations.
+		// Falls back to a full repaint where rect level updates
+		// don't exist (keyboards inside message views).
+		virtual void repaintPart(
+				not_null<const HistoryItem*> item,
+				const QRect &rect) const {
+			repaint(item);
+		}
 		virtual ~Style() {
 		}
 
@@ -377,6 +388,15 @@ public:
 	std::shared_ptr<VoiceSeekClickHandler> _seekl;
 	mutable int _lastDurationMs = 0;
 
+	// Prerendered waveform bars, playback progress is painted over them
+	// as two clipped blits instead of filling every bar each frame.
+	mutable QPixmap _waveformActive;
+	mutable QPixmap _waveformInactive;
+	mutable QColor _waveformActiveColor;
+	mutable QColor _waveformInactiveColor;
+	mutable int _waveformWidth = 0;
+	mutable bool _waveformHasData = false;
+
 	bool seeking() const {
 		return _seeking;
 	}
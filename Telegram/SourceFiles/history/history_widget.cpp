@@ -58,6 +58,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/localstorage.h"
 #include "storage/file_upload.h"
 #include "storage/storage_media_prepare.h"
+#include "platform/platform_file_utilities.h"
 #include "media/media_audio.h"
 #include "media/media_audio_capture.h"
 #include "media/player/media_player_instance.h"
@@ -94,6 +95,7 @@ namespace {
 constexpr auto kMessagesPerPageFirst = 30;
 constexpr auto kMessagesPerPage = 50;
 constexpr auto kPreloadHeightsCount = 3; // when 3 screens to scroll left make a preload request
+constexpr auto kMaxLoadedMessages = 1500; // drop the far-offscreen blocks when more is loaded
 constexpr auto kTabbedSelectorToggleTooltipTimeoutMs = 3000;
 constexpr auto kTabbedSelectorToggleTooltipCount = 3;
 constexpr auto kScrollToVoiceAfterScrolledMs = 1000;
@@ -105,6 +107,7 @@ constexpr auto kCancelTypingActionTimeout = TimeMs(5000);
 constexpr auto kSaveDraftTimeout = 1000;
 constexpr auto kSaveDraftAnywayTimeout = 5000;
 constexpr auto kSaveCloudDraftIdleTimeout = 14000;
+constexpr auto kCreateTabbedPanelTimeoutMs = 1000;
 
 ApiWrap::RequestMessageDataCallback replyEditMessageDataCallback() {
 	return [](ChannelData *channel, MsgId msgId) {
@@ -204,8 +207,6 @@ HistoryWidget::HistoryWidget(
 , _recordCancelWidth(st::historyRecordFont->width(lang(lng_record_cancel)))
 , _a_recording(animation(this, &HistoryWidget::step_recording))
 , _kbScroll(this, st::botKbScroll)
-, _tabbedPanel(this, controller)
-, _tabbedSelector(_tabbedPanel->getSelector())
 , _attachDragState(DragState::None)
 , _attachDragDocument(this)
 , _attachDragPhoto(this)
@@ -235,8 +236,6 @@ HistoryWidget::HistoryWidget(
 	connect(App::wnd()->windowHandle(), SIGNAL(visibleChanged(bool)), this, SLOT(onWindowVisibleChanged()));
 	connect(&_scrollTimer, SIGNAL(timeout()), this, SLOT(onScrollTimer()));
 
-	initTabbedSelector();
-
 	connect(Media::Capture::instance(), SIGNAL(error()), this, SLOT(onRecordError()));
 	connect(Media::Capture::instance(), SIGNAL(updated(quint16,qint32)), this, SLOT(onRecordUpdate(quint16,qint32)));
 	connect(Media::Capture::instance(), SIGNAL(done(QByteArray,VoiceWaveform,qint32)), this, SLOT(onRecordDone(QByteArray,VoiceWaveform,qint32)));
@@ -336,7 +335,6 @@ HistoryWidget::HistoryWidget(
 	_botKeyboardHide->hide();
 	_botCommandStart->hide();
 
-	_tabbedSelectorToggle->installEventFilter(_tabbedPanel);
 	_tabbedSelectorToggle->setClickedCallback([this] {
 		toggleTabbedSelectorMode();
 	});
@@ -345,7 +343,6 @@ HistoryWidget::HistoryWidget(
 	connect(_botKeyboardHide, SIGNAL(clicked()), this, SLOT(onKbToggle()));
 	connect(_botCommandStart, SIGNAL(clicked()), this, SLOT(onCmdStart()));
 
-	_tabbedPanel->hide();
 	_attachDragDocument->hide();
 	_attachDragPhoto->hide();
 
@@ -525,6 +522,27 @@ HistoryWidget::HistoryWidget(
 
 	orderWidgets();
 	setupShortcuts();
+
+	App::CallDelayed(kCreateTabbedPanelTimeoutMs, this, [this] {
+		if (!_tabbedPanel && !_tabbedSelectorInThirdSection) {
+			createTabbedPanel();
+		}
+	});
+}
+
+void HistoryWidget::createTabbedPanel() {
+	Expects(!_tabbedPanel);
+
+	_tabbedPanel.create(this, controller());
+	_tabbedPanel->hide();
+	_tabbedSelector = _tabbedPanel->getSelector();
+	_tabbedSelectorToggle->installEventFilter(_tabbedPanel);
+	initTabbedSelector();
+	if (_peer) {
+		_tabbedSelector->setCurrentPeer(_peer);
+		_tabbedSelector->showMegagroupSet(_peer->asMegagroup());
+	}
+	moveFieldControls();
 }
 
 void HistoryWidget::initTabbedSelector() {
@@ -814,7 +832,9 @@ bool HistoryWidget::inSelectionMode() const {
 void HistoryWidget::start() {
 	Auth().data().stickersUpdated(
 	) | rpl::start_with_next([this] {
-		_tabbedSelector->refreshStickers();
+		if (_tabbedSelector) {
+			_tabbedSelector->refreshStickers();
+		}
 		updateStickersByEmoji();
 	}, lifetime());
 	updateRecentStickers();
@@ -1176,7 +1196,9 @@ void HistoryWidget::updateSendAction(
 }
 
 void HistoryWidget::updateRecentStickers() {
-	_tabbedSelector->refreshStickers();
+	if (_tabbedSelector) {
+		_tabbedSelector->refreshStickers();
+	}
 }
 
 void HistoryWidget::sendActionDone(const MTPBool &result, mtpRequestId req) {
@@ -1598,7 +1620,9 @@ void HistoryWidget::showHistory(
 		_peer = Auth().data().peer(peerId);
 		_channel = peerToChannel(_peer->id);
 		_canSendMessages = _peer->canWrite();
-		_tabbedSelector->setCurrentPeer(_peer);
+		if (_tabbedSelector) {
+			_tabbedSelector->setCurrentPeer(_peer);
+		}
 	}
 
 	if (_peer) {
@@ -1678,7 +1702,9 @@ void HistoryWidget::showHistory(
 		applyDraft();
 		_send->finishAnimating();
 
-		_tabbedSelector->showMegagroupSet(_peer->asMegagroup());
+		if (_tabbedSelector) {
+			_tabbedSelector->showMegagroupSet(_peer->asMegagroup());
+		}
 
 		updateControlsGeometry();
 
@@ -1712,7 +1738,9 @@ void HistoryWidget::showHistory(
 		updateTopBarSelection();
 
 		clearFieldText();
-		_tabbedSelector->showMegagroupSet(nullptr);
+		if (_tabbedSelector) {
+			_tabbedSelector->showMegagroupSet(nullptr);
+		}
 		doneShow();
 	}
 	updateForwarding();
@@ -1723,6 +1751,10 @@ void HistoryWidget::showHistory(
 			_history,
 			FullMsgId(_history->channelId(), _showAtMsgId) });
 	}
+	if (Auth().settings().lastOpenPeer() != peerId) {
+		Auth().settings().setLastOpenPeer(peerId);
+		Auth().saveSettingsDelayed();
+	}
 	update();
 
 	crl::on_main(App::wnd(), [] { App::wnd()->setInnerFocus(); });
@@ -3025,14 +3057,18 @@ void HistoryWidget::chooseAttach() {
 				uploadFile(result.remoteContent, SendMediaType::File);
 			}
 		} else {
-			auto list = Storage::PrepareMediaList(
+			Storage::PrepareMediaListAsync(
 				result.paths,
-				st::sendMediaPreviewSize);
-			if (list.allFilesForCompress || list.albumIsPossible) {
-				confirmSendingFiles(std::move(list), CompressConfirm::Auto);
-			} else if (!showSendingFilesError(list)) {
-				uploadFiles(std::move(list), SendMediaType::File);
-			}
+				st::sendMediaPreviewSize,
+				crl::guard(this, [=](Storage::PreparedList &&list) {
+					if (list.allFilesForCompress || list.albumIsPossible) {
+						confirmSendingFiles(
+							std::move(list),
+							CompressConfirm::Auto);
+					} else if (!showSendingFilesError(list)) {
+						uploadFiles(std::move(list), SendMediaType::File);
+					}
+				}));
 		}
 	}));
 }
@@ -3670,14 +3706,18 @@ void HistoryWidget::onModerateKeyActivate(int index, bool *outHandled) {
 
 void HistoryWidget::pushTabbedSelectorToThirdSection(
 		const Window::SectionShow &params) {
-	if (!_history || !_tabbedPanel) {
+	if (!_history || _tabbedSelectorInThirdSection) {
 		return;
 	} else if (!_canSendMessages) {
 		Auth().settings().setTabbedReplacedWithInfo(true);
 		controller()->showPeerInfo(_peer, params.withThirdColumn());
 		return;
 	}
+	if (!_tabbedPanel) {
+		createTabbedPanel();
+	}
 	Auth().settings().setTabbedReplacedWithInfo(false);
+	_tabbedSelectorInThirdSection = true;
 	_tabbedSelectorToggle->setColorOverrides(
 		&st::historyAttachEmojiActive,
 		&st::historyRecordVoiceFgActive,
@@ -3695,6 +3735,9 @@ void HistoryWidget::pushTabbedSelectorToThirdSection(
 }
 
 void HistoryWidget::toggleTabbedSelectorMode() {
+	if (!_tabbedPanel && !_tabbedSelectorInThirdSection) {
+		createTabbedPanel();
+	}
 	if (_tabbedPanel) {
 		if (controller()->canShowThirdSection()
 			&& !Adaptive::OneColumn()) {
@@ -3712,6 +3755,7 @@ void HistoryWidget::toggleTabbedSelectorMode() {
 
 void HistoryWidget::returnTabbedSelector(
 		object_ptr<TabbedSelector> selector) {
+	_tabbedSelectorInThirdSection = false;
 	_tabbedPanel.create(
 		this,
 		controller(),
@@ -3944,10 +3988,19 @@ bool HistoryWidget::confirmSendingFiles(
 		const QStringList &files,
 		CompressConfirm compressed,
 		const QString &insertTextOnCancel) {
-	return confirmSendingFiles(
-		Storage::PrepareMediaList(files, st::sendMediaPreviewSize),
-		compressed,
-		insertTextOnCancel);
+	// The previews are decoded on the worker pool, so dropping even
+	// huge images does not freeze the compose window, the box is
+	// shown as soon as the prepared list arrives back here.
+	Storage::PrepareMediaListAsync(
+		files,
+		st::sendMediaPreviewSize,
+		crl::guard(this, [=](Storage::PreparedList &&list) {
+			confirmSendingFiles(
+				std::move(list),
+				compressed,
+				insertTextOnCancel);
+		}));
+	return true;
 }
 
 bool HistoryWidget::confirmSendingFiles(
@@ -4067,19 +4120,19 @@ bool HistoryWidget::confirmSendingFiles(
 	const auto hasImage = data->hasImage();
 
 	if (const auto urls = data->urls(); !urls.empty()) {
-		auto list = Storage::PrepareMediaList(
+		const auto allLocal = ranges::find_if(
 			urls,
-			st::sendMediaPreviewSize);
-		if (list.error != Storage::PreparedList::Error::NonLocalUrl) {
-			if (list.error == Storage::PreparedList::Error::None
-				|| !hasImage) {
-				const auto emptyTextOnCancel = QString();
-				confirmSendingFiles(
-					std::move(list),
-					compressed,
-					emptyTextOnCancel);
-				return true;
+			[](const QUrl &url) { return !url.isLocalFile(); }
+		) == urls.end();
+		if (allLocal) {
+			auto files = QStringList();
+			files.reserve(urls.size());
+			for (const auto &url : urls) {
+				files.push_back(Platform::File::UrlToLocal(url));
 			}
+			const auto emptyTextOnCancel = QString();
+			confirmSendingFiles(files, compressed, emptyTextOnCancel);
+			return true;
 		}
 	}
 
@@ -4879,6 +4932,13 @@ HistoryView::Element *HistoryWidget::firstUnreadMessage() const {
 void HistoryWidget::addMessagesToFront(PeerData *peer, const QVector<MTPMessage> &messages) {
 	_list->messagesReceived(peer, messages);
 	if (!_firstLoadRequest) {
+		// While the user scrolls up drop the blocks that are now far
+		// below the viewport, they'll be loaded again on scroll-back.
+		if (_history->unloadNewestBlocks(kMaxLoadedMessages)
+			&& _preloadDownRequest) {
+			MTP::cancel(_preloadDownRequest);
+			_preloadDownRequest = 0;
+		}
 		updateHistoryGeometry();
 		updateBotKeyboard();
 	}
@@ -4887,7 +4947,34 @@ void HistoryWidget::addMessagesToFront(PeerData *peer, const QVector<MTPMessage>
 void HistoryWidget::addMessagesToBack(PeerData *peer, const QVector<MTPMessage> &messages) {
 	_list->messagesReceivedDown(peer, messages);
 	if (!_firstLoadRequest) {
-		updateHistoryGeometry(false, true, { ScrollChangeNoJumpToBottom, 0 });
+		// While the user scrolls down drop the blocks that are now far
+		// above the viewport, they'll be loaded again on scroll-back.
+		auto unloaded = false;
+		if (_migrated && !_migrated->isEmpty()) {
+			// _migrated is displayed right above _history, there can't
+			// be a gap in between, so the far blocks are dropped from
+			// the migrated history before the history itself is cut.
+			if (_history->loadedMessagesCount() >= kMaxLoadedMessages) {
+				_migrated->unloadBlocks();
+				unloaded = true;
+			} else if (_migrated->unloadOldestBlocks(
+					kMaxLoadedMessages - _history->loadedMessagesCount())) {
+				unloaded = true;
+			}
+		}
+		if ((!_migrated || _migrated->isEmpty())
+			&& _history->unloadOldestBlocks(kMaxLoadedMessages)) {
+			unloaded = true;
+		}
+		if (unloaded && _preloadRequest) {
+			MTP::cancel(_preloadRequest);
+			_preloadRequest = 0;
+		}
+		// If the blocks above the viewport were dropped the old scroll
+		// top value is invalid, restore the position by the top item.
+		updateHistoryGeometry(false, true, unloaded
+			? ScrollChange{ ScrollChangeNone, 0 }
+			: ScrollChange{ ScrollChangeNoJumpToBottom, 0 });
 	}
 }
 
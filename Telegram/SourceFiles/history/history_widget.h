@@ -362,6 +362,9 @@ private:
 	using TabbedSelector = ChatHelpers::TabbedSelector;
 	using DragState = Storage::MimeDataState;
 
+	// The tabbed panel is not needed for the first frame, so it is
+	// created lazily - on the first use or on idle soon after show.
+	void createTabbedPanel();
 	void initTabbedSelector();
 	void updateField();
 
@@ -783,8 +786,9 @@ private:
 	QTimer _membersDropdownShowTimer;
 
 	object_ptr<InlineBots::Layout::Widget> _inlineResults = { nullptr };
-	object_ptr<TabbedPanel> _tabbedPanel;
+	object_ptr<TabbedPanel> _tabbedPanel = { nullptr };
 	QPointer<TabbedSelector> _tabbedSelector;
+	bool _tabbedSelectorInThirdSection = false;
 	DragState _attachDragState;
 	object_ptr<DragArea> _attachDragDocument, _attachDragPhoto;
 
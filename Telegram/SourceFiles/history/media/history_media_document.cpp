@@ -27,6 +27,57 @@ namespace {
 
 using TextState = HistoryView::TextState;
 
+// Rescale the waveform into bars of the given color at the given width,
+// so that playback progress can be painted as two clipped pixmap blits
+// instead of filling every bar on each animation frame.
+QPixmap PrepareWaveformPixmap(
+		const VoiceWaveform *wf,
+		uchar normValue,
+		int availw,
+		style::color color) {
+	const auto pixHeight = st::msgWaveformMax + st::msgWaveformMin;
+	auto image = QImage(
+		QSize(availw, pixHeight) * cIntRetinaFactor(),
+		QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(cRetinaFactor());
+	image.fill(Qt::transparent);
+	{
+		Painter p(&image);
+		p.setPen(Qt::NoPen);
+
+		// rescale waveform by going in waveform.size * bar_count 1D grid
+		auto wf_size = wf ? wf->size() : ::Media::Player::kWaveformSamplesCount;
+		auto bar_count = qMin(availw / (st::msgWaveformBar + st::msgWaveformSkip), wf_size);
+		auto max_value = 0;
+		auto max_delta = st::msgWaveformMax - st::msgWaveformMin;
+		auto bottom = st::msgWaveformMax;
+		for (auto i = 0, bar_x = 0, sum_i = 0; i < wf_size; ++i) {
+			auto value = wf ? wf->at(i) : 0;
+			if (sum_i + bar_count >= wf_size) { // draw bar
+				sum_i = sum_i + bar_count - wf_size;
+				if (sum_i < (bar_count + 1) / 2) {
+					if (max_value < value) max_value = value;
+				}
+				auto bar_value = ((max_value * max_delta) + ((normValue + 1) / 2)) / (normValue + 1);
+
+				p.fillRect(bar_x, bottom - bar_value, st::msgWaveformBar, st::msgWaveformMin + bar_value, color);
+				bar_x += st::msgWaveformBar + st::msgWaveformSkip;
+
+				if (sum_i < (bar_count + 1) / 2) {
+					max_value = 0;
+				} else {
+					max_value = value;
+				}
+			} else {
+				if (max_value < value) max_value = value;
+
+				sum_i += bar_count;
+			}
+		}
+	}
+	return App::pixmapFromImageInPlace(std::move(image));
+}
+
 } // namespace
 
 HistoryDocument::HistoryDocument(
@@ -371,10 +422,8 @@ void HistoryDocument::draw(Painter &p, const QRect &r, TextSelection selection,
 			voiceStatusOverride = formatPlayedText(qRound(progress * voice->_lastDurationMs) / 1000, voice->_lastDurationMs / 1000);
 		}
 
-		// rescale waveform by going in waveform.size * bar_count 1D grid
 		auto active = outbg ? (selected ? st::msgWaveformOutActiveSelected : st::msgWaveformOutActive) : (selected ? st::msgWaveformInActiveSelected : st::msgWaveformInActive);
 		auto inactive = outbg ? (selected ? st::msgWaveformOutInactiveSelected : st::msgWaveformOutInactive) : (selected ? st::msgWaveformInInactiveSelected : st::msgWaveformInInactive);
-		auto wf_size = wf ? wf->size() : Media::Player::kWaveformSamplesCount;
 		auto availw = namewidth + st::msgWaveformSkip;
 		auto activew = qRound(availw * progress);
 		if (!outbg
@@ -382,40 +431,31 @@ void HistoryDocument::draw(Painter &p, const QRect &r, TextSelection selection,
 			&& _parent->data()->hasUnreadMediaFlag()) {
 			activew = availw;
 		}
-		auto bar_count = qMin(availw / (st::msgWaveformBar + st::msgWaveformSkip), wf_size);
-		auto max_value = 0;
-		auto max_delta = st::msgWaveformMax - st::msgWaveformMin;
-		auto bottom = st::msgFilePadding.top() - topMinus + st::msgWaveformMax;
-		p.setPen(Qt::NoPen);
-		for (auto i = 0, bar_x = 0, sum_i = 0; i < wf_size; ++i) {
-			auto value = wf ? wf->at(i) : 0;
-			if (sum_i + bar_count >= wf_size) { // draw bar
-				sum_i = sum_i + bar_count - wf_size;
-				if (sum_i < (bar_count + 1) / 2) {
-					if (max_value < value) max_value = value;
-				}
-				auto bar_value = ((max_value * max_delta) + ((norm_value + 1) / 2)) / (norm_value + 1);
-
-				if (bar_x >= activew) {
-					p.fillRect(nameleft + bar_x, bottom - bar_value, st::msgWaveformBar, st::msgWaveformMin + bar_value, inactive);
-				} else if (bar_x + st::msgWaveformBar <= activew) {
-					p.fillRect(nameleft + bar_x, bottom - bar_value, st::msgWaveformBar, st::msgWaveformMin + bar_value, active);
-				} else {
-					p.fillRect(nameleft + bar_x, bottom - bar_value, activew - bar_x, st::msgWaveformMin + bar_value, active);
-					p.fillRect(nameleft + activew, bottom - bar_value, st::msgWaveformBar - (activew - bar_x), st::msgWaveformMin + bar_value, inactive);
-				}
-				bar_x += st::msgWaveformBar + st::msgWaveformSkip;
-
-				if (sum_i < (bar_count + 1) / 2) {
-					max_value = 0;
-				} else {
-					max_value = value;
-				}
-			} else {
-				if (max_value < value) max_value = value;
-
-				sum_i += bar_count;
-			}
+		if (voice->_waveformWidth != availw
+			|| voice->_waveformHasData != (wf != nullptr)
+			|| voice->_waveformActiveColor != active->c
+			|| voice->_waveformInactiveColor != inactive->c) {
+			voice->_waveformWidth = availw;
+			voice->_waveformHasData = (wf != nullptr);
+			voice->_waveformActiveColor = active->c;
+			voice->_waveformInactiveColor = inactive->c;
+			voice->_waveformActive = PrepareWaveformPixmap(wf, norm_value, availw, active);
+			voice->_waveformInactive = PrepareWaveformPixmap(wf, norm_value, availw, inactive);
+		}
+		auto wavetop = st::msgFilePadding.top() - topMinus;
+		auto waveheight = st::msgWaveformMax + st::msgWaveformMin;
+		auto factor = cIntRetinaFactor();
+		if (activew > 0) {
+			p.drawPixmap(
+				QRect(nameleft, wavetop, activew, waveheight),
+				voice->_waveformActive,
+				QRect(0, 0, activew * factor, voice->_waveformActive.height()));
+		}
+		if (activew < availw) {
+			p.drawPixmap(
+				QRect(nameleft + activew, wavetop, availw - activew, waveheight),
+				voice->_waveformInactive,
+				QRect(activew * factor, 0, (availw - activew) * factor, voice->_waveformInactive.height()));
 		}
 	} else if (auto named = Get<HistoryDocumentNamed>()) {
 		p.setFont(st::semiboldFont);
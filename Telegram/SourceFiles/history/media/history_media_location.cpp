@@ -48,6 +48,10 @@ HistoryLocation::HistoryLocation(
 				TextParseLinks | TextParseMultiline | TextParseRichText),
 			Ui::WebpageTextDescriptionOptions());
 	}
+	// The map image usually sits in the file cache already, so the
+	// load is started right away instead of on the first paint and
+	// scrolling to the message doesn't flash a placeholder.
+	_data->load(parent->data()->fullId());
 }
 
 QSize HistoryLocation::countOptimalSize() {
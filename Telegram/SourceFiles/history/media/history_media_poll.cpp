@@ -487,6 +487,12 @@ void HistoryPoll::draw(Painter &p, const QRect &r, TextSelection selection, Time
 	if (width() < st::msgPadding.left() + st::msgPadding.right() + 1) return;
 	auto paintx = 0, painty = 0, paintw = width(), painth = height();
 
+	if (_pollVersion != _poll->version) {
+		// Results-only updates arrive as plain repaints without a
+		// relayout, so refresh the cached votes here and animate
+		// the bars from the previous values.
+		const_cast<HistoryPoll*>(this)->updateTexts();
+	}
 	checkSendingAnimation();
 	_poll->checkResultsReload(_parent->data(), ms);
 
@@ -216,6 +216,9 @@ bool Element::isUnderCursor() const {
 
 void Element::setPendingResize() {
 	_flags |= Flag::NeedsResize;
+	if (_block) {
+		_block->setPendingResize();
+	}
 	if (_context == Context::History) {
 		data()->_history->setHasPendingResizedItems();
 	}
@@ -523,6 +526,7 @@ void Element::attachToBlock(not_null<HistoryBlock*> block, int index) {
 
 	_block = block;
 	_indexInBlock = index;
+	_block->setPendingResize();
 	_data->setMainView(this);
 	previousInBlocksChanged();
 }
@@ -546,6 +550,17 @@ void Element::setIndexInBlock(int index) {
 	_indexInBlock = index;
 }
 
+void Element::moveToBlock(not_null<HistoryBlock*> block, int index) {
+	Expects(_block != nullptr);
+	Expects(index >= 0);
+
+	// Rebinds the view when its block is split in two. The sequence of
+	// the views does not change, so no layout updates are needed here.
+	_block = block;
+	_indexInBlock = index;
+	_block->setPendingResize();
+}
+
 int Element::indexInBlock() const {
 	Expects((_indexInBlock >= 0) == (_block != nullptr));
 	Expects((_block == nullptr) || (_block->messages[_indexInBlock].get() == this));
@@ -237,6 +237,7 @@ public:
 	const HistoryBlock *block() const;
 	void attachToBlock(not_null<HistoryBlock*> block, int index);
 	void removeFromBlock();
+	void moveToBlock(not_null<HistoryBlock*> block, int index);
 	void refreshInBlock();
 	void setIndexInBlock(int index);
 	int indexInBlock() const;
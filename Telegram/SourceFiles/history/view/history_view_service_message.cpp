@@ -208,9 +208,11 @@ void ServiceMessagePainter::paintBubble(Painter &p, int x, int y, int w, int h)
 }
 
 void ServiceMessagePainter::paintComplexBubble(Painter &p, int left, int width, const Text &text, const QRect &textRect) {
-	createCircleMasks();
+	paintComplexBubble(p, left, width, countLineWidths(text, textRect));
+}
 
-	auto lineWidths = countLineWidths(text, textRect);
+void ServiceMessagePainter::paintComplexBubble(Painter &p, int left, int width, const QVector<int> &lineWidths) {
+	createCircleMasks();
 
 	int y = st::msgServiceMargin.top(), previousRichWidth = 0;
 	bool previousShrink = false, forceShrink = false;
@@ -320,6 +322,8 @@ QRect Service::countGeometry() const {
 }
 
 QSize Service::performCountCurrentSize(int newWidth) {
+	_bubbleLineWidthsFor = -1;
+
 	auto newHeight = displayedDateHeight();
 	if (const auto bar = Get<UnreadBar>()) {
 		newHeight += bar->height();
@@ -441,7 +445,20 @@ void Service::draw(
 
 	auto trect = QRect(g.left(), st::msgServiceMargin.top(), g.width(), height).marginsAdded(-st::msgServicePadding);
 
-	ServiceMessagePainter::paintComplexBubble(p, g.left(), g.width(), item->_text, trect);
+	if (_bubbleLineWidthsFor != trect.width()) {
+		// Wrapping the text into bubble outline widths is the
+		// costly part of the bubble paint, so it is done once per
+		// layout and not on every frame while scrolling.
+		_bubbleLineWidthsFor = trect.width();
+		_bubbleLineWidths = ServiceMessagePainter::countLineWidths(
+			item->_text,
+			trect);
+	}
+	ServiceMessagePainter::paintComplexBubble(
+		p,
+		g.left(),
+		g.width(),
+		_bubbleLineWidths);
 
 	p.setBrush(Qt::NoBrush);
 	p.setPen(st::msgServiceFg);
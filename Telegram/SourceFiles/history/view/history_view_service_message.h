@@ -45,6 +45,11 @@ private:
 	QSize performCountOptimalSize() override;
 	QSize performCountCurrentSize(int newWidth) override;
 
+	// Bubble outline widths for the current wrap width, so the text
+	// wrapping pass doesn't run again on every paint.
+	mutable QVector<int> _bubbleLineWidths;
+	mutable int _bubbleLineWidthsFor = -1;
+
 };
 
 int WideChatWidth();
@@ -68,8 +73,8 @@ public:
 	static void paintBubble(Painter &p, int x, int y, int w, int h);
 
 	static void paintComplexBubble(Painter &p, int left, int width, const Text &text, const QRect &textRect);
+	static void paintComplexBubble(Painter &p, int left, int width, const QVector<int> &lineWidths);
 
-private:
 	static QVector<int> countLineWidths(const Text &text, const QRect &textRect);
 
 };
@@ -619,6 +619,27 @@ not_null<Ui::RpWidget*> WrapWidget::topWidget() const {
 	return _topBar;
 }
 
+void WrapWidget::cacheOutgoingContent() {
+	if (!_content) {
+		return;
+	}
+	destroyCachedContent();
+	_cachedContent = std::move(_content);
+	_cachedContent->hide();
+	_cachedContentController = std::move(_controller);
+}
+
+void WrapWidget::destroyCachedContent() {
+	if (auto old = std::exchange(
+			_cachedContent,
+			object_ptr<ContentWidget>(nullptr))) {
+		// Content destructor may invoke closeBox(), see showContent().
+		old->setParent(nullptr);
+		old.destroy();
+	}
+	_cachedContentController = nullptr;
+}
+
 void WrapWidget::showContent(object_ptr<ContentWidget> content) {
 	if (auto old = std::exchange(_content, std::move(content))) {
 		old->hide();
@@ -906,8 +927,14 @@ void WrapWidget::showNewContent(
 		_controller->parentController(),
 		memento);
 	auto newContent = object_ptr<ContentWidget>(nullptr);
+	if (_cachedContent && _cachedContent->showInternal(memento)) {
+		newController = std::move(_cachedContentController);
+		newContent = std::move(_cachedContent);
+	}
 	if (needAnimation) {
-		newContent = createContent(memento, newController.get());
+		if (!newContent) {
+			newContent = createContent(memento, newController.get());
+		}
 		animationParams.withTopBarShadow = hasTopBarShadow()
 			&& newContent->hasTopBarShadow();
 		animationParams.oldContentCache = grabForShowAnimation(
@@ -925,6 +952,7 @@ void WrapWidget::showNewContent(
 		_historyStack.clear();
 	}
 
+	cacheOutgoingContent();
 	_controller = std::move(newController);
 	if (newContent) {
 		setupTop();
@@ -200,9 +200,19 @@ private:
 	void addProfileNotificationsButton();
 	void showTopBarMenu();
 
+	void cacheOutgoingContent();
+	void destroyCachedContent();
+
 	rpl::variable<Wrap> _wrap;
 	std::unique_ptr<Controller> _controller;
 	object_ptr<ContentWidget> _content = { nullptr };
+
+	// The section navigated away from is kept constructed (hidden,
+	// with its controller), so going back only restores its state
+	// from the memento instead of rebuilding the whole widget tree.
+	// The controller is declared first to outlive the content widget.
+	std::unique_ptr<Controller> _cachedContentController;
+	object_ptr<ContentWidget> _cachedContent = { nullptr };
 	int _additionalScroll = 0;
 	//object_ptr<Ui::PlainShadow> _topTabsBackground = { nullptr };
 	//object_ptr<Ui::SettingsSlider> _topTabs = { nullptr };
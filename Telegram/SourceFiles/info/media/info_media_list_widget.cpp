@@ -110,6 +110,7 @@ public:
 		const Context &context,
 		QRect clip,
 		int outerWidth) const;
+	void clearHeavyParts();
 
 	static int MinItemHeight(Type type, int width);
 
@@ -402,6 +403,12 @@ void ListWidget::Section::paint(
 	}
 }
 
+void ListWidget::Section::clearHeavyParts() {
+	for (const auto &item : _items) {
+		item.second->clearHeavyPart();
+	}
+}
+
 TextSelection ListWidget::Section::itemSelection(
 		not_null<const BaseLayout*> item,
 		const Context &context) const {
@@ -1014,9 +1021,27 @@ void ListWidget::visibleTopBottomUpdated(
 	_visibleTop = visibleTop;
 	_visibleBottom = visibleBottom;
 
+	trimHeavyParts();
 	checkMoveToOtherViewer();
 }
 
+void ListWidget::trimHeavyParts() {
+	// Rendered tile pixmaps are only kept for the sections within a
+	// screen height around the viewport, the rest are freed and get
+	// re-rendered from the (locally cached) media when scrolled back.
+	const auto visibleHeight = (_visibleBottom - _visibleTop);
+	if (visibleHeight <= 0) {
+		return;
+	}
+	const auto from = _visibleTop - visibleHeight;
+	const auto till = _visibleBottom + visibleHeight;
+	for (auto &section : _sections) {
+		if (section.bottom() <= from || section.top() >= till) {
+			section.clearHeavyParts();
+		}
+	}
+}
+
 void ListWidget::checkMoveToOtherViewer() {
 	auto visibleHeight = (_visibleBottom - _visibleTop);
 	if (width() <= 0
@@ -263,6 +263,7 @@ private:
 	void switchToWordSelection();
 	void validateTrippleClickStartTime();
 	void checkMoveToOtherViewer();
+	void trimHeavyParts();
 
 	void setActionBoxWeak(QPointer<Ui::RpWidget> box);
 
@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <rpl/then.h>
 #include <rpl/combine.h>
 #include "observer_peer.h"
+#include "base/frame_coalesce.h"
 #include "core/application.h"
 #include "auth_session.h"
 #include "ui/wrap/slide_wrap.h"
@@ -166,6 +167,7 @@ rpl::producer<bool> AmInChannelValue(not_null<ChannelData*> channel) {
 	return Notify::PeerUpdateValue(
 		channel,
 		Notify::PeerUpdate::Flag::ChannelAmIn
+	) | base::coalesce_frames(
 	) | rpl::map([channel] { return channel->amIn(); });
 }
 
@@ -175,6 +177,7 @@ rpl::producer<int> MembersCountValue(not_null<PeerData*> peer) {
 		return Notify::PeerUpdateValue(
 			peer,
 			Flag::MembersChanged
+		) | base::coalesce_frames(
 		) | rpl::map([chat] {
 			return chat->amIn()
 				? std::max(chat->count, int(chat->participants.size()))
@@ -184,6 +187,7 @@ rpl::producer<int> MembersCountValue(not_null<PeerData*> peer) {
 		return Notify::PeerUpdateValue(
 			channel,
 			Flag::MembersChanged
+		) | base::coalesce_frames(
 		) | rpl::map([channel] {
 			return channel->membersCount();
 		});
@@ -197,6 +201,7 @@ rpl::producer<int> AdminsCountValue(not_null<PeerData*> peer) {
 		return Notify::PeerUpdateValue(
 			chat,
 			Flag::AdminsChanged | Flag::RightsChanged
+		) | base::coalesce_frames(
 		) | rpl::map([=] {
 			return chat->participants.empty()
 				? 0
@@ -206,6 +211,7 @@ rpl::producer<int> AdminsCountValue(not_null<PeerData*> peer) {
 		return Notify::PeerUpdateValue(
 			channel,
 			Flag::AdminsChanged | Flag::RightsChanged
+		) | base::coalesce_frames(
 		) | rpl::map([=] {
 			return channel->canViewAdmins()
 				? channel->adminsCount()
@@ -220,6 +226,7 @@ rpl::producer<int> RestrictedCountValue(not_null<ChannelData*> channel) {
 	return Notify::PeerUpdateValue(
 		channel,
 		Flag::BannedUsersChanged | Flag::RightsChanged
+	) | base::coalesce_frames(
 	) | rpl::map([=] {
 		return channel->canViewBanned()
 			? channel->restrictedCount()
@@ -232,6 +239,7 @@ rpl::producer<int> KickedCountValue(not_null<ChannelData*> channel) {
 	return Notify::PeerUpdateValue(
 		channel,
 		Flag::BannedUsersChanged | Flag::RightsChanged
+	) | base::coalesce_frames(
 	) | rpl::map([=] {
 		return channel->canViewBanned()
 			? channel->kickedCount()
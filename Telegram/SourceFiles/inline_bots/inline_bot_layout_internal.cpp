@@ -368,7 +368,7 @@ void Gif::clipCallback(Media::Clip::Notification notification) {
 				auto height = st::inlineMediaHeight;
 				auto frame = countFrameSize();
 				_gif->start(frame.width(), frame.height(), _width, height, ImageRoundRadius::None, RectPart::None);
-			} else if (_gif->autoPausedGif() && !context()->inlineItemVisible(this)) {
+			} else if (_gif->autoPausedGif() && !context()->inlineItemNearVisible(this)) {
 				_gif.reset();
 				getShownDocument()->unload();
 			}
@@ -1409,7 +1409,7 @@ void Game::clipCallback(Media::Clip::Notification notification) {
 				getResultDocument()->unload();
 			} else if (_gif->ready() && !_gif->started()) {
 				_gif->start(_frameSize.width(), _frameSize.height(), st::inlineThumbSize, st::inlineThumbSize, ImageRoundRadius::None, RectPart::None);
-			} else if (_gif->autoPausedGif() && !context()->inlineItemVisible(this)) {
+			} else if (_gif->autoPausedGif() && !context()->inlineItemNearVisible(this)) {
 				_gif.reset();
 				getResultDocument()->unload();
 			}
@@ -39,6 +39,12 @@ public:
 	virtual bool inlineItemVisible(const ItemBase *item) = 0;
 	virtual void inlineItemRepaint(const ItemBase *item) = 0;
 	virtual Data::FileOrigin inlineItemFileOrigin() = 0;
+
+	// Whether the item is within the preload margin around the visible
+	// area, used to keep clip readers alive while scrolling around.
+	virtual bool inlineItemNearVisible(const ItemBase *item) {
+		return inlineItemVisible(item);
+	}
 };
 
 class ItemBase : public LayoutItemBase {
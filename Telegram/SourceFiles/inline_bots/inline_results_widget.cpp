@@ -40,6 +40,10 @@ namespace {
 
 constexpr auto kInlineBotRequestDelay = 400;
 
+// How many result layouts are prepared in one pass. The rest is laid
+// out from a zero timer, after the pending input events are handled.
+constexpr auto kInlineItemsLimitPerPass = 30;
+
 } // namespace
 
 Inner::Inner(QWidget *parent, not_null<Window::Controller*> controller) : TWidget(parent)
@@ -472,6 +476,7 @@ int Inner::refreshInlineRows(PeerData *queryPeer, UserData *bot, const CacheEntr
 	auto count = int(entry->results.size());
 	auto from = validateExistingInlineRows(entry->results);
 	auto added = 0;
+	_inlineRowsIncomplete = false;
 
 	if (count) {
 		_rows.reserve(count);
@@ -479,6 +484,10 @@ int Inner::refreshInlineRows(PeerData *queryPeer, UserData *bot, const CacheEntr
 		row.items.reserve(kInlineItemsMaxPerRow);
 		auto sumWidth = 0;
 		for (auto i = from; i != count; ++i) {
+			if (added >= kInlineItemsLimitPerPass) {
+				_inlineRowsIncomplete = true;
+				break;
+			}
 			if (inlineRowsAddItem(entry->results[i].get(), row, sumWidth)) {
 				++added;
 			}
@@ -722,7 +731,8 @@ Widget::Widget(QWidget *parent, not_null<Window::Controller*> controller) : TWid
 , _controller(controller)
 , _contentMaxHeight(st::emojiPanMaxHeight)
 , _contentHeight(_contentMaxHeight)
-, _scroll(this, st::inlineBotsScroll) {
+, _scroll(this, st::inlineBotsScroll)
+, _continueLayoutsTimer([=] { showInlineRows(false); }) {
 	resize(QRect(0, 0, st::emojiPanWidth, _contentHeight).marginsAdded(innerPadding()).size());
 	_width = width();
 	_height = height();
@@ -1153,6 +1163,11 @@ int Widget::showInlineRows(bool newResults) {
 		if (hidden || _hiding) {
 			showAnimated();
 		}
+		if (_inner->inlineRowsIncomplete()) {
+			// Lay out the rest of the results after the pending input
+			// events are handled, the typing should stay responsive.
+			_continueLayoutsTimer.callOnce(0);
+		}
 	}
 
 	return added;
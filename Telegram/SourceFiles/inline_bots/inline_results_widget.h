@@ -58,6 +58,9 @@ public:
 	void clearSelection();
 
 	int refreshInlineRows(PeerData *queryPeer, UserData *bot, const CacheEntry *results, bool resultsDeleted);
+	bool inlineRowsIncomplete() const {
+		return _inlineRowsIncomplete;
+	}
 	void inlineBotChanged();
 	void hideInlineRowsPanel();
 	void clearInlineRowsPanel();
@@ -137,6 +140,7 @@ private:
 	TimeMs _lastScrolled = 0;
 	base::Timer _updateInlineItems;
 	bool _inlineWithThumb = false;
+	bool _inlineRowsIncomplete = false;
 
 	object_ptr<Ui::RoundButton> _switchPmButton = { nullptr };
 	QString _switchPmStartToken;
@@ -257,6 +261,7 @@ private:
 
 	std::map<QString, std::unique_ptr<internal::CacheEntry>> _inlineCache;
 	QTimer _inlineRequestTimer;
+	base::Timer _continueLayoutsTimer;
 
 	UserData *_inlineBot = nullptr;
 	PeerData *_inlineQueryPeer = nullptr;
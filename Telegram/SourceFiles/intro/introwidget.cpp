@@ -520,8 +520,12 @@ void Widget::paintEvent(QPaintEvent *e) {
 	if (!trivial) {
 		p.setClipRect(e->rect());
 	}
-	p.fillRect(e->rect(), st::windowBg);
 	auto progress = _a_show.current(getms(), 1.);
+	if (!_a_show.animating()) {
+		// During the slide the two cached frames cover the whole
+		// widget, so the background fill would be painted over.
+		p.fillRect(e->rect(), st::windowBg);
+	}
 	if (_a_show.animating()) {
 		auto coordUnder = _showBack ? anim::interpolate(-st::slideShift, 0, progress) : anim::interpolate(0, -st::slideShift, progress);
 		auto coordOver = _showBack ? anim::interpolate(0, width(), progress) : anim::interpolate(width(), 0, progress);
@@ -795,9 +799,13 @@ void Widget::Step::paintContentSnapshot(Painter &p, const QPixmap &snapshot, flo
 }
 
 void Widget::Step::prepareCoverMask() {
-	if (!_coverMask.isNull()) return;
-
-	auto maskWidth = cIntRetinaFactor();
+	// The gradient is rendered at the full cover width, so painting
+	// it during the cover animation is a plain blit of the prepared
+	// pixmap and not a per-frame stretch of a one pixel column.
+	auto maskWidth = width() * cIntRetinaFactor();
+	if (!_coverMask.isNull() && _coverMask.width() == maskWidth) {
+		return;
+	}
 	auto maskHeight = st::introCoverHeight * cIntRetinaFactor();
 	auto mask = QImage(maskWidth, maskHeight, QImage::Format_ARGB32_Premultiplied);
 	auto maskInts = reinterpret_cast<uint32*>(mask.bits());
@@ -819,6 +827,9 @@ void Widget::Step::prepareCoverMask() {
 void Widget::Step::paintCover(Painter &p, int top) {
 	auto coverHeight = top + st::introCoverHeight;
 	if (coverHeight > 0) {
+		if (_coverMask.width() != width() * cIntRetinaFactor()) {
+			prepareCoverMask();
+		}
 		p.drawPixmap(QRect(0, 0, width(), coverHeight), _coverMask, QRect(0, -top * cIntRetinaFactor(), _coverMask.width(), coverHeight * cIntRetinaFactor()));
 	}
 
@@ -19,7 +19,13 @@ namespace Lang {
 namespace {
 
 const auto kSerializeVersionTag = qsl("#new");
-constexpr auto kSerializeVersion = 1;
+
+// Version 2 additionally stores the resolved key index next to each
+// key, so loading a cached langpack at startup skips the by-name key
+// resolution. The indexes come from the generated enum and stay valid
+// only within one build, so they are trusted only when the cache was
+// written by the same app version and recomputed otherwise.
+constexpr auto kSerializeVersion = 2;
 constexpr auto kDefaultLanguage = str_const("en");
 constexpr auto kCloudLangPackName = str_const("tdesktop");
 constexpr auto kCustomLanguage = str_const("#custom");
@@ -192,10 +198,10 @@ QString PluralCodeForCustom(
 
 template <typename Save>
 void ParseKeyValue(
+		LangKey index,
 		const QByteArray &key,
 		const QByteArray &value,
 		Save &&save) {
-	const auto index = GetKeyIndex(QLatin1String(key));
 	if (index != kLangKeysCount) {
 		ValueParser parser(key, index, value);
 		if (parser.parse()) {
@@ -207,6 +213,18 @@ void ParseKeyValue(
 	}
 }
 
+template <typename Save>
+void ParseKeyValue(
+		const QByteArray &key,
+		const QByteArray &value,
+		Save &&save) {
+	ParseKeyValue(
+		GetKeyIndex(QLatin1String(key)),
+		key,
+		value,
+		std::forward<Save>(save));
+}
+
 } // namespace
 
 QString DefaultLanguageId() {
@@ -383,7 +401,8 @@ QByteArray Instance::serialize() const {
 		+ sizeof(qint32); // _nonDefaultValues.size()
 	for (auto &nonDefault : _nonDefaultValues) {
 		size += Serialize::bytearraySize(nonDefault.first)
-			+ Serialize::bytearraySize(nonDefault.second);
+			+ Serialize::bytearraySize(nonDefault.second)
+			+ sizeof(qint32); // key index
 	}
 	const auto base = _base ? _base->serialize() : QByteArray();
 	size += Serialize::bytearraySize(base);
@@ -406,7 +425,10 @@ QByteArray Instance::serialize() const {
 			<< _customFileContent
 			<< qint32(_nonDefaultValues.size());
 		for (const auto &nonDefault : _nonDefaultValues) {
-			stream << nonDefault.first << nonDefault.second;
+			stream
+				<< nonDefault.first
+				<< nonDefault.second
+				<< qint32(GetKeyIndex(QLatin1String(nonDefault.first)));
 		}
 		stream << base;
 	}
@@ -437,7 +459,7 @@ void Instance::fillFromSerialized(
 			>> nonDefaultValuesCount;
 	} else {
 		stream >> serializeVersion;
-		if (serializeVersion == kSerializeVersion) {
+		if (serializeVersion == 1 || serializeVersion == kSerializeVersion) {
 			stream
 				>> id
 				>> pluralId
@@ -479,11 +501,22 @@ void Instance::fillFromSerialized(
 		}
 	}
 
+	// Key indexes from the cache are valid only for the exact build
+	// that wrote them, an older or newer one resolves keys by name.
+	const auto keyIndexesTrusted = !legacyFormat
+		&& (serializeVersion >= 2)
+		&& (dataAppVersion == AppVersion);
 	std::vector<QByteArray> nonDefaultStrings;
+	std::vector<LangKey> nonDefaultIndices;
 	nonDefaultStrings.reserve(2 * nonDefaultValuesCount);
+	nonDefaultIndices.reserve(nonDefaultValuesCount);
 	for (auto i = 0; i != nonDefaultValuesCount; ++i) {
 		QByteArray key, value;
+		qint32 keyIndex = kLangKeysCount;
 		stream >> key >> value;
+		if (!legacyFormat && serializeVersion >= 2) {
+			stream >> keyIndex;
+		}
 		if (stream.status() != QDataStream::Ok) {
 			LOG(("Lang Error: "
 				"Could not read data from serialized langpack."));
@@ -492,6 +525,10 @@ void Instance::fillFromSerialized(
 
 		nonDefaultStrings.push_back(key);
 		nonDefaultStrings.push_back(value);
+		nonDefaultIndices.push_back(
+			(keyIndexesTrusted && keyIndex >= 0 && keyIndex < kLangKeysCount)
+			? LangKey(keyIndex)
+			: kLangKeysCount);
 	}
 
 	_base = nullptr;
@@ -534,8 +571,14 @@ void Instance::fillFromSerialized(
 	_customFilePathRelative = customFilePathRelative;
 	_customFileContent = customFileContent;
 	LOG(("Lang Info: Loaded cached, keys: %1").arg(nonDefaultValuesCount));
-	for (auto i = 0, count = nonDefaultValuesCount * 2; i != count; i += 2) {
-		applyValue(nonDefaultStrings[i], nonDefaultStrings[i + 1]);
+	for (auto i = 0; i != nonDefaultValuesCount; ++i) {
+		const auto &key = nonDefaultStrings[2 * i];
+		const auto &value = nonDefaultStrings[2 * i + 1];
+		if (nonDefaultIndices[i] != kLangKeysCount) {
+			applyValue(key, value, nonDefaultIndices[i]);
+		} else {
+			applyValue(key, value);
+		}
 	}
 	updatePluralRules();
 }
@@ -746,6 +789,21 @@ void Instance::applyValue(const QByteArray &key, const QByteArray &value) {
 	});
 }
 
+void Instance::applyValue(
+		const QByteArray &key,
+		const QByteArray &value,
+		LangKey keyIndex) {
+	_nonDefaultValues[key] = value;
+	ParseKeyValue(keyIndex, key, value, [&](LangKey key, QString &&value) {
+		_nonDefaultSet[key] = 1;
+		if (!_derived) {
+			_values[key] = std::move(value);
+		} else if (!_derived->_nonDefaultSet[key]) {
+			_derived->_values[key] = std::move(value);
+		}
+	});
+}
+
 void Instance::updatePluralRules() {
 	if (_pluralId.isEmpty()) {
 		_pluralId = isCustom()
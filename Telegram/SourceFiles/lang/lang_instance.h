@@ -103,7 +103,11 @@ public:
 		return _updated;
 	}
 
-	QString getValue(LangKey key) const {
+	// Returned by reference: some strings resolve thousands of times
+	// per second on paint paths and the atomic ref count bump of a
+	// QString copy is measurable there. The reference stays valid
+	// until the values change, which only happens on the main thread.
+	const QString &getValue(LangKey key) const {
 		Expects(key >= 0 && key < _values.size());
 
 		return _values[key];
@@ -126,6 +130,10 @@ private:
 
 	void applyDifferenceToMe(const MTPDlangPackDifference &difference);
 	void applyValue(const QByteArray &key, const QByteArray &value);
+	void applyValue(
+		const QByteArray &key,
+		const QByteArray &value,
+		LangKey keyIndex);
 	void resetValue(const QByteArray &key);
 	void reset(const Language &language);
 	void fillFromCustomContent(
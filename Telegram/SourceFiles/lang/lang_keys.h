@@ -10,7 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "lang/lang_instance.h"
 #include "lang/lang_hardcoded.h"
 
-inline QString lang(LangKey key) {
+inline const QString &lang(LangKey key) {
 	return Lang::Current().getValue(key);
 }
 
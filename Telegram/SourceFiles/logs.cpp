@@ -239,10 +239,86 @@ LogsInMemoryList *DeletedLogsInMemory = SharedMemoryLocation<LogsInMemoryList, 0
 
 QString LogsBeforeSingleInstanceChecked; // LogsInMemory already dumped in LogsData, but LogsData is about to be deleted
 
+// Debug / tcp / mtp entries are formatted on the logging thread as before,
+// but written to disk by this worker, so enabling debug logs does not add
+// file I/O stalls to the main and MTP threads. The queue is bounded - under
+// pressure the newest entries are dropped and counted, and a warning with
+// the dropped amount is written once the writer catches up. The main log
+// is not routed here, it is rare and must reach the disk before a crash.
+class LogsWriteThread : public QThread {
+public:
+	static const int kQueueLimit = 8192;
+
+	void enqueue(LogDataType type, const QString &msg) {
+		QMutexLocker lock(&_mutex);
+		if (_queue.size() >= kQueueLimit) {
+			++_dropped;
+			return;
+		}
+		_queue.push_back(qMakePair(type, msg));
+		_condition.wakeOne();
+	}
+
+	void finish() {
+		{
+			QMutexLocker lock(&_mutex);
+			_finished = true;
+			_condition.wakeOne();
+		}
+		wait();
+	}
+
+protected:
+	void run() override {
+		while (true) {
+			LogsInMemoryList batch;
+			int32 dropped = 0;
+			bool finished = false;
+			{
+				QMutexLocker lock(&_mutex);
+				while (_queue.isEmpty() && !_dropped && !_finished) {
+					_condition.wait(&_mutex);
+				}
+				std::swap(batch, _queue);
+				dropped = _dropped;
+				_dropped = 0;
+				finished = _finished;
+			}
+			for (LogsInMemoryList::const_iterator i = batch.cbegin(), e = batch.cend(); i != e; ++i) {
+				if (LogsData) {
+					LogsData->write(i->first, i->second);
+				}
+			}
+			if (dropped && LogsData) {
+				LogsData->write(LogDataDebug, QString("%1 WARNING: logs queue overflow, %2 entries dropped!\n").arg(_logsEntryStart()).arg(dropped));
+			}
+			if (finished) {
+				return;
+			}
+		}
+	}
+
+private:
+	QMutex _mutex;
+	QWaitCondition _condition;
+	LogsInMemoryList _queue;
+	int32 _dropped = 0;
+	bool _finished = false;
+
+};
+
+LogsWriteThread *LogsWriter = 0;
+
 void _logsWrite(LogDataType type, const QString &msg) {
 	if (LogsData && (type == LogDataMain || LogsStartIndexChosen < 0)) {
-		if (type == LogDataMain || Logs::DebugEnabled()) {
+		if (type == LogDataMain) {
 			LogsData->write(type, msg);
+		} else if (Logs::DebugEnabled()) {
+			if (LogsWriter) {
+				LogsWriter->enqueue(type, msg);
+			} else {
+				LogsData->write(type, msg);
+			}
 		}
 	} else if (LogsInMemory != DeletedLogsInMemory) {
 		if (!LogsInMemory) {
@@ -446,6 +522,12 @@ void start(not_null<Core::Launcher*> launcher) {
 }
 
 void finish() {
+	if (LogsWriter) { // Flush the pending entries and join before closing the files.
+		LogsWriter->finish();
+		delete LogsWriter;
+		LogsWriter = 0;
+	}
+
 	delete LogsData;
 	LogsData = 0;
 
@@ -475,6 +557,13 @@ bool instanceChecked() {
 		return false;
 	}
 
+	// Debug logs are written from now on, spawn the writer thread
+	// before replaying the entries collected in memory at startup.
+	if (!LogsWriter) {
+		LogsWriter = new LogsWriteThread();
+		LogsWriter->start();
+	}
+
 	if (LogsInMemory) {
 		Assert(LogsInMemory != DeletedLogsInMemory);
 		LogsInMemoryList list = *LogsInMemory;
@@ -380,6 +380,7 @@ MainWidget::MainWidget(
 , _failDifferenceTimer([=] { getDifferenceAfterFail(); })
 , _cacheBackgroundTimer([=] { cacheBackground(); })
 , _viewsIncrementTimer([=] { viewsIncrement(); }) {
+	_updatesReplayTimer.setCallback([=] { replayNextRecordedUpdate(); });
 	_controller->setDefaultFloatPlayerDelegate(floatPlayerDelegate());
 	_controller->floatPlayerClosed(
 	) | rpl::start_with_next([=](FullMsgId itemId) {
@@ -811,7 +812,12 @@ void MainWidget::hiderLayer(base::unique_qptr<Window::HistoryHider> hider) {
 		dialogsToUp();
 
 		_hider->hide();
-		auto animationParams = prepareDialogsAnimation();
+
+		// The grabs are the expensive part of the slide animation,
+		// skip them when the animation wouldn't play anyway.
+		auto animationParams = anim::Disabled()
+			? Window::SectionSlideParams()
+			: prepareDialogsAnimation();
 
 		if (_mainSection) {
 			_mainSection->hide();
@@ -821,7 +827,13 @@ void MainWidget::hiderLayer(base::unique_qptr<Window::HistoryHider> hider) {
 		if (_dialogs->isHidden()) {
 			_dialogs->show();
 			updateControlsGeometry();
-			_dialogs->showAnimated(Window::SlideDirection::FromLeft, animationParams);
+			if (animationParams) {
+				_dialogs->showAnimated(
+					Window::SlideDirection::FromLeft,
+					animationParams);
+			} else {
+				_dialogs->showFast();
+			}
 		}
 	} else {
 		_hider->show();
@@ -1837,7 +1849,8 @@ void MainWidget::ui_showPeerHistory(
 	auto animatedShow = [&] {
 		if (_a_show.animating()
 			|| Core::App().locked()
-			|| (params.animated == anim::type::instant)) {
+			|| (params.animated == anim::type::instant)
+			|| anim::Disabled()) {
 			return false;
 		}
 		if (!peerId) {
@@ -2147,7 +2160,8 @@ void MainWidget::showNewSection(
 		if (_a_show.animating()
 			|| Core::App().locked()
 			|| (params.animated == anim::type::instant)
-			|| memento.instant()) {
+			|| memento.instant()
+			|| anim::Disabled()) {
 			return false;
 		}
 		if (!Adaptive::OneColumn() && params.way == SectionShow::Way::ClearStack) {
@@ -3426,6 +3440,8 @@ void MainWidget::start() {
 	session().api().requestNotifySettings(MTP_inputNotifyBroadcasts());
 
 	Local::readSavedPeers();
+	Local::readSharedMediaCounts();
+	_dialogs->restoreDialogsSnapshot();
 	cSetOtherOnline(0);
 	session().user()->loadUserpic();
 
@@ -3444,6 +3460,16 @@ void MainWidget::start() {
 
 	_history->start();
 
+	// Show the chat that was opened when the app was quit, so that
+	// the restart lands where the previous session ended.
+	if (const auto peerId = session().settings().lastOpenPeer()) {
+		if (const auto peer = session().data().peerLoaded(peerId)) {
+			if (!_history->peer()) {
+				Ui::showPeerHistory(peer, ShowAtUnreadMsgId);
+			}
+		}
+	}
+
 	Core::App().checkStartUrl();
 }
 
@@ -3749,6 +3775,13 @@ MainWidget::~MainWidget() {
 	if (App::main() == this) {
 		_history->showHistory(0, 0);
 	}
+
+	// On quit this runs before the session is destroyed, so the dialogs
+	// list state can still be collected. On logout the session is already
+	// gone here and the snapshot was cleared together with the local data.
+	if (AuthSession::Exists()) {
+		Local::writeDialogsSnapshot(_dialogs->collectDialogsSnapshot());
+	}
 }
 
 void MainWidget::updateOnline(bool gotOtherOffline) {
@@ -3915,7 +3948,117 @@ void MainWidget::updateReceived(const mtpPrime *from, const mtpPrime *end) {
 	update();
 }
 
+void MainWidget::updatesReceived(MTPUpdates &&updates) {
+	session().checkAutoLock();
+
+	_lastUpdateTime = getms(true);
+	_noUpdatesTimer.callOnce(kNoUpdatesTimeout);
+	if (!requestingDifference()
+		|| HasForceLogoutNotification(updates)) {
+		feedUpdates(updates);
+	}
+	update();
+}
+
+bool MainWidget::recordingUpdates() const {
+	return (_updatesRecordFile != nullptr);
+}
+
+void MainWidget::toggleUpdatesRecording() {
+	if (_updatesRecordFile) {
+		_updatesRecordFile = nullptr;
+		return;
+	}
+	auto file = std::make_unique<QFile>(
+		cWorkingDir() + qsl("updates.tdrec"));
+	if (file->open(QIODevice::WriteOnly)) {
+		_updatesRecordFile = std::move(file);
+		_updatesRecordStartTime = getms();
+	}
+}
+
+void MainWidget::writeRecordedUpdates(const MTPUpdates &updates) {
+	auto buffer = mtpBuffer();
+	updates.write(buffer);
+	const auto offset = qint32(getms() - _updatesRecordStartTime);
+	const auto count = qint32(buffer.size());
+	_updatesRecordFile->write(
+		reinterpret_cast<const char*>(&offset),
+		sizeof(offset));
+	_updatesRecordFile->write(
+		reinterpret_cast<const char*>(&count),
+		sizeof(count));
+	_updatesRecordFile->write(
+		reinterpret_cast<const char*>(buffer.constData()),
+		count * sizeof(mtpPrime));
+}
+
+bool MainWidget::replayRecordedUpdates(bool instant) {
+	if (_updatesRecordFile) {
+		toggleUpdatesRecording();
+	}
+	auto file = QFile(cWorkingDir() + qsl("updates.tdrec"));
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	_updatesReplayQueue.clear();
+	_updatesReplayIndex = 0;
+	while (!file.atEnd()) {
+		auto offset = qint32(0);
+		auto count = qint32(0);
+		if (file.read(
+				reinterpret_cast<char*>(&offset),
+				sizeof(offset)) != sizeof(offset)
+			|| file.read(
+				reinterpret_cast<char*>(&count),
+				sizeof(count)) != sizeof(count)
+			|| count <= 0) {
+			break;
+		}
+		auto buffer = mtpBuffer(count);
+		const auto bytes = count * qint64(sizeof(mtpPrime));
+		if (file.read(
+				reinterpret_cast<char*>(buffer.data()),
+				bytes) != bytes) {
+			break;
+		}
+		_updatesReplayQueue.push_back({ TimeMs(offset), buffer });
+	}
+	if (_updatesReplayQueue.empty()) {
+		return false;
+	}
+	_updatesReplayInstant = instant;
+	_updatesReplayStartTime = getms();
+	replayNextRecordedUpdate();
+	return true;
+}
+
+void MainWidget::replayNextRecordedUpdate() {
+	while (_updatesReplayIndex < int(_updatesReplayQueue.size())) {
+		const auto &[offset, buffer]
+			= _updatesReplayQueue[_updatesReplayIndex];
+		const auto passed = getms() - _updatesReplayStartTime;
+		if (!_updatesReplayInstant && offset > passed) {
+			_updatesReplayTimer.callOnce(offset - passed);
+			return;
+		}
+		++_updatesReplayIndex;
+		try {
+			auto updates = MTPUpdates();
+			const mtpPrime *from = buffer.constData();
+			updates.read(from, from + buffer.size());
+			feedUpdates(updates);
+		} catch (mtpErrorUnexpected &) { // just some other type
+		}
+	}
+	_updatesReplayQueue.clear();
+	_updatesReplayIndex = 0;
+}
+
 void MainWidget::feedUpdates(const MTPUpdates &updates, uint64 randomId) {
+	if (_updatesRecordFile) {
+		writeRecordedUpdates(updates);
+	}
 	switch (updates.type()) {
 	case mtpc_updates: {
 		auto &d = updates.c_updates();
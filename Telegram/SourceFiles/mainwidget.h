@@ -121,6 +121,13 @@ public:
 
 	void activate();
 	void updateReceived(const mtpPrime *from, const mtpPrime *end);
+	void updatesReceived(MTPUpdates &&updates);
+
+	// Deterministic replay of recorded update streams for profiling,
+	// driven by the "recordupdates" / "replayupdates" settings codes.
+	bool recordingUpdates() const;
+	void toggleUpdatesRecording();
+	bool replayRecordedUpdates(bool instant);
 
 	void createDialog(Dialogs::Key key);
 	void removeDialog(Dialogs::Key key);
@@ -253,6 +260,8 @@ public:
 
 	void ptsWaiterStartTimerFor(ChannelData *channel, int32 ms); // ms <= 0 - stop timer
 	void feedUpdates(const MTPUpdates &updates, uint64 randomId = 0);
+	void writeRecordedUpdates(const MTPUpdates &updates);
+	void replayNextRecordedUpdate();
 
 	void ctrlEnterSubmitUpdated();
 	void setInnerFocus();
@@ -526,6 +535,15 @@ private:
 	QMap<int32, MTPUpdates> _bySeqUpdates;
 	base::Timer _bySeqTimer;
 
+	// Recording / replaying of the update stream for profiling.
+	std::unique_ptr<QFile> _updatesRecordFile;
+	TimeMs _updatesRecordStartTime = 0;
+	std::vector<std::pair<TimeMs, mtpBuffer>> _updatesReplayQueue;
+	int _updatesReplayIndex = 0;
+	TimeMs _updatesReplayStartTime = 0;
+	bool _updatesReplayInstant = false;
+	base::Timer _updatesReplayTimer;
+
 	base::Timer _byMinChannelTimer;
 
 	mtpRequestId _onlineRequest = 0;
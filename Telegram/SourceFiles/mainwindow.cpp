@@ -46,6 +46,10 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace {
 
+constexpr auto kFrameBudgetCheckPeriod = TimeMs(100);
+constexpr auto kFrameBudgetStallThreshold = TimeMs(34);
+constexpr auto kFrameBudgetRecoverPeriod = TimeMs(2000);
+
 // Code for testing languages is F7-F6-F7-F8
 void FeedLangTestingKey(int key) {
 	static auto codeState = 0;
@@ -101,6 +105,40 @@ MainWindow::MainWindow() {
 
 	setAttribute(Qt::WA_NoSystemBackground);
 	setAttribute(Qt::WA_OpaquePaintEvent);
+
+	_frameBudgetTimer.setCallback([=] { checkFrameBudget(); });
+	_frameBudgetTimer.callEach(kFrameBudgetCheckPeriod);
+}
+
+// The timer above is expected to tick each kFrameBudgetCheckPeriod, so
+// how late it fires shows for how long the main loop was not serviced.
+// While the deadline misses keep coming we pause the optional repaint
+// work (gif autoplay) and resume it after a calm period.
+void MainWindow::checkFrameBudget() {
+	const auto controller = this->controller();
+	if (!controller) {
+		_frameBudgetLastTickTime = 0;
+		_frameBudgetOverloaded = false;
+		return;
+	}
+	const auto now = getms();
+	const auto expected = _frameBudgetLastTickTime
+		? (_frameBudgetLastTickTime + kFrameBudgetCheckPeriod)
+		: now;
+	_frameBudgetLastTickTime = now;
+	if (now - expected >= kFrameBudgetStallThreshold) {
+		_frameBudgetLastStallTime = now;
+		if (!_frameBudgetOverloaded) {
+			_frameBudgetOverloaded = true;
+			controller->enableGifPauseReason(
+				Window::GifPauseReason::Overload);
+		}
+	} else if (_frameBudgetOverloaded
+		&& (now - _frameBudgetLastStallTime >= kFrameBudgetRecoverPeriod)) {
+		_frameBudgetOverloaded = false;
+		controller->disableGifPauseReason(
+			Window::GifPauseReason::Overload);
+	}
 }
 
 void MainWindow::initHook() {
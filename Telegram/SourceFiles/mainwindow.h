@@ -154,6 +154,8 @@ private:
 	void ensureLayerCreated();
 	void destroyLayer();
 
+	void checkFrameBudget();
+
 	void themeUpdated(const Window::Theme::BackgroundUpdate &data);
 
 	QPixmap grabInner();
@@ -163,6 +165,12 @@ private:
 
 	TimeMs _lastTrayClickTime = 0;
 
+	// Pauses gif autoplay while the main loop misses frame deadlines.
+	base::Timer _frameBudgetTimer;
+	TimeMs _frameBudgetLastTickTime = 0;
+	TimeMs _frameBudgetLastStallTime = 0;
+	bool _frameBudgetOverloaded = false;
+
 	object_ptr<Window::PasscodeLockWidget> _passcodeLock = { nullptr };
 	object_ptr<Intro::Widget> _intro = { nullptr };
 	object_ptr<MainWidget> _main = { nullptr };
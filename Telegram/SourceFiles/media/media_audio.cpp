@@ -15,6 +15,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/media_audio_track.h"
 #include "platform/platform_audio.h"
 #include "core/application.h"
+#include "core/sampling_profiler.h"
 #include "facades.h"
 
 #include <AL/al.h>
@@ -357,12 +358,17 @@ void Mixer::Track::reattach(AudioMsgId::Type type) {
 	}
 
 	createStream(type);
+	auto count = 0;
 	for (auto i = 0; i != kBuffersCount; ++i) {
 		if (!samplesCount[i]) {
 			break;
 		}
 		alBufferData(stream.buffers[i], format, bufferSamples[i].constData(), bufferSamples[i].size(), frequency);
-		alSourceQueueBuffers(stream.source, 1, stream.buffers + i);
+		++count;
+	}
+	if (count > 0) {
+		// Queue all the refilled buffers with a single call.
+		alSourceQueueBuffers(stream.source, count, stream.buffers);
 	}
 
 	alSourcei(stream.source, AL_SAMPLE_OFFSET, qMax(state.position - bufferedPosition, 0LL));
@@ -435,40 +441,45 @@ void Mixer::Track::ensureStreamCreated(AudioMsgId::Type type) {
 
 int Mixer::Track::getNotQueuedBufferIndex() {
 	// See if there are no free buffers right now.
-	while (samplesCount[kBuffersCount - 1] != 0) {
-		// Try to unqueue some buffer.
+	if (samplesCount[kBuffersCount - 1] != 0) {
+		// Unqueue all processed buffers with a single call instead
+		// of going to the driver one buffer at a time.
 		ALint processed = 0;
 		alGetSourcei(stream.source, AL_BUFFERS_PROCESSED, &processed);
 		if (processed < 1) { // No processed buffers, wait.
 			return -1;
 		}
-
-		// Unqueue some processed buffer.
-		ALuint buffer = 0;
-		alSourceUnqueueBuffers(stream.source, 1, &buffer);
-
-		// Find it in the list and clear it.
-		bool found = false;
-		for (auto i = 0; i != kBuffersCount; ++i) {
-			if (stream.buffers[i] == buffer) {
-				auto samplesInBuffer = samplesCount[i];
-				bufferedPosition += samplesInBuffer;
-				bufferedLength -= samplesInBuffer;
-				for (auto j = i + 1; j != kBuffersCount; ++j) {
-					samplesCount[j - 1] = samplesCount[j];
-					stream.buffers[j - 1] = stream.buffers[j];
-					bufferSamples[j - 1] = bufferSamples[j];
+		accumulate_min(processed, ALint(kBuffersCount));
+
+		ALuint buffers[kBuffersCount] = { 0 };
+		alSourceUnqueueBuffers(stream.source, processed, buffers);
+
+		for (auto b = 0; b != int(processed); ++b) {
+			const auto buffer = buffers[b];
+
+			// Find it in the list and clear it.
+			bool found = false;
+			for (auto i = 0; i != kBuffersCount; ++i) {
+				if (stream.buffers[i] == buffer) {
+					auto samplesInBuffer = samplesCount[i];
+					bufferedPosition += samplesInBuffer;
+					bufferedLength -= samplesInBuffer;
+					for (auto j = i + 1; j != kBuffersCount; ++j) {
+						samplesCount[j - 1] = samplesCount[j];
+						stream.buffers[j - 1] = stream.buffers[j];
+						bufferSamples[j - 1] = bufferSamples[j];
+					}
+					samplesCount[kBuffersCount - 1] = 0;
+					stream.buffers[kBuffersCount - 1] = buffer;
+					bufferSamples[kBuffersCount - 1] = QByteArray();
+					found = true;
+					break;
 				}
-				samplesCount[kBuffersCount - 1] = 0;
-				stream.buffers[kBuffersCount - 1] = buffer;
-				bufferSamples[kBuffersCount - 1] = QByteArray();
-				found = true;
-				break;
 			}
-		}
-		if (!found) {
-			LOG(("Audio Error: Could not find the unqueued buffer! Buffer %1 in source %2 with processed count %3").arg(buffer).arg(stream.source).arg(processed));
-			return -1;
+			if (!found) {
+				LOG(("Audio Error: Could not find the unqueued buffer! Buffer %1 in source %2 with processed count %3").arg(buffer).arg(stream.source).arg(processed));
+				return -1;
+			}
 		}
 	}
 
@@ -1202,6 +1213,7 @@ Fader::Fader(QThread *thread) : QObject()
 }
 
 void Fader::onInit() {
+	Profiling::RegisterCurrentThread("audio_fader");
 }
 
 void Fader::onTimer() {
@@ -1632,13 +1644,24 @@ public:
 
 		auto fmt = format();
 		auto peak = uint16(0);
-		auto callback = [&](uint16 sample) {
-			accumulate_max(peak, sample);
-			sumbytes += Media::Player::kWaveformSamplesCount;
-			if (sumbytes >= countbytes) {
-				sumbytes -= countbytes;
-				peaks.push_back(peak);
-				peak = 0;
+		const auto kCount = int64(Media::Player::kWaveformSamplesCount);
+		auto feed = [&](auto *samples, int64 count) {
+			// Process whole peak buckets at once instead of keeping
+			// the bucket accounting in a per-sample callback, so the
+			// peak extraction itself is a vectorizable max-reduction.
+			while (count > 0) {
+				const auto left = (countbytes - sumbytes + kCount - 1)
+					/ kCount;
+				const auto take = qMin(count, left);
+				accumulate_max(peak, Media::Audio::SamplesPeak(samples, take));
+				samples += take;
+				count -= take;
+				sumbytes += take * kCount;
+				if (sumbytes >= countbytes) {
+					sumbytes -= countbytes;
+					peaks.push_back(peak);
+					peak = 0;
+				}
 			}
 		};
 		while (processed < countbytes) {
@@ -1653,11 +1676,10 @@ public:
 				continue;
 			}
 
-			auto sampleBytes = bytes::make_span(buffer);
 			if (fmt == AL_FORMAT_MONO8 || fmt == AL_FORMAT_STEREO8) {
-				Media::Audio::IterateSamples<uchar>(sampleBytes, callback);
+				feed(reinterpret_cast<const uchar*>(buffer.constData()), buffer.size());
 			} else if (fmt == AL_FORMAT_MONO16 || fmt == AL_FORMAT_STEREO16) {
-				Media::Audio::IterateSamples<int16>(sampleBytes, callback);
+				feed(reinterpret_cast<const int16*>(buffer.constData()), int64(buffer.size() / sizeof(int16)));
 			}
 			processed += sampleSize() * samples;
 		}
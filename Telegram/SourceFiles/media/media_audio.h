@@ -349,5 +349,16 @@ void IterateSamples(bytes::const_span bytes, Callback &&callback) {
 	}
 }
 
+// Peak of a run of samples in a tight loop, so that the compiler
+// can vectorize it, unlike IterateSamples with a per-sample callback.
+template <typename SampleType>
+uint16 SamplesPeak(const SampleType *data, int64 count) {
+	auto result = uint16(0);
+	for (auto i = int64(0); i != count; ++i) {
+		accumulate_max(result, ReadOneSample(data[i]));
+	}
+	return result;
+}
+
 } // namespace Audio
 } // namespace Media
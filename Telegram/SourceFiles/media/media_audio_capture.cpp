@@ -504,16 +504,26 @@ void Instance::Inner::onTimeout() {
 		auto skipSamples = kCaptureSkipDuration * kCaptureFrequency / 1000;
 		auto fadeSamples = kCaptureFadeInDuration * kCaptureFrequency / 1000;
 		auto levelindex = d->fullSamples + static_cast<int>(s / sizeof(short));
-		for (auto ptr = (const short*)(_captured.constData() + s), end = (const short*)(_captured.constData() + news); ptr < end; ++ptr, ++levelindex) {
+		auto pointer = (const short*)(_captured.constData() + s);
+		auto left = static_cast<int>(samples);
+		// The skip and fade-in regions pass only once at the start of
+		// the recording, the steady part takes the vectorized scan.
+		while (left > 0 && levelindex < skipSamples + fadeSamples) {
 			if (levelindex > skipSamples) {
-				uint16 value = qAbs(*ptr);
-				if (levelindex < skipSamples + fadeSamples) {
-					value = qRound(value * float64(levelindex - skipSamples) / fadeSamples);
-				}
+				uint16 value = qAbs(*pointer);
+				value = qRound(value * float64(levelindex - skipSamples) / fadeSamples);
 				if (d->levelMax < value) {
 					d->levelMax = value;
 				}
 			}
+			++pointer;
+			++levelindex;
+			--left;
+		}
+		if (left > 0) {
+			accumulate_max(
+				d->levelMax,
+				Media::Audio::SamplesPeak(pointer, left));
 		}
 		qint32 samplesFull = d->fullSamples + _captured.size() / sizeof(short), samplesSinceUpdate = samplesFull - d->lastUpdate;
 		if (samplesSinceUpdate > AudioVoiceMsgUpdateView * kCaptureFrequency / 1000) {
@@ -10,6 +10,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "media/media_audio.h"
 #include "media/media_audio_ffmpeg_loader.h"
 #include "media/media_child_ffmpeg_loader.h"
+#include "core/sampling_profiler.h"
 
 namespace Media {
 namespace Player {
@@ -83,6 +84,7 @@ void Loaders::clearFromVideoQueue() {
 }
 
 void Loaders::onInit() {
+	Profiling::RegisterCurrentThread("audio_loader");
 }
 
 void Loaders::onStart(const AudioMsgId &audio, qint64 positionMs) {
@@ -284,31 +286,41 @@ AudioPlayerLoader *Loaders::setupLoader(
 		SetupError &err,
 		TimeMs positionMs) {
 	err = SetupErrorAtStart;
-	QMutexLocker lock(internal::audioPlayerMutex());
-	if (!mixer()) return nullptr;
-
-	auto track = mixer()->trackForType(audio.type());
-	if (!track || track->state.id != audio || !track->loading) {
-		emit error(audio);
-		LOG(("Audio Error: trying to load part of audio, that is not current at the moment"));
-		err = SetupErrorNotPlaying;
-		return nullptr;
-	}
 
-	bool isGoodId = false;
 	AudioPlayerLoader *l = nullptr;
-	switch (audio.type()) {
-	case AudioMsgId::Type::Voice: l = _audioLoader.get(); isGoodId = (_audio == audio); break;
-	case AudioMsgId::Type::Song: l = _songLoader.get(); isGoodId = (_song == audio); break;
-	case AudioMsgId::Type::Video: l = _videoLoader.get(); isGoodId = (_video == audio); break;
-	}
+	{
+		QMutexLocker lock(internal::audioPlayerMutex());
+		if (!mixer()) return nullptr;
 
-	if (l && (!isGoodId || !l->check(track->file, track->data))) {
-		clear(audio.type());
-		l = nullptr;
-	}
+		auto track = mixer()->trackForType(audio.type());
+		if (!track || track->state.id != audio || !track->loading) {
+			emit error(audio);
+			LOG(("Audio Error: trying to load part of audio, that is not current at the moment"));
+			err = SetupErrorNotPlaying;
+			return nullptr;
+		}
+
+		bool isGoodId = false;
+		switch (audio.type()) {
+		case AudioMsgId::Type::Voice: l = _audioLoader.get(); isGoodId = (_audio == audio); break;
+		case AudioMsgId::Type::Song: l = _songLoader.get(); isGoodId = (_song == audio); break;
+		case AudioMsgId::Type::Video: l = _videoLoader.get(); isGoodId = (_video == audio); break;
+		}
+
+		if (l && (!isGoodId || !l->check(track->file, track->data))) {
+			clear(audio.type());
+			l = nullptr;
+		}
+
+		if (l) {
+			if (track->loaded) {
+				err = SetupErrorLoadedFull;
+				LOG(("Audio Error: trying to load part of audio, that is already loaded to the end"));
+				return nullptr;
+			}
+			return l;
+		}
 
-	if (!l) {
 		std::unique_ptr<AudioPlayerLoader> *loader = nullptr;
 		switch (audio.type()) {
 		case AudioMsgId::Type::Voice: _audio = audio; loader = &_audioLoader; break;
@@ -329,24 +341,30 @@ AudioPlayerLoader *Loaders::setupLoader(
 			*loader = std::make_unique<FFMpegLoader>(track->file, track->data, bytes::vector());
 		}
 		l = loader->get();
+	}
 
-		if (!l->open(positionMs)) {
-			track->state.state = State::StoppedAtStart;
-			return nullptr;
-		}
-		auto length = l->samplesCount();
-		if (length <= 0) {
-			track->state.state = State::StoppedAtStart;
-			return nullptr;
-		}
-		track->state.length = length;
-		track->state.frequency = l->samplesFrequency();
-		err = SetupNoErrorStarted;
-	} else if (track->loaded) {
-		err = SetupErrorLoadedFull;
-		LOG(("Audio Error: trying to load part of audio, that is already loaded to the end"));
+	// Opening the file (demuxer init + seek) can take a long time, so
+	// it is done without the mutex: the mixer and the fader would block
+	// on it otherwise and the stream would underrun during seeks. The
+	// loader objects are only used on this thread, they can't go away.
+	const auto opened = l->open(positionMs);
+	const auto length = opened ? l->samplesCount() : 0;
+
+	QMutexLocker lock(internal::audioPlayerMutex());
+	if (!mixer()) return nullptr;
+
+	auto track = mixer()->trackForType(audio.type());
+	if (!track || track->state.id != audio || !track->loading) {
+		err = SetupErrorNotPlaying;
+		return nullptr;
+	}
+	if (!opened || length <= 0) {
+		track->state.state = State::StoppedAtStart;
 		return nullptr;
 	}
+	track->state.length = length;
+	track->state.frequency = l->samplesFrequency();
+	err = SetupNoErrorStarted;
 	return l;
 }
 
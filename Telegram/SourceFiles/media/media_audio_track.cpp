@@ -39,6 +39,43 @@ ALuint CreateBuffer() {
 	return buffer;
 }
 
+std::shared_ptr<const Track::DecodedData> DecodeData(bytes::vector &&data) {
+	FFMpegLoader loader(FileLocation(), QByteArray(), std::move(data));
+
+	auto position = qint64(0);
+	if (!loader.open(position)) {
+		return nullptr;
+	}
+	auto result = std::make_shared<Track::DecodedData>();
+	do {
+		auto buffer = QByteArray();
+		auto samplesAdded = int64(0);
+		auto read = loader.readMore(buffer, samplesAdded);
+		if (samplesAdded > 0) {
+			auto sampleBytes = bytes::make_span(buffer);
+			result->samplesCount += samplesAdded;
+			result->samples.insert(result->samples.end(), sampleBytes.data(), sampleBytes.data() + sampleBytes.size());
+		}
+
+		using Result = AudioPlayerLoader::ReadResult;
+		switch (read) {
+		case Result::Error:
+		case Result::NotYet:
+		case Result::Wait: {
+			return nullptr;
+		} break;
+		}
+		if (read != Result::Ok) {
+			break;
+		}
+	} while (true);
+
+	result->alFormat = loader.format();
+	result->sampleRate = loader.samplesFrequency();
+	result->lengthMs = (loader.samplesCount() * TimeMs(1000)) / result->sampleRate;
+	return result;
+}
+
 } // namespace
 
 Track::Track(not_null<Instance*> instance) : _instance(instance) {
@@ -50,17 +87,23 @@ void Track::samplePeakEach(TimeMs peakDuration) {
 }
 
 void Track::fillFromData(bytes::vector &&data) {
-	FFMpegLoader loader(FileLocation(), QByteArray(), std::move(data));
-
-	auto position = qint64(0);
-	if (!loader.open(position)) {
+	_data = DecodeData(std::move(data));
+	if (!_data) {
 		_failed = true;
 		return;
 	}
-	auto format = loader.format();
-	_peakEachPosition = _peakDurationMs ? ((loader.samplesFrequency() * _peakDurationMs) / 1000) : 0;
-	auto peaksCount = _peakEachPosition ? (loader.samplesCount() / _peakEachPosition) : 0;
-	_peaks.reserve(peaksCount);
+	fillPeaks();
+}
+
+void Track::fillPeaks() {
+	Expects(_data != nullptr);
+
+	_peakEachPosition = _peakDurationMs ? ((_data->sampleRate * _peakDurationMs) / 1000) : 0;
+	if (!_peakEachPosition) {
+		return;
+	}
+	const auto format = _data->alFormat;
+	_peaks.reserve(_data->samplesCount / _peakEachPosition);
 	auto peakValue = uint16(0);
 	auto peakSamples = 0;
 	auto peakEachSample = (format == AL_FORMAT_STEREO8 || format == AL_FORMAT_STEREO16) ? (_peakEachPosition * 2) : _peakEachPosition;
@@ -76,39 +119,12 @@ void Track::fillFromData(bytes::vector &&data) {
 			peakValue = 0;
 		}
 	};
-	do {
-		auto buffer = QByteArray();
-		auto samplesAdded = int64(0);
-		auto result = loader.readMore(buffer, samplesAdded);
-		if (samplesAdded > 0) {
-			auto sampleBytes = bytes::make_span(buffer);
-			_samplesCount += samplesAdded;
-			_samples.insert(_samples.end(), sampleBytes.data(), sampleBytes.data() + sampleBytes.size());
-			if (peaksCount) {
-				if (format == AL_FORMAT_MONO8 || format == AL_FORMAT_STEREO8) {
-					Media::Audio::IterateSamples<uchar>(sampleBytes, peakCallback);
-				} else if (format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16) {
-					Media::Audio::IterateSamples<int16>(sampleBytes, peakCallback);
-				}
-			}
-		}
-
-		using Result = AudioPlayerLoader::ReadResult;
-		switch (result) {
-		case Result::Error:
-		case Result::NotYet:
-		case Result::Wait: {
-			_failed = true;
-		} break;
-		}
-		if (result != Result::Ok) {
-			break;
-		}
-	} while (true);
-
-	_alFormat = loader.format();
-	_sampleRate = loader.samplesFrequency();
-	_lengthMs = (loader.samplesCount() * TimeMs(1000)) / _sampleRate;
+	auto sampleBytes = bytes::make_span(_data->samples);
+	if (format == AL_FORMAT_MONO8 || format == AL_FORMAT_STEREO8) {
+		Media::Audio::IterateSamples<uchar>(sampleBytes, peakCallback);
+	} else if (format == AL_FORMAT_MONO16 || format == AL_FORMAT_STEREO16) {
+		Media::Audio::IterateSamples<int16>(sampleBytes, peakCallback);
+	}
 }
 
 void Track::fillFromFile(const FileLocation &location) {
@@ -122,6 +138,13 @@ void Track::fillFromFile(const FileLocation &location) {
 }
 
 void Track::fillFromFile(const QString &filePath) {
+	if (auto cached = _instance->cachedDecodedData(filePath)) {
+		// Several places play the same built-in sounds, no need to
+		// read and decode the file again for each of them.
+		_data = std::move(cached);
+		fillPeaks();
+		return;
+	}
 	QFile f(filePath);
 	if (f.open(QIODevice::ReadOnly)) {
 		auto size = f.size();
@@ -129,6 +152,9 @@ void Track::fillFromFile(const QString &filePath) {
 			auto bytes = bytes::vector(size);
 			if (f.read(reinterpret_cast<char*>(bytes.data()), bytes.size()) == bytes.size()) {
 				fillFromData(std::move(bytes));
+				if (_data) {
+					_instance->cacheDecodedData(filePath, _data);
+				}
 			} else {
 				LOG(("Track Error: Could not read %1 bytes from file '%2'.").arg(bytes.size()).arg(filePath));
 				_failed = true;
@@ -145,7 +171,7 @@ void Track::fillFromFile(const QString &filePath) {
 
 void Track::playWithLooping(bool looping) {
 	_active = true;
-	if (failed() || _samples.empty()) {
+	if (failed() || !_data || _data->samples.empty()) {
 		finish();
 		return;
 	}
@@ -182,7 +208,7 @@ void Track::ensureSourceCreated() {
 	_alSource = CreateSource();
 	_alBuffer = CreateBuffer();
 
-	alBufferData(_alBuffer, _alFormat, _samples.data(), _samples.size(), _sampleRate);
+	alBufferData(_alBuffer, _data->alFormat, _data->samples.data(), _data->samples.size(), _data->sampleRate);
 	alSourcei(_alSource, AL_BUFFER, _alBuffer);
 }
 
@@ -204,14 +230,14 @@ void Track::updateState() {
 }
 
 float64 Track::getPeakValue(TimeMs when) const {
-	if (!isActive() || !_samplesCount || _peaks.empty() || _peakValueMin == _peakValueMax) {
+	if (!isActive() || !_data || !_data->samplesCount || _peaks.empty() || _peakValueMin == _peakValueMax) {
 		return 0.;
 	}
-	auto sampleIndex = (_alPosition + ((when - _stateUpdatedAt) * _sampleRate / 1000));
+	auto sampleIndex = (_alPosition + ((when - _stateUpdatedAt) * _data->sampleRate / 1000));
 	while (sampleIndex < 0) {
-		sampleIndex += _samplesCount;
+		sampleIndex += _data->samplesCount;
 	}
-	sampleIndex = sampleIndex % _samplesCount;
+	sampleIndex = sampleIndex % _data->samplesCount;
 	auto peakIndex = (sampleIndex / _peakEachPosition) % _peaks.size();
 	return (_peaks[peakIndex] - _peakValueMin) / float64(_peakValueMax - _peakValueMin);
 }
@@ -280,6 +306,18 @@ void Instance::unregisterTrack(Track *track) {
 	_tracks.erase(track);
 }
 
+std::shared_ptr<const Track::DecodedData> Instance::cachedDecodedData(
+		const QString &path) const {
+	const auto i = _decodedDataByPath.find(path);
+	return (i != _decodedDataByPath.end()) ? i->second.lock() : nullptr;
+}
+
+void Instance::cacheDecodedData(
+		const QString &path,
+		std::shared_ptr<const Track::DecodedData> data) {
+	_decodedDataByPath[path] = std::move(data);
+}
+
 void Instance::trackStarted(Track *track) {
 	stopDetachIfNotUsed();
 	if (!_updateTimer.isActive()) {
@@ -19,6 +19,16 @@ class Track {
 public:
 	Track(not_null<Instance*> instance);
 
+	// One decoded buffer is shared between all the tracks filled
+	// from the same file, only the peaks are counted per track.
+	struct DecodedData {
+		bytes::vector samples;
+		int64 samplesCount = 0;
+		int32 sampleRate = 0;
+		int32 alFormat = 0;
+		TimeMs lengthMs = 0;
+	};
+
 	void samplePeakEach(TimeMs peakDuration);
 
 	void fillFromData(bytes::vector &&data);
@@ -43,7 +53,7 @@ public:
 	}
 
 	int64 getLengthMs() const {
-		return _lengthMs;
+		return _data ? _data->lengthMs : 0;
 	}
 	float64 getPeakValue(TimeMs when) const;
 
@@ -57,6 +67,7 @@ private:
 	void finish();
 	void ensureSourceCreated();
 	void playWithLooping(bool looping);
+	void fillPeaks();
 
 	not_null<Instance*> _instance;
 
@@ -65,9 +76,7 @@ private:
 	bool _looping = false;
 	float64 _volume = 1.;
 
-	int64 _samplesCount = 0;
-	int32 _sampleRate = 0;
-	bytes::vector _samples;
+	std::shared_ptr<const DecodedData> _data;
 
 	TimeMs _peakDurationMs = 0;
 	int _peakEachPosition = 0;
@@ -75,10 +84,8 @@ private:
 	uint16 _peakValueMin = 0;
 	uint16 _peakValueMax = 0;
 
-	TimeMs _lengthMs = 0;
 	TimeMs _stateUpdatedAt = 0;
 
-	int32 _alFormat = 0;
 	int64 _alPosition = 0;
 	uint32 _alSource = 0;
 	uint32 _alBuffer = 0;
@@ -113,8 +120,18 @@ private:
 	void trackStarted(Track *track);
 	void trackFinished(Track *track);
 
+	std::shared_ptr<const Track::DecodedData> cachedDecodedData(
+		const QString &path) const;
+	void cacheDecodedData(
+		const QString &path,
+		std::shared_ptr<const Track::DecodedData> data);
+
 private:
 	std::set<Track*> _tracks;
+
+	// One decoded buffer per file, freed when the last track using
+	// it is destroyed.
+	std::map<QString, std::weak_ptr<const Track::DecodedData>> _decodedDataByPath;
 	base::Observable<Track*> _trackFinished;
 
 	base::Timer _updateTimer;
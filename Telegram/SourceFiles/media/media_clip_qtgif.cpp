@@ -73,8 +73,24 @@ bool QtGifReaderImplementation::renderFrame(QImage &to, bool &hasAlpha, const QS
 		} else {
 			to = _frame.copy();
 		}
+	} else if (to.size() == size
+		&& to.isDetached()
+		&& (to.format() == QImage::Format_ARGB32_Premultiplied
+			|| to.format() == QImage::Format_RGB32)) {
+		// Scale into the existing buffer, like the FFmpeg-based reader
+		// does, instead of allocating a new image for each frame.
+		Painter p(&to);
+		p.setCompositionMode(QPainter::CompositionMode_Source);
+		p.setRenderHint(QPainter::SmoothPixmapTransform);
+		p.drawImage(QRect(QPoint(), size), _frame);
 	} else {
 		to = _frame.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+		if (to.format() != QImage::Format_ARGB32_Premultiplied
+			&& to.format() != QImage::Format_RGB32) {
+			to = std::move(to).convertToFormat(_frame.hasAlphaChannel()
+				? QImage::Format_ARGB32_Premultiplied
+				: QImage::Format_RGB32);
+		}
 	}
 	hasAlpha = _frame.hasAlphaChannel();
 	_frame = QImage();
@@ -29,6 +29,14 @@ namespace {
 QVector<QThread*> threads;
 QVector<Manager*> managers;
 
+int ThreadsCountLimit() {
+	static const auto result = qBound(
+		1,
+		QThread::idealThreadCount(),
+		int(ClipThreadsCount));
+	return result;
+}
+
 QImage PrepareFrameImage(const FrameRequest &request, const QImage &original, bool hasAlpha, QImage &cache) {
 	auto needResize = (original.width() != request.framew) || (original.height() != request.frameh);
 	auto needOuterFill = (request.outerw != request.framew) || (request.outerh != request.frameh);
@@ -96,8 +104,16 @@ Reader::Reader(not_null<DocumentData*> document, FullMsgId msgId, Callback &&cal
 	init(document->location(), document->data());
 }
 
+Reader::Reader(not_null<DocumentData*> document, FullMsgId msgId, Callback &&callback, const QByteArray &data, Mode mode, TimeMs seekMs)
+: _callback(std::move(callback))
+, _mode(mode)
+, _audioMsgId(document, msgId, (mode == Mode::Video) ? rand_value<uint32>() : 0)
+, _seekPositionMs(seekMs) {
+	init(FileLocation(), data);
+}
+
 void Reader::init(const FileLocation &location, const QByteArray &data) {
-	if (threads.size() < ClipThreadsCount) {
+	if (threads.size() < ThreadsCountLimit()) {
 		_threadIndex = threads.size();
 		threads.push_back(new QThread());
 		managers.push_back(new Manager(threads.back()));
@@ -437,42 +453,26 @@ public:
 	}
 
 	ProcessResult finishProcess(TimeMs ms) {
-		auto frameMs = _seekPositionMs + ms - _animationStarted;
-		auto readResult = _implementation->readFramesTill(frameMs, ms);
-		if (readResult == internal::ReaderImplementation::ReadResult::EndOfFile) {
+		if (!_aheadReady) {
+			prepareAhead(ms);
+		}
+		if (_aheadEndOfFile) {
 			stop(Player::State::StoppedAtEnd);
 			_state = State::Finished;
 			return ProcessResult::Finished;
-		} else if (readResult == internal::ReaderImplementation::ReadResult::Error) {
+		} else if (_aheadError || !_aheadReady) {
 			return error();
 		}
-		_nextFramePositionMs = _implementation->frameRealTime();
-		_nextFrameWhen = _animationStarted + _implementation->framePresentationTime();
-		if (_nextFrameWhen > _seekPositionMs) {
-			_nextFrameWhen -= _seekPositionMs;
-		} else {
-			_nextFrameWhen = 1;
-		}
+		_aheadReady = false;
+		_nextFrameWhen = _ahead.when;
+		_nextFramePositionMs = _ahead.positionMs;
 
-		if (!renderFrame()) {
-			return error();
-		}
+		// The buffers travel back and forth between the delivery slots
+		// and the decode-ahead slot, so they get reused between frames.
+		std::swap(*frame(), _ahead);
 		return ProcessResult::CopyFrame;
 	}
 
-	bool renderFrame() {
-		Assert(frame() != 0 && _request.valid());
-		if (!_implementation->renderFrame(frame()->original, frame()->alpha, QSize(_request.framew, _request.frameh))) {
-			return false;
-		}
-		frame()->original.setDevicePixelRatio(_request.factor);
-		frame()->pix = QPixmap();
-		frame()->pix = PrepareFrame(_request, frame()->original, frame()->alpha, frame()->cache);
-		frame()->when = _nextFrameWhen;
-		frame()->positionMs = _nextFramePositionMs;
-		return true;
-	}
-
 	bool init() {
 		if (_data.isEmpty() && QFileInfo(_location->name()).size() <= Storage::kMaxAnimationInMemory) {
 			QFile f(_location->name());
@@ -579,6 +579,53 @@ private:
 		return _frames + _frame;
 	}
 
+	// Reads and renders the next frame into the decode-ahead slot, so
+	// that finishProcess() only hands it over when the frame is due.
+	// End of file and errors found here are reported at that time too.
+	void prepareAhead(TimeMs ms) {
+		if (_aheadReady || _aheadEndOfFile || _aheadError || !_implementation) {
+			return;
+		}
+		auto frameMs = _seekPositionMs + ms - _animationStarted;
+		auto readResult = _implementation->readFramesTill(frameMs, ms);
+		if (readResult == internal::ReaderImplementation::ReadResult::EndOfFile) {
+			_aheadEndOfFile = true;
+			return;
+		} else if (readResult == internal::ReaderImplementation::ReadResult::Error) {
+			_aheadError = true;
+			return;
+		}
+		auto when = _animationStarted + _implementation->framePresentationTime();
+		if (when > _seekPositionMs) {
+			when -= _seekPositionMs;
+		} else {
+			when = 1;
+		}
+		if (!renderFrame(&_ahead, when, _implementation->frameRealTime())) {
+			_aheadError = true;
+			return;
+		}
+		_aheadReady = true;
+	}
+
+	bool renderFrame(Frame *to, TimeMs when, TimeMs positionMs) {
+		Assert(to != 0 && _request.valid());
+		if (!_implementation->renderFrame(to->original, to->alpha, QSize(_request.framew, _request.frameh))) {
+			return false;
+		}
+		to->original.setDevicePixelRatio(_request.factor);
+		to->pix = QPixmap();
+		to->pix = PrepareFrame(_request, to->original, to->alpha, to->cache);
+		to->when = when;
+		to->positionMs = positionMs;
+		return true;
+	}
+
+	Frame _ahead;
+	bool _aheadReady = false;
+	bool _aheadEndOfFile = false;
+	bool _aheadError = false;
+
 	int _width = 0;
 	int _height = 0;
 
@@ -790,26 +837,52 @@ void Manager::process() {
 		checkAllReaders = (_readers.size() > _readerPointers.size());
 	}
 
-	for (auto i = _readers.begin(), e = _readers.end(); i != e;) {
-		ReaderPrivate *reader = i.key();
+	// Handle the due readers, the most overdue first, so that under
+	// load the clips lagging behind the most get their decoder time
+	// before the ones that have only just become due.
+	auto due = std::vector<std::pair<TimeMs, ReaderPrivate*>>();
+	due.reserve(_readers.size());
+	for (auto i = _readers.cbegin(), e = _readers.cend(); i != e; ++i) {
 		if (i.value() <= ms) {
-			ResultHandleState state = handleResult(reader, reader->process(ms), ms);
-			if (state == ResultHandleRemove) {
-				i = _readers.erase(i);
-				continue;
-			} else if (state == ResultHandleStop) {
-				_processingInThread = 0;
-				return;
-			}
-			ms = getms();
-			if (reader->_videoPausedAtMs) {
-				i.value() = ms + 86400 * 1000ULL;
-			} else if (reader->_nextFrameWhen && reader->_started) {
-				i.value() = reader->_nextFrameWhen;
-			} else {
-				i.value() = (ms + 86400 * 1000ULL);
+			due.push_back({ i.value(), i.key() });
+		}
+	}
+	std::sort(due.begin(), due.end());
+	for (const auto &item : due) {
+		ReaderPrivate *reader = item.second;
+		ResultHandleState state = handleResult(reader, reader->process(ms), ms);
+		if (state == ResultHandleRemove) {
+			_readers.remove(reader);
+			continue;
+		} else if (state == ResultHandleStop) {
+			_processingInThread = 0;
+			return;
+		}
+		ms = getms();
+		auto i = _readers.find(reader);
+		if (i == _readers.end()) {
+			continue;
+		}
+		if (reader->_videoPausedAtMs) {
+			i.value() = ms + 86400 * 1000ULL;
+		} else if (reader->_nextFrameWhen && reader->_started) {
+			i.value() = reader->_nextFrameWhen;
+			if (reader->_mode == Reader::Mode::Gif
+				&& !reader->_autoPausedGif
+				&& reader->_state == State::Reading) {
+				// Render the next frame right after the current one
+				// was handed over, so that when its time comes it is
+				// ready instead of being decoded under the deadline.
+				reader->prepareAhead(ms);
 			}
-		} else if (checkAllReaders) {
+		} else {
+			i.value() = (ms + 86400 * 1000ULL);
+		}
+	}
+
+	for (auto i = _readers.begin(), e = _readers.end(); i != e;) {
+		ReaderPrivate *reader = i.key();
+		if (checkAllReaders) {
 			QMutexLocker lock(&_readerPointersMutex);
 			auto it = constUnsafeFindReaderPointer(reader);
 			if (it == _readerPointers.cend()) {
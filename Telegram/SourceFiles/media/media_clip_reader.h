@@ -52,6 +52,9 @@ public:
 	Reader(const QString &filepath, Callback &&callback, Mode mode = Mode::Gif, TimeMs seekMs = 0);
 	Reader(not_null<DocumentData*> document, FullMsgId msgId, Callback &&callback, Mode mode = Mode::Gif, TimeMs seekMs = 0);
 
+	// Reads an already downloaded part of a still loading document.
+	Reader(not_null<DocumentData*> document, FullMsgId msgId, Callback &&callback, const QByteArray &data, Mode mode = Mode::Gif, TimeMs seekMs = 0);
+
 	static void callback(Reader *reader, int threadIndex, Notification notification); // reader can be deleted
 
 	void setAutoplay() {
@@ -131,8 +131,11 @@ public:
 		Key key,
 		Image *image,
 		Data::FileOrigin origin,
+		QPixmap full,
 		Fn<void()> handler);
 
+	QPixmap fullPixmap() const;
+
 	int leftToUpdate() const;
 	int rightToUpdate() const;
 
@@ -174,15 +177,26 @@ GroupThumbs::Thumb::Thumb(
 	Key key,
 	Image *image,
 	Data::FileOrigin origin,
+	QPixmap full,
 	Fn<void()> handler)
 : _key(key)
 , _image(image)
-, _origin(origin) {
+, _origin(origin)
+, _full(std::move(full)) {
 	_link = std::make_shared<LambdaClickHandler>(std::move(handler));
-	_fullWidth = std::min(
-		wantedPixSize().width(),
-		st::mediaviewGroupWidthMax);
-	validateImage();
+	if (!_full.isNull()) {
+		// Reuse the pixmap prepared before this thumb faded out.
+		_fullWidth = _full.width() / cIntRetinaFactor();
+	} else {
+		_fullWidth = std::min(
+			wantedPixSize().width(),
+			st::mediaviewGroupWidthMax);
+		validateImage();
+	}
+}
+
+QPixmap GroupThumbs::Thumb::fullPixmap() const {
+	return _full;
 }
 
 QSize GroupThumbs::Thumb::wantedPixSize() const {
@@ -378,6 +392,7 @@ GroupThumbs::GroupThumbs(Context context)
 void GroupThumbs::updateContext(Context context) {
 	if (_context != context) {
 		clear();
+		_retiredPixmaps.clear();
 		_context = context;
 	}
 }
@@ -567,7 +582,12 @@ auto GroupThumbs::createThumb(Key key, Image *image)
 -> std::unique_ptr<Thumb> {
 	const auto weak = base::make_weak(this);
 	const auto origin = ComputeFileOrigin(key, _context);
-	return std::make_unique<Thumb>(key, image, origin, [=] {
+	auto full = QPixmap();
+	if (const auto i = _retiredPixmaps.find(key); i != _retiredPixmaps.end()) {
+		full = std::move(i->second);
+		_retiredPixmaps.erase(i);
+	}
+	return std::make_unique<Thumb>(key, image, origin, std::move(full), [=] {
 		if (const auto strong = weak.get()) {
 			strong->_activateStream.fire_copy(key);
 		}
@@ -676,6 +696,12 @@ void GroupThumbs::paint(
 		const auto &thumb = i->second;
 		thumb->paint(p, x, y, outerWidth, progress);
 		if (thumb->removed()) {
+			// Keep the prepared pixmap, so that flipping back through
+			// the album does not rescale the same thumbnail again.
+			auto full = thumb->fullPixmap();
+			if (!full.isNull()) {
+				_retiredPixmaps[i->first] = std::move(full);
+			}
 			_dying.erase(
 				ranges::remove(
 					_dying,
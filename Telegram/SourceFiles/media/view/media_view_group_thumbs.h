@@ -116,6 +116,7 @@ private:
 	std::vector<not_null<Thumb*>> _items;
 	std::vector<not_null<Thumb*>> _dying;
 	base::flat_map<Key, std::unique_ptr<Thumb>> _cache;
+	base::flat_map<Key, QPixmap> _retiredPixmaps;
 	int _width = 0;
 	QRect _updatedRect;
 
@@ -18,6 +18,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/image/image.h"
 #include "ui/text_options.h"
 #include "media/media_clip_reader.h"
+#include "media/media_clip_check_streaming.h"
 #include "media/view/media_clip_controller.h"
 #include "media/view/media_view_group_thumbs.h"
 #include "media/media_audio.h"
@@ -48,6 +49,10 @@ constexpr auto kIdsLimit = 48;
 // Preload next messages if we went further from current than that.
 constexpr auto kIdsPreloadAfter = 28;
 
+// Start playing a streamable video when that much of it is downloaded
+// and restart a stalled one when it grew by that much since the restart.
+constexpr auto kStreamedPrefixMinSize = 512 * 1024;
+
 Images::Options VideoThumbOptions(not_null<DocumentData*> document) {
 	const auto result = Images::Option::Smooth | Images::Option::Blurred;
 	return (document && document->isVideoMessage())
@@ -111,6 +116,9 @@ MediaView::MediaView()
 			subscribe(Auth().downloaderTaskFinished(), [this] {
 				if (!isHidden()) {
 					updateControls();
+					// A neighbor photo could have finished loading,
+					// decode it while the current one is still shown.
+					preloadData(0);
 				}
 			});
 			subscribe(Auth().calls().currentCallChanged(), [this](Calls::Call *call) {
@@ -249,19 +257,27 @@ bool MediaView::gifShown() const {
 void MediaView::stopGif() {
 	_gif = nullptr;
 	_videoPaused = _videoStopped = _videoIsSilent = false;
+	_streamedPrefixSize = 0;
 	_fullScreenVideo = false;
 	_clipController.destroy();
 	disconnect(Media::Player::mixer(), SIGNAL(updated(const AudioMsgId&)), this, SLOT(onVideoPlayProgress(const AudioMsgId&)));
 }
 
 void MediaView::documentUpdated(DocumentData *doc) {
-	if (fileBubbleShown() && _doc && _doc == doc) {
+	if (!_doc || _doc != doc) {
+		return;
+	} else if (fileBubbleShown()) {
 		if ((_doc->loading() && _docCancel->isHidden()) || (!_doc->loading() && !_docCancel->isHidden())) {
 			updateControls();
 		} else if (_doc->loading()) {
 			updateDocSize();
 			update(_docRect);
 		}
+	} else if (_streamedPrefixSize
+		&& _videoStopped
+		&& streamedVideoCanContinue()) {
+		// More of the still loading video arrived, continue the playback.
+		restartVideoAtSeekPosition(_videoPositionMs);
 	}
 }
 
@@ -942,9 +958,21 @@ void MediaView::clipCallback(Media::Clip::Notification notification) {
 				update();
 				break;
 			} else if (_gif->state() == State::Finished) {
-				_videoPositionMs = _videoDurationMs;
-				_videoStopped = true;
-				updateSilentVideoPlaybackState();
+				if (_streamedPrefixSize) {
+					if (streamedVideoCanContinue()) {
+						// The reader ran out of the downloaded part,
+						// restart it over the grown one.
+						restartVideoAtSeekPosition(_videoPositionMs);
+						break;
+					}
+					// Wait in documentUpdated() for more parts to arrive.
+					_videoStopped = true;
+					updateSilentVideoPlaybackState();
+				} else {
+					_videoPositionMs = _videoDurationMs;
+					_videoStopped = true;
+					updateSilentVideoPlaybackState();
+				}
 			} else {
 				_videoIsSilent = _doc && (_doc->isVideoFile() || _doc->isVideoMessage()) && !_gif->hasAudio();
 				_videoDurationMs = _gif->getDurationMs();
@@ -1803,6 +1831,8 @@ void MediaView::initAnimation() {
 	} else if (location.accessEnable()) {
 		createClipReader();
 		location.accessDisable();
+	} else if (canStreamPartial()) {
+		createClipReader();
 	} else if (_doc->dimensions.width() && _doc->dimensions.height()) {
 		auto w = _doc->dimensions.width();
 		auto h = _doc->dimensions.height();
@@ -1838,9 +1868,18 @@ void MediaView::createClipReader() {
 	auto mode = (_doc->isVideoFile() || _doc->isVideoMessage())
 		? Media::Clip::Reader::Mode::Video
 		: Media::Clip::Reader::Mode::Gif;
-	_gif = Media::Clip::MakeReader(_doc, _msgid, [this](Media::Clip::Notification notification) {
-		clipCallback(notification);
-	}, mode);
+	if (canStreamPartial()) {
+		const auto prefix = _doc->downloadedPrefix();
+		_streamedPrefixSize = prefix.size();
+		_gif = Media::Clip::MakeReader(_doc, _msgid, [this](Media::Clip::Notification notification) {
+			clipCallback(notification);
+		}, prefix, mode);
+	} else {
+		_streamedPrefixSize = 0;
+		_gif = Media::Clip::MakeReader(_doc, _msgid, [this](Media::Clip::Notification notification) {
+			clipCallback(notification);
+		}, mode);
+	}
 
 	// Correct values will be set when gif gets inited.
 	_videoPaused = _videoIsSilent = _videoStopped = false;
@@ -1850,6 +1889,31 @@ void MediaView::createClipReader() {
 	createClipController();
 }
 
+bool MediaView::canStreamPartial() const {
+	if (!_doc
+		|| !_doc->isVideoFile()
+		|| !_doc->supportsStreaming()
+		|| !_doc->loading()
+		|| !_doc->data().isEmpty()) {
+		return false;
+	}
+	const auto prefix = _doc->downloadedPrefix();
+	if (prefix.size() < kStreamedPrefixMinSize) {
+		return false;
+	}
+	return Media::Clip::CheckStreamingSupport(FileLocation(), prefix);
+}
+
+bool MediaView::streamedVideoCanContinue() const {
+	if (!_streamedPrefixSize || !_doc) {
+		return false;
+	} else if (_doc->loaded()) {
+		return true;
+	}
+	return _doc->downloadedPrefix().size()
+		>= _streamedPrefixSize + kStreamedPrefixMinSize;
+}
+
 void MediaView::initThemePreview() {
 	Assert(_doc && _doc->isTheme());
 
@@ -1980,9 +2044,18 @@ void MediaView::restartVideoAtSeekPosition(TimeMs positionMs) {
 		auto rounding = (_doc && _doc->isVideoMessage()) ? ImageRoundRadius::Ellipse : ImageRoundRadius::None;
 		_current = _gif->current(_gif->width() / cIntRetinaFactor(), _gif->height() / cIntRetinaFactor(), _gif->width() / cIntRetinaFactor(), _gif->height() / cIntRetinaFactor(), rounding, RectPart::AllCorners, getms());
 	}
-	_gif = Media::Clip::MakeReader(_doc, _msgid, [this](Media::Clip::Notification notification) {
-		clipCallback(notification);
-	}, Media::Clip::Reader::Mode::Video, positionMs);
+	if (canStreamPartial()) {
+		const auto prefix = _doc->downloadedPrefix();
+		_streamedPrefixSize = prefix.size();
+		_gif = Media::Clip::MakeReader(_doc, _msgid, [this](Media::Clip::Notification notification) {
+			clipCallback(notification);
+		}, prefix, Media::Clip::Reader::Mode::Video, positionMs);
+	} else {
+		_streamedPrefixSize = 0;
+		_gif = Media::Clip::MakeReader(_doc, _msgid, [this](Media::Clip::Notification notification) {
+			clipCallback(notification);
+		}, Media::Clip::Reader::Mode::Video, positionMs);
+	}
 
 	// Correct values will be set when gif gets inited.
 	_videoPaused = _videoIsSilent = _videoStopped = false;
@@ -2091,7 +2164,87 @@ void MediaView::validatePhotoImage(Image *image, bool blurred) {
 	_blurred = blurred;
 }
 
+bool MediaView::validatePhotoDecodedImage() {
+	const auto i = _decodedNeighbors.find(_photo);
+	if (i == end(_decodedNeighbors)) {
+		return false;
+	} else if (!_current.isNull() && !_blurred) {
+		return true;
+	}
+	const auto w = _width * cIntRetinaFactor();
+	const auto h = int((_photo->height() * (qreal(w) / qreal(_photo->width()))) + 0.9999);
+	_current = App::pixmapFromImageInPlace(Images::prepare(
+		i->second,
+		w,
+		h,
+		Images::Option::Smooth,
+		w,
+		h));
+	_current.setDevicePixelRatio(cRetinaFactor());
+	_blurred = false;
+	return true;
+}
+
+void MediaView::decodeNeighbor(not_null<PhotoData*> photo) {
+	const auto large = photo->large();
+	if (!large
+		|| !large->loaded()
+		|| (_decodedNeighbors.find(photo) != end(_decodedNeighbors))
+		|| (_decodingNeighbors.find(photo) != end(_decodingNeighbors))) {
+		return;
+	}
+	_decodingNeighbors.emplace(photo);
+	const auto weak = make_weak(this);
+	crl::async([=, bytes = large->bytesForCache()] {
+		auto image = App::readImage(bytes);
+		crl::on_main(weak, [=, image = std::move(image)]() mutable {
+			_decodingNeighbors.remove(photo);
+			if (!image.isNull()) {
+				_decodedNeighbors.emplace(photo, std::move(image));
+			}
+		});
+	});
+}
+
+bool MediaView::validateZoomCache(const QPixmap &source) {
+	const auto key = source.cacheKey();
+	const auto width = _w * cIntRetinaFactor();
+	if (_zoomCacheKey == key && _zoomCache.width() == width) {
+		return true;
+	} else if (_zoomCacheRequestKey == key
+		&& _zoomCacheRequestWidth == width) {
+		// The worker is already preparing this zoom level.
+		return false;
+	}
+	_zoomCache = QPixmap();
+	_zoomCacheRequestKey = key;
+	_zoomCacheRequestWidth = width;
+	const auto height = _h * cIntRetinaFactor();
+	const auto weak = make_weak(this);
+	crl::async([=, image = source.toImage()] {
+		auto scaled = image.scaled(
+			width,
+			height,
+			Qt::IgnoreAspectRatio,
+			Qt::SmoothTransformation);
+		crl::on_main(weak, [=, scaled = std::move(scaled)]() mutable {
+			if (_zoomCacheRequestKey != key
+				|| _zoomCacheRequestWidth != width) {
+				return;
+			}
+			_zoomCache = App::pixmapFromImageInPlace(std::move(scaled));
+			_zoomCache.setDevicePixelRatio(cRetinaFactor());
+			_zoomCacheKey = key;
+			update();
+		});
+	});
+	return false;
+}
+
 void MediaView::validatePhotoCurrentImage() {
+	if (validatePhotoDecodedImage()) {
+		return;
+	}
 	validatePhotoImage(_photo->large(), false);
 	validatePhotoImage(_photo->thumbnail(), true);
 	validatePhotoImage(_photo->thumbnailSmall(), true);
@@ -2146,9 +2299,20 @@ void MediaView::paintEvent(QPaintEvent *e) {
 				p.fillRect(imgRect, _transparentBrush);
 			}
 			if (!toDraw.isNull()) {
-				if (toDraw.width() != _w * cIntRetinaFactor()) {
-					PainterHighQualityEnabler hq(p);
-					p.drawPixmap(QRect(_x, _y, _w, _h), toDraw);
+				const auto dstWidth = _w * cIntRetinaFactor();
+				if (toDraw.width() != dstWidth) {
+					// Smoothly minifying a huge image on every paint makes
+					// panning a slideshow, so a prescaled copy for the
+					// current zoom level is prepared on a worker and
+					// painted 1:1 once it is ready.
+					if (!_gif
+						&& dstWidth < toDraw.width()
+						&& validateZoomCache(toDraw)) {
+						p.drawPixmap(_x, _y, _zoomCache);
+					} else {
+						PainterHighQualityEnabler hq(p);
+						p.drawPixmap(QRect(_x, _y, _w, _h), toDraw);
+					}
 				} else {
 					p.drawPixmap(_x, _y, toDraw);
 				}
@@ -2752,10 +2916,16 @@ void MediaView::preloadData(int delta) {
 		}
 	}
 
+	auto keepDecoded = base::flat_set<not_null<PhotoData*>>();
+	if (_photo) {
+		keepDecoded.emplace(_photo);
+	}
 	for (auto index = from; index != till; ++index) {
 		auto entity = entityByIndex(index);
 		if (auto photo = base::get_if<not_null<PhotoData*>>(&entity.data)) {
 			(*photo)->download(fileOrigin());
+			keepDecoded.emplace(*photo);
+			decodeNeighbor(*photo);
 		} else if (auto document = base::get_if<not_null<DocumentData*>>(&entity.data)) {
 			if (const auto image = (*document)->getStickerLarge()) {
 				image->load(fileOrigin());
@@ -2765,6 +2935,13 @@ void MediaView::preloadData(int delta) {
 			}
 		}
 	}
+	for (auto i = begin(_decodedNeighbors); i != end(_decodedNeighbors);) {
+		if (keepDecoded.find(i->first) == keepDecoded.end()) {
+			i = _decodedNeighbors.erase(i);
+		} else {
+			++i;
+		}
+	}
 }
 
 void MediaView::mousePressEvent(QMouseEvent *e) {
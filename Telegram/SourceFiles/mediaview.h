@@ -9,6 +9,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "ui/widgets/dropdown_menu.h"
 #include "ui/effects/radial_animation.h"
+#include "base/flat_map.h"
+#include "base/flat_set.h"
 #include "data/data_shared_media.h"
 #include "data/data_user_photos.h"
 #include "data/data_web_page.h"
@@ -215,6 +217,8 @@ private:
 
 	void initAnimation();
 	void createClipReader();
+	bool canStreamPartial() const;
+	bool streamedVideoCanContinue() const;
 
 	void initThemePreview();
 	void destroyThemePreview();
@@ -253,6 +257,9 @@ private:
 
 	void validatePhotoImage(Image *image, bool blurred);
 	void validatePhotoCurrentImage();
+	bool validatePhotoDecodedImage();
+	void decodeNeighbor(not_null<PhotoData*> photo);
+	bool validateZoomCache(const QPixmap &source);
 
 	QBrush _transparentBrush;
 
@@ -304,6 +311,19 @@ private:
 	Media::Clip::ReaderPointer _gif;
 	bool _blurred = true;
 
+	// Full-size images of the neighbor photos decoded on a worker,
+	// so that flipping through an album is not decode-bound.
+	base::flat_map<not_null<PhotoData*>, QImage> _decodedNeighbors;
+	base::flat_set<not_null<PhotoData*>> _decodingNeighbors;
+
+	// Smooth-scaled copy of the shown image for the current zoom level,
+	// prepared on a worker so that panning a zoomed-out huge image does
+	// not rescale it on every paint.
+	QPixmap _zoomCache;
+	qint64 _zoomCacheKey = 0;
+	qint64 _zoomCacheRequestKey = 0;
+	int _zoomCacheRequestWidth = 0;
+
 	// Video without audio stream playback information.
 	bool _videoIsSilent = false;
 	bool _videoPaused = false;
@@ -311,6 +331,7 @@ private:
 	TimeMs _videoPositionMs = 0;
 	TimeMs _videoDurationMs = 0;
 	int32 _videoFrequencyMs = 1000; // 1000 ms per second.
+	int32 _streamedPrefixSize = 0; // > 0 when playing a part of a loading video
 
 	bool fileShown() const;
 	bool gifShown() const;
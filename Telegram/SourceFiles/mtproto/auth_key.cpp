@@ -9,10 +9,100 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 extern "C" {
 #include <openssl/aes.h>
+#include <openssl/evp.h>
 #include <openssl/modes.h>
 } // extern "C"
 
 namespace MTP {
+namespace {
+
+constexpr auto kAesBlockSize = uint32(16);
+
+void XorBlock(uchar *to, const uchar *with) {
+	uint64 a, b;
+	memcpy(&a, to, 8);
+	memcpy(&b, with, 8);
+	a ^= b;
+	memcpy(to, &a, 8);
+	memcpy(&a, to + 8, 8);
+	memcpy(&b, with + 8, 8);
+	a ^= b;
+	memcpy(to + 8, &a, 8);
+}
+
+// The IGE chaining is inherently serial, but doing the block cipher
+// itself through EVP takes the AES-NI / NEON code paths of OpenSSL,
+// while AES_ige_encrypt() always runs the generic table-based AES.
+bool aesIgeThroughEvp(
+		const void *src,
+		void *dst,
+		uint32 len,
+		const void *key,
+		const void *iv,
+		bool encrypt) {
+	Expects(!(len % kAesBlockSize));
+
+	const auto ctx = EVP_CIPHER_CTX_new();
+	if (!ctx) {
+		return false;
+	}
+	const auto guard = gsl::finally([&] { EVP_CIPHER_CTX_free(ctx); });
+	const auto init = encrypt
+		? EVP_EncryptInit_ex(
+			ctx,
+			EVP_aes_256_ecb(),
+			nullptr,
+			static_cast<const uchar*>(key),
+			nullptr)
+		: EVP_DecryptInit_ex(
+			ctx,
+			EVP_aes_256_ecb(),
+			nullptr,
+			static_cast<const uchar*>(key),
+			nullptr);
+	if (init != 1) {
+		return false;
+	}
+	EVP_CIPHER_CTX_set_padding(ctx, 0);
+
+	// chain is the previous (ciphertext, plaintext) blocks pair,
+	// in the same layout as the AES_ige_encrypt() ivec.
+	uchar chain[2 * kAesBlockSize];
+	memcpy(chain, iv, sizeof(chain));
+
+	auto from = static_cast<const uchar*>(src);
+	auto to = static_cast<uchar*>(dst);
+	for (auto count = len / kAesBlockSize; count != 0; --count) {
+		uchar input[kAesBlockSize], output[kAesBlockSize];
+		auto outl = 0;
+		memcpy(input, from, kAesBlockSize);
+		if (encrypt) {
+			XorBlock(input, chain);
+			if (EVP_EncryptUpdate(ctx, output, &outl, input, kAesBlockSize) != 1
+				|| outl != int(kAesBlockSize)) {
+				return false;
+			}
+			XorBlock(output, chain + kAesBlockSize);
+			memcpy(chain, output, kAesBlockSize);
+			memcpy(chain + kAesBlockSize, from, kAesBlockSize);
+		} else {
+			XorBlock(input, chain + kAesBlockSize);
+			if (EVP_DecryptUpdate(ctx, output, &outl, input, kAesBlockSize) != 1
+				|| outl != int(kAesBlockSize)) {
+				return false;
+			}
+			XorBlock(output, chain);
+			memcpy(chain, from, kAesBlockSize);
+			memcpy(chain + kAesBlockSize, output, kAesBlockSize);
+		}
+		memcpy(to, output, kAesBlockSize);
+		from += kAesBlockSize;
+		to += kAesBlockSize;
+	}
+	return true;
+}
+
+} // namespace
 
 void AuthKey::prepareAES_oldmtp(const MTPint128 &msgKey, MTPint256 &aesKey, MTPint256 &aesIV, bool send) const {
 	uint32 x = send ? 0 : 8;
@@ -73,6 +163,9 @@ void AuthKey::prepareAES(const MTPint128 &msgKey, MTPint256 &aesKey, MTPint256 &
 }
 
 void aesIgeEncryptRaw(const void *src, void *dst, uint32 len, const void *key, const void *iv) {
+	if (aesIgeThroughEvp(src, dst, len, key, iv, true)) {
+		return;
+	}
 	uchar aes_key[32], aes_iv[32];
 	memcpy(aes_key, key, 32);
 	memcpy(aes_iv, iv, 32);
@@ -83,6 +176,9 @@ void aesIgeEncryptRaw(const void *src, void *dst, uint32 len, const void *key, c
 }
 
 void aesIgeDecryptRaw(const void *src, void *dst, uint32 len, const void *key, const void *iv) {
+	if (aesIgeThroughEvp(src, dst, len, key, iv, false)) {
+		return;
+	}
 	uchar aes_key[32], aes_iv[32];
 	memcpy(aes_key, key, 32);
 	memcpy(aes_iv, iv, 32);
@@ -10,6 +10,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/mtp_instance.h"
 #include "mtproto/rpc_sender.h"
 
+#include <crl/crl_async.h>
+
 namespace MTP {
 
 class ConcurrentSender::RPCDoneHandler : public RPCAbstractDoneHandler {
@@ -127,6 +129,11 @@ void ConcurrentSender::RequestBuilder::setFailSkipPolicy(
 	_failSkipPolicy = policy;
 }
 
+void ConcurrentSender::RequestBuilder::setExecutionPolicy(
+		ExecutionPolicy policy) noexcept {
+	_handlers.policy = policy;
+}
+
 void ConcurrentSender::RequestBuilder::setAfter(
 		mtpRequestId requestId) noexcept {
 	_afterRequestId = requestId;
@@ -176,16 +183,33 @@ void ConcurrentSender::senderRequestRegister(
 
 void ConcurrentSender::senderRequestDone(
 		mtpRequestId requestId,
-		bytes::const_span result) {
+		bytes::vector &&result) {
 	if (auto handlers = _requests.take(requestId)) {
-		try {
-			handlers->done(requestId, result);
-		} catch (Exception &e) {
-			handlers->fail(
+		const auto invoke = [](
+				Handlers &handlers,
+				mtpRequestId requestId,
+				const bytes::vector &result) {
+			try {
+				handlers.done(requestId, result);
+			} catch (Exception &e) {
+				handlers.fail(
+					requestId,
+					RPCError::Local(
+						"RESPONSE_PARSE_FAILED",
+						QString("exception text: ") + e.what()));
+			}
+		};
+		if (handlers->policy == ExecutionPolicy::WorkerPool) {
+			crl::async([
+				invoke,
 				requestId,
-				RPCError::Local(
-					"RESPONSE_PARSE_FAILED",
-					QString("exception text: ") + e.what()));
+				handlers = std::move(*handlers),
+				result = std::move(result)
+			]() mutable {
+				invoke(handlers, requestId, result);
+			});
+		} else {
+			invoke(*handlers, requestId, result);
 		}
 	}
 }
@@ -194,7 +218,17 @@ void ConcurrentSender::senderRequestFail(
 		mtpRequestId requestId,
 		RPCError &&error) {
 	if (auto handlers = _requests.take(requestId)) {
-		handlers->fail(requestId, std::move(error));
+		if (handlers->policy == ExecutionPolicy::WorkerPool) {
+			crl::async([
+				requestId,
+				handlers = std::move(*handlers),
+				error = std::move(error)
+			]() mutable {
+				handlers.fail(requestId, std::move(error));
+			});
+		} else {
+			handlers->fail(requestId, std::move(error));
+		}
 	}
 }
 
@@ -38,9 +38,15 @@ class ConcurrentSender : public base::has_weak_ptr {
 	using FailHandler = FnMut<void(
 		mtpRequestId requestId,
 		RPCError &&error)>;
+	enum class ExecutionPolicy {
+		Runner,
+		WorkerPool,
+	};
+
 	struct Handlers {
 		DoneHandler done;
 		FailHandler fail;
+		ExecutionPolicy policy = ExecutionPolicy::Runner;
 	};
 
 	enum class FailSkipPolicy {
@@ -70,6 +76,7 @@ class ConcurrentSender : public base::has_weak_ptr {
 		template <typename InvokeFullFail>
 		void setFailHandler(InvokeFullFail &&invoke) noexcept;
 		void setFailSkipPolicy(FailSkipPolicy policy) noexcept;
+		void setExecutionPolicy(ExecutionPolicy policy) noexcept;
 		void setAfter(mtpRequestId requestId) noexcept;
 
 	private:
@@ -131,6 +138,13 @@ public:
 
 		[[nodiscard]] SpecificRequestBuilder &handleFloodErrors() noexcept;
 		[[nodiscard]] SpecificRequestBuilder &handleAllErrors() noexcept;
+
+		// Parse the result and invoke the handlers on a crl::async
+		// worker instead of the sender's runner, moving the TL bytes
+		// to the worker, so heavy responses don't serialize behind
+		// each other.
+		[[nodiscard]] SpecificRequestBuilder &handleOnWorkerPool() noexcept;
+
 		[[nodiscard]] SpecificRequestBuilder &afterRequest(
 			mtpRequestId requestId) noexcept;
 
@@ -183,7 +197,7 @@ private:
 	void senderRequestRegister(mtpRequestId requestId, Handlers &&handlers);
 	void senderRequestDone(
 		mtpRequestId requestId,
-		bytes::const_span result);
+		bytes::vector &&result);
 	void senderRequestFail(
 		mtpRequestId requestId,
 		RPCError &&error);
@@ -434,6 +448,13 @@ auto ConcurrentSender::SpecificRequestBuilder<Request>::handleAllErrors(
 	return *this;
 }
 
+template <typename Request>
+auto ConcurrentSender::SpecificRequestBuilder<Request>::handleOnWorkerPool(
+) noexcept -> SpecificRequestBuilder & {
+	setExecutionPolicy(ExecutionPolicy::WorkerPool);
+	return *this;
+}
+
 template <typename Request>
 auto ConcurrentSender::SpecificRequestBuilder<Request>::afterRequest(
 	mtpRequestId requestId
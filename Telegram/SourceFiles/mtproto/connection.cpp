@@ -33,6 +33,28 @@ extern "C" {
 #endif // small
 
 namespace MTP {
+namespace {
+
+std::atomic<TimeMs> AckSendWaitingParam(kAckSendWaiting);
+std::atomic<int> AckSendMaxCountParam(kAckSendMaxCount);
+std::atomic<TimeMs> StateRequestWaitingParam(kStateRequestWaiting);
+
+} // namespace
+
+SendBatchingConfig CurrentSendBatchingConfig() {
+	auto result = SendBatchingConfig();
+	result.ackSendWaiting = AckSendWaitingParam.load();
+	result.ackSendMaxCount = AckSendMaxCountParam.load();
+	result.stateRequestWaiting = StateRequestWaitingParam.load();
+	return result;
+}
+
+void SetSendBatchingConfig(const SendBatchingConfig &config) {
+	AckSendWaitingParam.store(config.ackSendWaiting);
+	AckSendMaxCountParam.store(config.ackSendMaxCount);
+	StateRequestWaitingParam.store(config.stateRequestWaiting);
+}
+
 namespace internal {
 namespace {
 
@@ -40,6 +62,8 @@ constexpr auto kRecreateKeyId = AuthKey::KeyId(0xFFFFFFFFFFFFFFFFULL);
 constexpr auto kIntSize = static_cast<int>(sizeof(mtpPrime));
 constexpr auto kMaxModExpSize = 256;
 constexpr auto kWaitForBetterTimeout = TimeMs(2000);
+constexpr auto kFastConnectionRtt = TimeMs(500);
+constexpr auto kFastConnectionPriorityBonus = 4;
 constexpr auto kMinConnectedTimeout = TimeMs(1000);
 constexpr auto kMaxConnectedTimeout = TimeMs(8000);
 constexpr auto kMinReceiveTimeout = TimeMs(4000);
@@ -56,6 +80,10 @@ constexpr auto kRequestConfigTimeout = TimeMs(8000);
 // Don't try to handle messages larger than this size.
 constexpr auto kMaxMessageLength = 16 * 1024 * 1024;
 
+// Bound the pending updates queue while the main thread lags behind,
+// the gap from dropped updates is recovered by getDifference.
+constexpr auto kMaxPendingUpdates = 1024;
+
 QString LogIdsVector(const QVector<MTPlong> &ids) {
 	if (!ids.size()) return "[]";
 	auto idsStr = QString("[%1").arg(ids.cbegin()->v);
@@ -348,16 +376,28 @@ void ConnectionPrivate::appendTestConnection(
 		const bytes::vector &protocolSecret) {
 	QWriteLocker lock(&stateConnMutex);
 
+	// Endpoints that were fast to connect the last time win the race
+	// over the statically preferred ones, so that a reconnect lands on
+	// the known good endpoint right away.
+	const auto rtt = ip.isEmpty()
+		? TimeMs(0)
+		: _instance->dcOptions()->connectionRtt(ip.toStdString(), port);
 	const auto priority = (qthelp::is_ipv6(ip) ? 0 : 1)
 		+ (protocol == DcOptions::Variants::Tcp ? 1 : 0)
-		+ (protocolSecret.empty() ? 0 : 1);
+		+ (protocolSecret.empty() ? 0 : 1)
+		+ ((rtt > 0 && rtt <= kFastConnectionRtt)
+			? kFastConnectionPriorityBonus
+			: 0);
 	_testConnections.push_back({
 		AbstractConnection::Create(
 			_instance,
 			protocol,
 			thread(),
 			_connectionOptions->proxy),
-		priority
+		priority,
+		ip,
+		port,
+		getms(true)
 	});
 	auto weak = _testConnections.back().data.get();
 	connect(weak, &AbstractConnection::error, [=](int errorCode) {
@@ -1567,13 +1607,18 @@ void ConnectionPrivate::handleReceived() {
 		uint32 toAckSize = ackRequestData.size();
 		if (toAckSize) {
 			DEBUG_LOG(("MTP Info: will send %1 acks, ids: %2").arg(toAckSize).arg(LogIdsVector(ackRequestData)));
-			emit sendAnythingAsync(kAckSendWaiting);
+			const auto config = CurrentSendBatchingConfig();
+			emit sendAnythingAsync((toAckSize >= uint32(config.ackSendMaxCount))
+				? 0
+				: config.ackSendWaiting);
 		}
 
 		bool emitSignal = false;
 		{
 			QReadLocker locker(sessionData->haveReceivedMutex());
-			emitSignal = !sessionData->haveReceivedResponses().isEmpty() || !sessionData->haveReceivedUpdates().isEmpty();
+			emitSignal = !sessionData->haveReceivedResponses().isEmpty()
+				|| !sessionData->haveReceivedUpdates().isEmpty()
+				|| !sessionData->haveParsedUpdates().isEmpty();
 			if (emitSignal) {
 				DEBUG_LOG(("MTP Info: emitting needToReceive() - need to parse in another thread, %1 responses, %2 updates.").arg(sessionData->haveReceivedResponses().size()).arg(sessionData->haveReceivedUpdates().size()));
 			}
@@ -2161,20 +2206,24 @@ ConnectionPrivate::HandleResult ConnectionPrivate::handleOneReceived(const mtpPr
 	}
 
 	if (_dcType == DcType::Regular) {
-		mtpBuffer update(end - from);
-		if (end > from) memcpy(update.data(), from, (end - from) * sizeof(mtpPrime));
-
-		// Notify main process about the new updates.
-		QWriteLocker locker(sessionData->haveReceivedMutex());
-		sessionData->haveReceivedUpdates().push_back(SerializedMessage(update));
+		// Deserialize the updates right here, on the connection thread,
+		// so that a large catch-up burst does not block the main one,
+		// which receives only the already typed results.
+		try {
+			auto parseFrom = from;
+			auto updates = MTPUpdates();
+			updates.read(parseFrom, end);
 
-		if (cons != mtpc_updatesTooLong
-			&& cons != mtpc_updateShortMessage
-			&& cons != mtpc_updateShortChatMessage
-			&& cons != mtpc_updateShortSentMessage
-			&& cons != mtpc_updateShort
-			&& cons != mtpc_updatesCombined
-			&& cons != mtpc_updates) {
+			// Notify main process about the new updates.
+			QWriteLocker locker(sessionData->haveReceivedMutex());
+			auto &parsed = sessionData->haveParsedUpdates();
+			if (parsed.size() >= kMaxPendingUpdates) {
+				LOG(("MTP Warning: dropping the oldest pending update, "
+					"queue depth %1").arg(parsed.size()));
+				parsed.pop_front();
+			}
+			parsed.push_back(std::move(updates));
+		} catch (Exception &) {
 			// Maybe some new unknown update?
 			LOG(("Message Error: unknown constructor %1").arg(cons));
 		}
@@ -2431,6 +2480,12 @@ void ConnectionPrivate::onConnected(
 		connection.get(),
 		[](const TestConnection &test) { return test.data.get(); });
 	Assert(i != end(_testConnections));
+	if (!i->ip.isEmpty() && i->startedAt > 0) {
+		_instance->dcOptions()->setConnectionRtt(
+			i->ip.toStdString(),
+			i->port,
+			getms(true) - i->startedAt);
+	}
 	const auto my = i->priority;
 	const auto j = ranges::find_if(
 		_testConnections,
@@ -3020,6 +3075,15 @@ void ConnectionPrivate::onError(
 			instance->badConfigurationError();
 		});
 	}
+	const auto failed = ranges::find(
+		_testConnections,
+		connection.get(),
+		[](const TestConnection &test) { return test.data.get(); });
+	if (failed != end(_testConnections) && !failed->ip.isEmpty()) {
+		_instance->dcOptions()->setConnectionFailed(
+			failed->ip.toStdString(),
+			failed->port);
+	}
 	removeTestConnection(connection);
 
 	if (_testConnections.empty()) {
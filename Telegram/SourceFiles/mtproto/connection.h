@@ -12,12 +12,34 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "mtproto/connection_abstract.h"
 #include "base/openssl_help.h"
 #include "base/timer.h"
+#include "core/sampling_profiler.h"
 
 namespace MTP {
 
 // How much time to wait for some more requests, when sending msg acks.
 constexpr auto kAckSendWaiting = TimeMs(10000);
 
+// Flush the pending acks right away when this many have accumulated.
+constexpr auto kAckSendMaxCount = 16;
+
+// How much time to wait for some more requests, when sending
+// msgs_state requests for sent-but-unacked messages.
+constexpr auto kStateRequestWaiting = TimeMs(1000);
+
+// Batching parameters for acks and msgs_state requests. Acks are
+// piggybacked on outgoing containers whenever something else is sent,
+// these bounds only control when a dedicated packet is produced.
+struct SendBatchingConfig {
+	TimeMs ackSendWaiting = kAckSendWaiting;
+	int ackSendMaxCount = kAckSendMaxCount;
+	TimeMs stateRequestWaiting = kStateRequestWaiting;
+};
+
+// Both are thread-safe, the session threads read the config while
+// scheduling sends.
+[[nodiscard]] SendBatchingConfig CurrentSendBatchingConfig();
+void SetSendBatchingConfig(const SendBatchingConfig &config);
+
 class Instance;
 
 bool IsPrimeAndGood(bytes::const_span primeBytes, int g);
@@ -52,6 +74,13 @@ public:
 		return _threadIndex;
 	}
 
+protected:
+	void run() override {
+		Profiling::RegisterCurrentThread("mtp");
+		QThread::run();
+		Profiling::UnregisterCurrentThread();
+	}
+
 private:
 	int _threadIndex = 0;
 
@@ -150,6 +179,9 @@ private:
 	struct TestConnection {
 		ConnectionPointer data;
 		int priority = 0;
+		QString ip;
+		int port = 0;
+		TimeMs startedAt = 0;
 	};
 	void connectToServer(bool afterConfig = false);
 	void doDisconnect();
@@ -42,6 +42,14 @@ void HttpConnection::sendData(mtpBuffer &&buffer) {
 	request.setHeader(QNetworkRequest::ContentLengthHeader, QVariant(requestSize));
 	request.setHeader(QNetworkRequest::ContentTypeHeader, QVariant(qsl("application/x-www-form-urlencoded")));
 
+	// Reuse the kept-alive sockets and let overlapping POSTs share
+	// them instead of opening a connection per request - vital behind
+	// proxies where the TCP transport is blocked.
+	request.setRawHeader("Connection", "keep-alive");
+	request.setAttribute(
+		QNetworkRequest::HttpPipeliningAllowedAttribute,
+		true);
+
 	TCP_LOG(("HTTP Info: sending %1 len request").arg(requestSize));
 	_requests.insert(_manager.post(request, QByteArray((const char*)(&buffer[2]), requestSize)));
 }
@@ -389,6 +389,10 @@ void TcpConnection::socketRead() {
 			break;
 		}
 	} while (_socket.state() == QAbstractSocket::ConnectedState && _socket.bytesAvailable());
+
+	if (base::take(_receivedDataPending)) {
+		emit receivedData();
+	}
 }
 
 mtpBuffer TcpConnection::parsePacket(bytes::const_span bytes) {
@@ -632,7 +636,10 @@ void TcpConnection::socketPacket(bytes::const_span bytes) {
 		// new quickack?..
 	} else if (_status == Status::Ready) {
 		_receivedQueue.push_back(data);
-		emit receivedData();
+
+		// Notify once per socketRead() drain, not once per packet,
+		// the receiver processes the whole queue on each notification.
+		_receivedDataPending = true;
 	} else if (_status == Status::Waiting) {
 		try {
 			const auto res_pq = readPQFakeReply(data);
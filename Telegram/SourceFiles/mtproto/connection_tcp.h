@@ -76,6 +76,7 @@ private:
 	bytes::vector _smallBuffer;
 	bytes::vector _largeBuffer;
 	bool _usingLargeBuffer = false;
+	bool _receivedDataPending = false;
 
 	uchar _sendKey[CTRState::KeySize];
 	CTRState _sendState;
@@ -36,6 +36,10 @@ uint32 CountPaddingAmountInInts(uint32 requestSize, bool extended) {
 #endif // TDESKTOP_MTPROTO_OLD
 }
 
+// The most padding CountPaddingAmountInInts() can return: up to 3 ints
+// of alignment, 4 ints of minimal random padding and 60 ints extended.
+constexpr auto kMaxPaddingInts = uint32(3 + 4 + 60);
+
 } // namespace
 
 SecureRequest::SecureRequest(const details::SecureRequestCreateTag &tag)
@@ -46,7 +50,11 @@ SecureRequest SecureRequest::Prepare(uint32 size, uint32 reserveSize) {
 	const auto finalSize = std::max(size, reserveSize);
 
 	auto result = SecureRequest(details::SecureRequestCreateTag{});
-	result->reserve(kMessageBodyPosition + finalSize);
+
+	// Reserve the send-time padding headroom right away, so that
+	// addPadding() never reallocates (and so copies) the buffer of
+	// a fully serialized request on the send hot path.
+	result->reserve(kMessageBodyPosition + finalSize + kMaxPaddingInts);
 	result->resize(kMessageBodyPosition);
 	result->back() = (size << 2);
 	return result;
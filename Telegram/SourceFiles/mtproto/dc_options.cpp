@@ -371,7 +371,13 @@ QByteArray DcOptions::serialize() const {
 		}
 	}
 
-	constexpr auto kVersion = 1;
+	// Connection RTT history.
+	size += sizeof(qint32);
+	for (const auto &item : _rtts) {
+		size += sizeof(qint32) + item.first.size() + sizeof(qint64);
+	}
+
+	constexpr auto kVersion = 2;
 
 	auto result = QByteArray();
 	result.reserve(size);
@@ -406,6 +412,14 @@ QByteArray DcOptions::serialize() const {
 				<< Serialize::bytes(key.n)
 				<< Serialize::bytes(key.e);
 		}
+
+		// Connection RTT history.
+		stream << qint32(_rtts.size());
+		for (const auto &item : _rtts) {
+			stream << qint32(item.first.size());
+			stream.writeRawData(item.first.data(), item.first.size());
+			stream << qint64(item.second);
+		}
 	}
 	return result;
 }
@@ -431,6 +445,7 @@ void DcOptions::constructFromSerialized(const QByteArray &serialized) {
 
 	WriteLocker lock(this);
 	_data.clear();
+	_rtts.clear();
 	for (auto i = 0; i != count; ++i) {
 		qint32 id = 0, flags = 0, port = 0, ipSize = 0;
 		stream >> id >> flags >> port >> ipSize;
@@ -500,6 +515,40 @@ void DcOptions::constructFromSerialized(const QByteArray &serialized) {
 			}
 		}
 	}
+
+	// Read connection RTT history.
+	if (version > 1 && !stream.atEnd()) {
+		auto count = qint32(0);
+		stream >> count;
+		if (stream.status() != QDataStream::Ok) {
+			LOG(("MTP Error: Bad data for RTT history in DcOptions::constructFromSerialized()"));
+			return;
+		}
+
+		for (auto i = 0; i != count; ++i) {
+			auto keySize = qint32(0);
+			stream >> keySize;
+
+			// Maximal ip size (45) + ':' + port.
+			constexpr auto kMaxKeySize = 45 + 1 + 5;
+			if (keySize <= 0 || keySize > kMaxKeySize) {
+				LOG(("MTP Error: Bad data for RTT history inside DcOptions::constructFromSerialized()"));
+				return;
+			}
+
+			auto key = std::string(keySize, ' ');
+			stream.readRawData(key.data(), keySize);
+			auto rtt = qint64(0);
+			stream >> rtt;
+			if (stream.status() != QDataStream::Ok) {
+				LOG(("MTP Error: Bad data for RTT history inside DcOptions::constructFromSerialized()"));
+				return;
+			}
+			if (rtt > 0) {
+				_rtts.emplace(std::move(key), TimeMs(rtt));
+			}
+		}
+	}
 }
 
 DcOptions::Ids DcOptions::configEnumDcIds() const {
@@ -534,6 +583,26 @@ DcType DcOptions::dcType(ShiftedDcId shiftedDcId) const {
 	return DcType::Regular;
 }
 
+void DcOptions::setConnectionRtt(const std::string &ip, int port, TimeMs rtt) {
+	WriteLocker lock(this);
+	auto &stored = _rtts[ip + ':' + std::to_string(port)];
+	stored = stored ? ((stored + rtt) / 2) : rtt;
+}
+
+void DcOptions::setConnectionFailed(const std::string &ip, int port) {
+	WriteLocker lock(this);
+
+	// Drop the good history, so the endpoint loses its priority bonus
+	// until it manages to connect again.
+	_rtts.erase(ip + ':' + std::to_string(port));
+}
+
+TimeMs DcOptions::connectionRtt(const std::string &ip, int port) const {
+	ReadLocker lock(this);
+	const auto i = _rtts.find(ip + ':' + std::to_string(port));
+	return (i != end(_rtts)) ? i->second : TimeMs(0);
+}
+
 void DcOptions::setCDNConfig(const MTPDcdnConfig &config) {
 	WriteLocker lock(this);
 	_cdnPublicKeys.clear();
@@ -85,6 +85,13 @@ public:
 	Variants lookup(DcId dcId, DcType type, bool throughProxy) const;
 	DcType dcType(ShiftedDcId shiftedDcId) const;
 
+	// Remember how long an endpoint took to accept a connection, so that
+	// the next reconnect can prefer the historically fast endpoints.
+	// Thread safe.
+	void setConnectionRtt(const std::string &ip, int port, TimeMs rtt);
+	void setConnectionFailed(const std::string &ip, int port);
+	TimeMs connectionRtt(const std::string &ip, int port) const;
+
 	void setCDNConfig(const MTPDcdnConfig &config);
 	bool hasCDNKeysForDc(DcId dcId) const;
 	bool getDcRSAKey(DcId dcId, const QVector<MTPlong> &fingerprints, internal::RSAPublicKey *result) const;
@@ -124,6 +131,7 @@ private:
 	friend class ReadLocker;
 
 	std::map<DcId, std::vector<Endpoint>> _data;
+	std::map<std::string, TimeMs> _rtts;
 	std::set<DcId> _cdnDcIds;
 	std::map<uint64, internal::RSAPublicKey> _publicKeys;
 	std::map<DcId, std::map<uint64, internal::RSAPublicKey>> _cdnPublicKeys;
@@ -23,6 +23,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "lang/lang_instance.h"
 #include "lang/lang_cloud_manager.h"
 #include "base/timer.h"
+#include "base/flat_map.h"
 
 namespace MTP {
 namespace {
@@ -62,6 +63,7 @@ public:
 
 	void restart();
 	void restart(ShiftedDcId shiftedDcId);
+	void warmupMediaDc(DcId dcId);
 	int32 dcstate(ShiftedDcId shiftedDcId = 0);
 	QString dctransport(ShiftedDcId shiftedDcId = 0);
 	void ping();
@@ -99,6 +101,7 @@ public:
 	void execCallback(mtpRequestId requestId, const mtpPrime *from, const mtpPrime *end);
 	bool hasCallbacks(mtpRequestId requestId);
 	void globalCallback(const mtpPrime *from, const mtpPrime *end);
+	void processUpdates(MTPUpdates &&updates);
 
 	void onStateChange(ShiftedDcId shiftedDcId, int32 state);
 	void onSessionReset(ShiftedDcId shiftedDcId);
@@ -110,6 +113,7 @@ public:
 	}
 
 	void setUpdatesHandler(RPCDoneHandlerPtr onDone);
+	void setParsedUpdatesHandler(Fn<void(MTPUpdates &&updates)> handler);
 	void setGlobalFailHandler(RPCFailHandlerPtr onFail);
 	void setStateChangedHandler(Fn<void(ShiftedDcId shiftedDcId, int32 state)> handler);
 	void setSessionResetHandler(Fn<void(ShiftedDcId shiftedDcId)> handler);
@@ -196,17 +200,21 @@ private:
 
 	std::map<ShiftedDcId, mtpRequestId> _logoutGuestRequestIds;
 
+	// Request ids grow monotonically, so the per-request tables are kept
+	// flat - inserts append at the end and there is no node allocation
+	// for every sent RPC.
+
 	// holds dcWithShift for request to this dc or -dc for request to main dc
-	std::map<mtpRequestId, ShiftedDcId> _requestsByDc;
+	base::flat_map<mtpRequestId, ShiftedDcId> _requestsByDc;
 	mutable QMutex _requestByDcLock;
 
 	// holds target dcWithShift for auth export request
 	std::map<mtpRequestId, ShiftedDcId> _authExportRequests;
 
-	std::map<mtpRequestId, RPCResponseHandler> _parserMap;
+	base::flat_map<mtpRequestId, RPCResponseHandler> _parserMap;
 	QMutex _parserMapLock;
 
-	std::map<mtpRequestId, SecureRequest> _requestMap;
+	base::flat_map<mtpRequestId, SecureRequest> _requestMap;
 	QReadWriteLock _requestMapLock;
 
 	std::deque<std::pair<mtpRequestId, TimeMs>> _delayedRequests;
@@ -218,6 +226,7 @@ private:
 	std::map<DcId, std::vector<mtpRequestId>> _authWaiters;
 
 	RPCResponseHandler _globalHandler;
+	Fn<void(MTPUpdates &&updates)> _parsedUpdatesHandler;
 	Fn<void(ShiftedDcId shiftedDcId, int32 state)> _stateChangedHandler;
 	Fn<void(ShiftedDcId shiftedDcId)> _sessionResetHandler;
 
@@ -338,10 +347,12 @@ void Instance::Private::applyDomainIps(
 	for (auto &proxy : Global::RefProxiesList()) {
 		applyToProxy(proxy);
 	}
-	if (applyToProxy(Global::RefSelectedProxy())
-		&& (Global::ProxySettings() == ProxyData::Settings::Enabled)) {
-		for (auto &session : _sessions) {
-			session.second->refreshOptions();
+	if (applyToProxy(Global::RefSelectedProxy())) {
+		Global::RefreshProxyConfig();
+		if (Global::ProxySettings() == ProxyData::Settings::Enabled) {
+			for (auto &session : _sessions) {
+				session.second->refreshOptions();
+			}
 		}
 	}
 	emit _instance->proxyDomainResolved(host, ips, expireAt);
@@ -368,9 +379,11 @@ void Instance::Private::setGoodProxyDomain(
 	for (auto &proxy : Global::RefProxiesList()) {
 		applyToProxy(proxy);
 	}
-	if (applyToProxy(Global::RefSelectedProxy())
-		&& (Global::ProxySettings() == ProxyData::Settings::Enabled)) {
-		Core::App().refreshGlobalProxy();
+	if (applyToProxy(Global::RefSelectedProxy())) {
+		Global::RefreshProxyConfig();
+		if (Global::ProxySettings() == ProxyData::Settings::Enabled) {
+			Core::App().refreshGlobalProxy();
+		}
 	}
 }
 
@@ -480,6 +493,26 @@ void Instance::Private::restart(ShiftedDcId shiftedDcId) {
 	}
 }
 
+void Instance::Private::warmupMediaDc(DcId dcId) {
+	if (!dcId || isKeysDestroyer()) {
+		return;
+	}
+	const auto dc = getDcById(dcId);
+	{
+		QReadLocker lock(dc->keyMutex());
+		if (dc->getKey()) {
+			return;
+		}
+	}
+	const auto shiftedDcId = downloadDcId(dcId, 0);
+	if (_sessions.find(shiftedDcId) != _sessions.cend()) {
+		return;
+	}
+	DEBUG_LOG(("MTP Info: warming up download session for dc %1."
+		).arg(dcId));
+	getSession(shiftedDcId);
+}
+
 int32 Instance::Private::dcstate(ShiftedDcId shiftedDcId) {
 	if (!shiftedDcId) {
 		Assert(_mainSession != nullptr);
@@ -962,7 +995,7 @@ void Instance::Private::clearCallbacks(mtpRequestId requestId, int32 errorCode)
 		QMutexLocker locker(&_parserMapLock);
 		auto it = _parserMap.find(requestId);
 		if (it != _parserMap.end()) {
-			h = it->second;
+			h = std::move(it->second);
 			found = true;
 
 			_parserMap.erase(it);
@@ -1034,7 +1067,7 @@ void Instance::Private::execCallback(
 		QMutexLocker locker(&_parserMapLock);
 		auto it = _parserMap.find(requestId);
 		if (it != _parserMap.cend()) {
-			h = it->second;
+			h = std::move(it->second);
 			_parserMap.erase(it);
 
 			DEBUG_LOG(("RPC Info: found parser for request %1, trying to parse response...").arg(requestId));
@@ -1090,6 +1123,12 @@ void Instance::Private::globalCallback(const mtpPrime *from, const mtpPrime *end
 	}
 }
 
+void Instance::Private::processUpdates(MTPUpdates &&updates) {
+	if (_parsedUpdatesHandler) {
+		_parsedUpdatesHandler(std::move(updates));
+	}
+}
+
 void Instance::Private::onStateChange(int32 dcWithShift, int32 state) {
 	if (_stateChangedHandler) {
 		_stateChangedHandler(dcWithShift, state);
@@ -1497,6 +1536,10 @@ void Instance::Private::setUpdatesHandler(RPCDoneHandlerPtr onDone) {
 	_globalHandler.onDone = onDone;
 }
 
+void Instance::Private::setParsedUpdatesHandler(Fn<void(MTPUpdates &&updates)> handler) {
+	_parsedUpdatesHandler = std::move(handler);
+}
+
 void Instance::Private::setGlobalFailHandler(RPCFailHandlerPtr onFail) {
 	_globalHandler.onFail = onFail;
 }
@@ -1511,6 +1554,7 @@ void Instance::Private::setSessionResetHandler(Fn<void(ShiftedDcId shiftedDcId)>
 
 void Instance::Private::clearGlobalHandlers() {
 	setUpdatesHandler(RPCDoneHandlerPtr());
+	setParsedUpdatesHandler(nullptr);
 	setGlobalFailHandler(RPCFailHandlerPtr());
 	setStateChangedHandler(Fn<void(ShiftedDcId,int32)>());
 	setSessionResetHandler(Fn<void(ShiftedDcId)>());
@@ -1600,6 +1644,10 @@ void Instance::restart(ShiftedDcId shiftedDcId) {
 	_private->restart(shiftedDcId);
 }
 
+void Instance::warmupMediaDc(DcId dcId) {
+	_private->warmupMediaDc(dcId);
+}
+
 int32 Instance::dcstate(ShiftedDcId shiftedDcId) {
 	return _private->dcstate(shiftedDcId);
 }
@@ -1677,6 +1725,10 @@ void Instance::setUpdatesHandler(RPCDoneHandlerPtr onDone) {
 	_private->setUpdatesHandler(onDone);
 }
 
+void Instance::setParsedUpdatesHandler(Fn<void(MTPUpdates &&updates)> handler) {
+	_private->setParsedUpdatesHandler(std::move(handler));
+}
+
 void Instance::setGlobalFailHandler(RPCFailHandlerPtr onFail) {
 	_private->setGlobalFailHandler(onFail);
 }
@@ -1717,6 +1769,10 @@ void Instance::globalCallback(const mtpPrime *from, const mtpPrime *end) {
 	_private->globalCallback(from, end);
 }
 
+void Instance::processUpdates(MTPUpdates &&updates) {
+	_private->processUpdates(std::move(updates));
+}
+
 bool Instance::rpcErrorOccured(mtpRequestId requestId, const RPCFailHandlerPtr &onFail, const RPCError &err) {
 	return _private->rpcErrorOccured(requestId, onFail, err);
 }
@@ -139,6 +139,11 @@ public:
 
 	void restart();
 	void restart(ShiftedDcId shiftedDcId);
+
+	// Starts a download session for a dc we don't have an auth key for,
+	// so the key exchange happens before the first file part is requested.
+	void warmupMediaDc(DcId dcId);
+
 	int32 dcstate(ShiftedDcId shiftedDcId = 0);
 	QString dctransport(ShiftedDcId shiftedDcId = 0);
 	void ping();
@@ -155,6 +160,7 @@ public:
 	void queueQuittingConnection(std::unique_ptr<internal::Connection> &&connection);
 
 	void setUpdatesHandler(RPCDoneHandlerPtr onDone);
+	void setParsedUpdatesHandler(Fn<void(MTPUpdates &&updates)> handler);
 	void setGlobalFailHandler(RPCFailHandlerPtr onFail);
 	void setStateChangedHandler(Fn<void(ShiftedDcId shiftedDcId, int32 state)> handler);
 	void setSessionResetHandler(Fn<void(ShiftedDcId shiftedDcId)> handler);
@@ -168,6 +174,7 @@ public:
 	void execCallback(mtpRequestId requestId, const mtpPrime *from, const mtpPrime *end);
 	bool hasCallbacks(mtpRequestId requestId);
 	void globalCallback(const mtpPrime *from, const mtpPrime *end);
+	void processUpdates(MTPUpdates &&updates);
 
 	// return true if need to clean request data
 	bool rpcErrorOccured(mtpRequestId requestId, const RPCFailHandlerPtr &onFail, const RPCError &err);
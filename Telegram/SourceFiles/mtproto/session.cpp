@@ -27,6 +27,10 @@ constexpr auto kCheckResendWaiting = TimeMs(1000);
 // but instead to check its state.
 constexpr auto kResendThreshold = 1;
 
+// How many queued updates to hand to the instance per tryToReceive()
+// pass, so that a catch-up burst can't starve interactive work.
+constexpr auto kMaxUpdatesPerReceive = 16;
+
 // Container lives 10 minutes in haveSent map.
 constexpr auto kContainerLives = 600;
 
@@ -186,22 +190,20 @@ void Session::restart() {
 }
 
 void Session::refreshOptions() {
-	const auto &proxy = Global::SelectedProxy();
-	const auto proxyType =
-		(Global::ProxySettings() == ProxyData::Settings::Enabled
-			? proxy.type
-			: ProxyData::Type::None);
+	const auto config = Global::CurrentProxyConfig();
+	const auto enabled = (config->settings == ProxyData::Settings::Enabled);
+	const auto proxyType = enabled
+		? config->selected.type
+		: ProxyData::Type::None;
 	const auto useTcp = (proxyType != ProxyData::Type::Http);
 	const auto useHttp = (proxyType != ProxyData::Type::Mtproto);
 	const auto useIPv4 = true;
-	const auto useIPv6 = Global::TryIPv6();
+	const auto useIPv6 = config->tryIPv6;
 	data.applyConnectionOptions(ConnectionOptions(
 		_instance->systemLangCode(),
 		_instance->cloudLangCode(),
 		_instance->langPackName(),
-		(Global::ProxySettings() == ProxyData::Settings::Enabled
-			? proxy
-			: ProxyData()),
+		(enabled ? config->selected : ProxyData()),
 		useIPv4,
 		useIPv6,
 		useHttp,
@@ -344,7 +346,7 @@ void Session::checkRequestsByTimer() {
 				data.stateRequestMap().insert(stateRequestIds[i], true);
 			}
 		}
-		sendAnything(kCheckResendWaiting);
+		sendAnything(CurrentSendBatchingConfig().stateRequestWaiting);
 	}
 	if (!resendingIds.isEmpty()) {
 		for (uint32 i = 0, l = resendingIds.size(); i < l; ++i) {
@@ -596,23 +598,31 @@ void Session::tryToReceive() {
 		_needToReceive = true;
 		return;
 	}
+	auto processedUpdates = 0;
 	while (true) {
 		auto requestId = mtpRequestId(0);
 		auto isUpdate = false;
 		auto message = SerializedMessage();
+		auto parsedUpdates = std::optional<MTPUpdates>();
 		{
 			QWriteLocker locker(data.haveReceivedMutex());
 			auto &responses = data.haveReceivedResponses();
 			auto response = responses.begin();
 			if (response == responses.cend()) {
-				auto &updates = data.haveReceivedUpdates();
-				auto update = updates.begin();
-				if (update == updates.cend()) {
-					return;
+				auto &parsed = data.haveParsedUpdates();
+				if (!parsed.isEmpty()) {
+					parsedUpdates = std::move(parsed.first());
+					parsed.pop_front();
 				} else {
-					message = std::move(*update);
-					isUpdate = true;
-					updates.pop_front();
+					auto &updates = data.haveReceivedUpdates();
+					auto update = updates.begin();
+					if (update == updates.cend()) {
+						return;
+					} else {
+						message = std::move(*update);
+						isUpdate = true;
+						updates.pop_front();
+					}
 				}
 			} else {
 				requestId = response.key();
@@ -620,13 +630,27 @@ void Session::tryToReceive() {
 				responses.erase(response);
 			}
 		}
-		if (isUpdate) {
+		if (parsedUpdates) {
+			if (dcWithShift == BareDcId(dcWithShift)) { // process updates only in main session
+				_instance->processUpdates(std::move(*parsedUpdates));
+			}
+			++processedUpdates;
+		} else if (isUpdate) {
 			if (dcWithShift == BareDcId(dcWithShift)) { // call globalCallback only in main session
 				_instance->globalCallback(message.constData(), message.constData() + message.size());
 			}
+			++processedUpdates;
 		} else {
 			_instance->execCallback(requestId, message.constData(), message.constData() + message.size());
 		}
+		if (processedUpdates >= kMaxUpdatesPerReceive) {
+			// Yield to the event loop and continue on the next pass,
+			// responses above are always drained without a limit.
+			DEBUG_LOG(("MTP Info: processed %1 updates, deferring the rest"
+				).arg(processedUpdates));
+			QTimer::singleShot(0, this, SLOT(tryToReceive()));
+			return;
+		}
 	}
 }
 
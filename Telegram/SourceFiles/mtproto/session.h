@@ -256,6 +256,12 @@ public:
 	const QList<SerializedMessage> &haveReceivedUpdates() const {
 		return _receivedUpdates;
 	}
+	QList<MTPUpdates> &haveParsedUpdates() {
+		return _parsedUpdates;
+	}
+	const QList<MTPUpdates> &haveParsedUpdates() const {
+		return _parsedUpdates;
+	}
 	QMap<mtpMsgId, bool> &stateRequestMap() {
 		return _stateRequest;
 	}
@@ -301,6 +307,7 @@ private:
 
 	QMap<mtpRequestId, SerializedMessage> _receivedResponses; // map of request_id -> response that should be processed in the main thread
 	QList<SerializedMessage> _receivedUpdates; // list of updates that should be processed in the main thread
+	QList<MTPUpdates> _parsedUpdates; // list of updates already deserialized on the connection thread
 
 	// mutexes
 	mutable QReadWriteLock _lock;
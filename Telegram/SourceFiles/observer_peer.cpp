@@ -27,6 +27,7 @@ void FinishCallback() {
 }
 
 base::Observable<PeerUpdate, PeerUpdatedHandler> PeerUpdatedObservable;
+base::Observable<PeerUpdates, PeerUpdatedBatchHandler> PeerUpdatedBatchObservable;
 
 } // namespace
 
@@ -75,6 +76,14 @@ void peerUpdatedSendDelayed() {
 
 	auto smallList = base::take(*SmallUpdates);
 	auto allList = base::take(*AllUpdates);
+
+	auto batch = smallList;
+	batch.reserve(batch.size() + allList.size());
+	for (const auto &update : allList) {
+		batch.push_back(update);
+	}
+	PeerUpdatedBatch().notify(std::move(batch), true);
+
 	for (auto &update : smallList) {
 		PeerUpdated().notify(std::move(update), true);
 	}
@@ -92,6 +101,10 @@ base::Observable<PeerUpdate, PeerUpdatedHandler> &PeerUpdated() {
 	return PeerUpdatedObservable;
 }
 
+base::Observable<PeerUpdates, PeerUpdatedBatchHandler> &PeerUpdatedBatch() {
+	return PeerUpdatedBatchObservable;
+}
+
 rpl::producer<PeerUpdate> PeerUpdateViewer(
 		PeerUpdate::Flags flags) {
 	return [=](const auto &consumer) {
@@ -102,6 +102,33 @@ private:
 };
 base::Observable<PeerUpdate, PeerUpdatedHandler> &PeerUpdated();
 
+// A single frame of a large sync can bring thousands of peer updates
+// at once, so heavy observers can subscribe to the whole coalesced
+// list instead of being invoked once for each peer. The updates are
+// already merged by peer, each peer occurs in the list at most once.
+using PeerUpdates = QVector<PeerUpdate>;
+
+class PeerUpdatedBatchHandler {
+public:
+	template <typename Lambda>
+	PeerUpdatedBatchHandler(PeerUpdate::Flags events, Lambda &&handler) : _events(events), _handler(std::move(handler)) {
+	}
+	void operator()(const PeerUpdates &updates) const {
+		for (const auto &update : updates) {
+			if (update.flags & _events) {
+				_handler(updates);
+				return;
+			}
+		}
+	}
+
+private:
+	PeerUpdate::Flags _events;
+	Fn<void(const PeerUpdates&)> _handler;
+
+};
+base::Observable<PeerUpdates, PeerUpdatedBatchHandler> &PeerUpdatedBatch();
+
 rpl::producer<PeerUpdate> PeerUpdateViewer(
 	PeerUpdate::Flags flags);
 
@@ -386,6 +386,11 @@ void Photo::setPixFrom(not_null<Image*> image) {
 	_pix = App::pixmapFromImageInPlace(std::move(img));
 }
 
+void Photo::clearHeavyPart() {
+	_pix = QPixmap();
+	_goodLoaded = false;
+}
+
 TextState Photo::getState(
 		QPoint point,
 		StateRequest request) const {
@@ -540,6 +545,10 @@ bool Video::iconAnimated() const {
 	return true;
 }
 
+void Video::clearHeavyPart() {
+	_pix = QPixmap();
+}
+
 TextState Video::getState(
 		QPoint point,
 		StateRequest request) const {
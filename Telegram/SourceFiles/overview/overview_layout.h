@@ -58,6 +58,11 @@ public:
 	virtual void invalidateCache() {
 	}
 
+	// Frees the rendered tile pixmap when the item is scrolled far
+	// away from the viewport, it is rebuilt on the next paint.
+	virtual void clearHeavyPart() {
+	}
+
 };
 
 class ItemBase : public AbstractItem {
@@ -206,6 +211,7 @@ public:
 	TextState getState(
 		QPoint point,
 		StateRequest request) const override;
+	void clearHeavyPart() override;
 
 private:
 	void setPixFrom(not_null<Image*> image);
@@ -230,6 +236,7 @@ public:
 	TextState getState(
 		QPoint point,
 		StateRequest request) const override;
+	void clearHeavyPart() override;
 
 protected:
 	float64 dataProgress() const override;
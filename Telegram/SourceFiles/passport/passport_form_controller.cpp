@@ -1405,7 +1405,6 @@ void FormController::prepareFile(
 	file.fields.dcId = MTP::maindc();
 	file.fields.secret = GenerateSecretBytes();
 	file.fields.date = unixtime();
-	file.fields.image = ReadImage(bytes::make_span(content));
 	file.fields.downloadOffset = file.fields.size;
 
 	_scanUpdated.fire(&file);
@@ -1421,9 +1420,14 @@ void FormController::encryptFile(
 	crl::async([
 		=,
 		fileId = file.fields.id,
+		fileDcId = file.fields.dcId,
 		bytes = std::move(content),
 		fileSecret = file.fields.secret
 	] {
+		// The preview is decoded here as well, so that the main thread
+		// only does bookkeeping and the next scan from a multiple files
+		// selection is processed while this one is encrypted / uploaded.
+		auto image = ReadImage(bytes::make_span(bytes));
 		auto data = EncryptData(
 			bytes::make_span(bytes),
 			fileSecret);
@@ -1436,8 +1440,17 @@ void FormController::encryptFile(
 			result.bytes.data(),
 			result.bytes.size(),
 			result.md5checksum.data());
-		crl::on_main([=, encrypted = std::move(result)]() mutable {
+		crl::on_main([
+			=,
+			encrypted = std::move(result),
+			image = std::move(image)
+		]() mutable {
 			if (weak.lock()) {
+				const auto key = FileKey{ fileId, fileDcId };
+				if (const auto file = findEditFile(key)) {
+					file->fields.image = std::move(image);
+					_scanUpdated.fire(file);
+				}
 				callback(std::move(encrypted));
 			}
 		});
@@ -12,10 +12,79 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include <rpl/then.h>
 #include <rpl/range.h>
 #include <algorithm>
+#include <cstddef>
 #include "base/assertion.h"
 #include "base/index_based_iterator.h"
 
 namespace rpl {
+namespace details {
+
+// A fixed chunk of memory that can be handed out to one owner at a time.
+template <std::size_t Size>
+struct inline_storage {
+	alignas(std::max_align_t) char buffer[Size];
+	bool used = false;
+};
+
+// Serves allocations that fit from the inline storage, falling back to
+// the heap for larger ones or while the storage is handed out already.
+template <typename T, std::size_t Size>
+class inline_storage_allocator {
+public:
+	using value_type = T;
+
+	// The size parameter is a non-type one, so allocator_traits can't
+	// provide the default rebind and it is spelled out explicitly.
+	template <typename Other>
+	struct rebind {
+		using other = inline_storage_allocator<Other, Size>;
+	};
+
+	inline_storage_allocator(inline_storage<Size> *storage)
+	: _storage(storage) {
+	}
+	template <typename Other>
+	inline_storage_allocator(
+		const inline_storage_allocator<Other, Size> &other)
+	: _storage(other._storage) {
+	}
+
+	T *allocate(std::size_t count) {
+		if (!_storage->used && count * sizeof(T) <= Size) {
+			_storage->used = true;
+			return reinterpret_cast<T*>(_storage->buffer);
+		}
+		return static_cast<T*>(::operator new(count * sizeof(T)));
+	}
+	void deallocate(T *pointer, std::size_t count) {
+		if (static_cast<void*>(pointer)
+			== static_cast<void*>(_storage->buffer)) {
+			_storage->used = false;
+		} else {
+			::operator delete(pointer);
+		}
+	}
+
+	template <typename Other>
+	bool operator==(
+			const inline_storage_allocator<Other, Size> &other) const {
+		return (_storage == other._storage);
+	}
+	template <typename Other>
+	bool operator!=(
+			const inline_storage_allocator<Other, Size> &other) const {
+		return !(*this == other);
+	}
+
+private:
+	template <typename Other, std::size_t OtherSize>
+	friend class inline_storage_allocator;
+
+	inline_storage<Size> *_storage = nullptr;
+
+};
+
+} // namespace details
 
 // Currently not thread-safe :(
 
@@ -53,6 +122,11 @@ public:
 						}
 					}
 				};
+				if (!strong->consumers.capacity()) {
+					// Grab the whole inline storage at once, growing
+					// from it one by one would move it to the heap.
+					strong->consumers.reserve(Data::kInlineConsumers);
+				}
 				strong->consumers.push_back(std::move(consumer));
 				return lifetime(std::move(result));
 			}
@@ -73,7 +147,25 @@ public:
 
 private:
 	struct Data {
-		std::vector<consumer<Value, no_error>> consumers;
+		// The first consumers live in the inline storage, so streams
+		// with up to kInlineConsumers simultaneous consumers never
+		// allocate for the consumers list, only for the Data itself.
+		static constexpr auto kInlineConsumers = std::size_t(4);
+
+		using Consumer = consumer<Value, no_error>;
+		using Storage = details::inline_storage<
+			kInlineConsumers * sizeof(Consumer)>;
+		using Allocator = details::inline_storage_allocator<
+			Consumer,
+			kInlineConsumers * sizeof(Consumer)>;
+
+		Data() : consumers(Allocator(&storage)) {
+		}
+		Data(const Data &other) = delete;
+		Data &operator=(const Data &other) = delete;
+
+		Storage storage;
+		std::vector<Consumer, Allocator> consumers;
 		int depth = 0;
 	};
 	std::weak_ptr<Data> make_weak() const;
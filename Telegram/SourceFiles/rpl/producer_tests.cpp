@@ -308,6 +308,24 @@ TEST_CASE("basic event_streams tests", "[rpl::event_stream]") {
 		REQUIRE(*sum == 1 + 2 + 3);
 	}
 
+	SECTION("event_stream outgrows inline consumers storage") {
+		auto sum = std::make_shared<int>(0);
+		lifetime extended;
+		{
+			event_stream<int> stream;
+			for (auto i = 0; i != 6; ++i) {
+				stream.events().start([=](int value) {
+					*sum += value;
+				}, [=](no_error) {
+				}, [=] {
+				}, extended);
+			}
+			stream.fire(1);
+			stream.fire(2);
+		}
+		REQUIRE(*sum == 6 * (1 + 2));
+	}
+
 	SECTION("event_stream move test") {
 		auto sum = std::make_shared<int>(0);
 		lifetime extended;
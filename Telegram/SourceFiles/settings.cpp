@@ -16,6 +16,7 @@ uint64 gRealAlphaVersion = AppAlphaVersion;
 QByteArray gAlphaPrivateKey;
 
 bool gTestMode = false;
+bool gStartProfilerAtLaunch = false;
 bool gManyInstance = false;
 QString gKeyFile;
 QString gWorkingDir, gExeDir, gExeName;
@@ -60,6 +61,8 @@ RecentHashtagPack gRecentWriteHashtags, gRecentSearchHashtags;
 
 RecentInlineBots gRecentInlineBots;
 
+RecentSharePack gRecentSharePeers;
+
 bool gPasswordRecovered = false;
 int32 gPasscodeBadTries = 0;
 TimeMs gPasscodeLastTry = 0;
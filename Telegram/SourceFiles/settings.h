@@ -34,6 +34,7 @@ DeclareSetting(uint64, RealAlphaVersion);
 DeclareSetting(QByteArray, AlphaPrivateKey);
 
 DeclareSetting(bool, TestMode);
+DeclareSetting(bool, StartProfilerAtLaunch);
 DeclareSetting(QString, LoggedPhoneNumber);
 DeclareSetting(bool, AutoStart);
 DeclareSetting(bool, StartMinimized);
@@ -133,6 +134,14 @@ class UserData;
 typedef QVector<UserData*> RecentInlineBots;
 DeclareRefSetting(RecentInlineBots, RecentInlineBots);
 
+struct RecentSharedPeer {
+	uint64 peer = 0;
+	int32 date = 0; // unixtime of the last share
+	ushort count = 0;
+};
+typedef QList<RecentSharedPeer> RecentSharePack;
+DeclareRefSetting(RecentSharePack, RecentSharePeers);
+
 DeclareSetting(bool, PasswordRecovered);
 
 DeclareSetting(int32, PasscodeBadTries);
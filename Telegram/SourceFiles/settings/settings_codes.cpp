@@ -16,6 +16,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "lang/lang_cloud_manager.h"
 #include "lang/lang_instance.h"
 #include "core/application.h"
+#include "core/media_active_cache.h"
 #include "mtproto/mtp_instance.h"
 #include "mtproto/dc_options.h"
 #include "core/file_utilities.h"
@@ -68,6 +69,34 @@ auto GenerateCodes() {
 	codes.emplace(qsl("crashplease"), [] {
 		Unexpected("Crashed in Settings!");
 	});
+	codes.emplace(qsl("paintprofile"), [] {
+		if (Ui::PaintProfilingEnabled()) {
+			const auto collected = Ui::CollectPaintProfile();
+			Ui::SetPaintProfilingEnabled(false);
+			Ui::show(Box<InformBox>(collected.isEmpty()
+				? qsl("Paint profiling disabled.")
+				: qsl("Paint profiling disabled, "
+					"most expensive widgets:\n\n") + collected));
+		} else {
+			Ui::SetPaintProfilingEnabled(true);
+			Ui::show(Box<InformBox>(
+				qsl("Paint profiling enabled.\n\n"
+					"Use \"paintprofile\" again to see the most "
+					"expensive widgets and disable profiling.")));
+		}
+	});
+	codes.emplace(qsl("mediamemory"), [] {
+		auto text = qsl("Unpacked media in memory (budget %1 MB):"
+		).arg(Core::MediaCacheBudget() / (1024 * 1024));
+		for (const auto &category : Core::MediaCacheUsageByCategory()) {
+			text += qsl("\n%1: %2 KB"
+			).arg(category.name
+			).arg(category.bytes / 1024);
+		}
+		text += qsl("\ntotal: %1 KB"
+		).arg(Core::MediaCacheTotalUsage() / 1024);
+		Ui::show(Box<InformBox>(text));
+	});
 	codes.emplace(qsl("workmode"), [] {
 		auto text = Global::DialogsModeEnabled() ? qsl("Disable work mode?") : qsl("Enable work mode?");
 		Ui::show(Box<ConfirmBox>(text, [] {
@@ -87,6 +116,31 @@ auto GenerateCodes() {
 			main->getDifference();
 		}
 	});
+	codes.emplace(qsl("recordupdates"), [] {
+		if (auto main = App::main()) {
+			main->toggleUpdatesRecording();
+			Ui::show(Box<InformBox>(main->recordingUpdates()
+				? qsl("Recording updates to \"updates.tdrec\".\n\n"
+					"Use \"recordupdates\" again to stop.")
+				: qsl("Updates recording stopped.")));
+		}
+	});
+	codes.emplace(qsl("replayupdates"), [] {
+		if (auto main = App::main()) {
+			if (!main->replayRecordedUpdates(false)) {
+				Ui::show(Box<InformBox>(
+					qsl("Could not read \"updates.tdrec\".")));
+			}
+		}
+	});
+	codes.emplace(qsl("replayupdatesfast"), [] {
+		if (auto main = App::main()) {
+			if (!main->replayRecordedUpdates(true)) {
+				Ui::show(Box<InformBox>(
+					qsl("Could not read \"updates.tdrec\".")));
+			}
+		}
+	});
 	codes.emplace(qsl("loadcolors"), [] {
 		FileDialog::GetOpenPath(Core::App().getFileDialogParent(), "Open palette file", "Palette (*.tdesktop-palette)", [](const FileDialog::OpenResult &result) {
 			if (!result.paths.isEmpty()) {
@@ -9,6 +9,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "storage/cache/storage_cache_database_object.h"
 #include "storage/cache/storage_cache_binlog_reader.h"
+#include "base/concurrent_timer.h"
 #include <unordered_set>
 
 namespace Storage {
@@ -41,6 +42,7 @@ private:
 	bool readHeader();
 	bool openCompact();
 	void parseChunk();
+	void scheduleNextChunk();
 	void fail();
 	void done(int64 till);
 	void finish();
@@ -74,6 +76,8 @@ private:
 	File _binlog;
 	File _compact;
 	BinlogWrapper _wrapper;
+	base::ConcurrentTimer _nextChunkTimer;
+	int64 _lastChunkSize = 0;
 	size_type _partSize = 0;
 	std::unordered_set<Key> _written;
 	base::variant<
@@ -98,8 +102,10 @@ CompactorObject::CompactorObject(
 , _key(std::move(key))
 , _info(info)
 , _wrapper(_binlog, _settings, _info.till)
+, _nextChunkTimer(_weak, [=] { parseChunk(); })
 , _partSize(_settings.maxBundledRecords) { // Perhaps a better estimate?
 	Expects(_settings.compactChunkSize > 0);
+	Expects(_settings.compactRateBytes > 0);
 
 	_written.reserve(_info.keysCount);
 	start();
@@ -297,6 +303,7 @@ bool CompactorObject::readBlock(std::vector<Key> &result) {
 }
 
 void CompactorObject::parseChunk() {
+	const auto from = _binlog.offset();
 	auto keys = readChunk();
 	if (_wrapper.failed()) {
 		fail();
@@ -305,10 +312,14 @@ void CompactorObject::parseChunk() {
 		finish();
 		return;
 	}
+	const auto till = _binlog.offset();
+	_lastChunkSize = till - from;
 	_database.with([
 		weak = _weak,
-		keys = std::move(keys)
+		keys = std::move(keys),
+		till
 	](DatabaseObject &database) {
+		database.compactorProgress(till);
 		auto result = database.getManyRaw(keys);
 		weak.with([result = std::move(result)](CompactorObject &that) {
 			that.processValues(result);
@@ -328,7 +339,18 @@ void CompactorObject::processValues(
 			return;
 		}
 	}
-	parseChunk();
+	scheduleNextChunk();
+}
+
+void CompactorObject::scheduleNextChunk() {
+	// Rate-limit the binlog reading so that compacting a huge cache
+	// does not saturate the disk under the concurrent get() calls.
+	const auto delay = (_lastChunkSize * 1000) / _settings.compactRateBytes;
+	if (delay > 0) {
+		_nextChunkTimer.callOnce(delay);
+	} else {
+		parseChunk();
+	}
 }
 
 auto CompactorObject::fillList(RawSpan values) -> RawSpan {
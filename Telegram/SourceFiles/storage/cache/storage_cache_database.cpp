@@ -8,12 +8,14 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/cache/storage_cache_database.h"
 
 #include "storage/cache/storage_cache_database_object.h"
+#include "storage/cache/storage_cache_key_filter.h"
 
 namespace Storage {
 namespace Cache {
 
 Database::Database(const QString &path, const Settings &settings)
-: _wrapped(path, settings) {
+: _filter(std::make_shared<details::KeyFilter>())
+, _wrapped(path, settings, _filter) {
 }
 
 void Database::reconfigure(const Settings &settings) {
@@ -145,6 +147,14 @@ void Database::putIfEmpty(
 void Database::getWithTag(
 		const Key &key,
 		FnMut<void(TaggedValue&&)> &&done) {
+	if (!_filter->mayContain(key)) {
+		// The common miss is answered synchronously, without the
+		// bounce through the database thread and back.
+		if (done) {
+			done(TaggedValue());
+		}
+		return;
+	}
 	_wrapped.with([
 		key,
 		done = std::move(done)
@@ -19,6 +19,7 @@ class EncryptionKey;
 namespace Cache {
 namespace details {
 class DatabaseObject;
+class KeyFilter;
 } // namespace details
 
 class Database {
@@ -76,6 +77,10 @@ public:
 
 private:
 	using Implementation = details::DatabaseObject;
+
+	// Shared with the database thread, checked on the caller thread
+	// in getWithTag() to answer misses without the thread round trip.
+	std::shared_ptr<details::KeyFilter> _filter;
 	crl::object_on_queue<Implementation> _wrapped;
 
 };
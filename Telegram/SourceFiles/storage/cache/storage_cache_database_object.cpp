@@ -76,10 +76,12 @@ DatabaseObject::Entry::Entry(
 DatabaseObject::DatabaseObject(
 	crl::weak_on_queue<DatabaseObject> weak,
 	const QString &path,
-	const Settings &settings)
+	const Settings &settings,
+	std::shared_ptr<KeyFilter> filter)
 : _weak(std::move(weak))
 , _base(ComputeBasePath(path))
 , _settings(settings)
+, _filter(std::move(filter))
 , _writeBundlesTimer(_weak, [=] { writeBundles(); checkCompactor(); })
 , _pruneTimer(_weak, [=] { prune(); }) {
 	checkSettings();
@@ -353,6 +355,8 @@ void DatabaseObject::prune() {
 }
 
 void DatabaseObject::startStaleClear() {
+	_staleClearFull = size_type(_stale.size());
+
 	// Report "Clearing..." status.
 	pushStats();
 	clearStaleChunk();
@@ -401,8 +405,10 @@ void DatabaseObject::clearStaleChunk() {
 	_stale.resize(count - clear);
 	if (_stale.empty()) {
 		base::take(_stale);
+		_staleClearFull = 0;
 		optimize();
 	} else {
+		pushStatsDelayed();
 		clearStaleChunkDelayed();
 	}
 }
@@ -581,6 +587,9 @@ bool DatabaseObject::processRecordMultiAccess(
 }
 
 void DatabaseObject::setMapEntry(const Key &key, Entry &&entry) {
+	if (_filter) {
+		_filter->add(key);
+	}
 	auto &already = _map[key];
 	updateStats(already, entry);
 	if (already.size != 0) {
@@ -719,6 +728,15 @@ void DatabaseObject::compactorDone(
 	}
 	_binlogExcessLength -= _compactor.excessLength;
 	Assert(_binlogExcessLength >= 0);
+	pushStatsDelayed();
+}
+
+void DatabaseObject::compactorProgress(int64 readTill) {
+	if (!_compactor.object) {
+		return;
+	}
+	_compactor.readTill = readTill;
+	pushStatsDelayed();
 }
 
 void DatabaseObject::compactorFail() {
@@ -729,6 +747,7 @@ void DatabaseObject::compactorFail() {
 		delay * 2,
 		kMaxDelayAfterFailure);
 	QFile(compactReadyPath()).remove();
+	pushStatsDelayed();
 }
 
 void DatabaseObject::close(FnMut<void()> &&done) {
@@ -741,12 +760,16 @@ void DatabaseObject::close(FnMut<void()> &&done) {
 }
 
 void DatabaseObject::clearState() {
+	if (_filter) {
+		_filter->clear();
+	}
 	_path = QString();
 	_key = {};
 	_map = {};
 	_removing = {};
 	_accessed = {};
 	_stale = {};
+	_staleClearFull = 0;
 	_time = {};
 	_binlogExcessLength = 0;
 	_totalSize = 0;
@@ -965,7 +988,7 @@ QByteArray DatabaseObject::readValueData(PlaceId place, size_type size) const {
 	case File::Result::Success: {
 		auto result = QByteArray(size, Qt::Uninitialized);
 		const auto bytes = bytes::make_detached_span(result);
-		const auto read = data.readWithPadding(bytes);
+		const auto read = data.readMappedWithPadding(bytes);
 		if (read != size) {
 			return QByteArray();
 		}
@@ -1064,6 +1087,15 @@ Stats DatabaseObject::collectStats() const {
 	result.full.count = _map.size();
 	result.full.totalSize = _totalSize;
 	result.clearing = (_cleaner.object != nullptr) || !_stale.empty();
+	if (!_stale.empty() && _staleClearFull > 0) {
+		result.clearFull = _staleClearFull;
+		result.clearDone = _staleClearFull - size_type(_stale.size());
+	}
+	result.compacting = (_compactor.object != nullptr);
+	if (result.compacting) {
+		result.compactDone = _compactor.readTill;
+		result.compactFull = _compactor.till;
+	}
 	return result;
 }
 
@@ -1206,6 +1238,9 @@ void DatabaseObject::checkCompactor() {
 		base::duplicate(_key),
 		info);
 	_compactor.excessLength = _binlogExcessLength;
+	_compactor.readTill = 0;
+	_compactor.till = info.till;
+	pushStatsDelayed();
 }
 
 void DatabaseObject::clear(FnMut<void(Error)> &&done) {
@@ -1235,6 +1270,11 @@ void DatabaseObject::clearByTag(uint8 tag, FnMut<void(Error)> &&done) {
 	}
 	if (!hadStale) {
 		startStaleClear();
+	} else {
+		_staleClearFull = std::max(
+			_staleClearFull,
+			size_type(_stale.size()));
+		pushStatsDelayed();
 	}
 	invokeCallback(done, Error::NoError());
 }
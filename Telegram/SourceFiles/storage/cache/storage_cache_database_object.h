@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "storage/cache/storage_cache_database.h"
+#include "storage/cache/storage_cache_key_filter.h"
 #include "storage/storage_encrypted_file.h"
 #include "base/binary_guard.h"
 #include "base/concurrent_timer.h"
@@ -29,7 +30,8 @@ public:
 	DatabaseObject(
 		crl::weak_on_queue<DatabaseObject> weak,
 		const QString &path,
-		const Settings &settings);
+		const Settings &settings,
+		std::shared_ptr<KeyFilter> filter);
 	void reconfigure(const Settings &settings);
 	void updateSettings(const SettingsUpdate &update);
 
@@ -67,6 +69,7 @@ public:
 
 	void compactorDone(const QString &path, int64 originalReadTill);
 	void compactorFail();
+	void compactorProgress(int64 readTill);
 
 	struct Entry {
 		Entry() = default;
@@ -97,6 +100,8 @@ private:
 	struct CompactorWrap {
 		std::unique_ptr<Compactor> object;
 		int64 excessLength = 0;
+		int64 readTill = 0;
+		int64 till = 0;
 		crl::time_type nextAttempt = 0;
 		crl::time_type delayAfterFailure = 10 * crl::time_type(1000);
 		base::binary_guard guard;
@@ -222,9 +227,11 @@ private:
 	EncryptionKey _key;
 	File _binlog;
 	Map _map;
+	std::shared_ptr<KeyFilter> _filter;
 	std::set<Key> _removing;
 	std::set<Key> _accessed;
 	std::vector<Key> _stale;
+	size_type _staleClearFull = 0;
 
 	EstimatedTimePoint _time;
 
@@ -0,0 +1,51 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "storage/cache/storage_cache_key_filter.h"
+
+namespace Storage {
+namespace Cache {
+namespace details {
+
+KeyFilter::KeyFilter() {
+	clear();
+}
+
+void KeyFilter::clear() {
+	for (auto &word : _words) {
+		word.store(0, std::memory_order_relaxed);
+	}
+}
+
+void KeyFilter::add(const Key &key) {
+	const auto set = [&](uint64 bit) {
+		bit &= (kBitsCount - 1);
+		_words[bit >> 6].fetch_or(
+			uint64(1) << (bit & 63),
+			std::memory_order_relaxed);
+	};
+	set(key.high);
+	set(key.high >> 23);
+	set(key.low);
+	set(key.low >> 23);
+}
+
+bool KeyFilter::mayContain(const Key &key) const {
+	const auto check = [&](uint64 bit) {
+		bit &= (kBitsCount - 1);
+		const auto word = _words[bit >> 6].load(std::memory_order_relaxed);
+		return (word & (uint64(1) << (bit & 63))) != 0;
+	};
+	return check(key.high)
+		&& check(key.high >> 23)
+		&& check(key.low)
+		&& check(key.low >> 23);
+}
+
+} // namespace details
+} // namespace Cache
+} // namespace Storage
@@ -0,0 +1,42 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+#include "storage/cache/storage_cache_types.h"
+#include <array>
+#include <atomic>
+
+namespace Storage {
+namespace Cache {
+namespace details {
+
+// Approximate membership test over the binlog index, shared between
+// the caller threads and the database thread. Keys are uniformly
+// distributed hashes already, so the bit positions are taken straight
+// from the key bits. False positives just pay the usual bounce through
+// the database thread and removals may leave stale positives, but a
+// key that was added is never reported as missing.
+class KeyFilter {
+public:
+	KeyFilter();
+
+	void add(const Key &key);
+	[[nodiscard]] bool mayContain(const Key &key) const;
+	void clear();
+
+private:
+	static constexpr auto kBitsCount = size_type(1) << 23;
+	static constexpr auto kWordsCount = kBitsCount / 64;
+
+	std::array<std::atomic<uint64>, kWordsCount> _words;
+
+};
+
+} // namespace details
+} // namespace Cache
+} // namespace Storage
@@ -74,6 +74,7 @@ struct Settings {
 	int64 compactAfterExcess = 8 * 1024 * 1024;
 	int64 compactAfterFullSize = 0;
 	size_type compactChunkSize = 16 * 1024;
+	int64 compactRateBytes = 16 * 1024 * 1024; // Read rate limit, per second.
 
 	bool trackEstimatedTime = true;
 	int64 totalSizeLimit = 1024 * 1024 * 1024;
@@ -105,6 +106,11 @@ struct Stats {
 	TaggedSummary full;
 	base::flat_map<uint8, TaggedSummary> tagged;
 	bool clearing = false;
+	int64 clearDone = 0;
+	int64 clearFull = 0;
+	bool compacting = false;
+	int64 compactDone = 0;
+	int64 compactFull = 0;
 };
 
 using Version = int32;
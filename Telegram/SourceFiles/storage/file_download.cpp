@@ -116,8 +116,12 @@ namespace {
 constexpr auto kDownloadPhotoPartSize = 64 * 1024; // 64kb for photo
 constexpr auto kDownloadDocumentPartSize = 128 * 1024; // 128kb for document
 constexpr auto kMaxFileQueries = 16; // max 16 file parts downloaded at the same time
+constexpr auto kMaxFileQueriesLarge = 64; // the in-flight window may grow to this for large files
 constexpr auto kMaxWebFileQueries = 8; // max 8 http[s] files downloaded at the same time
 constexpr auto kDownloadCdnPartSize = 128 * 1024; // 128kb for cdn requests
+constexpr auto kQueriesLimitGrowDelay = TimeMs(200); // grow the window once per this
+constexpr auto kQueriesLimitGrowFileSize = 8 * 1024 * 1024; // only large files grow the window
+constexpr auto kResumeDataWriteDelay = TimeMs(1000); // write resume state once per this
 
 } // namespace
 
@@ -126,6 +130,7 @@ struct FileLoaderQueue {
 	}
 	int queriesCount = 0;
 	int queriesLimit = 0;
+	TimeMs lastGrowTime = 0;
 	FileLoader *start = nullptr;
 	FileLoader *end = nullptr;
 };
@@ -164,6 +169,22 @@ FileLoader::FileLoader(
 , _size(size)
 , _locationType(locationType) {
 	Expects(!_filename.isEmpty() || (_size <= Storage::kMaxFileInMemory));
+
+	_loadPriority = autoLoading
+		? LoadPriority::Background
+		: LoadPriority::Visible;
+}
+
+void FileLoader::setLoadPriority(LoadPriority priority) {
+	if (_loadPriority == priority) {
+		return;
+	}
+	const auto raised = (priority > _loadPriority);
+	_loadPriority = priority;
+	if (raised && _inQueue && !_finished) {
+		PreemptQueueForPriority(_queue, _loadPriority);
+		LoadNextFromQueue(_queue);
+	}
 }
 
 void FileLoader::finishWithBytes(const QByteArray &data) {
@@ -255,13 +276,39 @@ void FileLoader::LoadNextFromQueue(not_null<FileLoaderQueue*> queue) {
 	if (queue->queriesCount >= queue->queriesLimit) {
 		return;
 	}
-	for (auto i = queue->start; i;) {
-		if (i->loadPart()) {
-			if (queue->queriesCount >= queue->queriesLimit) {
-				return;
+	// Hand out query slots strictly by priority class, so media the
+	// user is looking at is requested before preloads, and preloads
+	// before background auto-downloads.
+	const auto classes = {
+		LoadPriority::Visible,
+		LoadPriority::Preload,
+		LoadPriority::Background,
+	};
+	for (const auto priority : classes) {
+		for (auto i = queue->start; i;) {
+			if (i->_loadPriority != priority) {
+				i = i->_next;
+			} else if (i->loadPart()) {
+				if (queue->queriesCount >= queue->queriesLimit) {
+					return;
+				}
+			} else {
+				i = i->_next;
 			}
-		} else {
-			i = i->_next;
+		}
+	}
+}
+
+void FileLoader::PreemptQueueForPriority(
+		not_null<FileLoaderQueue*> queue,
+		LoadPriority priority) {
+	// Take in-flight part requests back from lower priority loaders,
+	// freeing query slots for a higher priority one right away.
+	for (auto i = queue->end; i; i = i->_prev) {
+		if (queue->queriesCount < queue->queriesLimit) {
+			return;
+		} else if (i->_loadPriority < priority) {
+			i->releasePartsForPreemption();
 		}
 	}
 }
@@ -323,10 +370,13 @@ void FileLoader::start(bool loadFirst, bool prior) {
 	}
 
 	if (!_filename.isEmpty() && _toCache == LoadToFileOnly && !_fileIsOpen) {
-		_fileIsOpen = _file.open(QIODevice::WriteOnly);
+		_fileIsOpen = _file.open(QIODevice::ReadWrite);
 		if (!_fileIsOpen) {
 			return cancel(true);
 		}
+		if (!checkResumeData()) {
+			_file.resize(0);
+		}
 	}
 
 	auto currentPriority = _downloader->currentPriority();
@@ -504,6 +554,7 @@ void FileLoader::cancel(bool fail) {
 		_file.close();
 		_fileIsOpen = false;
 		_file.remove();
+		clearResumeData();
 	}
 	_data = QByteArray();
 	removeFromQueue();
@@ -523,7 +574,14 @@ void FileLoader::cancel(bool fail) {
 }
 
 void FileLoader::startLoading(bool loadFirst, bool prior) {
-	if ((_queue->queriesCount >= _queue->queriesLimit && (!loadFirst || !prior)) || _finished) {
+	if (_finished) {
+		return;
+	}
+	if (_queue->queriesCount >= _queue->queriesLimit
+		&& _loadPriority > LoadPriority::Background) {
+		PreemptQueueForPriority(_queue, _loadPriority);
+	}
+	if (_queue->queriesCount >= _queue->queriesLimit && (!loadFirst || !prior)) {
 		return;
 	}
 	loadPart();
@@ -676,6 +734,8 @@ void mtpFileLoader::refreshFileReferenceFrom(
 bool mtpFileLoader::loadPart() {
 	if (_finished || _lastComplete || (!_sentRequests.empty() && !_size)) {
 		return false;
+	} else if (_resumeChecking) {
+		return false;
 	} else if (_size && _nextRequestOffset >= _size) {
 		return false;
 	}
@@ -1009,7 +1069,12 @@ bool mtpFileLoader::feedPart(int offset, bytes::const_span buffer) {
 				return false;
 			}
 		} else {
-			_data.reserve(offset + buffer.size());
+			if (_size > 0 && _data.capacity() < _size) {
+				// Reserve the full file once. An exact reserve per part
+				// pins the capacity, so every following part reallocated
+				// the array and copied the whole downloaded prefix.
+				_data.reserve(_size);
+			}
 			if (offset > _data.size()) {
 				_skippedBytes += offset - _data.size();
 				_data.resize(offset);
@@ -1079,8 +1144,142 @@ bool mtpFileLoader::feedPart(int offset, bytes::const_span buffer) {
 	return true;
 }
 
+void mtpFileLoader::adjustQueriesLimit() {
+	// Ramp the in-flight window up while a large download keeps the
+	// queue saturated without errors, the way a congestion window grows,
+	// so that high-bandwidth links are not capped at 16 parts per
+	// round-trip. Any part failure on the queue drops it back.
+	if (_size < kQueriesLimitGrowFileSize
+		|| _queue->queriesLimit >= kMaxFileQueriesLarge
+		|| _queue->queriesCount + 1 < _queue->queriesLimit) {
+		return;
+	}
+	const auto now = getms(true);
+	if (now - _queue->lastGrowTime < kQueriesLimitGrowDelay) {
+		return;
+	}
+	_queue->lastGrowTime = now;
+	++_queue->queriesLimit;
+}
+
+std::optional<Storage::Cache::Key> mtpFileLoader::resumeKey() const {
+	if (!_urlLocation
+		&& !_geoLocation
+		&& (_toCache == LoadToFileOnly)
+		&& _id != 0
+		&& AuthSession::Exists()) {
+		return Data::DownloadResumeCacheKey(_dcId, _id);
+	}
+	return std::nullopt;
+}
+
+bool mtpFileLoader::checkResumeData() {
+	const auto key = resumeKey();
+	if (!key || !_size) {
+		return false;
+	}
+	_resumeChecking = true;
+	auto [first, second] = base::make_binary_guard();
+	_resumeLoading = std::move(first);
+	Auth().data().cache().get(*key, [=, guard = std::move(second)](
+			QByteArray &&value) mutable {
+		crl::on_main([
+			=,
+			value = std::move(value),
+			guard = std::move(guard)
+		]() mutable {
+			if (!guard) {
+				return;
+			}
+			applyResumeData(value);
+		});
+	});
+	return true;
+}
+
+void mtpFileLoader::applyResumeData(const QByteArray &value) {
+	Expects(_resumeChecking);
+
+	_resumeChecking = false;
+	const auto prefix = [&]() -> int {
+		if (value.isEmpty() || _finished || !_fileIsOpen) {
+			return 0;
+		}
+		QDataStream stream(value);
+		stream.setVersion(QDataStream::Qt_5_1);
+		qint32 size = 0, prefix = 0, part = 0;
+		QString filename;
+		stream >> size >> prefix >> part >> filename;
+		if (stream.status() != QDataStream::Ok
+			|| size != _size
+			|| part != partSize()
+			|| prefix <= 0
+			|| prefix >= size
+			|| (prefix % part)
+			|| filename != _filename
+			|| _file.size() < prefix) {
+			return 0;
+		}
+		return prefix;
+	}();
+	_file.resize(prefix);
+	if (prefix > 0) {
+		DEBUG_LOG(("Download Info: resuming '%1' from %2."
+			).arg(_filename
+			).arg(prefix));
+		_nextRequestOffset = prefix;
+	}
+	notifyAboutProgress();
+}
+
+void mtpFileLoader::writeResumeData() {
+	const auto key = resumeKey();
+	if (!key || _finished || !_size) {
+		return;
+	}
+	// Everything below the lowest offset still in flight was received,
+	// requests are sent in increasing offset order.
+	auto prefix = _nextRequestOffset;
+	for (const auto &[requestId, requestData] : _sentRequests) {
+		accumulate_min(prefix, int32(requestData.offset));
+	}
+	for (const auto &[offset, bytes] : _cdnUncheckedParts) {
+		accumulate_min(prefix, int32(offset));
+	}
+	if (prefix <= 0) {
+		return;
+	}
+	auto value = QByteArray();
+	{
+		QDataStream stream(&value, QIODevice::WriteOnly);
+		stream.setVersion(QDataStream::Qt_5_1);
+		stream
+			<< qint32(_size)
+			<< qint32(prefix)
+			<< qint32(partSize())
+			<< _filename;
+	}
+	Auth().data().cache().put(*key, std::move(value), nullptr);
+}
+
+void mtpFileLoader::clearResumeData() {
+	if (const auto key = resumeKey()) {
+		Auth().data().cache().remove(*key, nullptr);
+	}
+}
+
 void mtpFileLoader::partLoaded(int offset, bytes::const_span buffer) {
+	adjustQueriesLimit();
 	if (feedPart(offset, buffer)) {
+		if (_finished) {
+			clearResumeData();
+		} else {
+			const auto now = getms(true);
+			if (now - _resumeWriteTime >= kResumeDataWriteDelay) {
+				_resumeWriteTime = now;
+				writeResumeData();
+			}
+		}
 		notifyAboutProgress();
 	}
 }
@@ -1091,6 +1290,9 @@ bool mtpFileLoader::partFailed(
 	if (MTP::isDefaultHandledError(error)) {
 		return false;
 	}
+	if (_queue->queriesLimit > kMaxFileQueries) {
+		_queue->queriesLimit = kMaxFileQueries;
+	}
 	if (error.code() == 400
 		&& error.type().startsWith(qstr("FILE_REFERENCE_"))) {
 		Auth().api().refreshFileReference(
@@ -1137,6 +1339,22 @@ void mtpFileLoader::cancelRequests() {
 	}
 }
 
+bool mtpFileLoader::releasePartsForPreemption() {
+	if (_sentRequests.empty()) {
+		return false;
+	}
+	// Requests are made at increasing offsets, so after cancelling
+	// the in-flight ones we can simply rewind the next offset and
+	// the released parts will be requested again later.
+	auto rewindTo = _nextRequestOffset;
+	for (const auto &[requestId, requestData] : _sentRequests) {
+		accumulate_min(rewindTo, int32(requestData.offset));
+	}
+	cancelRequests();
+	_nextRequestOffset = rewindTo;
+	return true;
+}
+
 void mtpFileLoader::switchToCDN(
 		int offset,
 		const MTPDupload_fileCdnRedirect &redirect) {
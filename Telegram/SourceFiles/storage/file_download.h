@@ -72,6 +72,15 @@ struct StorageImageSaved {
 class mtpFileLoader;
 class webFileLoader;
 
+// Scheduling class for the per-DC download queues: loaders with a
+// higher priority always get their parts requested first and may
+// preempt in-flight parts of lower priority ones.
+enum class LoadPriority {
+	Background, // auto-downloads nobody is looking at
+	Preload, // predictive loads near the viewport
+	Visible, // media currently on the screen
+};
+
 struct FileLoaderQueue;
 class FileLoader : public QObject {
 	Q_OBJECT
@@ -101,6 +110,9 @@ public:
 	}
 	QByteArray imageFormat(const QSize &shrinkBox = QSize()) const;
 	QImage imageData(const QSize &shrinkBox = QSize()) const;
+	bool hasImageData() const {
+		return !_imageData.isNull();
+	}
 	QString fileName() const {
 		return _filename;
 	}
@@ -131,6 +143,10 @@ public:
 	bool autoLoading() const {
 		return _autoLoading;
 	}
+	LoadPriority loadPriority() const {
+		return _loadPriority;
+	}
+	void setLoadPriority(LoadPriority priority);
 
 	virtual void stop() {
 	}
@@ -160,18 +176,37 @@ protected:
 	virtual std::optional<Storage::Cache::Key> cacheKey() const = 0;
 	virtual void cancelRequests() = 0;
 
+	// Returns true if the loader will decide about reusing the already
+	// downloaded part of the destination file, so start() should not
+	// truncate it right away.
+	virtual bool checkResumeData() {
+		return false;
+	}
+	virtual void clearResumeData() {
+	}
+
+	// Returns true if in-flight part requests were taken back to the
+	// queue, freeing query slots for a higher priority loader.
+	virtual bool releasePartsForPreemption() {
+		return false;
+	}
+
 	void startLoading(bool loadFirst, bool prior);
 	void removeFromQueue();
 	void cancel(bool failed);
 
 	void notifyAboutProgress();
 	static void LoadNextFromQueue(not_null<FileLoaderQueue*> queue);
+	static void PreemptQueueForPriority(
+		not_null<FileLoaderQueue*> queue,
+		LoadPriority priority);
 	virtual bool loadPart() = 0;
 
 	not_null<Storage::Downloader*> _downloader;
 	FileLoader *_prev = nullptr;
 	FileLoader *_next = nullptr;
 	int _priority = 0;
+	LoadPriority _loadPriority = LoadPriority::Visible;
 	FileLoaderQueue *_queue = nullptr;
 
 	bool _paused = false;
@@ -268,6 +303,7 @@ private:
 	};
 	std::optional<Storage::Cache::Key> cacheKey() const override;
 	void cancelRequests() override;
+	bool releasePartsForPreemption() override;
 
 	int partSize() const;
 	RequestData prepareRequest(int offset) const;
@@ -283,8 +319,15 @@ private:
 	void getCdnFileHashesDone(const MTPVector<MTPFileHash> &result, mtpRequestId requestId);
 
 	bool feedPart(int offset, bytes::const_span buffer);
+	void adjustQueriesLimit();
 	void partLoaded(int offset, bytes::const_span buffer);
 
+	std::optional<Storage::Cache::Key> resumeKey() const;
+	bool checkResumeData() override;
+	void applyResumeData(const QByteArray &value);
+	void writeResumeData();
+	void clearResumeData() override;
+
 	bool partFailed(const RPCError &error, mtpRequestId requestId);
 	bool cdnPartFailed(const RPCError &error, mtpRequestId requestId);
 
@@ -307,6 +350,10 @@ private:
 	int32 _skippedBytes = 0;
 	int32 _nextRequestOffset = 0;
 
+	bool _resumeChecking = false;
+	TimeMs _resumeWriteTime = 0;
+	base::binary_guard _resumeLoading;
+
 	MTP::DcId _dcId = 0; // for photo locations
 	StorageImageLocation *_location = nullptr;
 
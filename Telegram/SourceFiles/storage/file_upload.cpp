@@ -21,6 +21,16 @@ namespace {
 // max 512kb uploaded at the same time in each session
 constexpr auto kMaxUploadFileParallelSize = MTP::kUploadSessionsCount * 512 * 1024;
 
+// The in-flight budget may grow up to this much on fast connections.
+constexpr auto kMaxUploadFileParallelSizeGrown = MTP::kUploadSessionsCount * 4 * 1024 * 1024;
+
+// Grow the in-flight budget by this much, not faster than once per delay.
+constexpr auto kParallelLimitGrowStep = 256 * 1024;
+constexpr auto kParallelLimitGrowDelay = TimeMs(200);
+
+// Retry a single document part this many times before failing the file.
+constexpr auto kMaxDocPartRetries = 2;
+
 constexpr auto kDocumentMaxPartsCount = 3000;
 
 // 32kb for tiny document ( < 1mb )
@@ -140,7 +150,8 @@ const QString &Uploader::File::filename() const {
 	return file ? file->filename : media.filename;
 }
 
-Uploader::Uploader() {
+Uploader::Uploader()
+: _parallelLimit(kMaxUploadFileParallelSize) {
 	nextTimer.setSingleShot(true);
 	connect(&nextTimer, SIGNAL(timeout()), this, SLOT(sendNext()));
 	stopSessionsTimer.setSingleShot(true);
@@ -249,12 +260,15 @@ void Uploader::currentFailed() {
 
 	requestsSent.clear();
 	docRequestsSent.clear();
+	docPartBytes.clear();
+	docPartRetries.clear();
 	dcMap.clear();
 	uploadingId = FullMsgId();
 	sentSize = 0;
 	for (int i = 0; i < MTP::kUploadSessionsCount; ++i) {
 		sentSizes[i] = 0;
 	}
+	_parallelLimit = kMaxUploadFileParallelSize;
 
 	sendNext();
 }
@@ -265,8 +279,59 @@ void Uploader::stopSessions() {
 	}
 }
 
+int32 Uploader::chooseDcIndex() const {
+	auto result = 0;
+	for (auto dc = 1; dc != MTP::kUploadSessionsCount; ++dc) {
+		if (sentSizes[dc] < sentSizes[result]) {
+			result = dc;
+		}
+	}
+	return result;
+}
+
+void Uploader::adjustParallelLimit(int32 sentPartSize) {
+	// Grow the in-flight budget like a congestion window: only while
+	// parts complete with the pipe still full, and not too often.
+	if (sentSize + sentPartSize < _parallelLimit
+		|| _parallelLimit >= kMaxUploadFileParallelSizeGrown) {
+		return;
+	}
+	const auto now = getms(true);
+	if (now - _parallelGrowTime < kParallelLimitGrowDelay) {
+		return;
+	}
+	_parallelGrowTime = now;
+	_parallelLimit += kParallelLimitGrowStep;
+}
+
+mtpRequestId Uploader::sendDocPartRequest(
+		const File &uploadingData,
+		int32 part,
+		const QByteArray &bytes,
+		int32 todc) {
+	if (uploadingData.docSize > kUseBigFilesFrom) {
+		return MTP::send(
+			MTPupload_SaveBigFilePart(
+				MTP_long(uploadingData.id()),
+				MTP_int(part),
+				MTP_int(uploadingData.docPartsCount),
+				MTP_bytes(bytes)),
+			rpcDone(&Uploader::partLoaded),
+			rpcFail(&Uploader::partFailed),
+			MTP::uploadDcId(todc));
+	}
+	return MTP::send(
+		MTPupload_SaveFilePart(
+			MTP_long(uploadingData.id()),
+			MTP_int(part),
+			MTP_bytes(bytes)),
+		rpcDone(&Uploader::partLoaded),
+		rpcFail(&Uploader::partFailed),
+		MTP::uploadDcId(todc));
+}
+
 void Uploader::sendNext() {
-	if (sentSize >= kMaxUploadFileParallelSize || _pausedId.msg) return;
+	if (sentSize >= _parallelLimit || _pausedId.msg) return;
 
 	bool stopping = stopSessionsTimer.isActive();
 	if (queue.empty()) {
@@ -289,12 +354,7 @@ void Uploader::sendNext() {
 	}
 	auto &uploadingData = i->second;
 
-	auto todc = 0;
-	for (auto dc = 1; dc != MTP::kUploadSessionsCount; ++dc) {
-		if (sentSizes[dc] < sentSizes[todc]) {
-			todc = dc;
-		}
-	}
+	const auto todc = chooseDcIndex();
 
 	auto &parts = uploadingData.file
 		? ((uploadingData.type() == SendMediaType::Photo
@@ -415,28 +475,13 @@ void Uploader::sendNext() {
 			currentFailed();
 			return;
 		}
-		mtpRequestId requestId;
-		if (uploadingData.docSize > kUseBigFilesFrom) {
-			requestId = MTP::send(
-				MTPupload_SaveBigFilePart(
-					MTP_long(uploadingData.id()),
-					MTP_int(uploadingData.docSentParts),
-					MTP_int(uploadingData.docPartsCount),
-					MTP_bytes(toSend)),
-				rpcDone(&Uploader::partLoaded),
-				rpcFail(&Uploader::partFailed),
-				MTP::uploadDcId(todc));
-		} else {
-			requestId = MTP::send(
-				MTPupload_SaveFilePart(
-					MTP_long(uploadingData.id()),
-					MTP_int(uploadingData.docSentParts),
-					MTP_bytes(toSend)),
-				rpcDone(&Uploader::partLoaded),
-				rpcFail(&Uploader::partFailed),
-				MTP::uploadDcId(todc));
-		}
+		const auto requestId = sendDocPartRequest(
+			uploadingData,
+			uploadingData.docSentParts,
+			toSend,
+			todc);
 		docRequestsSent.emplace(requestId, uploadingData.docSentParts);
+		docPartBytes.emplace(uploadingData.docSentParts, toSend);
 		dcMap.emplace(requestId, todc);
 		sentSize += uploadingData.docPartSize;
 		sentSizes[todc] += uploadingData.docPartSize;
@@ -461,6 +506,12 @@ void Uploader::sendNext() {
 		parts.erase(part);
 	}
 	nextTimer.start(kUploadRequestInterval);
+
+	// Fill the whole in-flight budget right away instead of waiting
+	// for the timer or a part confirmation to send the next one.
+	if (sentSize < _parallelLimit) {
+		sendNext();
+	}
 }
 
 void Uploader::cancel(const FullMsgId &msgId) {
@@ -495,12 +546,15 @@ void Uploader::clear() {
 		MTP::cancel(requestData.first);
 	}
 	docRequestsSent.clear();
+	docPartBytes.clear();
+	docPartRetries.clear();
 	dcMap.clear();
 	sentSize = 0;
 	for (int i = 0; i < MTP::kUploadSessionsCount; ++i) {
 		MTP::stopSession(MTP::uploadDcId(i));
 		sentSizes[i] = 0;
 	}
+	_parallelLimit = kMaxUploadFileParallelSize;
 	stopSessionsTimer.stop();
 }
 
@@ -532,10 +586,13 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 				requestsSent.erase(i);
 			} else {
 				sentPartSize = file.docPartSize;
+				docPartBytes.remove(j->second);
+				docPartRetries.remove(j->second);
 				docRequestsSent.erase(j);
 			}
 			sentSize -= sentPartSize;
 			sentSizes[dc] -= sentPartSize;
+			adjustParallelLimit(sentPartSize);
 			if (file.type() == SendMediaType::Photo) {
 				file.fileSentSize += sentPartSize;
 				const auto photo = Auth().data().photo(file.id());
@@ -572,9 +629,38 @@ void Uploader::partLoaded(const MTPBool &result, mtpRequestId requestId) {
 bool Uploader::partFailed(const RPCError &error, mtpRequestId requestId) {
 	if (MTP::isDefaultHandledError(error)) return false;
 
+	_parallelLimit = kMaxUploadFileParallelSize;
+
+	const auto j = docRequestsSent.find(requestId);
+	if (j != docRequestsSent.cend()) {
+		// Retry a single document part on a transient server error
+		// instead of restarting the whole file from the first part.
+		const auto part = j->second;
+		const auto bytes = docPartBytes.find(part);
+		const auto dcIt = dcMap.find(requestId);
+		const auto file = queue.find(uploadingId);
+		if (error.code() >= 500
+			&& bytes != docPartBytes.cend()
+			&& dcIt != dcMap.cend()
+			&& file != queue.cend()
+			&& ++docPartRetries[part] <= kMaxDocPartRetries) {
+			const auto dc = dcIt->second;
+			dcMap.erase(dcIt);
+			docRequestsSent.erase(j);
+			const auto newId = sendDocPartRequest(
+				file->second,
+				part,
+				bytes->second,
+				dc);
+			docRequestsSent.emplace(newId, part);
+			dcMap.emplace(newId, dc);
+			return true;
+		}
+	}
+
 	// failed to upload current file
 	if ((requestsSent.find(requestId) != requestsSent.cend())
-		|| (docRequestsSent.find(requestId) != docRequestsSent.cend())) {
+		|| (j != docRequestsSent.cend())) {
 		currentFailed();
 	}
 	sendNext();
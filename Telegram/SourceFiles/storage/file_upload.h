@@ -111,11 +111,23 @@ private:
 
 	void currentFailed();
 
+	int32 chooseDcIndex() const;
+	void adjustParallelLimit(int32 sentPartSize);
+	mtpRequestId sendDocPartRequest(
+		const File &uploadingData,
+		int32 part,
+		const QByteArray &bytes,
+		int32 todc);
+
 	base::flat_map<mtpRequestId, QByteArray> requestsSent;
 	base::flat_map<mtpRequestId, int32> docRequestsSent;
+	base::flat_map<int32, QByteArray> docPartBytes;
+	base::flat_map<int32, int32> docPartRetries;
 	base::flat_map<mtpRequestId, int32> dcMap;
 	uint32 sentSize = 0;
 	uint32 sentSizes[MTP::kUploadSessionsCount] = { 0 };
+	uint32 _parallelLimit;
+	TimeMs _parallelGrowTime = 0;
 
 	FullMsgId uploadingId;
 	FullMsgId _pausedId;
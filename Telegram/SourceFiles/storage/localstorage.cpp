@@ -11,6 +11,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/serialize_common.h"
 #include "storage/storage_encrypted_file.h"
 #include "storage/storage_clear_legacy.h"
+#include "storage/storage_facade.h"
+#include "storage/storage_shared_media.h"
 #include "chat_helpers/stickers.h"
 #include "data/data_drafts.h"
 #include "data/data_user.h"
@@ -48,6 +50,8 @@ constexpr auto kFileLoaderQueueStopTimeout = TimeMs(5000);
 constexpr auto kDefaultStickerInstallDate = TimeId(1);
 constexpr auto kProxyTypeShift = 1024;
 constexpr auto kWriteMapTimeout = TimeMs(1000);
+constexpr auto kWriteReadStatesTimeout = TimeMs(10000);
+constexpr auto kMaxDraftDeltas = 32;
 constexpr auto kSavedBackgroundFormat = QImage::Format_ARGB32_Premultiplied;
 
 constexpr auto kWallPaperLegacySerializeTagId = int32(-111);
@@ -523,6 +527,27 @@ enum { // Local Storage Keys
 	lskExportSettings = 0x13, // no data
 	lskBackground = 0x14, // no data
 	lskSelfSerialized = 0x15, // serialized self
+	lskStickerSetsData = 0x16, // data: set count
+	lskSharedMediaCounts = 0x17, // no data
+	lskRecentSharePeers = 0x18, // no data
+	lskDialogsSnapshot = 0x19, // no data
+	lskDraftDeltas = 0x1a, // data: PeerId peer
+	lskReadStates = 0x1b, // no data
+};
+
+enum { // Map Journal Record Types
+	mjkDraftKey = 0x01, // data: quint64 peer, quint64 key
+	mjkDraftRemoved = 0x02, // data: quint64 peer
+	mjkDraftCursorKey = 0x03, // data: quint64 peer, quint64 key
+	mjkDraftCursorRemoved = 0x04, // data: quint64 peer
+	mjkDraftDeltasKey = 0x05, // data: quint64 peer, quint64 key
+	mjkDraftDeltasRemoved = 0x06, // data: quint64 peer
+};
+
+enum { // Locations Journal Record Types
+	ljkLocation = 0x01, // data: quint64 first, quint64 second, QString name, QByteArray bookmark, QDateTime modified, quint32 size
+	ljkAlias = 0x02, // data: quint64 first, quint64 second, quint64 tofirst, quint64 tosecond
+	ljkRemoved = 0x03, // data: quint64 first, quint64 second, QString name
 };
 
 enum {
@@ -627,7 +652,32 @@ enum {
 };
 
 typedef QMap<PeerId, FileKey> DraftsMap;
-DraftsMap _draftsMap, _draftCursorsMap;
+DraftsMap _draftsMap, _draftCursorsMap, _draftDeltasMap;
+
+// A draft is stored as a base record plus a bounded chain of text
+// edits in a separate small file, so the per-keystroke-cadence save
+// rewrites tens of bytes. The chain is compacted into the base record
+// when it grows too long or when anything besides the local draft
+// text changes.
+struct DraftDelta {
+	qint32 position = 0;
+	qint32 removed = 0;
+	QString inserted;
+};
+struct DraftDeltaState { // in-memory only
+	QVector<DraftDelta> deltas;
+	QString lastText;
+	qint32 localMsgId = 0;
+	bool localPreviewCancelled = false;
+	QString editText;
+	qint32 editMsgId = 0;
+	bool editPreviewCancelled = false;
+};
+QMap<PeerId, DraftDeltaState> _draftDeltaStates;
+
+typedef QMap<quint64, FileKey> StickerSetKeysMap;
+StickerSetKeysMap _stickerSetContentKeys;
+QMap<quint64, qint32> _stickerSetContentHashes; // in-memory only
 typedef QMap<PeerId, bool> DraftsNotReadMap;
 DraftsNotReadMap _draftsNotReadMap;
 
@@ -666,15 +716,28 @@ bool _readingUserSettings = false;
 FileKey _userSettingsKey = 0;
 FileKey _recentHashtagsAndBotsKey = 0;
 bool _recentHashtagsAndBotsWereRead = false;
+FileKey _recentSharePeersKey = 0;
+bool _recentSharePeersWereRead = false;
 qint64 _cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
 qint32 _cacheTotalTimeLimit = Database::Settings().totalTimeLimit;
 
 FileKey _exportSettingsKey = 0;
 
+FileKey _sharedMediaCountsKey = 0;
+
 FileKey _savedPeersKey = 0;
+FileKey _dialogsSnapshotKey = 0;
 FileKey _langPackKey = 0;
 FileKey _languagesKey = 0;
 
+// Unread counts journaled between dialogs snapshot writes, so that a
+// crash does not roll the restored snapshot back to counts the user
+// has already read through. Flushed coalesced on a timer.
+FileKey _readStatesKey = 0;
+QMap<PeerId, qint32> _readStatesMap;
+bool _readStatesChanged = false;
+bool _readStatesRead = false;
+
 bool _mapChanged = false;
 int32 _oldMapVersion = 0, _oldSettingsVersion = 0;
 
@@ -694,6 +757,114 @@ AuthSessionSettings &GetStoredAuthSessionCache() {
 
 void _writeMap(WriteMapWhen when = WriteMapWhen::Soon);
 
+// Draft map mutations append a few dozen bytes to a journal file instead
+// of scheduling a rewrite of the whole map. The journal is replayed right
+// after the map is read and is dropped by every full map rewrite.
+constexpr auto kMapJournalSizeLimit = 256 * 1024;
+
+QString _mapJournalPath() {
+	return _userBasePath + qsl("mapj");
+}
+
+void _clearMapJournal() {
+	QFile::remove(_mapJournalPath());
+}
+
+void _writeMapJournal(quint32 type, quint64 peer, quint64 key = 0) {
+	if (_userBasePath.isEmpty() || !LocalKey) {
+		_mapChanged = true;
+		_writeMap();
+		return;
+	}
+	QFile file(_mapJournalPath());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		_mapChanged = true;
+		_writeMap();
+		return;
+	}
+	EncryptedDescriptor record(sizeof(quint32) + 2 * sizeof(quint64));
+	record.stream << type << peer << key;
+
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << FileWriteDescriptor::prepareEncrypted(record);
+	file.flush();
+
+	if (file.size() > kMapJournalSizeLimit) {
+		// Checkpoint: the full rewrite drops the journal when it is done.
+		_mapChanged = true;
+		_writeMap(WriteMapWhen::Fast);
+	}
+}
+
+void _readMapJournal() {
+	QFile file(_mapJournalPath());
+	if (!file.open(QIODevice::ReadOnly)) {
+		return;
+	}
+	LOG(("App Info: replaying map journal..."));
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+	while (!stream.atEnd()) {
+		QByteArray encrypted;
+		stream >> encrypted;
+		if (stream.status() != QDataStream::Ok) {
+			break;
+		}
+		EncryptedDescriptor record;
+		if (!decryptLocal(record, encrypted)) {
+			// A record torn by a crash mid-append ends the replay.
+			break;
+		}
+		quint32 type = 0;
+		quint64 peer = 0, key = 0;
+		record.stream >> type >> peer >> key;
+		if (!_checkStreamStatus(record.stream)) {
+			break;
+		}
+		switch (type) {
+		case mjkDraftKey:
+			_draftsMap.insert(peer, key);
+			_draftsNotReadMap.insert(peer, true);
+			break;
+		case mjkDraftRemoved:
+			_draftsMap.remove(peer);
+			_draftsNotReadMap.remove(peer);
+			break;
+		case mjkDraftCursorKey:
+			_draftCursorsMap.insert(peer, key);
+			break;
+		case mjkDraftCursorRemoved:
+			_draftCursorsMap.remove(peer);
+			break;
+		case mjkDraftDeltasKey:
+			_draftDeltasMap.insert(peer, key);
+			break;
+		case mjkDraftDeltasRemoved:
+			_draftDeltasMap.remove(peer);
+			break;
+		default:
+			LOG(("App Error: unknown type in map journal: %1").arg(type));
+			break;
+		}
+	}
+}
+
+// File location mutations append to a journal the same way draft map
+// mutations do, so that a busy download session doesn't schedule full
+// locations rewrites and quitting doesn't have to flush one. The journal
+// is replayed after the locations are read and is dropped by every full
+// locations rewrite.
+constexpr auto kLocationsJournalSizeLimit = 512 * 1024;
+
+QString _locationsJournalPath() {
+	return _userBasePath + qsl("locj");
+}
+
+void _clearLocationsJournal() {
+	QFile::remove(_locationsJournalPath());
+}
+
 void _writeLocations(WriteMapWhen when = WriteMapWhen::Soon) {
 	if (when != WriteMapWhen::Now) {
 		_manager->writeLocations(when == WriteMapWhen::Fast);
@@ -764,6 +935,128 @@ void _writeLocations(WriteMapWhen when = WriteMapWhen::Soon) {
 		FileWriteDescriptor file(_locationsKey);
 		file.writeEncrypted(data);
 	}
+	_clearLocationsJournal();
+}
+
+void _writeLocationsJournal(EncryptedDescriptor &record) {
+	if (_userBasePath.isEmpty() || !LocalKey) {
+		_writeLocations(WriteMapWhen::Fast);
+		return;
+	}
+	QFile file(_locationsJournalPath());
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+		_writeLocations(WriteMapWhen::Fast);
+		return;
+	}
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+	stream << FileWriteDescriptor::prepareEncrypted(record);
+	file.flush();
+
+	if (file.size() > kLocationsJournalSizeLimit) {
+		// Checkpoint: the full rewrite drops the journal when it is done.
+		_writeLocations(WriteMapWhen::Fast);
+	}
+}
+
+void _journalFileLocation(const MediaKey &location, const FileLocation &local) {
+	EncryptedDescriptor record(sizeof(quint32)
+		+ 2 * sizeof(quint64)
+		+ Serialize::stringSize(local.name())
+		+ Serialize::bytearraySize(local.bookmark())
+		+ Serialize::dateTimeSize()
+		+ sizeof(quint32));
+	record.stream << quint32(ljkLocation) << quint64(location.first) << quint64(location.second);
+	record.stream << local.name() << local.bookmark() << local.modified << quint32(local.size);
+	_writeLocationsJournal(record);
+}
+
+void _journalFileLocationAlias(const MediaKey &location, const MediaKey &to) {
+	EncryptedDescriptor record(sizeof(quint32) + 4 * sizeof(quint64));
+	record.stream << quint32(ljkAlias) << quint64(location.first) << quint64(location.second);
+	record.stream << quint64(to.first) << quint64(to.second);
+	_writeLocationsJournal(record);
+}
+
+void _journalFileLocationRemoved(const MediaKey &location, const QString &name) {
+	EncryptedDescriptor record(sizeof(quint32)
+		+ 2 * sizeof(quint64)
+		+ Serialize::stringSize(name));
+	record.stream << quint32(ljkRemoved) << quint64(location.first) << quint64(location.second);
+	record.stream << name;
+	_writeLocationsJournal(record);
+}
+
+void _writeReadStates(WriteMapWhen when = WriteMapWhen::Soon) {
+	if (when != WriteMapWhen::Now) {
+		_manager->writeReadStates(when == WriteMapWhen::Fast);
+		return;
+	}
+	if (!_working() || !_readStatesChanged) return;
+	_readStatesChanged = false;
+
+	_manager->writingReadStates();
+	if (_readStatesMap.isEmpty()) {
+		if (_readStatesKey) {
+			clearKey(_readStatesKey);
+			_readStatesKey = 0;
+			_mapChanged = true;
+			_writeMap();
+		}
+	} else {
+		if (!_readStatesKey) {
+			_readStatesKey = genKey();
+			_mapChanged = true;
+			_writeMap(WriteMapWhen::Fast);
+		}
+		quint32 size = sizeof(quint32) + _readStatesMap.size() * (sizeof(quint64) + sizeof(qint32));
+
+		EncryptedDescriptor data(size);
+		data.stream << quint32(_readStatesMap.size());
+		for (auto i = _readStatesMap.cbegin(), e = _readStatesMap.cend(); i != e; ++i) {
+			data.stream << quint64(i.key()) << qint32(i.value());
+		}
+
+		FileWriteDescriptor file(_readStatesKey);
+		file.writeEncrypted(data);
+	}
+}
+
+void _readReadStates() {
+	if (_readStatesRead) return;
+	_readStatesRead = true;
+	if (!_readStatesKey) return;
+
+	FileReadDescriptor states;
+	if (!readEncryptedFile(states, _readStatesKey)) {
+		clearKey(_readStatesKey);
+		_readStatesKey = 0;
+		_writeMap();
+		return;
+	}
+
+	quint32 count = 0;
+	states.stream >> count;
+	for (quint32 i = 0; i < count; ++i) {
+		quint64 peer = 0;
+		qint32 unreadCount = 0;
+		states.stream >> peer >> unreadCount;
+		if (!_checkStreamStatus(states.stream)) {
+			return;
+		}
+		_readStatesMap.insert(peer, unreadCount);
+	}
+}
+
+void _clearReadStates() {
+	_readStatesMap.clear();
+	_readStatesChanged = false;
+	if (_readStatesKey) {
+		clearKey(_readStatesKey);
+		_readStatesKey = 0;
+		_mapChanged = true;
+		_writeMap();
+	}
 }
 
 void _readLocations() {
@@ -822,6 +1115,79 @@ void _readLocations() {
 	}
 }
 
+void _readLocationsJournal() {
+	QFile file(_locationsJournalPath());
+	if (!file.open(QIODevice::ReadOnly) || !file.size()) {
+		return;
+	}
+	LOG(("App Info: replaying locations journal..."));
+	QDataStream stream(&file);
+	stream.setVersion(QDataStream::Qt_5_1);
+	while (!stream.atEnd()) {
+		QByteArray encrypted;
+		stream >> encrypted;
+		if (stream.status() != QDataStream::Ok) {
+			break;
+		}
+		EncryptedDescriptor record;
+		if (!decryptLocal(record, encrypted)) {
+			// A record torn by a crash mid-append ends the replay.
+			break;
+		}
+		quint32 type = 0;
+		quint64 first = 0, second = 0;
+		record.stream >> type >> first >> second;
+		if (!_checkStreamStatus(record.stream)) {
+			break;
+		}
+		switch (type) {
+		case ljkLocation: {
+			QByteArray bookmark;
+			FileLocation loc;
+			record.stream >> loc.fname >> bookmark >> loc.modified >> loc.size;
+			loc.setBookmark(bookmark);
+			if (!_checkStreamStatus(record.stream)) {
+				return;
+			}
+			const auto key = MediaKey(first, second);
+			_fileLocations.insert(key, loc);
+			_fileLocationPairs.insert(loc.fname, FileLocationPair(key, loc));
+		} break;
+		case ljkAlias: {
+			quint64 tofirst = 0, tosecond = 0;
+			record.stream >> tofirst >> tosecond;
+			if (!_checkStreamStatus(record.stream)) {
+				return;
+			}
+			_fileLocationAliases.insert(MediaKey(first, second), MediaKey(tofirst, tosecond));
+		} break;
+		case ljkRemoved: {
+			QString name;
+			record.stream >> name;
+			if (!_checkStreamStatus(record.stream)) {
+				return;
+			}
+			const auto key = MediaKey(first, second);
+			for (auto i = _fileLocations.find(key); (i != _fileLocations.end()) && (i.key() == key);) {
+				if (i.value().fname == name) {
+					_fileLocationPairs.remove(i.value().fname);
+					i = _fileLocations.erase(i);
+				} else {
+					++i;
+				}
+			}
+		} break;
+		default:
+			LOG(("App Error: unknown type in locations journal: %1").arg(type));
+			break;
+		}
+	}
+
+	// The journal has no other full rewrite trigger besides its size
+	// limit, so checkpoint it soon after the replay to keep it short.
+	_writeLocations();
+}
+
 void _writeReportSpamStatuses() {
 	if (!_working()) return;
 
@@ -2262,14 +2628,19 @@ ReadMapState _readMap(const QByteArray &pass) {
 	LOG(("App Info: reading encrypted map..."));
 
 	QByteArray selfSerialized;
-	DraftsMap draftsMap, draftCursorsMap;
+	DraftsMap draftsMap, draftCursorsMap, draftDeltasMap;
 	DraftsNotReadMap draftsNotReadMap;
+	StickerSetKeysMap stickerSetContentKeys;
 	quint64 locationsKey = 0, reportSpamStatusesKey = 0, trustedBotsKey = 0;
 	quint64 recentStickersKeyOld = 0;
 	quint64 installedStickersKey = 0, featuredStickersKey = 0, recentStickersKey = 0, favedStickersKey = 0, archivedStickersKey = 0;
 	quint64 savedGifsKey = 0;
 	quint64 backgroundKeyDay = 0, backgroundKeyNight = 0;
 	quint64 userSettingsKey = 0, recentHashtagsAndBotsKey = 0, savedPeersKey = 0, exportSettingsKey = 0;
+	quint64 sharedMediaCountsKey = 0;
+	quint64 recentSharePeersKey = 0;
+	quint64 dialogsSnapshotKey = 0;
+	quint64 readStatesKey = 0;
 	while (!map.stream.atEnd()) {
 		quint32 keyType;
 		map.stream >> keyType;
@@ -2288,6 +2659,16 @@ ReadMapState _readMap(const QByteArray &pass) {
 		case lskSelfSerialized: {
 			map.stream >> selfSerialized;
 		} break;
+		case lskStickerSetsData: {
+			quint32 count = 0;
+			map.stream >> count;
+			for (quint32 i = 0; i < count; ++i) {
+				FileKey key;
+				quint64 setId;
+				map.stream >> key >> setId;
+				stickerSetContentKeys.insert(setId, key);
+			}
+		} break;
 		case lskDraftPosition: {
 			quint32 count = 0;
 			map.stream >> count;
@@ -2298,6 +2679,16 @@ ReadMapState _readMap(const QByteArray &pass) {
 				draftCursorsMap.insert(p, key);
 			}
 		} break;
+		case lskDraftDeltas: {
+			quint32 count = 0;
+			map.stream >> count;
+			for (quint32 i = 0; i < count; ++i) {
+				FileKey key;
+				quint64 p;
+				map.stream >> key >> p;
+				draftDeltasMap.insert(p, key);
+			}
+		} break;
 		case lskImages:
 		case lskStickerImages:
 		case lskAudios: {
@@ -2359,6 +2750,18 @@ ReadMapState _readMap(const QByteArray &pass) {
 		case lskExportSettings: {
 			map.stream >> exportSettingsKey;
 		} break;
+		case lskSharedMediaCounts: {
+			map.stream >> sharedMediaCountsKey;
+		} break;
+		case lskRecentSharePeers: {
+			map.stream >> recentSharePeersKey;
+		} break;
+		case lskDialogsSnapshot: {
+			map.stream >> dialogsSnapshotKey;
+		} break;
+		case lskReadStates: {
+			map.stream >> readStatesKey;
+		} break;
 		default:
 		LOG(("App Error: unknown key type in encrypted map: %1").arg(keyType));
 		return ReadMapFailed;
@@ -2370,7 +2773,9 @@ ReadMapState _readMap(const QByteArray &pass) {
 
 	_draftsMap = draftsMap;
 	_draftCursorsMap = draftCursorsMap;
+	_draftDeltasMap = draftDeltasMap;
 	_draftsNotReadMap = draftsNotReadMap;
+	_stickerSetContentKeys = stickerSetContentKeys;
 
 	_locationsKey = locationsKey;
 	_reportSpamStatusesKey = reportSpamStatusesKey;
@@ -2388,6 +2793,13 @@ ReadMapState _readMap(const QByteArray &pass) {
 	_userSettingsKey = userSettingsKey;
 	_recentHashtagsAndBotsKey = recentHashtagsAndBotsKey;
 	_exportSettingsKey = exportSettingsKey;
+	_sharedMediaCountsKey = sharedMediaCountsKey;
+	_recentSharePeersKey = recentSharePeersKey;
+	_dialogsSnapshotKey = dialogsSnapshotKey;
+	_readStatesKey = readStatesKey;
+
+	_readMapJournal();
+
 	_oldMapVersion = mapData.version;
 	if (_oldMapVersion < AppVersion) {
 		_mapChanged = true;
@@ -2399,6 +2811,7 @@ ReadMapState _readMap(const QByteArray &pass) {
 	if (_locationsKey) {
 		_readLocations();
 	}
+	_readLocationsJournal();
 	if (_reportSpamStatusesKey) {
 		_readReportSpamStatuses();
 	}
@@ -2477,6 +2890,8 @@ void _writeMap(WriteMapWhen when) {
 	if (!self.isEmpty()) mapSize += sizeof(quint32) + Serialize::bytearraySize(self);
 	if (!_draftsMap.isEmpty()) mapSize += sizeof(quint32) * 2 + _draftsMap.size() * sizeof(quint64) * 2;
 	if (!_draftCursorsMap.isEmpty()) mapSize += sizeof(quint32) * 2 + _draftCursorsMap.size() * sizeof(quint64) * 2;
+	if (!_draftDeltasMap.isEmpty()) mapSize += sizeof(quint32) * 2 + _draftDeltasMap.size() * sizeof(quint64) * 2;
+	if (!_stickerSetContentKeys.isEmpty()) mapSize += sizeof(quint32) * 2 + _stickerSetContentKeys.size() * sizeof(quint64) * 2;
 	if (_locationsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_reportSpamStatusesKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_trustedBotsKey) mapSize += sizeof(quint32) + sizeof(quint64);
@@ -2491,6 +2906,10 @@ void _writeMap(WriteMapWhen when) {
 	if (_userSettingsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_recentHashtagsAndBotsKey) mapSize += sizeof(quint32) + sizeof(quint64);
 	if (_exportSettingsKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_sharedMediaCountsKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_recentSharePeersKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_dialogsSnapshotKey) mapSize += sizeof(quint32) + sizeof(quint64);
+	if (_readStatesKey) mapSize += sizeof(quint32) + sizeof(quint64);
 
 	EncryptedDescriptor mapData(mapSize);
 	if (!self.isEmpty()) {
@@ -2502,12 +2921,24 @@ void _writeMap(WriteMapWhen when) {
 			mapData.stream << quint64(i.value()) << quint64(i.key());
 		}
 	}
+	if (!_draftDeltasMap.isEmpty()) {
+		mapData.stream << quint32(lskDraftDeltas) << quint32(_draftDeltasMap.size());
+		for (DraftsMap::const_iterator i = _draftDeltasMap.cbegin(), e = _draftDeltasMap.cend(); i != e; ++i) {
+			mapData.stream << quint64(i.value()) << quint64(i.key());
+		}
+	}
 	if (!_draftCursorsMap.isEmpty()) {
 		mapData.stream << quint32(lskDraftPosition) << quint32(_draftCursorsMap.size());
 		for (DraftsMap::const_iterator i = _draftCursorsMap.cbegin(), e = _draftCursorsMap.cend(); i != e; ++i) {
 			mapData.stream << quint64(i.value()) << quint64(i.key());
 		}
 	}
+	if (!_stickerSetContentKeys.isEmpty()) {
+		mapData.stream << quint32(lskStickerSetsData) << quint32(_stickerSetContentKeys.size());
+		for (StickerSetKeysMap::const_iterator i = _stickerSetContentKeys.cbegin(), e = _stickerSetContentKeys.cend(); i != e; ++i) {
+			mapData.stream << quint64(i.value()) << quint64(i.key());
+		}
+	}
 	if (_locationsKey) {
 		mapData.stream << quint32(lskLocations) << quint64(_locationsKey);
 	}
@@ -2548,7 +2979,21 @@ void _writeMap(WriteMapWhen when) {
 	if (_exportSettingsKey) {
 		mapData.stream << quint32(lskExportSettings) << quint64(_exportSettingsKey);
 	}
+	if (_sharedMediaCountsKey) {
+		mapData.stream << quint32(lskSharedMediaCounts) << quint64(_sharedMediaCountsKey);
+	}
+	if (_recentSharePeersKey) {
+		mapData.stream << quint32(lskRecentSharePeers) << quint64(_recentSharePeersKey);
+	}
+	if (_dialogsSnapshotKey) {
+		mapData.stream << quint32(lskDialogsSnapshot) << quint64(_dialogsSnapshotKey);
+	}
+	if (_readStatesKey) {
+		mapData.stream << quint32(lskReadStates) << quint64(_readStatesKey);
+	}
 	map.writeEncrypted(mapData);
+	map.finish();
+	_clearMapJournal();
 
 	_mapChanged = false;
 }
@@ -2568,6 +3013,31 @@ void finish() {
 void loadTheme();
 void readLangPack();
 
+void _prefetchUserFiles() {
+	// Touch the files that readMap() and the mtp data read will need,
+	// so that on cold disks their I/O overlaps the window construction
+	// that happens on the main thread before the map is read.
+	QByteArray dataNameUtf8 = (cDataFile() + (cTestMode() ? qsl(":/test/") : QString())).toUtf8();
+	FileKey dataNameHash[2];
+	hashMd5(dataNameUtf8.constData(), dataNameUtf8.size(), dataNameHash);
+	const auto dataName = toFilePart(dataNameHash[0]);
+	const auto userBasePath = _basePath + dataName + QChar('/');
+	const auto basePath = _basePath;
+	crl::async([=] {
+		const auto prefetch = [](const QString &path) {
+			QFile file(path);
+			if (file.open(QIODevice::ReadOnly)) {
+				file.read(file.size());
+			}
+		};
+		prefetch(userBasePath + qsl("map0"));
+		prefetch(userBasePath + qsl("map1"));
+		prefetch(userBasePath + qsl("mapj"));
+		prefetch(basePath + dataName + '0');
+		prefetch(basePath + dataName + '1');
+	});
+}
+
 void start() {
 	Expects(!_manager);
 
@@ -2577,6 +3047,8 @@ void start() {
 	_basePath = cWorkingDir() + qsl("tdata/");
 	if (!QDir().exists(_basePath)) QDir().mkpath(_basePath);
 
+	_prefetchUserFiles();
+
 	ReadSettingsContext context;
 	FileReadDescriptor settingsData;
 	if (!readFile(settingsData, cTestMode() ? qsl("settings_test") : qsl("settings"), FileOption::Safe)) {
@@ -2799,10 +3271,15 @@ void reset() {
 	_passKeySalt.clear(); // reset passcode, local key
 	_draftsMap.clear();
 	_draftCursorsMap.clear();
+	_draftDeltasMap.clear();
+	_draftDeltaStates.clear();
 	_fileLocations.clear();
 	_fileLocationPairs.clear();
 	_fileLocationAliases.clear();
+	_clearLocationsJournal();
 	_draftsNotReadMap.clear();
+	_stickerSetContentKeys.clear();
+	_stickerSetContentHashes.clear();
 	_locationsKey = _reportSpamStatusesKey = _trustedBotsKey = 0;
 	_recentStickersKeyOld = 0;
 	_installedStickersKey = _featuredStickersKey = _recentStickersKey = _favedStickersKey = _archivedStickersKey = 0;
@@ -2810,6 +3287,13 @@ void reset() {
 	_backgroundKeyDay = _backgroundKeyNight = 0;
 	Window::Theme::Background()->reset();
 	_userSettingsKey = _recentHashtagsAndBotsKey = _savedPeersKey = _exportSettingsKey = 0;
+	_sharedMediaCountsKey = 0;
+	_recentSharePeersKey = 0;
+	_dialogsSnapshotKey = 0;
+	_readStatesKey = 0;
+	_readStatesMap.clear();
+	_readStatesChanged = false;
+	_readStatesRead = false;
 	_oldMapVersion = _oldSettingsVersion = 0;
 	_cacheTotalSizeLimit = Database::Settings().totalSizeLimit;
 	_cacheTotalTimeLimit = Database::Settings().totalTimeLimit;
@@ -2857,9 +3341,13 @@ base::flat_set<QString> CollectGoodNames() {
 		_recentHashtagsAndBotsKey,
 		_exportSettingsKey,
 		_savedPeersKey,
-		_trustedBotsKey
+		_trustedBotsKey,
+		_sharedMediaCountsKey,
+		_recentSharePeersKey,
+		_dialogsSnapshotKey,
+		_readStatesKey
 	};
-	auto result = base::flat_set<QString>{ "map0", "map1" };
+	auto result = base::flat_set<QString>{ "map0", "map1", "mapj" };
 	const auto push = [&](FileKey key) {
 		if (!key) {
 			return;
@@ -2875,6 +3363,12 @@ base::flat_set<QString> CollectGoodNames() {
 	for (const auto &value : _draftCursorsMap) {
 		push(value);
 	}
+	for (const auto &value : _draftDeltasMap) {
+		push(value);
+	}
+	for (const auto &value : _stickerSetContentKeys) {
+		push(value);
+	}
 	for (const auto &value : keys) {
 		push(value);
 	}
@@ -2894,7 +3388,13 @@ ReadMapState readMap(const QByteArray &pass) {
 		_writeMap(WriteMapWhen::Now);
 	}
 	if (result != ReadMapPassNeeded) {
-		Storage::ClearLegacyFiles(_userBasePath, FilterLegacyFiles);
+		const auto checkedTotal = std::make_shared<std::atomic<int>>(0);
+		Storage::ClearLegacyFiles(_userBasePath, FilterLegacyFiles, [=](
+				size_type checked) {
+			const auto total = checkedTotal->fetch_add(checked) + checked;
+			DEBUG_LOG(("App Info: cleared legacy files part, "
+				"%1 checked total").arg(total));
+		});
 	}
 	return result;
 }
@@ -2907,6 +3407,70 @@ int32 oldSettingsVersion() {
 	return _oldSettingsVersion;
 }
 
+void _clearDraftDeltas(const PeerId &peer) {
+	auto i = _draftDeltasMap.find(peer);
+	if (i != _draftDeltasMap.cend()) {
+		clearKey(i.value());
+		_draftDeltasMap.erase(i);
+		_writeMapJournal(mjkDraftDeltasRemoved, peer);
+	}
+	_draftDeltaStates.remove(peer);
+}
+
+void _writeDraftDeltas(const PeerId &peer, const QVector<DraftDelta> &deltas) {
+	auto i = _draftDeltasMap.constFind(peer);
+	if (i == _draftDeltasMap.cend()) {
+		i = _draftDeltasMap.insert(peer, genKey());
+		_writeMapJournal(mjkDraftDeltasKey, peer, i.value());
+	}
+
+	int size = sizeof(quint64) + sizeof(qint32);
+	for (const auto &delta : deltas) {
+		size += 2 * sizeof(qint32) + Serialize::stringSize(delta.inserted);
+	}
+
+	EncryptedDescriptor data(size);
+	data.stream << quint64(peer) << qint32(deltas.size());
+	for (const auto &delta : deltas) {
+		data.stream << qint32(delta.position) << qint32(delta.removed) << delta.inserted;
+	}
+
+	FileWriteDescriptor file(i.value());
+	file.writeEncrypted(data);
+}
+
+void _applyDraftDeltas(const PeerId &peer, QString &text) {
+	auto j = _draftDeltasMap.find(peer);
+	if (j == _draftDeltasMap.cend()) {
+		return;
+	}
+
+	FileReadDescriptor deltas;
+	if (!readEncryptedFile(deltas, j.value())) {
+		clearKey(j.value());
+		_draftDeltasMap.erase(j);
+		return;
+	}
+	quint64 deltaPeer = 0;
+	qint32 count = 0;
+	deltas.stream >> deltaPeer >> count;
+	if (deltaPeer != peer || count < 0 || count > kMaxDraftDeltas) {
+		return;
+	}
+	for (auto i = 0; i != count; ++i) {
+		qint32 position = 0, removed = 0;
+		QString inserted;
+		deltas.stream >> position >> removed >> inserted;
+		if (!_checkStreamStatus(deltas.stream)
+			|| position < 0
+			|| removed < 0
+			|| position + removed > text.size()) {
+			return;
+		}
+		text = text.left(position) + inserted + text.mid(position + removed);
+	}
+}
+
 void writeDrafts(const PeerId &peer, const MessageDraft &localDraft, const MessageDraft &editDraft) {
 	if (!_working()) return;
 
@@ -2915,24 +3479,65 @@ void writeDrafts(const PeerId &peer, const MessageDraft &localDraft, const Messa
 		if (i != _draftsMap.cend()) {
 			clearKey(i.value());
 			_draftsMap.erase(i);
-			_mapChanged = true;
-			_writeMap();
+			_writeMapJournal(mjkDraftRemoved, peer);
 		}
+		_clearDraftDeltas(peer);
 
 		_draftsNotReadMap.remove(peer);
 	} else {
-		auto i = _draftsMap.constFind(peer);
-		if (i == _draftsMap.cend()) {
-			i = _draftsMap.insert(peer, genKey());
-			_mapChanged = true;
-			_writeMap(WriteMapWhen::Fast);
-		}
-
 		auto msgTags = TextUtilities::SerializeTags(
 			localDraft.textWithTags.tags);
 		auto editTags = TextUtilities::SerializeTags(
 			editDraft.textWithTags.tags);
 
+		// When only the local draft text changed since the last full write
+		// we append one more text edit to the deltas chain instead of
+		// rewriting the whole draft record. Tagged texts are always written
+		// in full, a text delta could invalidate the stored tag ranges.
+		const auto state = _draftDeltaStates.find(peer);
+		if (state != _draftDeltaStates.end()
+			&& msgTags.isEmpty()
+			&& editTags.isEmpty()
+			&& state->localMsgId == localDraft.msgId
+			&& state->localPreviewCancelled == localDraft.previewCancelled
+			&& state->editText == editDraft.textWithTags.text
+			&& state->editMsgId == editDraft.msgId
+			&& state->editPreviewCancelled == editDraft.previewCancelled
+			&& state->deltas.size() < kMaxDraftDeltas
+			&& _draftsMap.contains(peer)) {
+			const auto &was = state->lastText;
+			const auto &now = localDraft.textWithTags.text;
+			if (was == now) {
+				return;
+			}
+			auto prefix = 0;
+			const auto minSize = qMin(was.size(), now.size());
+			while (prefix != minSize && was[prefix] == now[prefix]) {
+				++prefix;
+			}
+			auto suffix = 0;
+			while (suffix != minSize - prefix
+				&& was[was.size() - suffix - 1] == now[now.size() - suffix - 1]) {
+				++suffix;
+			}
+			auto delta = DraftDelta();
+			delta.position = prefix;
+			delta.removed = was.size() - prefix - suffix;
+			delta.inserted = now.mid(prefix, now.size() - prefix - suffix);
+			state->deltas.push_back(delta);
+			state->lastText = now;
+			_writeDraftDeltas(peer, state->deltas);
+
+			_draftsNotReadMap.remove(peer);
+			return;
+		}
+
+		auto i = _draftsMap.constFind(peer);
+		if (i == _draftsMap.cend()) {
+			i = _draftsMap.insert(peer, genKey());
+			_writeMapJournal(mjkDraftKey, peer, i.value());
+		}
+
 		int size = sizeof(quint64);
 		size += Serialize::stringSize(localDraft.textWithTags.text) + Serialize::bytearraySize(msgTags) + 2 * sizeof(qint32);
 		size += Serialize::stringSize(editDraft.textWithTags.text) + Serialize::bytearraySize(editTags) + 2 * sizeof(qint32);
@@ -2947,6 +3552,19 @@ void writeDrafts(const PeerId &peer, const MessageDraft &localDraft, const Messa
 		FileWriteDescriptor file(i.value());
 		file.writeEncrypted(data);
 
+		// A full write compacts the deltas chain into the base record.
+		_clearDraftDeltas(peer);
+		if (msgTags.isEmpty() && editTags.isEmpty()) {
+			auto &seeded = _draftDeltaStates[peer];
+			seeded = DraftDeltaState();
+			seeded.lastText = localDraft.textWithTags.text;
+			seeded.localMsgId = localDraft.msgId;
+			seeded.localPreviewCancelled = localDraft.previewCancelled;
+			seeded.editText = editDraft.textWithTags.text;
+			seeded.editMsgId = editDraft.msgId;
+			seeded.editPreviewCancelled = editDraft.previewCancelled;
+		}
+
 		_draftsNotReadMap.remove(peer);
 	}
 }
@@ -2956,8 +3574,7 @@ void clearDraftCursors(const PeerId &peer) {
 	if (i != _draftCursorsMap.cend()) {
 		clearKey(i.value());
 		_draftCursorsMap.erase(i);
-		_mapChanged = true;
-		_writeMap();
+		_writeMapJournal(mjkDraftCursorRemoved, peer);
 	}
 }
 
@@ -3005,6 +3622,7 @@ void readDraftsWithCursors(History *h) {
 	if (!readEncryptedFile(draft, j.value())) {
 		clearKey(j.value());
 		_draftsMap.erase(j);
+		_clearDraftDeltas(peer);
 		clearDraftCursors(peer);
 		return;
 	}
@@ -3033,10 +3651,13 @@ void readDraftsWithCursors(History *h) {
 	if (draftPeer != peer) {
 		clearKey(j.value());
 		_draftsMap.erase(j);
+		_clearDraftDeltas(peer);
 		clearDraftCursors(peer);
 		return;
 	}
 
+	_applyDraftDeltas(peer, msgData.text);
+
 	msgData.tags = TextUtilities::DeserializeTags(
 		msgTagsSerialized,
 		msgData.text.size());
@@ -3078,8 +3699,7 @@ void writeDraftCursors(const PeerId &peer, const MessageCursor &msgCursor, const
 		DraftsMap::const_iterator i = _draftCursorsMap.constFind(peer);
 		if (i == _draftCursorsMap.cend()) {
 			i = _draftCursorsMap.insert(peer, genKey());
-			_mapChanged = true;
-			_writeMap(WriteMapWhen::Fast);
+			_writeMapJournal(mjkDraftCursorKey, peer, i.value());
 		}
 
 		EncryptedDescriptor data(sizeof(quint64) + sizeof(qint32) * 3);
@@ -3112,13 +3732,14 @@ void writeFileLocation(MediaKey location, const FileLocation &local) {
 		if (i.value().second == local) {
 			if (i.value().first != location) {
 				_fileLocationAliases.insert(location, i.value().first);
-				_writeLocations(WriteMapWhen::Fast);
+				_journalFileLocationAlias(location, i.value().first);
 			}
 			return;
 		}
 		if (i.value().first != location) {
 			for (FileLocations::iterator j = _fileLocations.find(i.value().first), e = _fileLocations.end(); (j != e) && (j.key() == i.value().first);) {
 				if (j.value() == i.value().second) {
+					_journalFileLocationRemoved(i.value().first, j.value().fname);
 					_fileLocations.erase(j);
 					break;
 				}
@@ -3128,7 +3749,7 @@ void writeFileLocation(MediaKey location, const FileLocation &local) {
 	}
 	_fileLocations.insert(location, local);
 	_fileLocationPairs.insert(local.fname, FileLocationPair(location, local));
-	_writeLocations(WriteMapWhen::Fast);
+	_journalFileLocation(location, local);
 }
 
 FileLocation readFileLocation(MediaKey location, bool check) {
@@ -3141,9 +3762,9 @@ FileLocation readFileLocation(MediaKey location, bool check) {
 	for (FileLocations::iterator i = _fileLocations.find(location); (i != _fileLocations.end()) && (i.key() == location);) {
 		if (check) {
 			if (!i.value().check()) {
+				_journalFileLocationRemoved(location, i.value().fname);
 				_fileLocationPairs.remove(i.value().fname);
 				i = _fileLocations.erase(i);
-				_writeLocations();
 				continue;
 			}
 		}
@@ -3282,6 +3903,141 @@ void cancelTask(TaskId id) {
 	}
 }
 
+// Written as the hash of the sets file to mark the index format, where
+// set contents are stored in separate per-set files. Legacy files wrote
+// an empty hash there.
+const char kStickerSetsIndexMarker[] = "indexed";
+
+quint32 _stickerSetContentSize(const Stickers::Set &set) {
+	quint32 size = sizeof(qint32); // stickersCount
+	for (const auto sticker : std::as_const(set.stickers)) {
+		sticker->refreshStickerThumbFileReference();
+		size += Serialize::Document::sizeInStream(sticker);
+	}
+	size += sizeof(qint32); // dates count
+	if (!set.dates.empty()) {
+		Assert(set.dates.size() == set.stickers.size());
+		size += set.dates.size() * sizeof(qint32);
+	}
+	size += sizeof(qint32); // emojiCount
+	for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
+		size += Serialize::stringSize(j.key()->id()) + sizeof(qint32) + (j->size() * sizeof(quint64));
+	}
+	return size;
+}
+
+FileKey _writeStickerSetContent(const Stickers::Set &set) {
+	auto key = _stickerSetContentKeys.value(set.id);
+	if (!key) {
+		key = genKey();
+		_stickerSetContentKeys.insert(set.id, key);
+		_mapChanged = true;
+		_writeMap(WriteMapWhen::Fast);
+	} else if (set.hash != 0
+		&& _stickerSetContentHashes.value(set.id) == set.hash) {
+		// The content file is up to date, only the index gets rewritten.
+		return key;
+	}
+
+	EncryptedDescriptor data(_stickerSetContentSize(set));
+	data.stream << qint32(set.stickers.size());
+	for (auto j = set.stickers.cbegin(), e = set.stickers.cend(); j != e; ++j) {
+		Serialize::Document::writeToStream(data.stream, *j);
+	}
+	data.stream << qint32(set.dates.size());
+	if (!set.dates.empty()) {
+		Assert(set.dates.size() == set.stickers.size());
+		for (const auto date : set.dates) {
+			data.stream << qint32(date);
+		}
+	}
+	data.stream << qint32(set.emoji.size());
+	for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
+		data.stream << j.key()->id() << qint32(j->size());
+		for (int32 k = 0, l = j->size(); k < l; ++k) {
+			data.stream << quint64(j->at(k)->id);
+		}
+	}
+
+	FileWriteDescriptor file(key);
+	file.writeEncrypted(data);
+	_stickerSetContentHashes.insert(set.id, set.hash);
+	return key;
+}
+
+void _readStickerSetContent(FileKey contentKey, Stickers::Set &set, bool fillStickers, const MTPInputStickerSet &inputSet) {
+	FileReadDescriptor content;
+	if (!readEncryptedFile(content, contentKey)) {
+		return;
+	}
+	qint32 scnt = 0;
+	content.stream >> scnt;
+	if (!_checkStreamStatus(content.stream) || scnt < 0) {
+		return;
+	}
+
+	Serialize::Document::StickerSetInfo info(set.id, set.access, set.shortName);
+	OrderedSet<DocumentId> read;
+	for (qint32 j = 0; j < scnt; ++j) {
+		auto document = Serialize::Document::readStickerFromStream(content.version, content.stream, info);
+		if (!document || !document->sticker()) continue;
+
+		if (read.contains(document->id)) continue;
+		read.insert(document->id);
+
+		if (fillStickers) {
+			set.stickers.push_back(document);
+			if (!(set.flags & MTPDstickerSet_ClientFlag::f_special)) {
+				if (document->sticker()->set.type() != mtpc_inputStickerSetID) {
+					document->sticker()->set = inputSet;
+				}
+			}
+			++set.count;
+		}
+	}
+
+	auto datesCount = qint32(0);
+	content.stream >> datesCount;
+	if (datesCount > 0) {
+		if (datesCount != scnt) {
+			// Bad file.
+			return;
+		}
+		set.dates.reserve(datesCount);
+		for (auto i = 0; i != datesCount; ++i) {
+			auto date = qint32();
+			content.stream >> date;
+			if (set.id == Stickers::CloudRecentSetId) {
+				set.dates.push_back(TimeId(date));
+			}
+		}
+	}
+
+	qint32 emojiCount = 0;
+	content.stream >> emojiCount;
+	for (qint32 j = 0; j < emojiCount; ++j) {
+		QString emojiString;
+		qint32 stickersCount;
+		content.stream >> emojiString >> stickersCount;
+		Stickers::Pack pack;
+		pack.reserve(stickersCount);
+		for (qint32 k = 0; k < stickersCount; ++k) {
+			quint64 id;
+			content.stream >> id;
+			const auto doc = Auth().data().document(id);
+			if (!doc->sticker()) continue;
+
+			pack.push_back(doc);
+		}
+		if (fillStickers) {
+			if (auto emoji = Ui::Emoji::Find(emojiString)) {
+				emoji = emoji->original();
+				set.emoji.insert(emoji, pack);
+			}
+		}
+	}
+}
+
 void _writeStickerSet(QDataStream &stream, const Stickers::Set &set) {
 	bool notLoaded = (set.flags & MTPDstickerSet_ClientFlag::f_not_loaded);
 	if (notLoaded) {
@@ -3312,28 +4068,7 @@ void _writeStickerSet(QDataStream &stream, const Stickers::Set &set) {
 	if (AppVersion > 1002008) {
 		stream << qint32(set.installDate);
 	}
-	for (auto j = set.stickers.cbegin(), e = set.stickers.cend(); j != e; ++j) {
-		Serialize::Document::writeToStream(stream, *j);
-	}
-	if (AppVersion > 1002008) {
-		stream << qint32(set.dates.size());
-		if (!set.dates.empty()) {
-			Assert(set.dates.size() == set.stickers.size());
-			for (const auto date : set.dates) {
-				stream << qint32(date);
-			}
-		}
-	}
-
-	if (AppVersion > 9018) {
-		stream << qint32(set.emoji.size());
-		for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
-			stream << j.key()->id() << qint32(j->size());
-			for (int32 k = 0, l = j->size(); k < l; ++k) {
-				stream << quint64(j->at(k)->id);
-			}
-		}
-	}
+	stream << quint64(_writeStickerSetContent(set));
 }
 
 // In generic method _writeStickerSets() we look through all the sets and call a
@@ -3356,11 +4091,19 @@ void _writeStickerSets(FileKey &stickersKey, CheckSet checkSet, const Stickers::
 			stickersKey = 0;
 			_mapChanged = true;
 		}
+		if (!_stickerSetContentKeys.isEmpty()) {
+			for (const auto &key : _stickerSetContentKeys) {
+				clearKey(key);
+			}
+			_stickerSetContentKeys.clear();
+			_stickerSetContentHashes.clear();
+			_mapChanged = true;
+		}
 		_writeMap();
 		return;
 	}
 	int32 setsCount = 0;
-	QByteArray hashToWrite;
+	QByteArray hashToWrite(kStickerSetsIndexMarker);
 	quint32 size = sizeof(quint32) + Serialize::bytearraySize(hashToWrite);
 	for (const auto &set : sets) {
 		auto result = checkSet(set);
@@ -3372,20 +4115,7 @@ void _writeStickerSets(FileKey &stickersKey, CheckSet checkSet, const Stickers::
 
 		// id + access + title + shortName + stickersCount + hash + flags + installDate
 		size += sizeof(quint64) * 2 + Serialize::stringSize(set.title) + Serialize::stringSize(set.shortName) + sizeof(quint32) + sizeof(qint32) * 3;
-		for (const auto sticker : std::as_const(set.stickers)) {
-			sticker->refreshStickerThumbFileReference();
-			size += Serialize::Document::sizeInStream(sticker);
-		}
-		size += sizeof(qint32); // dates count
-		if (!set.dates.empty()) {
-			Assert(set.stickers.size() == set.dates.size());
-			size += set.dates.size() * sizeof(qint32);
-		}
-
-		size += sizeof(qint32); // emojiCount
-		for (auto j = set.emoji.cbegin(), e = set.emoji.cend(); j != e; ++j) {
-			size += Serialize::stringSize(j.key()->id()) + sizeof(qint32) + (j->size() * sizeof(quint64));
-		}
+		size += sizeof(quint64); // content file key
 
 		++setsCount;
 	}
@@ -3420,6 +4150,23 @@ void _writeStickerSets(FileKey &stickersKey, CheckSet checkSet, const Stickers::
 
 	FileWriteDescriptor file(stickersKey);
 	file.writeEncrypted(data);
+
+	// Drop content files of sets that are gone completely.
+	auto removed = false;
+	for (auto i = _stickerSetContentKeys.begin(); i != _stickerSetContentKeys.end();) {
+		if (sets.contains(i.key())) {
+			++i;
+		} else {
+			clearKey(i.value());
+			_stickerSetContentHashes.remove(i.key());
+			i = _stickerSetContentKeys.erase(i);
+			removed = true;
+		}
+	}
+	if (removed) {
+		_mapChanged = true;
+		_writeMap();
+	}
 }
 
 void _readStickerSets(FileKey &stickersKey, Stickers::Order *outOrder = nullptr, MTPDstickerSet::Flags readingFlags = 0) {
@@ -3438,7 +4185,9 @@ void _readStickerSets(FileKey &stickersKey, Stickers::Order *outOrder = nullptr,
 
 	quint32 cnt;
 	QByteArray hash;
-	stickers.stream >> cnt >> hash; // ignore hash, it is counted
+	stickers.stream >> cnt >> hash;
+	// Legacy files stored set contents inline and an empty hash here.
+	const auto indexed = (hash == kStickerSetsIndexMarker);
 	if (readingInstalled && stickers.version < 8019) { // bad data in old caches
 		cnt += 2; // try to read at least something
 	}
@@ -3473,6 +4222,13 @@ void _readStickerSets(FileKey &stickersKey, Stickers::Order *outOrder = nullptr,
 			setFlags |= MTPDstickerSet::Flag::f_installed_date;
 		}
 
+		FileKey contentKey = 0;
+		if (indexed && scnt >= 0) {
+			quint64 contentKeyValue = 0;
+			stickers.stream >> contentKeyValue;
+			contentKey = contentKeyValue;
+		}
+
 		if (setId == Stickers::DefaultSetId) {
 			setTitle = lang(lng_stickers_default_set);
 			setFlags |= MTPDstickerSet::Flag::f_official | MTPDstickerSet_ClientFlag::f_special;
@@ -3526,6 +4282,13 @@ void _readStickerSets(FileKey &stickersKey, Stickers::Order *outOrder = nullptr,
 			set.count = 0;
 		}
 
+		if (indexed) {
+			_stickerSetContentKeys.insert(setId, contentKey);
+			_readStickerSetContent(contentKey, set, fillStickers, inputSet);
+			_stickerSetContentHashes.insert(setId, setHash);
+			continue;
+		}
+
 		Serialize::Document::StickerSetInfo info(setId, setAccess, setShortName);
 		OrderedSet<DocumentId> read;
 		for (int32 j = 0; j < scnt; ++j) {
@@ -4609,6 +5372,121 @@ void saveRecentSearchHashtags(const QString &text) {
 	}
 }
 
+void writeRecentSharePeers() {
+	if (!_working()) return;
+
+	const RecentSharePack &recent(cRecentSharePeers());
+	if (recent.isEmpty()) {
+		if (_recentSharePeersKey) {
+			clearKey(_recentSharePeersKey);
+			_recentSharePeersKey = 0;
+			_mapChanged = true;
+		}
+		_writeMap();
+	} else {
+		if (!_recentSharePeersKey) {
+			_recentSharePeersKey = genKey();
+			_mapChanged = true;
+			_writeMap(WriteMapWhen::Fast);
+		}
+		quint32 size = sizeof(quint32) + recent.size() * (sizeof(quint64) + sizeof(qint32) + sizeof(quint16));
+
+		EncryptedDescriptor data(size);
+		data.stream << quint32(recent.size());
+		for (auto i = recent.cbegin(), e = recent.cend(); i != e; ++i) {
+			data.stream << quint64(i->peer) << qint32(i->date) << quint16(i->count);
+		}
+		FileWriteDescriptor file(_recentSharePeersKey);
+		file.writeEncrypted(data);
+	}
+}
+
+void readRecentSharePeers() {
+	if (_recentSharePeersWereRead) return;
+	_recentSharePeersWereRead = true;
+
+	if (!_recentSharePeersKey) return;
+
+	FileReadDescriptor peers;
+	if (!readEncryptedFile(peers, _recentSharePeersKey)) {
+		clearKey(_recentSharePeersKey);
+		_recentSharePeersKey = 0;
+		_writeMap();
+		return;
+	}
+
+	quint32 count = 0;
+	peers.stream >> count;
+
+	RecentSharePack recent;
+	if (count) {
+		recent.reserve(count);
+		for (quint32 i = 0; i < count; ++i) {
+			quint64 peer = 0;
+			qint32 date = 0;
+			quint16 shareCount = 0;
+			peers.stream >> peer >> date >> shareCount;
+			if (!_checkStreamStatus(peers.stream)) {
+				return;
+			}
+			RecentSharedPeer entry;
+			entry.peer = peer;
+			entry.date = date;
+			entry.count = shareCount;
+			recent.push_back(entry);
+		}
+	}
+	cSetRecentSharePeers(recent);
+}
+
+void saveRecentSharePeers(const QVector<PeerData*> &peers) {
+	if (peers.isEmpty()) {
+		return;
+	}
+	readRecentSharePeers();
+	auto &recent = cRefRecentSharePeers();
+	const auto date = unixtime();
+	for (const auto peer : peers) {
+		const auto id = quint64(peer->id);
+		auto i = recent.begin(), e = recent.end();
+		for (; i != e; ++i) {
+			if (i->peer == id) {
+				++i->count;
+				i->date = date;
+				if (i->count > 0x4000) {
+					for (auto j = recent.begin(); j != e; ++j) {
+						if (j->count > 1) {
+							j->count /= 2;
+						}
+					}
+				}
+				for (; i != recent.begin(); --i) {
+					if ((i - 1)->count >= i->count) {
+						break;
+					}
+					qSwap(*i, *(i - 1));
+				}
+				break;
+			}
+		}
+		if (i == e) {
+			while (recent.size() >= 64) recent.pop_back();
+			RecentSharedPeer entry;
+			entry.peer = id;
+			entry.date = date;
+			entry.count = 1;
+			recent.push_back(entry);
+			for (i = recent.end() - 1; i != recent.begin(); --i) {
+				if ((i - 1)->count >= i->count) {
+					break;
+				}
+				qSwap(*i, *(i - 1));
+			}
+		}
+	}
+	writeRecentSharePeers();
+}
+
 void WriteExportSettings(const Export::Settings &settings) {
 	if (!_working()) return;
 
@@ -4842,10 +5720,183 @@ void removeSavedPeer(PeerData *peer) {
 	}
 }
 
+void writeDialogsSnapshot(const std::vector<SnapshotDialog> &list) {
+	if (!_working()) return;
+
+	if (list.empty()) {
+		if (_dialogsSnapshotKey) {
+			clearKey(_dialogsSnapshotKey);
+			_dialogsSnapshotKey = 0;
+			_mapChanged = true;
+		}
+		_writeMap();
+	} else {
+		if (!_dialogsSnapshotKey) {
+			_dialogsSnapshotKey = genKey();
+			_mapChanged = true;
+			_writeMap(WriteMapWhen::Fast);
+		}
+		quint32 size = sizeof(quint32);
+		for (const auto &entry : list) {
+			size += Serialize::peerSize(entry.peer) + 2 * sizeof(qint32);
+		}
+
+		EncryptedDescriptor data(size);
+		data.stream << quint32(list.size());
+		for (const auto &entry : list) {
+			Serialize::writePeer(data.stream, entry.peer);
+			data.stream << qint32(entry.unreadCount) << qint32(entry.date);
+		}
+
+		FileWriteDescriptor file(_dialogsSnapshotKey);
+		file.writeEncrypted(data);
+	}
+
+	// The snapshot carries the current unread counts, so the read states
+	// journaled since the previous snapshot are superseded by it.
+	_clearReadStates();
+}
+
+void writeReadStateDelayed(const PeerId &peer, int32 unreadCount) {
+	if (!_working()) return;
+
+	_readReadStates();
+	const auto i = _readStatesMap.constFind(peer);
+	if (i != _readStatesMap.cend() && i.value() == unreadCount) {
+		return;
+	}
+	_readStatesMap.insert(peer, unreadCount);
+	_readStatesChanged = true;
+	_writeReadStates(WriteMapWhen::Soon);
+}
+
+std::vector<SnapshotDialog> readDialogsSnapshot() {
+	if (!_dialogsSnapshotKey) return {};
+
+	FileReadDescriptor snapshot;
+	if (!readEncryptedFile(snapshot, _dialogsSnapshotKey)) {
+		clearKey(_dialogsSnapshotKey);
+		_dialogsSnapshotKey = 0;
+		_writeMap();
+		return {};
+	}
+
+	// After a crash the snapshot unread counts may predate chats the
+	// user has already read through, the journal has the later values.
+	_readReadStates();
+
+	quint32 count = 0;
+	snapshot.stream >> count;
+	auto result = std::vector<SnapshotDialog>();
+	result.reserve(count);
+	for (quint32 i = 0; i < count; ++i) {
+		const auto peer = Serialize::readPeer(
+			snapshot.version,
+			snapshot.stream);
+		if (!peer) break;
+
+		qint32 unreadCount = 0, date = 0;
+		snapshot.stream >> unreadCount >> date;
+		if (!_checkStreamStatus(snapshot.stream)) {
+			return result;
+		}
+
+		SnapshotDialog entry;
+		entry.peer = peer;
+		entry.unreadCount = unreadCount;
+		entry.date = date;
+		const auto readState = _readStatesMap.constFind(peer->id);
+		if (readState != _readStatesMap.cend()) {
+			entry.unreadCount = readState.value();
+		}
+		result.push_back(entry);
+	}
+	return result;
+}
+
 void writeReportSpamStatuses() {
 	_writeReportSpamStatuses();
 }
 
+void writeSharedMediaCounts() {
+	if (!_working()) return;
+
+	const auto counts = Auth().storage().sharedMediaCountsSnapshot();
+	if (counts.empty()) {
+		if (_sharedMediaCountsKey) {
+			clearKey(_sharedMediaCountsKey);
+			_sharedMediaCountsKey = 0;
+			_mapChanged = true;
+		}
+		_writeMap();
+	} else {
+		if (!_sharedMediaCountsKey) {
+			_sharedMediaCountsKey = genKey();
+			_mapChanged = true;
+			_writeMap(WriteMapWhen::Fast);
+		}
+		quint32 size = sizeof(quint32);
+		for (const auto &[peerId, list] : counts) {
+			// peer + types count + counts
+			size += sizeof(quint64)
+				+ sizeof(qint32)
+				+ list.size() * sizeof(qint32);
+		}
+
+		EncryptedDescriptor data(size);
+		data.stream << quint32(counts.size());
+		for (const auto &[peerId, list] : counts) {
+			data.stream << quint64(peerId) << qint32(list.size());
+			for (const auto count : list) {
+				data.stream << qint32(count);
+			}
+		}
+
+		FileWriteDescriptor file(_sharedMediaCountsKey);
+		file.writeEncrypted(data);
+	}
+}
+
+void readSharedMediaCounts() {
+	if (!_sharedMediaCountsKey) return;
+
+	FileReadDescriptor counts;
+	if (!readEncryptedFile(counts, _sharedMediaCountsKey)) {
+		clearKey(_sharedMediaCountsKey);
+		_sharedMediaCountsKey = 0;
+		_writeMap();
+		return;
+	}
+
+	quint32 peersCount = 0;
+	counts.stream >> peersCount;
+	for (quint32 i = 0; i < peersCount; ++i) {
+		quint64 peerId = 0;
+		qint32 typesCount = 0;
+		counts.stream >> peerId >> typesCount;
+		if (!_checkStreamStatus(counts.stream)
+			|| typesCount < 0
+			|| typesCount > Storage::kSharedMediaTypeCount) {
+			return;
+		}
+		auto list = std::vector<int>();
+		list.reserve(typesCount);
+		for (auto j = 0; j != typesCount; ++j) {
+			qint32 count = 0;
+			counts.stream >> count;
+			list.push_back(count);
+		}
+		if (!_checkStreamStatus(counts.stream)) {
+			return;
+		}
+		if (peerId) {
+			Auth().storage().setCachedCounts(Storage::SharedMediaCachedCounts(
+				peerId,
+				std::move(list)));
+		}
+	}
+}
+
 void writeSelf() {
 	_mapChanged = true;
 	_writeMap();
@@ -4976,6 +6027,11 @@ bool ClearManager::addTask(int task) {
 			_draftCursorsMap.clear();
 			_mapChanged = true;
 		}
+		if (!_draftDeltasMap.isEmpty()) {
+			_draftDeltasMap.clear();
+			_mapChanged = true;
+		}
+		_draftDeltaStates.clear();
 		if (_locationsKey) {
 			_locationsKey = 0;
 			_mapChanged = true;
@@ -5000,10 +6056,24 @@ bool ClearManager::addTask(int task) {
 			_recentHashtagsAndBotsKey = 0;
 			_mapChanged = true;
 		}
+		if (_recentSharePeersKey) {
+			_recentSharePeersKey = 0;
+			_mapChanged = true;
+		}
 		if (_savedPeersKey) {
 			_savedPeersKey = 0;
 			_mapChanged = true;
 		}
+		if (_dialogsSnapshotKey) {
+			_dialogsSnapshotKey = 0;
+			_mapChanged = true;
+		}
+		if (_readStatesKey) {
+			_readStatesKey = 0;
+			_mapChanged = true;
+		}
+		_readStatesMap.clear();
+		_readStatesChanged = false;
 		_writeMap();
 	} else {
 		for (int32 i = 0, l = data->tasks.size(); i < l; ++i) {
@@ -5107,6 +6177,8 @@ Manager::Manager() {
 	connect(&_mapWriteTimer, SIGNAL(timeout()), this, SLOT(mapWriteTimeout()));
 	_locationsWriteTimer.setSingleShot(true);
 	connect(&_locationsWriteTimer, SIGNAL(timeout()), this, SLOT(locationsWriteTimeout()));
+	_readStatesWriteTimer.setSingleShot(true);
+	connect(&_readStatesWriteTimer, SIGNAL(timeout()), this, SLOT(readStatesWriteTimeout()));
 }
 
 void Manager::writeMap(bool fast) {
@@ -5133,6 +6205,18 @@ void Manager::writingLocations() {
 	_locationsWriteTimer.stop();
 }
 
+void Manager::writeReadStates(bool fast) {
+	if (!_readStatesWriteTimer.isActive() || fast) {
+		_readStatesWriteTimer.start(fast ? 1 : kWriteReadStatesTimeout);
+	} else if (_readStatesWriteTimer.remainingTime() <= 0) {
+		readStatesWriteTimeout();
+	}
+}
+
+void Manager::writingReadStates() {
+	_readStatesWriteTimer.stop();
+}
+
 void Manager::mapWriteTimeout() {
 	_writeMap(WriteMapWhen::Now);
 }
@@ -5141,6 +6225,10 @@ void Manager::locationsWriteTimeout() {
 	_writeLocations(WriteMapWhen::Now);
 }
 
+void Manager::readStatesWriteTimeout() {
+	_writeReadStates(WriteMapWhen::Now);
+}
+
 void Manager::finish() {
 	if (_mapWriteTimer.isActive()) {
 		mapWriteTimeout();
@@ -5148,6 +6236,9 @@ void Manager::finish() {
 	if (_locationsWriteTimer.isActive()) {
 		locationsWriteTimeout();
 	}
+	if (_readStatesWriteTimer.isActive()) {
+		readStatesWriteTimeout();
+	}
 }
 
 } // namespace internal
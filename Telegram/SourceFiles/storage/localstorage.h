@@ -159,6 +159,10 @@ void readRecentHashtagsAndBots();
 void saveRecentSentHashtags(const QString &text);
 void saveRecentSearchHashtags(const QString &text);
 
+void writeRecentSharePeers();
+void readRecentSharePeers();
+void saveRecentSharePeers(const QVector<PeerData*> &peers);
+
 void WriteExportSettings(const Export::Settings &settings);
 Export::Settings ReadExportSettings();
 
@@ -166,8 +170,27 @@ void addSavedPeer(PeerData *peer, const QDateTime &position);
 void removeSavedPeer(PeerData *peer);
 void readSavedPeers();
 
+// The last known state of the dialogs list, saved when the main widget
+// is destroyed and shown right at startup before any network round trip.
+struct SnapshotDialog {
+	PeerData *peer = nullptr;
+	int32 unreadCount = 0;
+	TimeId date = 0;
+};
+void writeDialogsSnapshot(const std::vector<SnapshotDialog> &list);
+std::vector<SnapshotDialog> readDialogsSnapshot();
+
+// Read-state changes are coalesced in memory and flushed as one small
+// journal file on a timer, so marking chats read costs no I/O at
+// interaction time. The journal overrides the snapshot unread counts
+// after a crash and is superseded by the next snapshot write.
+void writeReadStateDelayed(const PeerId &peer, int32 unreadCount);
+
 void writeReportSpamStatuses();
 
+void writeSharedMediaCounts();
+void readSharedMediaCounts();
+
 void writeSelf();
 void readSelf(const QByteArray &serialized, int32 streamVersion);
 
@@ -189,15 +212,19 @@ public:
 	void writingMap();
 	void writeLocations(bool fast);
 	void writingLocations();
+	void writeReadStates(bool fast);
+	void writingReadStates();
 	void finish();
 
 public slots:
 	void mapWriteTimeout();
 	void locationsWriteTimeout();
+	void readStatesWriteTimeout();
 
 private:
 	QTimer _mapWriteTimer;
 	QTimer _locationsWriteTimer;
+	QTimer _readStatesWriteTimer;
 
 };
 
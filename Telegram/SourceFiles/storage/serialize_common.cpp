@@ -16,6 +16,36 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 namespace Serialize {
 
+void writeCompactString(QDataStream &stream, const QString &value) {
+	const auto utf = value.toUtf8();
+	writeVarInt(stream, quint32(utf.size()));
+	if (!utf.isEmpty()) {
+		stream.writeRawData(utf.constData(), utf.size());
+	}
+}
+
+QString readCompactString(QDataStream &stream) {
+	constexpr auto kMaxSize = quint32(16 * 1024 * 1024);
+	const auto length = readVarInt(stream);
+	if (stream.status() != QDataStream::Ok || !length) {
+		return QString();
+	} else if (length > kMaxSize) {
+		stream.setStatus(QDataStream::ReadCorruptData);
+		return QString();
+	}
+	auto utf = QByteArray(length, Qt::Uninitialized);
+	if (stream.readRawData(utf.data(), length) != int(length)) {
+		stream.setStatus(QDataStream::ReadPastEnd);
+		return QString();
+	}
+	return QString::fromUtf8(utf);
+}
+
+int compactStringSize(const QString &value) {
+	const auto length = quint32(value.toUtf8().size());
+	return varIntSize(length) + int(length);
+}
+
 void writeStorageImageLocation(
 		QDataStream &stream,
 		const StorageImageLocation &location) {
@@ -84,6 +84,43 @@ inline int dateTimeSize() {
 	return (sizeof(qint64) + sizeof(quint32) + sizeof(qint8));
 }
 
+// Unsigned LEB128, one byte for values below 128 instead of a fixed
+// qint32 / quint32. Used by the compact record formats.
+inline int varIntSize(quint32 value) {
+	auto result = 1;
+	for (value >>= 7; value != 0; value >>= 7) {
+		++result;
+	}
+	return result;
+}
+
+inline void writeVarInt(QDataStream &stream, quint32 value) {
+	while (value >= 0x80U) {
+		stream << quint8((value & 0x7FU) | 0x80U);
+		value >>= 7;
+	}
+	stream << quint8(value);
+}
+
+inline quint32 readVarInt(QDataStream &stream) {
+	auto result = quint32(0);
+	for (auto shift = 0; shift != 35; shift += 7) {
+		quint8 byte = 0;
+		stream >> byte;
+		result |= quint32(byte & 0x7FU) << shift;
+		if (!(byte & 0x80U)) {
+			break;
+		}
+	}
+	return result;
+}
+
+// UTF-8 string with a varint length prefix, roughly half the size of
+// the UTF-16 QString stream operators for mostly-latin data.
+void writeCompactString(QDataStream &stream, const QString &value);
+QString readCompactString(QDataStream &stream);
+int compactStringSize(const QString &value);
+
 void writeStorageImageLocation(
 	QDataStream &stream,
 	const StorageImageLocation &location);
@@ -21,34 +21,90 @@ enum StickerSetType {
 	StickerSetTypeShortName = 2,
 };
 
+// Version 1 is the compact format: varint-encoded integers, UTF-8
+// strings and a table of well-known mime types instead of fixed-width
+// fields and UTF-16 QString streams. Version 0 records are still read.
+constexpr auto kCompactFormatVersion = 1;
+
+// Most records share one of a few well-known mime types, so these are
+// written as a single varint index into this table. Any other value is
+// written inline after an index equal to the table size.
+const char *MimeTable[] = {
+	"image/webp",
+	"image/jpeg",
+	"image/png",
+	"image/gif",
+	"video/mp4",
+	"video/webm",
+	"audio/ogg",
+	"audio/mpeg",
+	"application/pdf",
+	"application/zip",
+};
+constexpr auto kMimeTableSize = int(sizeof(MimeTable) / sizeof(MimeTable[0]));
+
+void writeMimeString(QDataStream &stream, const QString &mime) {
+	for (auto i = 0; i != kMimeTableSize; ++i) {
+		if (mime == QLatin1String(MimeTable[i])) {
+			Serialize::writeVarInt(stream, quint32(i));
+			return;
+		}
+	}
+	Serialize::writeVarInt(stream, quint32(kMimeTableSize));
+	Serialize::writeCompactString(stream, mime);
+}
+
+QString readMimeString(QDataStream &stream) {
+	const auto index = Serialize::readVarInt(stream);
+	if (index < quint32(kMimeTableSize)) {
+		return QString::fromLatin1(MimeTable[index]);
+	}
+	return Serialize::readCompactString(stream);
+}
+
+int mimeStringSize(const QString &mime) {
+	for (auto i = 0; i != kMimeTableSize; ++i) {
+		if (mime == QLatin1String(MimeTable[i])) {
+			return Serialize::varIntSize(quint32(i));
+		}
+	}
+	return Serialize::varIntSize(quint32(kMimeTableSize))
+		+ Serialize::compactStringSize(mime);
+}
+
 } // namespace
 
 namespace Serialize {
 
 void Document::writeToStream(QDataStream &stream, DocumentData *document) {
-	const auto version = 0;
+	const auto version = kCompactFormatVersion;
 	stream << quint64(document->id) << quint64(document->_access) << qint32(document->date);
 	stream << document->_fileReference << qint32(version);
-	stream << document->filename() << document->mimeString() << qint32(document->_dc) << qint32(document->size);
-	stream << qint32(document->dimensions.width()) << qint32(document->dimensions.height());
-	stream << qint32(document->type);
+	writeCompactString(stream, document->filename());
+	writeMimeString(stream, document->mimeString());
+	writeVarInt(stream, quint32(document->_dc));
+	writeVarInt(stream, quint32(document->size));
+	writeVarInt(stream, quint32(document->dimensions.width()));
+	writeVarInt(stream, quint32(document->dimensions.height()));
+	writeVarInt(stream, quint32(document->type));
 	if (auto sticker = document->sticker()) {
-		stream << document->sticker()->alt;
+		writeCompactString(stream, document->sticker()->alt);
 		switch (document->sticker()->set.type()) {
 		case mtpc_inputStickerSetID: {
-			stream << qint32(StickerSetTypeID);
+			writeVarInt(stream, quint32(StickerSetTypeID));
 		} break;
 		case mtpc_inputStickerSetShortName: {
-			stream << qint32(StickerSetTypeShortName);
+			writeVarInt(stream, quint32(StickerSetTypeShortName));
 		} break;
 		case mtpc_inputStickerSetEmpty:
 		default: {
-			stream << qint32(StickerSetTypeEmpty);
+			writeVarInt(stream, quint32(StickerSetTypeEmpty));
 		} break;
 		}
 		writeStorageImageLocation(stream, document->sticker()->loc);
 	} else {
-		stream << qint32(document->duration());
+		// +1 so that the "no duration" value -1 stays in varint range.
+		writeVarInt(stream, quint32(document->duration() + 1));
 		if (const auto thumb = document->thumbnail()) {
 			writeStorageImageLocation(stream, thumb->location());
 		} else {
@@ -71,9 +127,19 @@ DocumentData *Document::readFromStreamHelper(int streamAppVersion, QDataStream &
 	} else {
 		version = 0;
 	}
-	stream >> name >> mime >> dc >> size;
-	stream >> width >> height;
-	stream >> type;
+	if (version >= kCompactFormatVersion) {
+		name = readCompactString(stream);
+		mime = readMimeString(stream);
+		dc = qint32(readVarInt(stream));
+		size = qint32(readVarInt(stream));
+		width = qint32(readVarInt(stream));
+		height = qint32(readVarInt(stream));
+		type = qint32(readVarInt(stream));
+	} else {
+		stream >> name >> mime >> dc >> size;
+		stream >> width >> height;
+		stream >> type;
+	}
 
 	QVector<MTPDocumentAttribute> attributes;
 	if (!name.isEmpty()) {
@@ -84,8 +150,13 @@ DocumentData *Document::readFromStreamHelper(int streamAppVersion, QDataStream &
 	StorageImageLocation thumb;
 	if (type == StickerDocument) {
 		QString alt;
-		qint32 typeOfSet;
-		stream >> alt >> typeOfSet;
+		qint32 typeOfSet = StickerSetTypeEmpty;
+		if (version >= kCompactFormatVersion) {
+			alt = readCompactString(stream);
+			typeOfSet = qint32(readVarInt(stream));
+		} else {
+			stream >> alt >> typeOfSet;
+		}
 
 		thumb = readStorageImageLocation(streamAppVersion, stream);
 
@@ -113,7 +184,11 @@ DocumentData *Document::readFromStreamHelper(int streamAppVersion, QDataStream &
 			}
 		}
 	} else {
-		stream >> duration;
+		if (version >= kCompactFormatVersion) {
+			duration = qint32(readVarInt(stream)) - 1;
+		} else {
+			stream >> duration;
+		}
 		if (type == AnimatedDocument) {
 			attributes.push_back(MTP_documentAttributeAnimated());
 		}
@@ -159,23 +234,24 @@ DocumentData *Document::readFromStream(int streamAppVersion, QDataStream &stream
 int Document::sizeInStream(DocumentData *document) {
 	int result = 0;
 
-	// id + access + date + version
-	result += sizeof(quint64) + sizeof(quint64) + sizeof(qint32) + sizeof(qint32);
-	// + namelen + name + mimelen + mime + dc + size
-	result += stringSize(document->filename()) + stringSize(document->mimeString()) + sizeof(qint32) + sizeof(qint32);
-	// + width + height
-	result += sizeof(qint32) + sizeof(qint32);
-	// + type
-	result += sizeof(qint32);
+	// id + access + date + file-reference + version
+	result += sizeof(quint64) + sizeof(quint64) + sizeof(qint32);
+	result += bytearraySize(document->_fileReference) + sizeof(qint32);
+	// + name + mime + dc + size
+	result += compactStringSize(document->filename()) + mimeStringSize(document->mimeString());
+	result += varIntSize(quint32(document->_dc)) + varIntSize(quint32(document->size));
+	// + width + height + type
+	result += varIntSize(quint32(document->dimensions.width())) + varIntSize(quint32(document->dimensions.height()));
+	result += varIntSize(quint32(document->type));
 
 	if (auto sticker = document->sticker()) { // type == StickerDocument
-		// + altlen + alt + type-of-set
-		result += stringSize(sticker->alt) + sizeof(qint32);
+		// + alt + type-of-set
+		result += compactStringSize(sticker->alt) + 1;
 		// + sticker loc
 		result += Serialize::storageImageLocationSize(document->sticker()->loc);
 	} else {
 		// + duration
-		result += sizeof(qint32);
+		result += varIntSize(quint32(document->duration() + 1));
 		// + thumb loc
 		if (const auto thumb = document->thumbnail()) {
 			result += Serialize::storageImageLocationSize(thumb->location());
@@ -8,17 +8,79 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_clear_legacy.h"
 
 #include <crl/crl_async.h>
+#include <crl/crl_semaphore.h>
+#include <thread>
 
 namespace Storage {
 namespace {
 
 constexpr auto kClearPartSize = size_type(10000);
+constexpr auto kRemoveShardSize = size_type(1024);
+
+// Removes [from, till) of files, pushing the ones it could not remove
+// to the failed list instead of mutating the shared skip set.
+void RemoveFilesShard(
+		const QString &base,
+		const std::vector<QString> &files,
+		size_type from,
+		size_type till,
+		const base::flat_set<QString> &skip,
+		std::vector<QString> &failed) {
+	for (auto i = from; i != till; ++i) {
+		const auto &name = files[i];
+		if (!skip.contains(name)
+			&& !details::RemoveLegacyFile(base + name)) {
+			failed.push_back(name);
+		}
+	}
+}
+
+void RemoveFiles(
+		const QString &base,
+		const std::vector<QString> &files,
+		base::flat_set<QString> &skip) {
+	const auto count = size_type(files.size());
+	const auto concurrency = std::max(
+		size_type(std::thread::hardware_concurrency()),
+		size_type(1));
+	const auto shards = std::min(
+		concurrency,
+		(count + kRemoveShardSize - 1) / kRemoveShardSize);
+	if (shards < 2) {
+		auto failed = std::vector<QString>();
+		RemoveFilesShard(base, files, 0, count, skip, failed);
+		for (auto &name : failed) {
+			skip.emplace(std::move(name));
+		}
+		return;
+	}
+	auto failed = std::vector<std::vector<QString>>(shards);
+	auto semaphore = crl::semaphore();
+	const auto perShard = (count + shards - 1) / shards;
+	for (auto i = size_type(0); i != shards; ++i) {
+		const auto from = i * perShard;
+		const auto till = std::min(from + perShard, count);
+		crl::async([&, from, till, i] {
+			RemoveFilesShard(base, files, from, till, skip, failed[i]);
+			semaphore.release();
+		});
+	}
+	for (auto i = size_type(0); i != shards; ++i) {
+		semaphore.acquire();
+	}
+	for (auto &list : failed) {
+		for (auto &name : list) {
+			skip.emplace(std::move(name));
+		}
+	}
+}
 
 } // namespace
 
 void ClearLegacyFilesPart(
 		const QString &base,
 		CollectGoodFiles filter,
+		ClearLegacyProgress progress,
 		base::flat_set<QString> &&skip = {}) {
 	filter([
 		=,
@@ -29,24 +91,29 @@ void ClearLegacyFilesPart(
 			files = std::move(files),
 			skip = std::move(skip)
 		]() mutable {
-			for (const auto &name : files) {
-				if (!skip.contains(name)
-					&& !details::RemoveLegacyFile(base + name)) {
-					skip.emplace(name);
-				}
+			RemoveFiles(base, files, skip);
+			if (progress) {
+				progress(size_type(files.size()));
 			}
 			if (files.size() == kClearPartSize) {
-				ClearLegacyFilesPart(base, filter, std::move(skip));
+				ClearLegacyFilesPart(
+					base,
+					filter,
+					progress,
+					std::move(skip));
 			}
 		});
 	});
 }
 
-void ClearLegacyFiles(const QString &base, CollectGoodFiles filter) {
+void ClearLegacyFiles(
+		const QString &base,
+		CollectGoodFiles filter,
+		ClearLegacyProgress progress) {
 	Expects(base.endsWith('/'));
 
 	crl::async([=] {
-		ClearLegacyFilesPart(base, std::move(filter));
+		ClearLegacyFilesPart(base, std::move(filter), std::move(progress));
 	});
 }
 
@@ -11,7 +11,14 @@ namespace Storage {
 
 using CollectGoodFiles = Fn<void(FnMut<void(base::flat_set<QString>&&)>)>;
 
-void ClearLegacyFiles(const QString &base, CollectGoodFiles filter);
+// Called from an arbitrary thread after each part of the sweep with the
+// number of files that were checked in that part.
+using ClearLegacyProgress = Fn<void(size_type checked)>;
+
+void ClearLegacyFiles(
+	const QString &base,
+	CollectGoodFiles filter,
+	ClearLegacyProgress progress = nullptr);
 
 namespace details {
 
@@ -46,6 +46,10 @@ private:
 
 };
 
+// Each database handed out here runs on its own serial crl::queue that
+// is multiplexed over the common crl thread pool together with its
+// cleaner and compactor, so keeping several databases alive (the main
+// cache, the big-file cache) does not pin an OS thread per database.
 class Databases {
 public:
 	DatabasePointer get(
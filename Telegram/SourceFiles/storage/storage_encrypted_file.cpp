@@ -187,6 +187,13 @@ void File::decrypt(bytes::span bytes) {
 	_encryptionOffset += bytes.size();
 }
 
+void File::decryptTo(bytes::span to, bytes::const_span from) {
+	Expects(_state.has_value());
+
+	_state->decrypt(from, to, _encryptionOffset);
+	_encryptionOffset += from.size();
+}
+
 void File::encrypt(bytes::span bytes) {
 	Expects(_state.has_value());
 
@@ -262,6 +269,37 @@ size_type File::readWithPadding(bytes::span bytes) {
 	return size;
 }
 
+size_type File::readMappedWithPadding(bytes::span bytes) {
+	const auto size = bytes.size();
+	const auto part = size % kBlockSize;
+	const auto good = size - part;
+	const auto full = part ? (good + kBlockSize) : good;
+	const auto position = _data.pos();
+	if (!full || position + full > _data.size()) {
+		return readWithPadding(bytes);
+	}
+	const auto mapped = _data.map(position, full);
+	if (!mapped) {
+		// Some filesystems cannot map, keep the buffered path working.
+		return readWithPadding(bytes);
+	}
+	const auto ciphertext = bytes::make_span(
+		reinterpret_cast<const bytes::type*>(mapped),
+		full);
+	if (good) {
+		decryptTo(bytes.subspan(0, good), ciphertext.subspan(0, good));
+	}
+	if (part) {
+		auto storage = bytes::array<kBlockSize>();
+		const auto padded = bytes::make_span(storage);
+		decryptTo(padded, ciphertext.subspan(good));
+		bytes::copy(bytes.subspan(good), padded.subspan(0, part));
+	}
+	_data.unmap(mapped);
+	_data.seek(position + full);
+	return size;
+}
+
 bool File::writeWithPadding(bytes::span bytes) {
 	const auto size = bytes.size();
 	const auto part = size % kBlockSize;
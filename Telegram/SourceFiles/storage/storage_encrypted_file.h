@@ -35,6 +35,12 @@ public:
 	size_type readWithPadding(bytes::span bytes);
 	bool writeWithPadding(bytes::span bytes);
 
+	// Reads like readWithPadding(), but through a memory mapping of the
+	// underlying file, decrypting straight from the mapped bytes into
+	// the destination, so big values are copied only once. Falls back
+	// to readWithPadding() if the file could not be mapped.
+	size_type readMappedWithPadding(bytes::span bytes);
+
 	bool flush();
 
 	bool isOpen() const;
@@ -58,6 +64,7 @@ private:
 	size_type readPlain(bytes::span bytes);
 	size_type writePlain(bytes::const_span bytes);
 	void decrypt(bytes::span bytes);
+	void decryptTo(bytes::span to, bytes::const_span from);
 	void encrypt(bytes::span bytes);
 	void decryptBack(bytes::span bytes);
 
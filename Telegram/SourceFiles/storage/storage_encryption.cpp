@@ -19,31 +19,50 @@ CtrState::CtrState(bytes::const_span key, bytes::const_span iv) {
 	bytes::copy(_iv, iv);
 }
 
-template <typename Method>
-void CtrState::process(bytes::span data, int64 offset, Method method) {
-	Expects((data.size() % kBlockSize) == 0);
-	Expects((offset % kBlockSize) == 0);
+void CtrState::ContextDeleter::operator()(evp_cipher_ctx_st *value) const {
+	EVP_CIPHER_CTX_free(value);
+}
 
-	AES_KEY aes;
-	AES_set_encrypt_key(
-		reinterpret_cast<const uchar*>(_key.data()),
-		_key.size() * CHAR_BIT,
-		&aes);
+void CtrState::process(
+		bytes::const_span from,
+		bytes::span to,
+		int64 offset) {
+	Expects(from.size() == to.size());
+	Expects((from.size() % kBlockSize) == 0);
+	Expects((offset % kBlockSize) == 0);
 
-	unsigned char ecountBuf[kBlockSize] = { 0 };
-	unsigned int offsetInBlock = 0;
 	const auto blockIndex = offset / kBlockSize;
 	auto iv = incrementedIv(blockIndex);
 
-	CRYPTO_ctr128_encrypt(
-		reinterpret_cast<const uchar*>(data.data()),
-		reinterpret_cast<uchar*>(data.data()),
-		data.size(),
-		&aes,
-		reinterpret_cast<unsigned char*>(iv.data()),
-		ecountBuf,
-		&offsetInBlock,
-		(block128_f)method);
+	// The key schedule is expanded only once, the following calls just
+	// set the new counter value on the ready context.
+	if (!_context) {
+		_context.reset(EVP_CIPHER_CTX_new());
+		Assert(_context != nullptr);
+		const auto result = EVP_EncryptInit_ex(
+			_context.get(),
+			EVP_aes_256_ctr(),
+			nullptr,
+			reinterpret_cast<const uchar*>(_key.data()),
+			reinterpret_cast<const uchar*>(iv.data()));
+		Assert(result == 1);
+	} else {
+		const auto result = EVP_EncryptInit_ex(
+			_context.get(),
+			nullptr,
+			nullptr,
+			nullptr,
+			reinterpret_cast<const uchar*>(iv.data()));
+		Assert(result == 1);
+	}
+	auto outLength = 0;
+	const auto result = EVP_EncryptUpdate(
+		_context.get(),
+		reinterpret_cast<uchar*>(to.data()),
+		&outLength,
+		reinterpret_cast<const uchar*>(from.data()),
+		int(from.size()));
+	Assert(result == 1 && outLength == int(from.size()));
 }
 
 auto CtrState::incrementedIv(int64 blockIndex)
@@ -66,11 +85,18 @@ auto CtrState::incrementedIv(int64 blockIndex)
 }
 
 void CtrState::encrypt(bytes::span data, int64 offset) {
-	return process(data, offset, AES_encrypt);
+	return process(data, data, offset);
 }
 
 void CtrState::decrypt(bytes::span data, int64 offset) {
-	return process(data, offset, AES_encrypt);
+	return process(data, data, offset);
+}
+
+void CtrState::decrypt(
+		bytes::const_span from,
+		bytes::span to,
+		int64 offset) {
+	return process(from, to, offset);
 }
 
 EncryptionKey::EncryptionKey(bytes::vector &&data)
@@ -9,6 +9,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "base/bytes.h"
 
+struct evp_cipher_ctx_st;
+
 namespace Storage {
 
 constexpr auto kSaltSize = size_type(64);
@@ -23,18 +25,24 @@ public:
 
 	void encrypt(bytes::span data, int64 offset);
 	void decrypt(bytes::span data, int64 offset);
+	void decrypt(bytes::const_span from, bytes::span to, int64 offset);
 
 private:
-	template <typename Method>
-	void process(bytes::span data, int64 offset, Method method);
+	struct ContextDeleter {
+		void operator()(evp_cipher_ctx_st *value) const;
+	};
 
-	bytes::array<kIvSize> incrementedIv(int64 blockIndex);
+	void process(bytes::const_span from, bytes::span to, int64 offset);
 
-	static constexpr auto EcountSize = kBlockSize;
+	bytes::array<kIvSize> incrementedIv(int64 blockIndex);
 
 	bytes::array<kKeySize> _key;
 	bytes::array<kIvSize> _iv;
 
+	// Keeps the expanded key schedule between calls and lets OpenSSL
+	// choose the hardware (AES-NI) implementation when available.
+	std::unique_ptr<evp_cipher_ctx_st, ContextDeleter> _context;
+
 };
 
 class EncryptionKey {
@@ -21,6 +21,8 @@ public:
 	void remove(SharedMediaRemoveOne &&query);
 	void remove(SharedMediaRemoveAll &&query);
 	void invalidate(SharedMediaInvalidateBottom &&query);
+	void setCachedCounts(SharedMediaCachedCounts &&counts);
+	std::map<PeerId, std::vector<int>> sharedMediaCountsSnapshot() const;
 	rpl::producer<SharedMediaResult> query(SharedMediaQuery &&query) const;
 	rpl::producer<SharedMediaSliceUpdate> sharedMediaSliceUpdated() const;
 	rpl::producer<SharedMediaRemoveOne> sharedMediaOneRemoved() const;
@@ -79,6 +81,14 @@ void Facade::Impl::invalidate(SharedMediaInvalidateBottom &&query) {
 	_sharedMedia.invalidate(std::move(query));
 }
 
+void Facade::Impl::setCachedCounts(SharedMediaCachedCounts &&counts) {
+	_sharedMedia.setCachedCounts(std::move(counts));
+}
+
+std::map<PeerId, std::vector<int>> Facade::Impl::sharedMediaCountsSnapshot() const {
+	return _sharedMedia.countsSnapshot();
+}
+
 rpl::producer<SharedMediaResult> Facade::Impl::query(SharedMediaQuery &&query) const {
 	return _sharedMedia.query(std::move(query));
 }
@@ -199,6 +209,14 @@ void Facade::invalidate(SharedMediaInvalidateBottom &&query) {
 	_impl->invalidate(std::move(query));
 }
 
+void Facade::setCachedCounts(SharedMediaCachedCounts &&counts) {
+	_impl->setCachedCounts(std::move(counts));
+}
+
+std::map<PeerId, std::vector<int>> Facade::sharedMediaCountsSnapshot() const {
+	return _impl->sharedMediaCountsSnapshot();
+}
+
 rpl::producer<SharedMediaResult> Facade::query(SharedMediaQuery &&query) const {
 	return _impl->query(std::move(query));
 }
@@ -27,6 +27,7 @@ struct SharedMediaInvalidateBottom;
 struct SharedMediaQuery;
 using SharedMediaResult = SparseIdsListResult;
 struct SharedMediaSliceUpdate;
+struct SharedMediaCachedCounts;
 
 struct UserPhotosAddNew;
 struct UserPhotosAddSlice;
@@ -56,6 +57,8 @@ public:
 	void remove(SharedMediaRemoveOne &&query);
 	void remove(SharedMediaRemoveAll &&query);
 	void invalidate(SharedMediaInvalidateBottom &&query);
+	void setCachedCounts(SharedMediaCachedCounts &&counts);
+	std::map<PeerId, std::vector<int>> sharedMediaCountsSnapshot() const;
 
 	rpl::producer<SharedMediaResult> query(SharedMediaQuery &&query) const;
 	rpl::producer<SharedMediaSliceUpdate> sharedMediaSliceUpdated() const;
@@ -52,6 +52,115 @@ QSize PrepareShownDimensions(const QImage &preview) {
 		: result;
 }
 
+// A second drop of the same files (for example after cancelling the
+// send box) is served from here, skipping the expensive image decode.
+// Images are implicitly shared, so while the send box is opened the
+// entries mostly alias the pixel buffers which the list holds anyway.
+struct PreparedCacheEntry {
+	QDateTime modified;
+	int previewWidth = 0;
+	QString mime;
+	FileMediaInformation information;
+	QImage preview;
+	QSize shownDimensions;
+	PreparedFile::AlbumType type = PreparedFile::AlbumType::None;
+};
+
+QMutex PreparedCacheMutex;
+std::map<QString, PreparedCacheEntry> PreparedCache;
+
+bool FillFromPreparedCache(PreparedFile &file, int previewWidth) {
+	const auto modified = QFileInfo(file.path).lastModified();
+	QMutexLocker lock(&PreparedCacheMutex);
+	const auto i = PreparedCache.find(file.path);
+	if (i == PreparedCache.end()
+		|| i->second.previewWidth != previewWidth
+		|| i->second.modified != modified) {
+		return false;
+	}
+	const auto &entry = i->second;
+	file.mime = entry.mime;
+	file.information = std::make_unique<FileMediaInformation>(
+		entry.information);
+	file.preview = entry.preview;
+	file.shownDimensions = entry.shownDimensions;
+	file.type = entry.type;
+	return true;
+}
+
+void AddToPreparedCache(const PreparedFile &file, int previewWidth) {
+	if (!file.information) {
+		return;
+	}
+	auto entry = PreparedCacheEntry();
+	entry.modified = QFileInfo(file.path).lastModified();
+	entry.previewWidth = previewWidth;
+	entry.mime = file.mime;
+	entry.information = *file.information;
+	entry.preview = file.preview;
+	entry.shownDimensions = file.shownDimensions;
+	entry.type = file.type;
+
+	QMutexLocker lock(&PreparedCacheMutex);
+	if (PreparedCache.size() >= kMaxAlbumCount) {
+		PreparedCache.clear();
+	}
+	PreparedCache[file.path] = std::move(entry);
+}
+
+void PrepareAlbumEntry(PreparedFile &file, int previewWidth) {
+	if (!file.path.isEmpty()
+		&& FillFromPreparedCache(file, previewWidth)) {
+		return;
+	}
+	if (!file.path.isEmpty()) {
+		file.mime = Core::MimeTypeForFile(QFileInfo(file.path)).name();
+		file.information = FileLoadTask::ReadMediaInformation(
+			file.path,
+			QByteArray(),
+			file.mime);
+	} else if (!file.content.isEmpty()) {
+		file.mime = Core::MimeTypeForData(file.content).name();
+		file.information = FileLoadTask::ReadMediaInformation(
+			QString(),
+			file.content,
+			file.mime);
+	} else {
+		Assert(file.information != nullptr);
+	}
+
+	using Image = FileMediaInformation::Image;
+	using Video = FileMediaInformation::Video;
+	if (const auto image = base::get_if<Image>(
+			&file.information->media)) {
+		if (ValidPhotoForAlbum(*image)) {
+			file.shownDimensions = PrepareShownDimensions(image->data);
+			file.preview = Images::prepareOpaque(image->data.scaledToWidth(
+				std::min(previewWidth, ConvertScale(image->data.width()))
+					* cIntRetinaFactor(),
+				Qt::SmoothTransformation));
+			Assert(!file.preview.isNull());
+			file.preview.setDevicePixelRatio(cRetinaFactor());
+			file.type = PreparedFile::AlbumType::Photo;
+		}
+	} else if (const auto video = base::get_if<Video>(
+			&file.information->media)) {
+		if (ValidVideoForAlbum(*video)) {
+			auto blurred = Images::prepareBlur(Images::prepareOpaque(video->thumbnail));
+			file.shownDimensions = PrepareShownDimensions(video->thumbnail);
+			file.preview = std::move(blurred).scaledToWidth(
+				previewWidth * cIntRetinaFactor(),
+				Qt::SmoothTransformation);
+			Assert(!file.preview.isNull());
+			file.preview.setDevicePixelRatio(cRetinaFactor());
+			file.type = PreparedFile::AlbumType::Video;
+		}
+	}
+	if (!file.path.isEmpty()) {
+		AddToPreparedCache(file, previewWidth);
+	}
+}
+
 bool PrepareAlbumMediaIsWaiting(
 		QSemaphore &semaphore,
 		PreparedFile &file,
@@ -59,53 +168,21 @@ bool PrepareAlbumMediaIsWaiting(
 	// TODO: Use some special thread queue, like a separate QThreadPool.
 	crl::async([=, &semaphore, &file] {
 		const auto guard = gsl::finally([&] { semaphore.release(); });
-		if (!file.path.isEmpty()) {
-			file.mime = Core::MimeTypeForFile(QFileInfo(file.path)).name();
-			file.information = FileLoadTask::ReadMediaInformation(
-				file.path,
-				QByteArray(),
-				file.mime);
-		} else if (!file.content.isEmpty()) {
-			file.mime = Core::MimeTypeForData(file.content).name();
-			file.information = FileLoadTask::ReadMediaInformation(
-				QString(),
-				file.content,
-				file.mime);
-		} else {
-			Assert(file.information != nullptr);
-		}
-
-		using Image = FileMediaInformation::Image;
-		using Video = FileMediaInformation::Video;
-		if (const auto image = base::get_if<Image>(
-				&file.information->media)) {
-			if (ValidPhotoForAlbum(*image)) {
-				file.shownDimensions = PrepareShownDimensions(image->data);
-				file.preview = Images::prepareOpaque(image->data.scaledToWidth(
-					std::min(previewWidth, ConvertScale(image->data.width()))
-						* cIntRetinaFactor(),
-					Qt::SmoothTransformation));
-				Assert(!file.preview.isNull());
-				file.preview.setDevicePixelRatio(cRetinaFactor());
-				file.type = PreparedFile::AlbumType::Photo;
-			}
-		} else if (const auto video = base::get_if<Video>(
-				&file.information->media)) {
-			if (ValidVideoForAlbum(*video)) {
-				auto blurred = Images::prepareBlur(Images::prepareOpaque(video->thumbnail));
-				file.shownDimensions = PrepareShownDimensions(video->thumbnail);
-				file.preview = std::move(blurred).scaledToWidth(
-					previewWidth * cIntRetinaFactor(),
-					Qt::SmoothTransformation);
-				Assert(!file.preview.isNull());
-				file.preview.setDevicePixelRatio(cRetinaFactor());
-				file.type = PreparedFile::AlbumType::Video;
-			}
-		}
+		PrepareAlbumEntry(file, previewWidth);
 	});
 	return true;
 }
 
+void FinishAlbumPreparation(PreparedList &result) {
+	if (result.albumIsPossible) {
+		const auto badIt = ranges::find(
+			result.files,
+			PreparedFile::AlbumType::None,
+			[](const PreparedFile &file) { return file.type; });
+		result.albumIsPossible = (badIt == result.files.end());
+	}
+}
+
 void PrepareAlbum(PreparedList &result, int previewWidth) {
 	const auto count = int(result.files.size());
 	if (count > kMaxAlbumCount) {
@@ -122,14 +199,56 @@ void PrepareAlbum(PreparedList &result, int previewWidth) {
 	}
 	if (waiting > 0) {
 		semaphore.acquire(waiting);
-		if (result.albumIsPossible) {
-			const auto badIt = ranges::find(
-				result.files,
-				PreparedFile::AlbumType::None,
-				[](const PreparedFile &file) { return file.type; });
-			result.albumIsPossible = (badIt == result.files.end());
+		FinishAlbumPreparation(result);
+	}
+}
+
+// Used when the whole preparation already runs on the worker pool -
+// a pool task must not block on other pool tasks, so the files are
+// prepared one by one instead of the fan-out PrepareAlbum() does.
+void PrepareAlbumSerial(PreparedList &result, int previewWidth) {
+	const auto count = int(result.files.size());
+	if (count > kMaxAlbumCount) {
+		return;
+	}
+
+	result.albumIsPossible = (count > 1);
+	for (auto &file : result.files) {
+		PrepareAlbumEntry(file, previewWidth);
+	}
+	FinishAlbumPreparation(result);
+}
+
+PreparedList ListFromFiles(const QStringList &files) {
+	auto result = PreparedList();
+	result.files.reserve(files.size());
+	const auto extensionsToCompress = cExtensionsForCompress();
+	for (const auto &file : files) {
+		const auto fileinfo = QFileInfo(file);
+		const auto filesize = fileinfo.size();
+		if (fileinfo.isDir()) {
+			return {
+				PreparedList::Error::Directory,
+				file
+			};
+		} else if (filesize <= 0) {
+			return {
+				PreparedList::Error::EmptyFile,
+				file
+			};
+		} else if (filesize > App::kFileSizeLimit) {
+			return {
+				PreparedList::Error::TooLargeFile,
+				file
+			};
 		}
+		const auto toCompress = HasExtensionFrom(file, extensionsToCompress);
+		if (filesize > App::kImageSizeLimit || !toCompress) {
+			result.allFilesForCompress = false;
+		}
+		result.files.emplace_back(file);
 	}
+	return result;
 }
 
 } // namespace
@@ -215,38 +334,31 @@ PreparedList PrepareMediaList(const QList<QUrl> &files, int previewWidth) {
 }
 
 PreparedList PrepareMediaList(const QStringList &files, int previewWidth) {
-	auto result = PreparedList();
-	result.files.reserve(files.size());
-	const auto extensionsToCompress = cExtensionsForCompress();
-	for (const auto &file : files) {
-		const auto fileinfo = QFileInfo(file);
-		const auto filesize = fileinfo.size();
-		if (fileinfo.isDir()) {
-			return {
-				PreparedList::Error::Directory,
-				file
-			};
-		} else if (filesize <= 0) {
-			return {
-				PreparedList::Error::EmptyFile,
-				file
-			};
-		} else if (filesize > App::kFileSizeLimit) {
-			return {
-				PreparedList::Error::TooLargeFile,
-				file
-			};
-		}
-		const auto toCompress = HasExtensionFrom(file, extensionsToCompress);
-		if (filesize > App::kImageSizeLimit || !toCompress) {
-			result.allFilesForCompress = false;
-		}
-		result.files.emplace_back(file);
+	auto result = ListFromFiles(files);
+	if (result.error == PreparedList::Error::None) {
+		PrepareAlbum(result, previewWidth);
 	}
-	PrepareAlbum(result, previewWidth);
 	return result;
 }
 
+void PrepareMediaListAsync(
+		const QStringList &files,
+		int previewWidth,
+		Fn<void(PreparedList&&)> done) {
+	crl::async([=, done = std::move(done)]() mutable {
+		auto result = ListFromFiles(files);
+		if (result.error == PreparedList::Error::None) {
+			PrepareAlbumSerial(result, previewWidth);
+		}
+		crl::on_main([
+			done = std::move(done),
+			result = std::move(result)
+		]() mutable {
+			done(std::move(result));
+		});
+	});
+}
+
 PreparedList PrepareMediaFromImage(
 		QImage &&image,
 		QByteArray &&content,
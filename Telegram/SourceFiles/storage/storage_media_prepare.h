@@ -74,6 +74,10 @@ struct PreparedList {
 bool ValidateThumbDimensions(int width, int height);
 PreparedList PrepareMediaList(const QList<QUrl> &files, int previewWidth);
 PreparedList PrepareMediaList(const QStringList &files, int previewWidth);
+void PrepareMediaListAsync(
+	const QStringList &files,
+	int previewWidth,
+	Fn<void(PreparedList&&)> done);
 PreparedList PrepareMediaFromImage(
 	QImage &&image,
 	QByteArray &&content,
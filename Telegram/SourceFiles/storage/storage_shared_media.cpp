@@ -65,6 +65,37 @@ void SharedMedia::add(SharedMediaAddSlice &&query) {
 		query.count);
 }
 
+void SharedMedia::setCachedCounts(SharedMediaCachedCounts &&counts) {
+	auto peerIt = enforceLists(counts.peerId);
+	const auto filled = std::min(
+		int(counts.counts.size()),
+		kSharedMediaTypeCount);
+	for (auto index = 0; index != filled; ++index) {
+		auto &list = peerIt->second[index];
+		if (counts.counts[index] >= 0 && !list.count()) {
+			list.setCount(counts.counts[index]);
+		}
+	}
+}
+
+std::map<PeerId, std::vector<int>> SharedMedia::countsSnapshot() const {
+	auto result = std::map<PeerId, std::vector<int>>();
+	for (const auto &[peerId, lists] : _lists) {
+		auto counts = std::vector<int>(kSharedMediaTypeCount, -1);
+		auto anyCounted = false;
+		for (auto index = 0; index != kSharedMediaTypeCount; ++index) {
+			if (const auto count = lists[index].count()) {
+				counts[index] = *count;
+				anyCounted = true;
+			}
+		}
+		if (anyCounted) {
+			result.emplace(peerId, std::move(counts));
+		}
+	}
+	return result;
+}
+
 void SharedMedia::remove(SharedMediaRemoveOne &&query) {
 	auto peerIt = _lists.find(query.peerId);
 	if (peerIt != _lists.end()) {
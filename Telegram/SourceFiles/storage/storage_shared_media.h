@@ -89,6 +89,19 @@ struct SharedMediaAddSlice {
 
 };
 
+struct SharedMediaCachedCounts {
+	SharedMediaCachedCounts(PeerId peerId, std::vector<int> &&counts)
+	: peerId(peerId)
+	, counts(std::move(counts)) {
+	}
+
+	PeerId peerId = 0;
+
+	// Counts by SharedMediaType index, -1 stands for an unknown count.
+	std::vector<int> counts;
+
+};
+
 struct SharedMediaRemoveOne {
 	SharedMediaRemoveOne(
 		PeerId peerId,
@@ -190,6 +203,11 @@ public:
 	void remove(SharedMediaRemoveAll &&query);
 	void invalidate(SharedMediaInvalidateBottom &&query);
 
+	// Counts restored from the local storage only fill the types that
+	// weren't counted in this session yet, fresh data always wins.
+	void setCachedCounts(SharedMediaCachedCounts &&counts);
+	std::map<PeerId, std::vector<int>> countsSnapshot() const;
+
 	rpl::producer<SharedMediaResult> query(SharedMediaQuery &&query) const;
 	rpl::producer<SharedMediaSliceUpdate> sliceUpdated() const;
 	rpl::producer<SharedMediaRemoveOne> oneRemoved() const;
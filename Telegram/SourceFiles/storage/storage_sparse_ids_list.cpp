@@ -39,18 +39,43 @@ SparseIdsList::AddResult SparseIdsList::uniteAndAdd(
 		MsgRange noSkipRange) {
 	const auto uniteFromIndex = uniteFrom - _slices.begin();
 	const auto was = int(uniteFrom->messages.size());
-	_slices.modify(uniteFrom, [&](Slice &slice) {
-		slice.merge(messages, noSkipRange);
-	});
 	const auto firstToErase = uniteFrom + 1;
 	if (firstToErase != uniteTill) {
+		// Collect the ids of all the united slices together with the
+		// new batch and merge them into the first slice in one pass
+		// instead of paying for a separate merge per united slice.
+		auto united = std::vector<MsgId>();
+		auto unitedRange = noSkipRange;
+		auto unitedCount = std::distance(
+			std::begin(messages),
+			std::end(messages));
 		for (auto it = firstToErase; it != uniteTill; ++it) {
-			_slices.modify(uniteFrom, [&](Slice &slice) {
-				slice.merge(it->messages, it->range);
-			});
+			unitedCount += it->messages.size();
+		}
+		united.reserve(unitedCount);
+		united.insert(
+			united.end(),
+			std::begin(messages),
+			std::end(messages));
+		for (auto it = firstToErase; it != uniteTill; ++it) {
+			united.insert(
+				united.end(),
+				it->messages.begin(),
+				it->messages.end());
+			unitedRange = {
+				qMin(unitedRange.from, it->range.from),
+				qMax(unitedRange.till, it->range.till)
+			};
 		}
+		_slices.modify(uniteFrom, [&](Slice &slice) {
+			slice.merge(united, unitedRange);
+		});
 		_slices.erase(firstToErase, uniteTill);
 		uniteFrom = _slices.begin() + uniteFromIndex;
+	} else {
+		_slices.modify(uniteFrom, [&](Slice &slice) {
+			slice.merge(messages, noSkipRange);
+		});
 	}
 	update.messages = &uniteFrom->messages;
 	update.range = uniteFrom->range;
@@ -162,6 +187,10 @@ void SparseIdsList::removeAll() {
 	_count = 0;
 }
 
+void SparseIdsList::setCount(int count) {
+	_count = count;
+}
+
 void SparseIdsList::invalidateBottom() {
 	if (!_slices.empty()) {
 		const auto &last = _slices.back();
@@ -49,6 +49,13 @@ public:
 	void removeOne(MsgId messageId);
 	void removeAll();
 	void invalidateBottom();
+	std::optional<int> count() const {
+		return _count;
+	}
+
+	// Primes the list with a count restored from the local storage,
+	// doesn't notify - used before any subscribers could appear.
+	void setCount(int count);
 	rpl::producer<SparseIdsListResult> query(SparseIdsListQuery &&query) const;
 	rpl::producer<SparseIdsSliceUpdate> sliceUpdated() const;
 
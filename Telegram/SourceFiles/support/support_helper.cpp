@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "support/support_helper.h"
 
 #include "dialogs/dialogs_key.h"
+#include "dialogs/dialogs_indexed_list.h"
 #include "data/data_drafts.h"
 #include "data/data_user.h"
 #include "data/data_session.h"
@@ -24,6 +25,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "storage/storage_media_prepare.h"
 #include "storage/localimageloader.h"
 #include "core/sandbox.h"
+#include "mainwidget.h"
 #include "auth_session.h"
 #include "observer_peer.h"
 #include "apiwrap.h"
@@ -36,6 +38,12 @@ constexpr auto kOccupyFor = TimeId(60);
 constexpr auto kReoccupyEach = 30 * TimeMs(1000);
 constexpr auto kMaxSupportInfoLength = MaxMessageSize * 4;
 
+// Support agents cycle between the unread chats, preload the
+// nearest ones in the list so the switch doesn't wait for network.
+constexpr auto kPrefetchChatsCount = 3;
+constexpr auto kPrefetchChatsDelay = TimeMs(1000);
+constexpr auto kPrefetchMessagesCount = 50; // like the first history load
+
 class EditInfoBox : public BoxContent {
 public:
 	EditInfoBox(
@@ -273,7 +281,8 @@ Helper::Helper(not_null<AuthSession*> session)
 : _session(session)
 , _templates(_session)
 , _reoccupyTimer([=] { reoccupy(); })
-, _checkOccupiedTimer([=] { checkOccupiedChats(); }) {
+, _checkOccupiedTimer([=] { checkOccupiedChats(); })
+, _prefetchTimer([=] { prefetchQueueChats(); }) {
 	request(MTPhelp_GetSupportName(
 	)).done([=](const MTPhelp_SupportName &result) {
 		result.match([&](const MTPDhelp_supportName &data) {
@@ -301,9 +310,123 @@ void Helper::registerWindow(not_null<Window::Controller*> controller) {
 	}) | rpl::distinct_until_changed(
 	) | rpl::start_with_next([=](History *history) {
 		updateOccupiedHistory(controller, history);
+		scheduleQueuePrefetch(history);
 	}, controller->lifetime());
 }
 
+void Helper::scheduleQueuePrefetch(History *history) {
+	_prefetchFrom = history;
+	if (history) {
+		// Let the switch itself finish its work first.
+		_prefetchTimer.callOnce(kPrefetchChatsDelay);
+	} else {
+		_prefetchTimer.cancel();
+	}
+}
+
+void Helper::prefetchQueueChats() {
+	const auto main = App::main();
+	const auto list = main ? main->dialogsList() : nullptr;
+	if (!list || !_prefetchFrom) {
+		return;
+	}
+	const auto row = list->getRow(Dialogs::Key(_prefetchFrom));
+	if (!row) {
+		return;
+	}
+	const auto from = list->cfind(row);
+	const auto prefetchIfNext = [&](not_null<History*> history) {
+		if (history->chatListUnreadCount()
+			|| history->chatListUnreadMark()) {
+			prefetchChat(history);
+			return true;
+		}
+		return false;
+	};
+	auto count = kPrefetchChatsCount;
+	for (auto i = from + 1; count && i != list->cend(); ++i) {
+		if (const auto history = (*i)->key().history()) {
+			if (TrackHistoryOccupation(history)
+				&& prefetchIfNext(history)) {
+				--count;
+			}
+		}
+	}
+	count = kPrefetchChatsCount;
+	for (auto i = from; count && i != list->cbegin();) {
+		--i;
+		if (const auto history = (*i)->key().history()) {
+			if (TrackHistoryOccupation(history)
+				&& prefetchIfNext(history)) {
+				--count;
+			}
+		}
+	}
+}
+
+void Helper::prefetchChat(not_null<History*> history) {
+	history->peer->loadUserpic();
+	if (history->isReadyFor(ShowAtUnreadMsgId)
+		|| _prefetchRequests.contains(history)) {
+		return;
+	}
+	const auto around = history->loadAroundId();
+	const auto requestId = request(MTPmessages_GetHistory(
+		history->peer->input,
+		MTP_int(around), // offset_id
+		MTP_int(0), // offset_date
+		MTP_int(around ? (-kPrefetchMessagesCount / 2) : 0), // add_offset
+		MTP_int(kPrefetchMessagesCount), // limit
+		MTP_int(0), // max_id
+		MTP_int(0), // min_id
+		MTP_int(0) // hash
+	)).done([=](const MTPmessages_Messages &result) {
+		_prefetchRequests.remove(history);
+		applyPrefetched(history, around, result);
+	}).fail([=](const RPCError &error) {
+		_prefetchRequests.remove(history);
+	}).send();
+	_prefetchRequests.emplace(history, requestId);
+}
+
+void Helper::applyPrefetched(
+		not_null<History*> history,
+		MsgId wasAroundId,
+		const MTPmessages_Messages &result) {
+	// If the chat was opened or got messages meanwhile the widget
+	// owns the loading, don't touch the history state from here.
+	if (history == _occupiedHistory
+		|| !history->isEmpty()
+		|| history->isReadyFor(ShowAtUnreadMsgId)
+		|| history->loadAroundId() != wasAroundId) {
+		return;
+	}
+	const auto slice = [&]() -> const QVector<MTPMessage>* {
+		switch (result.type()) {
+		case mtpc_messages_messages: {
+			const auto &data = result.c_messages_messages();
+			_session->data().processUsers(data.vusers);
+			_session->data().processChats(data.vchats);
+			return &data.vmessages.v;
+		} break;
+		case mtpc_messages_messagesSlice: {
+			const auto &data = result.c_messages_messagesSlice();
+			_session->data().processUsers(data.vusers);
+			_session->data().processChats(data.vchats);
+			return &data.vmessages.v;
+		} break;
+		}
+		return nullptr;
+	}();
+	if (!slice) {
+		return;
+	}
+	history->getReadyFor(wasAroundId
+		? ShowAtUnreadMsgId
+		: ShowAtTheEndMsgId);
+	history->addOlderSlice(*slice);
+}
+
 void Helper::cloudDraftChanged(not_null<History*> history) {
 	chatOccupiedUpdated(history);
 	if (history != _occupiedHistory) {
@@ -68,6 +68,13 @@ private:
 	void updateOccupiedHistory(
 		not_null<Window::Controller*> controller,
 		History *history);
+	void scheduleQueuePrefetch(History *history);
+	void prefetchQueueChats();
+	void prefetchChat(not_null<History*> history);
+	void applyPrefetched(
+		not_null<History*> history,
+		MsgId wasAroundId,
+		const MTPmessages_Messages &result);
 	void setSupportName(const QString &name);
 	void occupyIfNotYet();
 	void occupyInDraft();
@@ -92,6 +99,10 @@ private:
 	base::Timer _checkOccupiedTimer;
 	base::flat_map<not_null<History*>, TimeId> _occupiedChats;
 
+	History *_prefetchFrom = nullptr;
+	base::Timer _prefetchTimer;
+	base::flat_map<not_null<History*>, mtpRequestId> _prefetchRequests;
+
 	base::flat_map<not_null<UserData*>, UserInfo> _userInformation;
 	base::flat_set<not_null<UserData*>> _userInfoEditPending;
 	base::flat_map<not_null<UserData*>, SavingInfo> _userInfoSaving;
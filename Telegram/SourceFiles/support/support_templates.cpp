@@ -73,11 +73,11 @@ void ReadByLine(
 	auto state = State::None;
 	auto hadKeys = false;
 	auto hadValue = false;
+	static const auto expression = QRegularExpression(
+		qsl("^\\{([A-Z_]+)\\}$"));
 	for (const auto &utf : blob.split('\n')) {
 		const auto line = QString::fromUtf8(utf).trimmed();
-		const auto match = QRegularExpression(
-			qsl("^\\{([A-Z_]+)\\}$")
-		).match(line);
+		const auto match = expression.match(line);
 		if (match.hasMatch()) {
 			const auto token = match.captured(1);
 			if (state == State::Value) {
@@ -284,18 +284,19 @@ TemplatesIndex ComputeIndex(const TemplatesData &data) {
 			uniqueFull[id].emplace(std::make_pair(word, weight));
 		}
 	};
+	auto result = TemplatesIndex();
 	for (const auto &[path, file] : data.files) {
 		for (const auto &[normalized, question] : file.questions) {
 			const auto id = std::make_pair(path, normalized);
 			for (const auto &key : question.normalizedKeys) {
 				pushString(id, key, kWeightStep * kWeightStep);
+				result.keys.emplace(key, id);
 			}
 			pushString(id, question.question, kWeightStep);
 			pushString(id, question.value, 1);
 		}
 	}
 
-	auto result = TemplatesIndex();
 	for (const auto &[ch, unique] : uniqueFirst) {
 		result.first.emplace(ch, unique | ranges::to_vector);
 	}
@@ -320,6 +321,17 @@ void ReplaceFileIndex(
 		result.full.emplace(id, std::move(list));
 	}
 
+	for (auto i = begin(result.keys); i != end(result.keys);) {
+		if (i->second.first == path) {
+			i = result.keys.erase(i);
+		} else {
+			++i;
+		}
+	}
+	for (auto &[key, id] : source.keys) {
+		result.keys.emplace(key, id);
+	}
+
 	using Id = TemplatesIndex::Id;
 	for (auto &[ch, list] : result.first) {
 		auto i = ranges::lower_bound(
@@ -626,16 +638,14 @@ auto Templates::matchExact(QString query) const
 
 	query = NormalizeKey(query);
 
-	for (const auto &[path, file] : _data.files) {
-		for (const auto &[normalized, question] : file.questions) {
-			for (const auto &key : question.normalizedKeys) {
-				if (key == query) {
-					return QuestionByKey{ question, key };
-				}
-			}
-		}
+	const auto i = _index.keys.find(query);
+	if (i == end(_index.keys)) {
+		return {};
 	}
-	return {};
+	const auto &id = i->second;
+	return QuestionByKey{
+		_data.files.at(id.first).questions.at(id.second),
+		i->first };
 }
 
 auto Templates::matchFromEnd(QString query) const
@@ -645,22 +655,16 @@ auto Templates::matchFromEnd(QString query) const
 	}
 
 	const auto size = query.size();
-	auto queries = std::vector<QString>();
-	queries.reserve(size);
-	for (auto i = 0; i != size; ++i) {
-		queries.push_back(NormalizeKey(query.mid(size - i - 1)));
-	}
-
 	auto result = std::optional<QuestionByKey>();
-	for (const auto &[path, file] : _data.files) {
-		for (const auto &[normalized, question] : file.questions) {
-			for (const auto &key : question.normalizedKeys) {
-				if (key.size() <= queries.size()
-					&& queries[key.size() - 1] == key
-					&& (!result || result->key.size() <= key.size())) {
-					result = QuestionByKey{ question, key };
-				}
-			}
+	for (auto i = 0; i != size; ++i) {
+		const auto j = _index.keys.find(NormalizeKey(query.mid(size - i - 1)));
+		if (j != end(_index.keys)
+			&& j->first.size() == i + 1
+			&& (!result || result->key.size() <= j->first.size())) {
+			const auto &id = j->second;
+			result = QuestionByKey{
+				_data.files.at(id.first).questions.at(id.second),
+				j->first };
 		}
 	}
 	return result;
@@ -157,7 +157,34 @@ void BasicAnimation::stop() {
 
 AnimationManager::AnimationManager() : _timer(this) {
 	_timer.setSingleShot(false);
+
+	// A coarse timer with a single digit interval fires irregularly
+	// (on Windows it is rounded up to the ~16 ms system granularity),
+	// which makes the animations judder on high refresh rate panels.
+	_timer.setTimerType(Qt::PreciseTimer);
 	connect(&_timer, &QTimer::timeout, this, &AnimationManager::step);
+
+	refreshTimerDelta();
+	connect(
+		qApp,
+		&QGuiApplication::primaryScreenChanged,
+		this,
+		[=] { refreshTimerDelta(); });
+}
+
+void AnimationManager::refreshTimerDelta() {
+	// A raster QWidget application gets no direct vsync signal, the
+	// closest tick source is a precise timer at the primary screen
+	// refresh rate - no wasted ticks on 60Hz panels and no skipped
+	// frames on 144Hz ones.
+	const auto screen = QApplication::primaryScreen();
+	const auto rate = screen ? screen->refreshRate() : 0.;
+	_timerDelta = (rate >= 30.)
+		? snap(qRound(1000. / rate), int(AnimationTimerDelta), 20)
+		: int(AnimationTimerDelta);
+	if (_timer.isActive()) {
+		_timer.start(_timerDelta);
+	}
 }
 
 void AnimationManager::start(BasicAnimation *obj) {
@@ -168,7 +195,7 @@ void AnimationManager::start(BasicAnimation *obj) {
 		}
 	} else {
 		if (_objects.empty()) {
-			_timer.start(AnimationTimerDelta);
+			_timer.start(_timerDelta);
 		}
 		_objects.insert(obj);
 	}
@@ -716,9 +716,11 @@ private:
 		Media::Clip::Reader *reader,
 		qint32 threadIndex,
 		qint32 notification);
+	void refreshTimerDelta();
 
 	base::flat_set<BasicAnimation*> _objects, _starting, _stopping;
 	QTimer _timer;
+	int _timerDelta = AnimationTimerDelta;
 	bool _iterating = false;
 
 };
@@ -18,18 +18,24 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace {
 
 	typedef QList<const CountryInfo *> CountriesFiltered;
-	typedef QVector<int> CountriesIds;
-	typedef QHash<QChar, CountriesIds> CountriesByLetter;
 	typedef QVector<QString> CountryNames;
 	typedef QVector<CountryNames> CountriesNames;
 
+	// One word of some country name, prepared for prefix search.
+	struct CountryWord {
+		QString word;
+		int index = 0; // Index in the countries[] array.
+	};
+	typedef QVector<CountryWord> CountriesWords;
+
 	CountriesByCode _countriesByCode;
 	CountriesByISO2 _countriesByISO2;
 	CountriesFiltered countriesFiltered, countriesAll, *countriesNow = &countriesAll;
-	CountriesByLetter countriesByLetter;
 	CountriesNames countriesNames;
+	CountriesWords countriesWords;
 
 	QString lastValidISO;
+	int lastValidIndex = -1;
 	int countriesCount = sizeof(countries) / sizeof(countries[0]);
 
 	void initCountries() {
@@ -50,6 +56,28 @@ namespace {
 		countriesAll.reserve(countriesCount);
 		countriesFiltered.reserve(countriesCount);
 		countriesNames.resize(countriesCount);
+
+		// The sorted index over all the words of all the names is
+		// built once, so the per-keystroke filtering is a binary
+		// search over it and not a scan of the whole list.
+		for (int i = 0; i < countriesCount; ++i) {
+			auto namesList = QString::fromUtf8(countries[i].name).toLower().split(QRegularExpression("[\\s\\-]"), QString::SkipEmptyParts);
+			auto &names = countriesNames[i];
+			names.reserve(namesList.size());
+			for (const auto &namePart : namesList) {
+				auto name = namePart.trimmed();
+				if (!name.length()) continue;
+
+				names.push_back(name);
+				countriesWords.push_back({ name, i });
+			}
+		}
+		std::sort(
+			countriesWords.begin(),
+			countriesWords.end(),
+			[](const CountryWord &a, const CountryWord &b) {
+				return a.word < b.word;
+			});
 	}
 
 } // namespace
@@ -303,8 +331,8 @@ CountrySelectBox::Inner::Inner(QWidget *parent, Type type)
 	bool seenLastValid = false;
 	int already = countriesAll.size();
 
-	countriesByLetter.clear();
 	const CountryInfo *lastValid = (l == _countriesByISO2.cend()) ? 0 : (*l);
+	lastValidIndex = lastValid ? int(lastValid - countries) : -1;
 	for (int i = 0; i < countriesCount; ++i) {
 		const CountryInfo *ins = lastValid ? (i ? (countries + i - (seenLastValid ? 0 : 1)) : lastValid) : (countries + i);
 		if (lastValid && i && ins == lastValid) {
@@ -316,24 +344,6 @@ CountrySelectBox::Inner::Inner(QWidget *parent, Type type)
 		} else {
 			countriesAll.push_back(ins);
 		}
-
-		auto namesList = QString::fromUtf8(ins->name).toLower().split(QRegularExpression("[\\s\\-]"), QString::SkipEmptyParts);
-		auto &names = countriesNames[i];
-		int l = namesList.size();
-		names.resize(0);
-		names.reserve(l);
-		for (int j = 0, l = namesList.size(); j < l; ++j) {
-			auto name = namesList[j].trimmed();
-			if (!name.length()) continue;
-
-			auto ch = name[0];
-			auto &v = countriesByLetter[ch];
-			if (v.isEmpty() || v.back() != i) {
-				v.push_back(i);
-			}
-
-			names.push_back(name);
-		}
 	}
 
 	_filter = qsl("a");
@@ -454,17 +464,33 @@ void CountrySelectBox::Inner::updateFilter(QString filter) {
 		if (_filter.isEmpty()) {
 			countriesNow = &countriesAll;
 		} else {
-			QChar first = _filter[0].toLower();
-			CountriesIds &ids(countriesByLetter[first]);
-
 			QStringList::const_iterator fb = words.cbegin(), fe = words.cend(), fi;
 
+			// The first word finds its candidates by a prefix range
+			// in the sorted word index, the other words are checked
+			// against the names of those candidates only.
+			const QString &first = words.front();
+			auto i = std::lower_bound(
+				countriesWords.cbegin(),
+				countriesWords.cend(),
+				first,
+				[](const CountryWord &word, const QString &prefix) {
+					return word.word < prefix;
+				});
+			auto matched = QVector<int>();
+			for (; i != countriesWords.cend() && i->word.startsWith(first); ++i) {
+				matched.push_back(i->index);
+			}
+			std::sort(matched.begin(), matched.end());
+			matched.erase(
+				std::unique(matched.begin(), matched.end()),
+				matched.end());
+
 			countriesFiltered.clear();
-			for (CountriesIds::const_iterator i = ids.cbegin(), e = ids.cend(); i != e; ++i) {
-				int index = *i;
+			for (const auto index : matched) {
 				CountryNames &names(countriesNames[index]);
 				CountryNames::const_iterator nb = names.cbegin(), ne = names.cend(), ni;
-				for (fi = fb; fi != fe; ++fi) {
+				for (fi = fb + 1; fi != fe; ++fi) {
 					QString filterName(*fi);
 					for (ni = nb; ni != ne; ++ni) {
 						if (ni->startsWith(*fi)) {
@@ -476,7 +502,13 @@ void CountrySelectBox::Inner::updateFilter(QString filter) {
 					}
 				}
 				if (fi == fe) {
-					countriesFiltered.push_back(countriesAll[index]);
+					// The last chosen country goes first, like in
+					// the full list.
+					if (index == lastValidIndex) {
+						countriesFiltered.push_front(countries + index);
+					} else {
+						countriesFiltered.push_back(countries + index);
+					}
 				}
 			}
 			countriesNow = &countriesFiltered;
@@ -7,7 +7,26 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "ui/effects/panel_animation.h"
 
+#include "window/themes/window_theme.h"
+
 namespace Ui {
+namespace {
+
+// The shadow parts are the same for all popups sharing a style, so
+// render each part once and reuse it across menus, dropdowns and boxes.
+// QImage is copy-on-write and the animations only read the bits.
+std::map<const style::icon*, QImage> &ShadowPartsCache() {
+	static auto result = std::map<const style::icon*, QImage>();
+	static auto subscription = Window::Theme::Background()->add_subscription([](
+			const Window::Theme::BackgroundUpdate &update) {
+		if (update.paletteChanged()) {
+			result.clear();
+		}
+	});
+	return result;
+}
+
+} // namespace
 
 void RoundShadowAnimation::start(int frameWidth, int frameHeight, float64 devicePixelRatio) {
 	Assert(!started());
@@ -78,6 +97,11 @@ void RoundShadowAnimation::setCornerMask(Corner &corner, const QImage &image) {
 QImage RoundShadowAnimation::cloneImage(const style::icon &source) {
 	if (source.empty()) return QImage();
 
+	auto &cache = ShadowPartsCache();
+	const auto i = cache.find(&source);
+	if (i != cache.end()) {
+		return i->second;
+	}
 	auto result = QImage(source.size() * cIntRetinaFactor(), QImage::Format_ARGB32_Premultiplied);
 	result.setDevicePixelRatio(cRetinaFactor());
 	result.fill(Qt::transparent);
@@ -85,6 +109,7 @@ QImage RoundShadowAnimation::cloneImage(const style::icon &source) {
 		Painter p(&result);
 		source.paint(p, 0, 0, source.width());
 	}
+	cache.emplace(&source, result);
 	return result;
 }
 
@@ -10,6 +10,156 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "styles/style_widgets.h"
 
 namespace Ui {
+namespace {
+
+// All the radials are stepped by the single AnimationManager ticker,
+// so inside one animation frame spinners in identical states (say, a
+// media grid full of queued downloads) paint exactly the same arc.
+// Rasterizing a thick antialiased round-capped arc is the expensive
+// part, so it is done once per distinct state per frame and the rest
+// of the spinners blit the ready sprite. The cache lives for a single
+// frame, arc positions are quantized to a degree to make the states
+// of spinners painted a millisecond apart match. Only used from the
+// main thread.
+constexpr auto kArcQuantize = 16; // FullArcLength / 360, one degree.
+constexpr auto kFrameDuration = TimeMs(7); // Minimal ticker interval.
+
+// Sprite loops quantize coarser so that the whole loop fits in a
+// bounded set of frames, 6 degrees still looks smooth for a spinner
+// rotating a full turn per second. The count limit only guards against
+// a pathological style, the standard loop stays well below it.
+constexpr auto kLoopQuantize = 96; // FullArcLength / 60, six degrees.
+constexpr auto kLoopFramesLimit = 360;
+
+struct ArcSprites {
+	TimeMs frameTime = 0;
+	std::map<std::vector<int>, QPixmap> frames;
+};
+
+int QuantizeArc(int value, int quantize = kArcQuantize) {
+	const auto half = (value < 0) ? -(quantize / 2) : (quantize / 2);
+	return quantize * ((value + half) / quantize);
+}
+
+int ArcFrameMargin(int thickness) {
+	// The pen is centered on the arc, so it sticks out of the bounding
+	// rectangle by half of the thickness in each direction.
+	return (thickness + 1) / 2 + 1;
+}
+
+QPixmap CreateArcFrame(
+		QSize size,
+		int thickness,
+		QColor color,
+		int arcFrom,
+		int arcLength) {
+	const auto margin = ArcFrameMargin(thickness);
+	const auto full = QSize(
+		size.width() + 2 * margin,
+		size.height() + 2 * margin);
+	auto image = QImage(
+		full * cIntRetinaFactor(),
+		QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(cRetinaFactor());
+	image.fill(Qt::transparent);
+	{
+		Painter p(&image);
+		PainterHighQualityEnabler hq(p);
+
+		auto pen = QPen(color);
+		pen.setWidth(thickness);
+		pen.setCapStyle(Qt::RoundCap);
+		p.setPen(pen);
+		p.drawArc(
+			QRect(QPoint(margin, margin), size),
+			arcFrom,
+			arcLength);
+	}
+	return App::pixmapFromImageInPlace(std::move(image));
+}
+
+const QPixmap &ArcSprite(
+		QSize size,
+		int thickness,
+		QColor color,
+		int arcFrom,
+		int arcLength) {
+	static auto sprites = ArcSprites();
+
+	const auto now = getms();
+	if (now - sprites.frameTime >= kFrameDuration) {
+		sprites.frames.clear();
+		sprites.frameTime = now;
+	}
+	const auto key = std::vector<int>{
+		size.width(),
+		size.height(),
+		thickness,
+		int(color.rgba()),
+		arcFrom,
+		arcLength,
+	};
+	const auto i = sprites.frames.find(key);
+	if (i != end(sprites.frames)) {
+		return i->second;
+	}
+
+	return sprites.frames.emplace(
+		key,
+		CreateArcFrame(size, thickness, color, arcFrom, arcLength)
+	).first->second;
+}
+
+void DrawArcSprite(
+		Painter &p,
+		const QRect &inner,
+		int thickness,
+		style::color color,
+		const RadialState &state) {
+	const auto &sprite = ArcSprite(
+		inner.size(),
+		thickness,
+		color->c,
+		QuantizeArc(state.arcFrom),
+		QuantizeArc(state.arcLength));
+	const auto margin = ArcFrameMargin(thickness);
+	p.drawPixmap(inner.x() - margin, inner.y() - margin, sprite);
+}
+
+} // namespace
+
+void RadialSpriteLoop::draw(
+		Painter &p,
+		const QRect &inner,
+		int thickness,
+		style::color color,
+		const RadialState &state) {
+	if (_size != inner.size()
+		|| _thickness != thickness
+		|| _color != color->c.rgba()
+		|| _frames.size() >= kLoopFramesLimit) {
+		_frames.clear();
+		_size = inner.size();
+		_thickness = thickness;
+		_color = color->c.rgba();
+	}
+	const auto key = std::make_pair(
+		QuantizeArc(state.arcFrom, kLoopQuantize),
+		QuantizeArc(state.arcLength, kLoopQuantize));
+	auto i = _frames.find(key);
+	if (i == end(_frames)) {
+		i = _frames.emplace(
+			key,
+			CreateArcFrame(
+				inner.size(),
+				thickness,
+				color->c,
+				key.first,
+				key.second)).first;
+	}
+	const auto margin = ArcFrameMargin(thickness);
+	p.drawPixmap(inner.x() - margin, inner.y() - margin, i->second);
+}
 
 RadialAnimation::RadialAnimation(AnimationCallbacks &&callbacks)
 : a_arcStart(0, FullArcLength)
@@ -57,7 +207,10 @@ bool RadialAnimation::update(float64 prg, bool finished, TimeMs ms) {
 		a_arcEnd.update(r, anim::linear);
 		_opacity *= 1 - r;
 	}
-	auto fromstart = fulldt / st::radialPeriod;
+	// The rotation phase is computed from the absolute time instead of
+	// the animation start, so that all the spinners rotate in sync and
+	// ones with an equal progress share a single rendered arc sprite.
+	auto fromstart = ms / float64(st::radialPeriod);
 	a_arcStart.update(fromstart - std::floor(fromstart), anim::linear);
 	return result;
 }
@@ -82,18 +235,8 @@ void RadialAnimation::draw(
 	auto o = p.opacity();
 	p.setOpacity(o * state.shown);
 
-	auto pen = color->p;
-	auto was = p.pen();
-	pen.setWidth(thickness);
-	pen.setCapStyle(Qt::RoundCap);
-	p.setPen(pen);
-
-	{
-		PainterHighQualityEnabler hq(p);
-		p.drawArc(inner, state.arcFrom, state.arcLength);
-	}
+	DrawArcSprite(p, inner, thickness, color, state);
 
-	p.setPen(was);
 	p.setOpacity(o);
 }
 
@@ -172,26 +315,44 @@ void InfiniteRadialAnimation::draw(
 		size.width(),
 		size.height(),
 		outerWidth);
-	const auto was = p.pen();
-	const auto brush = p.brush();
 	if (anim::Disabled()) {
+		const auto was = p.pen();
+		const auto brush = p.brush();
 		anim::DrawStaticLoading(p, rect, _st.thickness, _st.color);
+		p.setPen(was);
+		p.setBrush(brush);
 	} else {
-		auto pen = _st.color->p;
-		pen.setWidth(_st.thickness);
-		pen.setCapStyle(Qt::RoundCap);
-		p.setPen(pen);
+		DrawArcSprite(p, rect, _st.thickness, _st.color, state);
+	}
+	p.setOpacity(o);
+}
 
-		{
-			PainterHighQualityEnabler hq(p);
-			p.drawArc(
-				rect,
-				state.arcFrom,
-				state.arcLength);
-		}
+void InfiniteRadialAnimation::draw(
+		Painter &p,
+		QPoint position,
+		QSize size,
+		int outerWidth,
+		RadialSpriteLoop &frames) {
+	const auto state = computeState();
+
+	auto o = p.opacity();
+	p.setOpacity(o * state.shown);
+
+	const auto rect = rtlrect(
+		position.x(),
+		position.y(),
+		size.width(),
+		size.height(),
+		outerWidth);
+	if (anim::Disabled()) {
+		const auto was = p.pen();
+		const auto brush = p.brush();
+		anim::DrawStaticLoading(p, rect, _st.thickness, _st.color);
+		p.setPen(was);
+		p.setBrush(brush);
+	} else {
+		frames.draw(p, rect, _st.thickness, _st.color, state);
 	}
-	p.setPen(was);
-	p.setBrush(brush);
 	p.setOpacity(o);
 }
 
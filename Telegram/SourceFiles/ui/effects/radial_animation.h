@@ -19,6 +19,28 @@ struct RadialState {
 	int arcLength = FullArcLength;
 };
 
+// A persistent loop of prerendered spinner frames. The infinite radial
+// state is periodic, so a spinner that stays on screen for a long time
+// (like the connecting status in the corner) walks the same closed loop
+// of states over and over — each distinct frame is rasterized once and
+// all the following repaints only blit the ready pixmap.
+class RadialSpriteLoop {
+public:
+	void draw(
+		Painter &p,
+		const QRect &inner,
+		int thickness,
+		style::color color,
+		const RadialState &state);
+
+private:
+	QSize _size;
+	int _thickness = 0;
+	QRgb _color = 0;
+	std::map<std::pair<int, int>, QPixmap> _frames;
+
+};
+
 class RadialAnimation {
 public:
 	RadialAnimation(AnimationCallbacks &&callbacks);
@@ -86,6 +108,12 @@ public:
 		QPoint position,
 		QSize size,
 		int outerWidth);
+	void draw(
+		Painter &p,
+		QPoint position,
+		QSize size,
+		int outerWidth,
+		RadialSpriteLoop &frames);
 
 	RadialState computeState();
 
@@ -8,6 +8,35 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/effects/ripple_animation.h"
 
 namespace Ui {
+namespace {
+
+// Rasterizing an antialiased ellipse through QPainter every frame for
+// every ripple is what drops frames when several ripples expand at
+// once. A single antialiased disc is prerendered once and shared by
+// all ripples, the expanding frames are produced from it by cheap
+// scaled blits. Only used from the main thread.
+constexpr auto kPrerenderedDiscSize = 512;
+
+const QImage &PrerenderedDisc() {
+	static const auto result = [] {
+		auto image = QImage(
+			kPrerenderedDiscSize,
+			kPrerenderedDiscSize,
+			QImage::Format_ARGB32_Premultiplied);
+		image.fill(Qt::transparent);
+		{
+			Painter p(&image);
+			PainterHighQualityEnabler hq(p);
+			p.setPen(Qt::NoPen);
+			p.setBrush(QColor(255, 255, 255));
+			p.drawEllipse(0, 0, kPrerenderedDiscSize, kPrerenderedDiscSize);
+		}
+		return image;
+	}();
+	return result;
+}
+
+} // namespace
 
 class RippleAnimation::Ripple {
 public:
@@ -84,16 +113,21 @@ void RippleAnimation::Ripple::paint(QPainter &p, const QPixmap &mask, TimeMs ms,
 		_frame.fill(Qt::transparent);
 		{
 			Painter p(&_frame);
-			p.setPen(Qt::NoPen);
-			if (colorOverride) {
-				p.setBrush(*colorOverride);
-			} else {
-				p.setBrush(_st.color);
-			}
-			{
-				PainterHighQualityEnabler hq(p);
-				p.drawEllipse(_origin, radius, radius);
-			}
+			p.setRenderHint(QPainter::SmoothPixmapTransform);
+			p.drawImage(
+				QRect(
+					_origin.x() - radius,
+					_origin.y() - radius,
+					2 * radius,
+					2 * radius),
+				PrerenderedDisc());
+			p.setCompositionMode(QPainter::CompositionMode_SourceIn);
+			p.fillRect(
+				0,
+				0,
+				_frame.width() / cIntRetinaFactor(),
+				_frame.height() / cIntRetinaFactor(),
+				colorOverride ? QBrush(*colorOverride) : QBrush(_st.color));
 			p.setCompositionMode(QPainter::CompositionMode_DestinationIn);
 			p.drawPixmap(0, 0, mask);
 		}
@@ -15,10 +15,28 @@ namespace {
 constexpr int kTypingDotsCount = 3;
 constexpr int kRecordArcsCount = 4;
 constexpr int kUploadArrowsCount = 3;
+constexpr int kFrameDuration = 25;
 
 using ImplementationsMap = QMap<SendAction::Type, const SendActionAnimation::Impl::MetaData*>;
 NeverFreedPointer<ImplementationsMap> Implementations;
 
+// All instances animate on one shared clock (absolute time modulo the
+// period), so identical frames repeat across all visible indicators and
+// can be prerendered once per (animation type, palette entry) and then
+// just blitted for each of the N simultaneously typing peers.
+struct CachedFrameStrip {
+	QRgb color = 0;
+	std::vector<QImage> frames;
+};
+using FrameStripKey = QPair<const void*, int>;
+NeverFreedPointer<QMap<FrameStripKey, CachedFrameStrip>> FrameStrips;
+
+// Covers the drawing of all three implementations relative to the
+// (x, y) passed to paint, with a margin for antialiased strokes.
+QRect FrameRect(int x, int y, int width) {
+	return QRect(x - 2, y - 12, width + 4, 18);
+}
+
 class TypingAnimation : public SendActionAnimation::Impl {
 public:
 	TypingAnimation() : Impl(st::historySendActionTypingDuration) {
@@ -197,13 +215,53 @@ void SendActionAnimation::Impl::paint(
 		int y,
 		int outerWidth,
 		TimeMs ms) {
-	paintFrame(
-		p,
-		color,
-		x,
-		y,
-		outerWidth,
-		anim::Disabled() ? 0 : (qMax(ms - _started, 0LL) % _period));
+	const auto frameMs = anim::Disabled() ? 0 : int(ms % _period);
+	if (!paintCachedFrame(p, color, x, y, outerWidth, frameMs)) {
+		paintFrame(p, color, x, y, outerWidth, frameMs);
+	}
+}
+
+bool SendActionAnimation::Impl::paintCachedFrame(
+		Painter &p,
+		style::color color,
+		int x,
+		int y,
+		int outerWidth,
+		int frameMs) {
+	const auto paletteIndex = style::main_palette::indexOfColor(color);
+	if (paletteIndex < 0) {
+		return false;
+	}
+	FrameStrips.createIfNull();
+	auto &strip = (*FrameStrips)[FrameStripKey(metaData(), paletteIndex)];
+	const auto framesCount = (_period + kFrameDuration - 1) / kFrameDuration;
+	if (strip.color != color->c.rgba() || strip.frames.empty()) {
+		strip.color = color->c.rgba();
+		strip.frames.clear();
+		strip.frames.resize(framesCount);
+	}
+	const auto index = std::min(frameMs / kFrameDuration, framesCount - 1);
+	auto &frame = strip.frames[index];
+	const auto rect = FrameRect(x, y, width());
+	if (frame.isNull()) {
+		frame = QImage(
+			rect.size() * cIntRetinaFactor(),
+			QImage::Format_ARGB32_Premultiplied);
+		frame.setDevicePixelRatio(cRetinaFactor());
+		frame.fill(Qt::transparent);
+		{
+			Painter q(&frame);
+			paintFrame(
+				q,
+				color,
+				x - rect.x(),
+				y - rect.y(),
+				rect.width(),
+				index * kFrameDuration);
+		}
+	}
+	p.drawImage(rect.topLeft(), frame);
+	return true;
 }
 
 
@@ -33,7 +33,7 @@ public:
 	public:
 		using Type = SendAction::Type;
 
-		Impl(int period) : _period(period), _started(getms()) {
+		Impl(int period) : _period(period) {
 		}
 
 		struct MetaData {
@@ -57,8 +57,15 @@ public:
 	private:
 		virtual void paintFrame(Painter &p, style::color color, int x, int y, int outerWidth, int frameMs) = 0;
 
+		bool paintCachedFrame(
+			Painter &p,
+			style::color color,
+			int x,
+			int y,
+			int outerWidth,
+			int frameMs);
+
 		int _period = 1;
-		TimeMs _started = 0;
 
 	};
 
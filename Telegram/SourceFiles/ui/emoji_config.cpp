@@ -12,6 +12,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 
 #include "chat_helpers/emoji_suggestions_helper.h"
 #include "base/bytes.h"
+#include "base/flat_map.h"
 #include "base/openssl_help.h"
 #include "base/parse_helper.h"
 #include "auth_session.h"
@@ -55,6 +56,12 @@ private:
 	int _id = 0;
 	int _size = 0;
 	std::vector<QPixmap> _sprites;
+
+	// Cut-out pixmaps for emoji that were already painted, so that
+	// emoji-dense texts blit from small tightly packed images instead
+	// of reading scattered rows of the large sprite sheets each time.
+	base::flat_map<int, QPixmap> _singles;
+
 	base::binary_guard _generating;
 
 };
@@ -906,10 +913,14 @@ void Instance::draw(QPainter &p, EmojiPtr emoji, int x, int y) {
 		Universal->draw(p, emoji, _size, x, y);
 		return;
 	}
-	p.drawPixmap(
-		QPoint(x, y),
-		_sprites[sprite],
-		QRect(emoji->column() * _size, emoji->row() * _size, _size, _size));
+	auto i = _singles.find(emoji->index());
+	if (i == end(_singles)) {
+		auto single = _sprites[sprite].copy(
+			QRect(emoji->column() * _size, emoji->row() * _size, _size, _size));
+		single.setDevicePixelRatio(cRetinaFactor());
+		i = _singles.emplace(emoji->index(), std::move(single)).first;
+	}
+	p.drawPixmap(QPoint(x, y), i->second);
 }
 
 void Instance::readCache() {
@@ -929,6 +940,7 @@ void Instance::checkUniversalImages() {
 		_id = Universal->id();
 		_generating = nullptr;
 		_sprites.clear();
+		_singles.clear();
 	}
 	if (!Universal->ensureLoaded() && Universal->id() != 0) {
 		ClearCurrentSetIdSync();
@@ -12,6 +12,22 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "styles/style_history.h"
 
 namespace Ui {
+namespace {
+
+// A long member list holds thousands of peers without a photo and each
+// of them rasterizes the same circle-and-initials image again on every
+// paint while the list is scrolled. The generated userpics are cached
+// by color, initials, size and shape, shared by all the lists. Only
+// used from the main thread.
+constexpr auto kCacheLimit = 128;
+
+} // namespace
+
+enum class EmptyUserpic::Shape : char {
+	Circle,
+	Rounded,
+	Square,
+};
 
 EmptyUserpic::EmptyUserpic(const style::color &color, const QString &name)
 : _color(color) {
@@ -43,27 +59,73 @@ void EmptyUserpic::paint(
 	p.drawText(QRect(x, y, size, size), _string, QTextOption(style::al_center));
 }
 
+const QPixmap &EmptyUserpic::cachedFrame(int size, Shape shape) const {
+	static auto cache = std::map<std::vector<uint64>, QPixmap>();
+
+	const auto unique = uniqueKey();
+	const auto key = std::vector<uint64>{
+		unique.first,
+		unique.second,
+		uint64(size),
+		uint64(shape),
+		uint64(st::historyPeerUserpicFg->c.rgba()),
+	};
+	const auto i = cache.find(key);
+	if (i != end(cache)) {
+		return i->second;
+	}
+
+	auto image = QImage(
+		QSize(size, size) * cIntRetinaFactor(),
+		QImage::Format_ARGB32_Premultiplied);
+	image.setDevicePixelRatio(cRetinaFactor());
+	image.fill(Qt::transparent);
+	{
+		Painter p(&image);
+		switch (shape) {
+		case Shape::Circle:
+			paint(p, 0, 0, size, size, [&p, size] {
+				p.drawEllipse(0, 0, size, size);
+			});
+			break;
+		case Shape::Rounded:
+			paint(p, 0, 0, size, size, [&p, size] {
+				p.drawRoundedRect(0, 0, size, size, st::buttonRadius, st::buttonRadius);
+			});
+			break;
+		case Shape::Square:
+			paint(p, 0, 0, size, size, [&p, size] {
+				p.fillRect(0, 0, size, size, p.brush());
+			});
+			break;
+		}
+	}
+	if (cache.size() >= kCacheLimit) {
+		cache.clear();
+	}
+	return cache.emplace(
+		key,
+		App::pixmapFromImageInPlace(std::move(image))).first->second;
+}
+
 void EmptyUserpic::paint(
 		Painter &p,
 		int x,
 		int y,
 		int outerWidth,
 		int size) const {
-	paint(p, x, y, outerWidth, size, [&p, x, y, size] {
-		p.drawEllipse(x, y, size, size);
-	});
+	x = rtl() ? (outerWidth - x - size) : x;
+	p.drawPixmap(x, y, cachedFrame(size, Shape::Circle));
 }
 
 void EmptyUserpic::paintRounded(Painter &p, int x, int y, int outerWidth, int size) const {
-	paint(p, x, y, outerWidth, size, [&p, x, y, size] {
-		p.drawRoundedRect(x, y, size, size, st::buttonRadius, st::buttonRadius);
-	});
+	x = rtl() ? (outerWidth - x - size) : x;
+	p.drawPixmap(x, y, cachedFrame(size, Shape::Rounded));
 }
 
 void EmptyUserpic::paintSquare(Painter &p, int x, int y, int outerWidth, int size) const {
-	paint(p, x, y, outerWidth, size, [&p, x, y, size] {
-		p.fillRect(x, y, size, size, p.brush());
-	});
+	x = rtl() ? (outerWidth - x - size) : x;
+	p.drawPixmap(x, y, cachedFrame(size, Shape::Square));
 }
 
 void EmptyUserpic::PaintSavedMessages(
@@ -168,14 +230,7 @@ StorageKey EmptyUserpic::uniqueKey() const {
 }
 
 QPixmap EmptyUserpic::generate(int size) {
-	auto result = QImage(QSize(size, size) * cIntRetinaFactor(), QImage::Format_ARGB32_Premultiplied);
-	result.setDevicePixelRatio(cRetinaFactor());
-	result.fill(Qt::transparent);
-	{
-		Painter p(&result);
-		paint(p, 0, 0, size, size);
-	}
-	return App::pixmapFromImageInPlace(std::move(result));
+	return cachedFrame(size, Shape::Circle);
 }
 
 void EmptyUserpic::fillString(const QString &name) {
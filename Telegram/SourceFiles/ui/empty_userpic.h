@@ -52,6 +52,8 @@ public:
 	~EmptyUserpic();
 
 private:
+	enum class Shape : char;
+
 	template <typename Callback>
 	void paint(
 		Painter &p,
@@ -61,6 +63,8 @@ private:
 		int size,
 		Callback paintBackground) const;
 
+	const QPixmap &cachedFrame(int size, Shape shape) const;
+
 	void fillString(const QString &name);
 
 	style::color _color;
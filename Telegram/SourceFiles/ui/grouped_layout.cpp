@@ -10,6 +10,12 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 namespace Ui {
 namespace {
 
+// History view initializes its dimensions again and again while the
+// album parts are being downloaded, each time computing the same
+// mosaic geometry, so the last layouts are memoized. Only used from
+// the main thread.
+constexpr auto kMemoizeLimit = 64;
+
 int Round(float64 value) {
 	return int(std::round(value));
 }
@@ -572,7 +578,29 @@ std::vector<GroupMediaLayout> LayoutMediaGroup(
 		int maxWidth,
 		int minWidth,
 		int spacing) {
-	return Layouter(sizes, maxWidth, minWidth, spacing).layout();
+	static auto memoized = std::map<
+		std::vector<int>,
+		std::vector<GroupMediaLayout>>();
+
+	auto key = std::vector<int>();
+	key.reserve(3 + sizes.size() * 2);
+	key.push_back(maxWidth);
+	key.push_back(minWidth);
+	key.push_back(spacing);
+	for (const auto &size : sizes) {
+		key.push_back(size.width());
+		key.push_back(size.height());
+	}
+	const auto i = memoized.find(key);
+	if (i != end(memoized)) {
+		return i->second;
+	}
+	auto result = Layouter(sizes, maxWidth, minWidth, spacing).layout();
+	if (memoized.size() >= kMemoizeLimit) {
+		memoized.clear();
+	}
+	memoized.emplace(std::move(key), result);
+	return result;
 }
 
 RectParts GetCornersFromSides(RectParts sides) {
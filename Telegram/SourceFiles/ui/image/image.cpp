@@ -19,9 +19,6 @@ using namespace Images;
 namespace Images {
 namespace {
 
-// After 128 MB of unpacked images we try to clear some memory.
-constexpr auto kMemoryForCache = 128 * 1024 * 1024;
-
 QMap<QString, Image*> LocalFileImages;
 QMap<QString, Image*> WebUrlImages;
 QMap<StorageKey, Image*> StorageImages;
@@ -42,7 +39,7 @@ int64 ComputeUsage(const QImage &image) {
 
 Core::MediaActiveCache<const Image> &ActiveCache() {
 	static auto Instance = Core::MediaActiveCache<const Image>(
-		kMemoryForCache,
+		"images",
 		[](const Image *image) { image->unload(); });
 	return Instance;
 }
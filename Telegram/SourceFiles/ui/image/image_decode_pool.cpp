@@ -0,0 +1,89 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#include "ui/image/image_decode_pool.h"
+
+namespace Images {
+namespace {
+
+struct DecodeTask {
+	QByteArray bytes;
+	QSize shrinkBox;
+	DecodePriority priority = DecodePriority::Background;
+	uint64 order = 0;
+	FnMut<void(QImage &&image)> done;
+};
+
+QMutex DecodeQueueMutex;
+std::vector<DecodeTask> DecodeQueue;
+uint64 DecodeOrderCounter = 0;
+
+bool FirstComesBefore(const DecodeTask &a, const DecodeTask &b) {
+	return (a.priority != b.priority)
+		? (a.priority < b.priority)
+		: (a.order < b.order);
+}
+
+DecodeTask TakeBestTask() {
+	QMutexLocker lock(&DecodeQueueMutex);
+	Assert(!DecodeQueue.empty());
+
+	const auto best = std::min_element(
+		begin(DecodeQueue),
+		end(DecodeQueue),
+		FirstComesBefore);
+	auto result = std::move(*best);
+	DecodeQueue.erase(best);
+	return result;
+}
+
+void DecodeAndDeliver(DecodeTask &&task) {
+	auto format = QByteArray();
+	auto image = App::readImage(task.bytes, &format, false);
+	if (!image.isNull()
+		&& !task.shrinkBox.isEmpty()
+		&& (image.width() > task.shrinkBox.width()
+			|| image.height() > task.shrinkBox.height())) {
+		image = image.scaled(
+			task.shrinkBox,
+			Qt::KeepAspectRatio,
+			Qt::SmoothTransformation);
+	}
+	crl::on_main([
+		done = std::move(task.done),
+		image = std::move(image)
+	]() mutable {
+		done(std::move(image));
+	});
+}
+
+} // namespace
+
+void DecodeAsync(
+		QByteArray bytes,
+		QSize shrinkBox,
+		DecodePriority priority,
+		FnMut<void(QImage &&image)> done) {
+	{
+		QMutexLocker lock(&DecodeQueueMutex);
+		DecodeQueue.push_back({
+			std::move(bytes),
+			shrinkBox,
+			priority,
+			++DecodeOrderCounter,
+			std::move(done) });
+	}
+
+	// Each queued task wakes one pool thread, which then takes whatever
+	// task has the highest priority at that moment, so viewport decodes
+	// overtake preloads and background work queued earlier.
+	crl::async([] {
+		DecodeAndDeliver(TakeBestTask());
+	});
+}
+
+} // namespace Images
@@ -0,0 +1,29 @@
+/*
+This file is part of Telegram Desktop,
+the official desktop application for the Telegram messaging service.
+
+For license and copyright information please follow this link:
+https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
+*/
+#pragma once
+
+namespace Images {
+
+enum class DecodePriority {
+	Viewport, // Requested while painting currently visible content.
+	Preload,
+	Background,
+};
+
+// Decodes image bytes on pool threads so that scrolling through a
+// media-heavy history never runs JPEG / PNG decoding in the paint code
+// path. If !shrinkBox.isEmpty() the result is scaled down to fit in it.
+// The done callback is always invoked on the main thread, with a null
+// QImage if the bytes could not be read.
+void DecodeAsync(
+	QByteArray bytes,
+	QSize shrinkBox,
+	DecodePriority priority,
+	FnMut<void(QImage &&image)> done);
+
+} // namespace Images
@@ -7,6 +7,8 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "ui/image/image_prepare.h"
 
+#include <thread>
+
 namespace Images {
 namespace {
 
@@ -14,29 +16,72 @@ TG_FORCE_INLINE uint64 blurGetColors(const uchar *p) {
 	return (uint64)p[0] + ((uint64)p[1] << 16) + ((uint64)p[2] << 32) + ((uint64)p[3] << 48);
 }
 
-const QPixmap &circleMask(int width, int height) {
-	Assert(Global::started());
+struct CircleMaskRow {
+	int outerLeft = 0;
+	int innerLeft = 0;
+	int innerRight = 0;
+	int outerRight = 0;
+};
+
+struct CircleMaskData {
+	QImage mask;
 
-	uint64 key = uint64(uint32(width)) << 32 | uint64(uint32(height));
+	// Per row: [outerLeft, innerLeft) and [innerRight, outerRight)
+	// are the anti-aliased edges, everything between them is fully
+	// opaque and everything outside is fully transparent.
+	std::vector<CircleMaskRow> rows;
+};
 
-	Global::CircleMasksMap &masks(Global::RefCircleMasks());
-	auto i = masks.constFind(key);
-	if (i == masks.cend()) {
-		QImage mask(width, height, QImage::Format_ARGB32_Premultiplied);
-		{
-			Painter p(&mask);
-			PainterHighQualityEnabler hq(p);
+const CircleMaskData *circleMaskData(int width, int height) {
+	static QMutex Mutex;
+	static std::map<uint64, CircleMaskData> Masks;
 
-			p.setCompositionMode(QPainter::CompositionMode_Source);
-			p.fillRect(0, 0, width, height, Qt::transparent);
-			p.setBrush(Qt::white);
-			p.setPen(Qt::NoPen);
-			p.drawEllipse(0, 0, width, height);
+	const auto key = uint64(uint32(width)) << 32 | uint64(uint32(height));
+
+	QMutexLocker lock(&Mutex);
+	const auto i = Masks.find(key);
+	if (i != Masks.end()) {
+		return &i->second;
+	}
+	QImage mask(width, height, QImage::Format_ARGB32_Premultiplied);
+	{
+		Painter p(&mask);
+		PainterHighQualityEnabler hq(p);
+
+		p.setCompositionMode(QPainter::CompositionMode_Source);
+		p.fillRect(0, 0, width, height, Qt::transparent);
+		p.setBrush(Qt::white);
+		p.setPen(Qt::NoPen);
+		p.drawEllipse(0, 0, width, height);
+	}
+	auto rows = std::vector<CircleMaskRow>(height);
+	for (auto y = 0; y != height; ++y) {
+		const auto pixels = reinterpret_cast<const uint32*>(
+			mask.constScanLine(y));
+		auto &row = rows[y];
+		row.outerLeft = row.innerLeft = width;
+		row.outerRight = row.innerRight = 0;
+		for (auto x = 0; x != width; ++x) {
+			const auto alpha = (pixels[x] >> 24);
+			if (!alpha) {
+				continue;
+			}
+			row.outerLeft = std::min(row.outerLeft, x);
+			row.outerRight = x + 1;
+			if (alpha == 255) {
+				row.innerLeft = std::min(row.innerLeft, x);
+				row.innerRight = x + 1;
+			}
+		}
+		if (row.innerRight < row.innerLeft) {
+			// No fully opaque pixels in this row.
+			row.innerLeft = row.innerRight = row.outerRight;
 		}
-		mask.setDevicePixelRatio(cRetinaFactor());
-		i = masks.insert(key, App::pixmapFromImageInPlace(std::move(mask)));
 	}
-	return i.value();
+	auto &result = Masks[key];
+	result.mask = std::move(mask);
+	result.rows = std::move(rows);
+	return &result;
 }
 
 } // namespace
@@ -89,22 +134,21 @@ QImage prepareBlur(QImage img) {
 			}
 			uint64 *rgb = new uint64[w * h];
 
-			int x, y, i;
-
-			int yw = 0;
-			const int we = w - r1;
-			for (y = 0; y < h; y++) {
-				uint64 cur = blurGetColors(&pix[yw]);
-				uint64 rgballsum = -radius * cur;
-				uint64 rgbsum = cur * ((r1 * (r1 + 1)) >> 1);
-
-				for (i = 1; i <= radius; i++) {
-					uint64 cur = blurGetColors(&pix[yw + i * 4]);
-					rgbsum += cur * (r1 - i);
-					rgballsum += cur;
-				}
+			const auto rowsPass = [&](int yFrom, int yTo) {
+				const int we = w - r1;
+				int yw = yFrom * stride;
+				for (int y = yFrom; y < yTo; y++) {
+					uint64 cur = blurGetColors(&pix[yw]);
+					uint64 rgballsum = -radius * cur;
+					uint64 rgbsum = cur * ((r1 * (r1 + 1)) >> 1);
+
+					for (int i = 1; i <= radius; i++) {
+						uint64 cur = blurGetColors(&pix[yw + i * 4]);
+						rgbsum += cur * (r1 - i);
+						rgballsum += cur;
+					}
 
-				x = 0;
+					int x = 0;
 
 #define update(start, middle, end) \
 rgb[y * w + x] = (rgbsum >> 4) & 0x00FF00FF00FF00FFLL; \
@@ -112,32 +156,33 @@ rgballsum += blurGetColors(&pix[yw + (start) * 4]) - 2 * blurGetColors(&pix[yw +
 rgbsum += rgballsum; \
 x++;
 
-				while (x < r1) {
-					update(0, x, x + r1);
-				}
-				while (x < we) {
-					update(x - r1, x, x + r1);
-				}
-				while (x < w) {
-					update(x - r1, x, w - 1);
-				}
+					while (x < r1) {
+						update(0, x, x + r1);
+					}
+					while (x < we) {
+						update(x - r1, x, x + r1);
+					}
+					while (x < w) {
+						update(x - r1, x, w - 1);
+					}
 
 #undef update
 
-				yw += stride;
-			}
-
-			const int he = h - r1;
-			for (x = 0; x < w; x++) {
-				uint64 rgballsum = -radius * rgb[x];
-				uint64 rgbsum = rgb[x] * ((r1 * (r1 + 1)) >> 1);
-				for (i = 1; i <= radius; i++) {
-					rgbsum += rgb[i * w + x] * (r1 - i);
-					rgballsum += rgb[i * w + x];
+					yw += stride;
 				}
+			};
+			const auto columnsPass = [&](int xFrom, int xTo) {
+				const int he = h - r1;
+				for (int x = xFrom; x < xTo; x++) {
+					uint64 rgballsum = -radius * rgb[x];
+					uint64 rgbsum = rgb[x] * ((r1 * (r1 + 1)) >> 1);
+					for (int i = 1; i <= radius; i++) {
+						rgbsum += rgb[i * w + x] * (r1 - i);
+						rgballsum += rgb[i * w + x];
+					}
 
-				y = 0;
-				int yi = x * 4;
+					int y = 0;
+					int yi = x * 4;
 
 #define update(start, middle, end) \
 uint64 res = rgbsum >> 4; \
@@ -150,18 +195,51 @@ rgbsum += rgballsum; \
 y++; \
 yi += stride;
 
-				while (y < r1) {
-					update(0, y, y + r1);
+					while (y < r1) {
+						update(0, y, y + r1);
+					}
+					while (y < he) {
+						update(y - r1, y, y + r1);
+					}
+					while (y < h) {
+						update(y - r1, y, h - 1);
+					}
+
+#undef update
 				}
-				while (y < he) {
-					update(y - r1, y, y + r1);
+			};
+
+			// Rows are independent in the first pass and columns in
+			// the second, so wallpaper-sized images are split between
+			// workers, while small thumbnails stay on this thread.
+			const auto runPass = [](int count, const auto &pass) {
+				constexpr auto kParallelThreshold = 256;
+				const auto threads = std::max(
+					int(std::thread::hardware_concurrency()),
+					1);
+				const auto chunks = std::min(
+					threads,
+					count / kParallelThreshold);
+				if (chunks < 2) {
+					pass(0, count);
+					return;
 				}
-				while (y < h) {
-					update(y - r1, y, h - 1);
+				crl::semaphore semaphore;
+				const auto perChunk = (count + chunks - 1) / chunks;
+				for (auto i = 0; i != chunks; ++i) {
+					const auto from = i * perChunk;
+					const auto till = std::min(count, from + perChunk);
+					crl::async([&, from, till] {
+						pass(from, till);
+						semaphore.release();
+					});
 				}
-
-#undef update
-			}
+				for (auto i = 0; i != chunks; ++i) {
+					semaphore.acquire();
+				}
+			};
+			runPass(h, rowsPass);
+			runPass(w, columnsPass);
 
 			delete[] rgb;
 		}
@@ -391,10 +469,37 @@ void prepareCircle(QImage &img) {
 	img = img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
 	Assert(!img.isNull());
 
-	QPixmap mask = circleMask(img.width(), img.height());
-	Painter p(&img);
-	p.setCompositionMode(QPainter::CompositionMode_DestinationIn);
-	p.drawPixmap(0, 0, mask);
+	// This runs for every round video frame, so instead of a full
+	// QPainter DestinationIn pass over the whole frame only the
+	// anti-aliased edges of each row are multiplied by the mask and
+	// the corners outside the circle are cleared.
+	const auto data = circleMaskData(img.width(), img.height());
+	const auto width = img.width();
+	const auto height = img.height();
+	for (auto y = 0; y != height; ++y) {
+		const auto maskPixels = reinterpret_cast<const uint32*>(
+			data->mask.constScanLine(y));
+		const auto pixels = reinterpret_cast<uint32*>(img.scanLine(y));
+		const auto &row = data->rows[y];
+		memset(pixels, 0, row.outerLeft * sizeof(uint32));
+		memset(
+			pixels + row.outerRight,
+			0,
+			(width - row.outerRight) * sizeof(uint32));
+		const auto multiply = [&](int from, int till) {
+			for (auto x = from; x != till; ++x) {
+				const auto alpha = (maskPixels[x] >> 24) + 1;
+				const auto value = pixels[x];
+				const auto rb = (((value & 0x00FF00FFU) * alpha) >> 8)
+					& 0x00FF00FFU;
+				const auto ag = ((((value >> 8) & 0x00FF00FFU) * alpha))
+					& 0xFF00FF00U;
+				pixels[x] = rb | ag;
+			}
+		};
+		multiply(row.outerLeft, row.innerLeft);
+		multiply(row.innerRight, row.outerRight);
+	}
 }
 
 void prepareRound(
@@ -513,6 +618,74 @@ QImage prepareOpaque(QImage image) {
 	return image;
 }
 
+namespace {
+
+// Averages each 2x2 box of pixels into one. Expects a 32 bit format,
+// for ARGB32_Premultiplied the channel-wise average is correct.
+QImage PrescaleHalf(QImage &&image) {
+	const auto width = image.width() / 2;
+	const auto height = image.height() / 2;
+	auto result = QImage(width, height, image.format());
+	result.setDevicePixelRatio(image.devicePixelRatio());
+	for (auto y = 0; y != height; ++y) {
+		const auto src1 = image.constScanLine(2 * y);
+		const auto src2 = image.constScanLine(2 * y + 1);
+		const auto dst = result.scanLine(y);
+		for (auto x = 0; x != width; ++x) {
+			const auto i = x * 4;
+			const auto j = x * 8;
+			for (auto c = 0; c != 4; ++c) {
+				dst[i + c] = uchar((src1[j + c]
+					+ src1[j + 4 + c]
+					+ src2[j + c]
+					+ src2[j + 4 + c]
+					+ 2) >> 2);
+			}
+		}
+	}
+	return result;
+}
+
+} // namespace
+
+QImage scaleDown(
+		QImage &&image,
+		int boxWidth,
+		int boxHeight,
+		Qt::AspectRatioMode mode) {
+	if (image.isNull() || image.width() <= 0 || image.height() <= 0) {
+		return std::move(image);
+	}
+	const auto target = image.size().scaled(boxWidth, boxHeight, mode);
+	if (target.isEmpty()) {
+		return image.scaled(
+			boxWidth,
+			boxHeight,
+			mode,
+			Qt::SmoothTransformation);
+	}
+	if (image.width() >= target.width() * 2
+		&& image.height() >= target.height() * 2) {
+		if (image.format() != QImage::Format_RGB32
+			&& image.format() != QImage::Format_ARGB32_Premultiplied) {
+			image = std::move(image).convertToFormat(image.hasAlphaChannel()
+				? QImage::Format_ARGB32_Premultiplied
+				: QImage::Format_RGB32);
+		}
+		do {
+			image = PrescaleHalf(std::move(image));
+		} while (image.width() >= target.width() * 2
+			&& image.height() >= target.height() * 2);
+	}
+	if (image.size() == target) {
+		return std::move(image);
+	}
+	return image.scaled(
+		target,
+		Qt::IgnoreAspectRatio,
+		Qt::SmoothTransformation);
+}
+
 QImage prepare(QImage img, int w, int h, Images::Options options, int outerw, int outerh, const style::color *colored) {
 	Assert(!img.isNull());
 	if (options & Images::Option::Blurred) {
@@ -523,8 +696,11 @@ QImage prepare(QImage img, int w, int h, Images::Options options, int outerw, in
 	} else if (h <= 0) {
 		img = img.scaledToWidth(w, (options & Images::Option::Smooth) ? Qt::SmoothTransformation : Qt::FastTransformation);
 		Assert(!img.isNull());
+	} else if (options & Images::Option::Smooth) {
+		img = scaleDown(std::move(img), w, h, Qt::IgnoreAspectRatio);
+		Assert(!img.isNull());
 	} else {
-		img = img.scaled(w, h, Qt::IgnoreAspectRatio, (options & Images::Option::Smooth) ? Qt::SmoothTransformation : Qt::FastTransformation);
+		img = img.scaled(w, h, Qt::IgnoreAspectRatio, Qt::FastTransformation);
 		Assert(!img.isNull());
 	}
 	if (outerw > 0 && outerh > 0) {
@@ -7,6 +7,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 */
 #include "ui/image/image_source.h"
 
+#include "ui/image/image_decode_pool.h"
 #include "storage/file_download.h"
 #include "data/data_session.h"
 #include "data/data_file_origin.h"
@@ -283,21 +284,65 @@ QByteArray LocalFileSource::bytesForCache() {
 }
 
 QImage RemoteSource::takeLoaded() {
-	if (!loaderValid() || !_loader->finished()) {
+	if (!_decoded.isNull()) {
+		return base::take(_decoded);
+	} else if (!loaderValid() || !_loader->finished()) {
 		return QImage();
 	}
 
-	auto data = _loader->imageData(shrinkBox());
-	if (data.isNull()) {
-		destroyLoader(CancelledFileLoader);
-		return QImage();
+	if (_loader->hasImageData()) {
+		// Already decoded, for example by the local cache reading task.
+		auto data = _loader->imageData(shrinkBox());
+		if (data.isNull()) {
+			destroyLoader(CancelledFileLoader);
+			return QImage();
+		}
+
+		setInformation(_loader->bytes().size(), data.width(), data.height());
+
+		destroyLoader();
+
+		return data;
+	} else if (!_decodeGuard) {
+		startDecode();
 	}
 
-	setInformation(_loader->bytes().size(), data.width(), data.height());
+	// The blurred thumbnail stays on screen till the decode finishes.
+	return QImage();
+}
+
+void RemoteSource::startDecode() {
+	Expects(loaderValid() && _loader->finished());
+
+	auto [mine, theirs] = base::make_binary_guard();
+	_decodeGuard = std::move(mine);
+	DecodeAsync(
+		_loader->bytes(),
+		shrinkBox(),
+		DecodePriority::Viewport,
+		[=, guard = std::move(theirs)](QImage &&image) mutable {
+			if (guard.alive()) {
+				decodeDone(std::move(image));
+			}
+		});
+}
+
+void RemoteSource::decodeDone(QImage &&image) {
+	_decodeGuard = nullptr;
+	if (!loaderValid() || !_loader->finished()) {
+		return;
+	} else if (image.isNull()) {
+		destroyLoader(CancelledFileLoader);
+		return;
+	}
+	setInformation(_loader->bytes().size(), image.width(), image.height());
 
 	destroyLoader();
 
-	return data;
+	_decoded = std::move(image);
+
+	// Repaint the views that were waiting for this image.
+	Auth().downloader().taskFinished().notify();
 }
 
 bool RemoteSource::loaderValid() const {
@@ -372,6 +417,8 @@ void RemoteSource::automaticLoad(
 	}
 	if (loaderValid()) {
 		_loader->start();
+		// Called from the drawing code, so the image is on the screen.
+		_loader->setLoadPriority(LoadPriority::Visible);
 	}
 }
 
@@ -415,10 +462,13 @@ bool RemoteSource::displayLoading() {
 void RemoteSource::cancel() {
 	if (!loaderValid()) return;
 
+	_decodeGuard = nullptr;
 	destroyLoader(CancelledFileLoader);
 }
 
 void RemoteSource::unload() {
+	_decodeGuard = nullptr;
+	_decoded = QImage();
 	if (loaderValid()) {
 		delete base::take(_loader);
 	}
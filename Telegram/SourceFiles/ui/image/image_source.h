@@ -8,6 +8,7 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #pragma once
 
 #include "ui/image/image.h"
+#include "base/binary_guard.h"
 
 namespace Images {
 
@@ -171,9 +172,15 @@ private:
 	bool loaderValid() const;
 	bool cancelled() const;
 	void destroyLoader(FileLoader *newValue = nullptr);
+	void startDecode();
+	void decodeDone(QImage &&image);
 
 	FileLoader *_loader = nullptr;
 
+	// Filled by the decode pool, taken by the first takeLoaded() call.
+	QImage _decoded;
+	base::binary_guard _decodeGuard;
+
 };
 
 class StorageSource : public RemoteSource {
@@ -2544,6 +2544,7 @@ void Text::setText(const style::TextStyle &st, const QString &text, const TextPa
 }
 
 void Text::recountNaturalSize(bool initial, Qt::LayoutDirection optionsDir) {
+	_lastCountedWidth = -1;
 	NewlineBlock *lastNewline = 0;
 
 	_maxWidth = _minHeight = 0;
@@ -2791,10 +2792,15 @@ int Text::countHeight(int width) const {
 	if (QFixed(width) >= _maxWidth) {
 		return _minHeight;
 	}
+	if (width == _lastCountedWidth) {
+		return _lastCountedHeight;
+	}
 	int result = 0;
 	enumerateLines(width, [&result](QFixed lineWidth, int lineHeight) {
 		result += lineHeight;
 	});
+	_lastCountedWidth = width;
+	_lastCountedHeight = result;
 	return result;
 }
 
@@ -3130,6 +3136,8 @@ void Text::clearFields() {
 	_blocks.clear();
 	_links.clear();
 	_maxWidth = _minHeight = 0;
+	_lastCountedWidth = -1;
+	_lastCountedHeight = 0;
 	_startDir = Qt::LayoutDirectionAuto;
 }
 
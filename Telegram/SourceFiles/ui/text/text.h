@@ -221,6 +221,11 @@ private:
 	QFixed _maxWidth = 0;
 	int32 _minHeight = 0;
 
+	// Last countHeight() result, so that repeated layout passes at
+	// an unchanged width don't re-enumerate all lines.
+	mutable int _lastCountedWidth = -1;
+	mutable int _lastCountedHeight = 0;
+
 	QString _text;
 	const style::TextStyle *_st = nullptr;
 
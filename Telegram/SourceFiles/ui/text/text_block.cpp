@@ -8,6 +8,9 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/text/text_block.h"
 
 #include "core/crash_reports.h"
+#include "base/last_used_cache.h"
+
+#include <unordered_map>
 
 // COPIED FROM qtextlayout.cpp AND MODIFIED
 namespace {
@@ -292,6 +295,59 @@ private:
 
 };
 
+namespace {
+
+// Process-wide cache of shaped runs for short strings (sender names,
+// timestamps, "Forwarded from" and similar), so that thousands of
+// visible messages don't hit QTextEngine for identical text again.
+constexpr auto kShapingCacheLimit = 8192;
+constexpr auto kShapingCacheMaxLength = 64;
+
+struct ShapedBlock {
+	QVector<TextWord> words; // TextWord::from() relative to the part.
+	QFixed width;
+	QFixed rpadding;
+};
+
+using ShapingKey = std::u16string;
+
+std::unordered_map<ShapingKey, ShapedBlock> ShapingCache;
+base::last_used_cache<ShapingKey> ShapingCacheIndex;
+
+ShapingKey ShapingKeyFor(
+		const QString &part,
+		const style::font &font,
+		QFixed minResizeWidth,
+		bool inLink) {
+	auto result = ShapingKey();
+	result.reserve(part.size() + 7);
+	result.assign(
+		reinterpret_cast<const char16_t*>(part.constData()),
+		part.size());
+	const auto append32 = [&](uint32 value) {
+		result.push_back(char16_t(value & 0xFFFF));
+		result.push_back(char16_t(value >> 16));
+	};
+	result.push_back(char16_t(inLink ? 1 : 0));
+	const auto fontId = uint64(quintptr(font.v()));
+	append32(uint32(fontId & 0xFFFFFFFFULL));
+	append32(uint32(fontId >> 32));
+	append32(uint32(minResizeWidth.value()));
+	return result;
+}
+
+void PruneShapingCache() {
+	while (ShapingCache.size() > kShapingCacheLimit) {
+		const auto lowest = ShapingCacheIndex.take_lowest();
+		if (lowest.empty()) {
+			break;
+		}
+		ShapingCache.erase(lowest);
+	}
+}
+
+} // namespace
+
 QFixed ITextBlock::f_rbearing() const {
 	return (type() == TextBlockTText) ? static_cast<const TextBlock*>(this)->real_f_rbearing() : 0;
 }
@@ -330,8 +386,34 @@ TextBlock::TextBlock(const style::font &font, const QString &str, QFixed minResi
 		// Attempt to catch a crash in text processing
 		CrashReports::SetAnnotationRef("CrashString", &part);
 
-		QStackTextEngine engine(part, blockFont->f);
-		BlockParser parser(&engine, this, minResizeWidth, _from, part);
+		if (length <= kShapingCacheMaxLength) {
+			const auto key = ShapingKeyFor(
+				part,
+				blockFont,
+				minResizeWidth,
+				lnkIndex > 0);
+			const auto i = ShapingCache.find(key);
+			if (i != ShapingCache.cend()) {
+				_words = i->second.words;
+				_width = i->second.width;
+				_rpadding = i->second.rpadding;
+			} else {
+				QStackTextEngine engine(part, blockFont->f);
+				BlockParser parser(&engine, this, minResizeWidth, 0, part);
+				auto &entry = ShapingCache[key];
+				entry.words = _words;
+				entry.width = _width;
+				entry.rpadding = _rpadding;
+				PruneShapingCache();
+			}
+			for (auto &word : _words) {
+				word.add_from(_from);
+			}
+			ShapingCacheIndex.up(key);
+		} else {
+			QStackTextEngine engine(part, blockFont->f);
+			BlockParser parser(&engine, this, minResizeWidth, _from, part);
+		}
 
 		CrashReports::ClearAnnotationRef("CrashString");
 	}
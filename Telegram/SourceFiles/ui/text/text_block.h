@@ -132,6 +132,9 @@ public:
 	void add_rpadding(QFixed padding) {
 		_rpadding += padding;
 	}
+	void add_from(uint16 delta) {
+		_from += delta;
+	}
 
 private:
 	uint16 _from = 0;
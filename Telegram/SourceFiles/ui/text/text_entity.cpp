@@ -1578,6 +1578,56 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 	int32 len = result.text.size(), commandOffset = rich ? 0 : len;
 	bool inLink = false, commandIsLink = false;
 	const QChar *start = result.text.constData(), *end = start + result.text.size();
+
+	// Cheap classification pass: most messages contain none of the
+	// characters that could start an entity of a given class, so the
+	// regular expressions for such classes never need to run at all.
+	auto hasDotChar = false;
+	auto hasColonChar = false;
+	auto hasHashChar = false;
+	auto hasAtChar = false;
+	auto hasSlashChar = false;
+	for (const QChar *ch = start; ch != end; ++ch) {
+		switch (ch->unicode()) {
+		case '.': hasDotChar = true; break;
+		case ':': hasColonChar = true; break;
+		case '#': hasHashChar = true; break;
+		case '@': hasAtChar = true; break;
+		case '/': hasSlashChar = true; break;
+		}
+	}
+	withHashtags = withHashtags && hasHashChar;
+	withMentions = withMentions && hasAtChar;
+	withBotCommands = withBotCommands && hasSlashChar;
+
+	// Each match is cached and re-run only after the scan offset
+	// passes its position, instead of re-running all five regular
+	// expressions on every found entity. Once an expression stops
+	// matching it can never match again further in the text.
+	auto mDomain = QRegularExpressionMatch();
+	auto mExplicitDomain = QRegularExpressionMatch();
+	auto mHashtag = QRegularExpressionMatch();
+	auto mMention = QRegularExpressionMatch();
+	auto mBotCommand = QRegularExpressionMatch();
+	auto domainExhausted = !hasDotChar;
+	auto explicitDomainExhausted = !hasColonChar;
+	auto hashtagExhausted = !withHashtags;
+	auto mentionExhausted = !withMentions;
+	auto botCommandExhausted = !withBotCommands;
+	const auto matchAgain = [&](
+			QRegularExpressionMatch &match,
+			bool &exhausted,
+			const QRegularExpression &expression,
+			int from) {
+		if (exhausted
+			|| (match.hasMatch() && match.capturedStart() >= from)) {
+			return;
+		}
+		match = expression.match(result.text, from);
+		if (!match.hasMatch()) {
+			exhausted = true;
+		}
+	};
 	for (int32 offset = 0, matchOffset = offset, mentionSkip = 0; offset < len;) {
 		if (commandOffset <= offset) {
 			for (commandOffset = offset; commandOffset < len; ++commandOffset) {
@@ -1588,11 +1638,11 @@ void ParseEntities(TextWithEntities &result, int32 flags, bool rich) {
 				}
 			}
 		}
-		auto mDomain = qthelp::RegExpDomain().match(result.text, matchOffset);
-		auto mExplicitDomain = qthelp::RegExpDomainExplicit().match(result.text, matchOffset);
-		auto mHashtag = withHashtags ? RegExpHashtag().match(result.text, matchOffset) : QRegularExpressionMatch();
-		auto mMention = withMentions ? RegExpMention().match(result.text, qMax(mentionSkip, matchOffset)) : QRegularExpressionMatch();
-		auto mBotCommand = withBotCommands ? RegExpBotCommand().match(result.text, matchOffset) : QRegularExpressionMatch();
+		matchAgain(mDomain, domainExhausted, qthelp::RegExpDomain(), matchOffset);
+		matchAgain(mExplicitDomain, explicitDomainExhausted, qthelp::RegExpDomainExplicit(), matchOffset);
+		matchAgain(mHashtag, hashtagExhausted, RegExpHashtag(), matchOffset);
+		matchAgain(mMention, mentionExhausted, RegExpMention(), qMax(mentionSkip, matchOffset));
+		matchAgain(mBotCommand, botCommandExhausted, RegExpBotCommand(), matchOffset);
 
 		EntityInTextType lnkType = EntityInTextUrl;
 		int32 lnkStart = 0, lnkLength = 0;
@@ -120,6 +120,20 @@ QString GetOverride(const QString &familyName) {
 namespace Ui {
 namespace {
 
+constexpr auto kPaintProfileRecordsLimit = 4096;
+constexpr auto kPaintProfileLogInterval = TimeMs(5000);
+constexpr auto kPaintProfileTopCount = 10;
+
+struct PaintProfileRecord {
+	const QMetaObject *meta = nullptr;
+	quint64 nanoseconds = 0;
+};
+
+bool PaintProfileEnabled = false;
+std::vector<PaintProfileRecord> PaintProfileRecords;
+int PaintProfileIndex = 0;
+TimeMs PaintProfileLastLogTime = 0;
+
 class WidgetCreator : public QWidget {
 public:
 	static void Create(not_null<QWidget*> widget) {
@@ -182,6 +196,75 @@ void SendPendingEventsRecursive(QWidget *target, bool parentHiddenFlag) {
 
 } // namespace
 
+void SetPaintProfilingEnabled(bool enabled) {
+	PaintProfileEnabled = enabled;
+	PaintProfileRecords.clear();
+	PaintProfileIndex = 0;
+	PaintProfileLastLogTime = 0;
+	if (enabled) {
+		PaintProfileRecords.reserve(kPaintProfileRecordsLimit);
+	}
+}
+
+bool PaintProfilingEnabled() {
+	return PaintProfileEnabled;
+}
+
+QString CollectPaintProfile() {
+	struct Entry {
+		const QMetaObject *meta = nullptr;
+		int count = 0;
+		quint64 total = 0;
+		quint64 largest = 0;
+	};
+	auto entries = std::vector<Entry>();
+	for (const auto &record : PaintProfileRecords) {
+		const auto i = ranges::find_if(entries, [&](const Entry &entry) {
+			return (entry.meta == record.meta);
+		});
+		auto &entry = (i != end(entries))
+			? *i
+			: (entries.push_back({ record.meta }), entries.back());
+		++entry.count;
+		entry.total += record.nanoseconds;
+		accumulate_max(entry.largest, record.nanoseconds);
+	}
+	ranges::sort(entries, std::greater<>(), &Entry::total);
+	if (entries.size() > kPaintProfileTopCount) {
+		entries.resize(kPaintProfileTopCount);
+	}
+	auto result = QString();
+	for (const auto &entry : entries) {
+		if (!result.isEmpty()) {
+			result += '\n';
+		}
+		result += qsl("%1: %2 paints, total %3 ms, max %4 ms"
+		).arg(entry.meta->className()
+		).arg(entry.count
+		).arg(entry.total / 1000000., 0, 'f', 3
+		).arg(entry.largest / 1000000., 0, 'f', 3);
+	}
+	return result;
+}
+
+void RegisterPaintProfile(const QMetaObject *meta, quint64 nanoseconds) {
+	if (PaintProfileRecords.size() < kPaintProfileRecordsLimit) {
+		PaintProfileRecords.push_back({ meta, nanoseconds });
+	} else {
+		PaintProfileRecords[PaintProfileIndex] = { meta, nanoseconds };
+		PaintProfileIndex = (PaintProfileIndex + 1)
+			% kPaintProfileRecordsLimit;
+	}
+	const auto now = getms();
+	if (!PaintProfileLastLogTime) {
+		PaintProfileLastLogTime = now;
+	} else if (now - PaintProfileLastLogTime >= kPaintProfileLogInterval) {
+		PaintProfileLastLogTime = now;
+		DEBUG_LOG(("Paint Profile: %1"
+			).arg(CollectPaintProfile().replace('\n', qsl("; "))));
+	}
+}
+
 void SendPendingMoveResizeEvents(not_null<QWidget*> target) {
 	CreateWidgetStateRecursive(target);
 	SendPendingEventsRecursive(target, !target->isVisible());
@@ -239,6 +322,18 @@ void PostponeCall(FnMut<void()> &&callable) {
 
 } // namespace Ui
 
+bool TWidget::event(QEvent *e) {
+	if (e->type() == QEvent::Paint && Ui::PaintProfilingEnabled()) {
+		auto timer = QElapsedTimer();
+		timer.start();
+		const auto meta = metaObject();
+		const auto result = TWidgetHelper<QWidget>::event(e);
+		Ui::RegisterPaintProfile(meta, quint64(timer.nsecsElapsed()));
+		return result;
+	}
+	return TWidgetHelper<QWidget>::event(e);
+}
+
 void sendSynteticMouseEvent(QWidget *widget, QEvent::Type type, Qt::MouseButton button, const QPoint &globalPoint) {
 	if (auto windowHandle = widget->window()->windowHandle()) {
 		auto localPoint = windowHandle->mapFromGlobal(globalPoint);
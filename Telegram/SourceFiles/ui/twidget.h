@@ -48,6 +48,14 @@ inline ChildWidget *AttachParentChild(
 
 void SendPendingMoveResizeEvents(not_null<QWidget*> target);
 
+// Paint profiling for finding expensive widgets, toggled by the
+// "paintprofile" settings code. While enabled every TWidget / RpWidget
+// paint is timed into a ring buffer and the most expensive widget
+// classes are written to the debug log every few seconds.
+void SetPaintProfilingEnabled(bool enabled);
+bool PaintProfilingEnabled();
+QString CollectPaintProfile();
+
 QPixmap GrabWidget(
 	not_null<QWidget*> target,
 	QRect rect = QRect(),
@@ -425,6 +433,8 @@ signals:
 	void heightUpdated();
 
 protected:
+	bool event(QEvent *e) override;
+
 	void setChildVisibleTopBottom(
 			TWidget *child,
 			int visibleTop,
@@ -24,6 +24,11 @@ namespace Ui {
 namespace {
 
 constexpr auto kMaxUsernameLength = 32;
+
+// With an undo limit set the document history is compacted when it
+// grows this many times past the limit, so the expensive rebuild
+// happens only once in a while.
+constexpr auto kUndoCompactRatio = 8;
 constexpr auto kInstantReplaceRandomId = QTextFormat::UserProperty;
 constexpr auto kInstantReplaceWhatId = QTextFormat::UserProperty + 1;
 constexpr auto kInstantReplaceWithId = QTextFormat::UserProperty + 2;
@@ -2183,6 +2188,7 @@ void InputField::handleContentsChanged() {
 	setErrorShown(false);
 
 	auto tagsChanged = false;
+	const auto previousTextWithTags = _lastTextWithTags;
 	const auto currentText = getTextPart(
 		0,
 		-1,
@@ -2194,6 +2200,9 @@ void InputField::handleContentsChanged() {
 
 	if (tagsChanged || (_lastTextWithTags.text != currentText)) {
 		_lastTextWithTags.text = currentText;
+		if (_undoLimit > 0) {
+			recordUndoState(previousTextWithTags);
+		}
 		const auto weak = make_weak(this);
 		emit changed();
 		if (!weak) {
@@ -2248,6 +2257,102 @@ void InputField::onRedoAvailable(bool avail) {
 	if (App::wnd()) App::wnd()->updateGlobalMenu();
 }
 
+void InputField::setUndoLimit(int limit) {
+	Expects(limit >= 0);
+
+	_undoLimit = limit;
+	_undoBase = _lastTextWithTags;
+	_undoDeltas.clear();
+}
+
+void InputField::ApplyUndoDelta(TextWithTags &to, const UndoDelta &delta) {
+	to.text = to.text.left(delta.position)
+		+ delta.added
+		+ to.text.mid(delta.position + delta.removed.size());
+	to.tags = delta.tags;
+}
+
+void InputField::recordUndoState(const TextWithTags &was) {
+	if (_undoCompacting) {
+		return;
+	} else if (_undoHistoryCleared) {
+		// The document history was just dropped, so the states
+		// before this one must not survive into a compaction.
+		_undoHistoryCleared = false;
+		_undoBase = _lastTextWithTags;
+		_undoDeltas.clear();
+		return;
+	}
+	const auto &now = _lastTextWithTags;
+	const auto length = int(now.text.size());
+	const auto wasLength = int(was.text.size());
+	auto prefix = 0;
+	const auto minLength = std::min(length, wasLength);
+	while (prefix != minLength && now.text[prefix] == was.text[prefix]) {
+		++prefix;
+	}
+	auto suffix = 0;
+	const auto maxSuffix = minLength - prefix;
+	while (suffix != maxSuffix
+		&& (now.text[length - suffix - 1]
+			== was.text[wasLength - suffix - 1])) {
+		++suffix;
+	}
+	auto delta = UndoDelta();
+	delta.position = prefix;
+	delta.removed = was.text.mid(prefix, wasLength - suffix - prefix);
+	delta.added = now.text.mid(prefix, length - suffix - prefix);
+	delta.tags = now.tags;
+	_undoDeltas.push_back(std::move(delta));
+	while (int(_undoDeltas.size()) > _undoLimit) {
+		ApplyUndoDelta(_undoBase, _undoDeltas.front());
+		_undoDeltas.erase(_undoDeltas.begin());
+	}
+	if (!_undoCompactScheduled
+		&& (document()->availableUndoSteps()
+			> kUndoCompactRatio * _undoLimit)) {
+		// The compaction rewrites the document, so it can't happen
+		// inside the contents change handler we're called from.
+		_undoCompactScheduled = true;
+		InvokeQueued(this, [=] {
+			_undoCompactScheduled = false;
+			compactUndoStack();
+		});
+	}
+}
+
+void InputField::compactUndoStack() {
+	if (_undoLimit <= 0
+		|| (document()->availableUndoSteps()
+			<= kUndoCompactRatio * _undoLimit)) {
+		return;
+	}
+
+	// Qt's history can't drop only its oldest entries, so it is
+	// cleared and the recent states we retain are replayed, each
+	// becoming a single full-document undo step, releasing all the
+	// fragments the older steps were keeping alive.
+	_undoCompacting = true;
+	const auto weak = make_weak(this);
+	const auto position = _inner->textCursor().position();
+	document()->setUndoRedoEnabled(false);
+	document()->setUndoRedoEnabled(true);
+	auto state = _undoBase;
+	setTextWithTags(state, HistoryAction::NewEntry);
+	for (const auto &delta : _undoDeltas) {
+		if (!weak) {
+			return;
+		}
+		ApplyUndoDelta(state, delta);
+		setTextWithTags(state, HistoryAction::NewEntry);
+	}
+	if (!weak) {
+		return;
+	}
+	setCursorPosition(position);
+	_undoCompacting = false;
+}
+
 void InputField::setDisplayFocused(bool focused) {
 	setFocused(focused);
 	finishAnimating();
@@ -2362,6 +2467,7 @@ void InputField::setTextWithTags(
 	auto cursor = QTextCursor(document->docHandle(), 0);
 	if (historyAction == HistoryAction::Clear) {
 		document->setUndoRedoEnabled(false);
+		_undoHistoryCleared = true;
 		cursor.beginEditBlock();
 	} else if (historyAction == HistoryAction::MergeEntry) {
 		cursor.joinPreviousEditBlock();
@@ -4215,8 +4321,15 @@ void PhoneInput::correctValue(
 		int wasCursor,
 		QString &now,
 		int &nowCursor) {
-	auto digits = now;
-	digits.replace(QRegularExpression(qsl("[^\\d]")), QString());
+	// This runs on every keypress, so gather the digits by hand
+	// instead of rebuilding the text through a regular expression.
+	auto digits = QString();
+	digits.reserve(now.size());
+	for (auto i = 0, l = now.size(); i != l; ++i) {
+		if (now.at(i).isDigit()) {
+			digits.append(now.at(i));
+		}
+	}
 	_pattern = phoneNumberParse(digits);
 
 	QString newPlaceholder;
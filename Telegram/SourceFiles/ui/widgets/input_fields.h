@@ -255,6 +255,12 @@ public:
 	bool isUndoAvailable() const;
 	bool isRedoAvailable() const;
 
+	// Bounds the memory kept for the document history: when it grows
+	// several times past the limit it is compacted so that only the
+	// recent steps stay undoable. Zero (the default) keeps the full
+	// unbounded history.
+	void setUndoLimit(int limit);
+
 	using SubmitSettings = InputSubmitSettings;
 	void setSubmitSettings(SubmitSettings settings);
 	static bool ShouldSubmit(
@@ -413,6 +419,19 @@ private:
 
 	bool revertFormatReplace();
 
+	// The recent states of the field are kept as deltas over a base
+	// snapshot, so that the document history can be rebuilt from
+	// them when it exceeds the undo limit.
+	struct UndoDelta {
+		int position = 0;
+		QString removed;
+		QString added;
+		TagList tags; // Tags of the state this delta leads to.
+	};
+	static void ApplyUndoDelta(TextWithTags &to, const UndoDelta &delta);
+	void recordUndoState(const TextWithTags &was);
+	void compactUndoStack();
+
 	void highlightMarkdown();
 
 	const style::InputField &_st;
@@ -450,6 +469,12 @@ private:
 	bool _markdownEnabled = false;
 	bool _undoAvailable = false;
 	bool _redoAvailable = false;
+	int _undoLimit = 0;
+	TextWithTags _undoBase;
+	std::vector<UndoDelta> _undoDeltas;
+	bool _undoHistoryCleared = false;
+	bool _undoCompacting = false;
+	bool _undoCompactScheduled = false;
 	bool _inDrop = false;
 	bool _inHeightCheck = false;
 	int _additionalMargin = 0;
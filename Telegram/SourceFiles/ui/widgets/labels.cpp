@@ -193,6 +193,7 @@ void FlatLabel::init() {
 }
 
 void FlatLabel::textUpdated() {
+	_countedTextWidth = -1;
 	refreshSize();
 	setMouseTracking(_selectable || _text.hasLinks());
 	update();
@@ -256,7 +257,12 @@ int FlatLabel::countTextWidth() const {
 }
 
 int FlatLabel::countTextHeight(int textWidth) {
-	_fullTextHeight = _text.countHeight(textWidth);
+	// Parent layouts call resizeGetHeight() on every resize pass, most
+	// often with an unchanged width, so keep the last result around.
+	if (_countedTextWidth != textWidth) {
+		_countedTextWidth = textWidth;
+		_fullTextHeight = _text.countHeight(textWidth);
+	}
 	return _st.maxHeight ? qMin(_fullTextHeight, _st.maxHeight) : _fullTextHeight;
 }
 
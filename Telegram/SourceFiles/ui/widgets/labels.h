@@ -181,6 +181,7 @@ private:
 
 	int _allowedWidth = 0;
 	int _fullTextHeight = 0;
+	int _countedTextWidth = -1;
 	bool _breakEverywhere = false;
 
 	style::cursor _cursor = style::cur_default;
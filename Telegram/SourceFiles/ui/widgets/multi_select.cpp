@@ -474,7 +474,11 @@ void MultiSelect::Inner::setActiveItemNext() {
 }
 
 int MultiSelect::Inner::resizeGetHeight(int newWidth) {
-	computeItemsGeometry(newWidth);
+	if (newWidth != _layoutWidth || _laidOutCount > int(_items.size())) {
+		computeItemsGeometry(newWidth);
+	} else {
+		layoutTailItems(newWidth - _st.padding.left() - _st.padding.right());
+	}
 	updateFieldGeometry();
 
 	auto cancelLeft = _fieldLeft + _fieldWidth + _st.padding.right() - _cancel->width();
@@ -522,7 +526,30 @@ void MultiSelect::Inner::paintEvent(QPaintEvent *e) {
 			++i;
 		}
 	}
-	for_const (auto &item, _items) {
+	// Items are laid out row by row with non-decreasing tops, so skip
+	// the rows fully above the repainted rect right away. The chips
+	// above that are still sliding to their final position may paint
+	// anywhere, so they are checked one by one.
+	const auto firstVisible = std::lower_bound(
+		_items.begin(),
+		_items.end(),
+		checkRect.y(),
+		[&](const std::unique_ptr<Item> &item, int top) {
+			return item->rect().y() + _st.item.height + paintMargins.bottom() <= top;
+		});
+	for (auto i = _items.begin(); i != firstVisible; ++i) {
+		const auto &item = *i;
+		if (!item->animatingPosition()) {
+			continue;
+		}
+		auto itemRect = item->paintArea(outerWidth);
+		itemRect = itemRect.marginsAdded(paintMargins);
+		if (checkRect.intersects(itemRect)) {
+			item->paint(p, outerWidth, ms);
+		}
+	}
+	for (auto i = firstVisible, e = _items.end(); i != e; ++i) {
+		const auto &item = *i;
 		auto itemRect = item->paintArea(outerWidth);
 		itemRect = itemRect.marginsAdded(paintMargins);
 		if (checkRect.y() + checkRect.height() <= itemRect.y()) {
@@ -659,33 +686,41 @@ void MultiSelect::Inner::finishItemsBunch(AddItemWay way) {
 }
 
 void MultiSelect::Inner::computeItemsGeometry(int newWidth) {
+	_layoutWidth = newWidth;
 	newWidth -= _st.padding.left() + _st.padding.right();
 
-	auto itemLeft = 0;
-	auto itemTop = 0;
-	auto widthLeft = newWidth;
+	_laidOutCount = 0;
+	_layoutItemLeft = 0;
+	_layoutItemTop = 0;
+	_layoutWidthLeft = newWidth;
+	layoutTailItems(newWidth);
+}
+
+void MultiSelect::Inner::layoutTailItems(int newWidth) {
 	auto maxVisiblePadding = qMax(_st.padding.left(), _st.padding.right());
-	for_const (auto &item, _items) {
+	for (auto i = _laidOutCount, count = int(_items.size()); i != count; ++i) {
+		auto &item = _items[i];
 		auto itemWidth = item->getWidth();
 		Assert(itemWidth <= newWidth);
-		if (itemWidth > widthLeft) {
-			itemLeft = 0;
-			itemTop += _st.item.height + _st.itemSkip;
-			widthLeft = newWidth;
+		if (itemWidth > _layoutWidthLeft) {
+			_layoutItemLeft = 0;
+			_layoutItemTop += _st.item.height + _st.itemSkip;
+			_layoutWidthLeft = newWidth;
 		}
-		item->setPosition(itemLeft, itemTop, newWidth, maxVisiblePadding);
-		itemLeft += itemWidth + _st.itemSkip;
-		widthLeft -= itemWidth + _st.itemSkip;
+		item->setPosition(_layoutItemLeft, _layoutItemTop, newWidth, maxVisiblePadding);
+		_layoutItemLeft += itemWidth + _st.itemSkip;
+		_layoutWidthLeft -= itemWidth + _st.itemSkip;
 	}
+	_laidOutCount = int(_items.size());
 
 	auto fieldMinWidth = _st.fieldMinWidth + _st.fieldCancelSkip;
 	Assert(fieldMinWidth <= newWidth);
-	if (fieldMinWidth > widthLeft) {
+	if (fieldMinWidth > _layoutWidthLeft) {
 		_fieldLeft = 0;
-		_fieldTop = itemTop + _st.item.height + _st.itemSkip;
+		_fieldTop = _layoutItemTop + _st.item.height + _st.itemSkip;
 	} else {
-		_fieldLeft = itemLeft + (_items.empty() ? _st.fieldIconSkip : 0);
-		_fieldTop = itemTop;
+		_fieldLeft = _layoutItemLeft + (_items.empty() ? _st.fieldIconSkip : 0);
+		_fieldTop = _layoutItemTop;
 	}
 	_fieldWidth = newWidth - _fieldLeft;
 }
@@ -718,6 +753,7 @@ void MultiSelect::Inner::setItemText(uint64 itemId, const QString &text) {
 	for_const (auto &item, _items) {
 		if (item->id() == itemId) {
 			item->setText(text);
+			_layoutWidth = 0; // Forces a full relayout.
 			updateItemsGeometry();
 			return;
 		}
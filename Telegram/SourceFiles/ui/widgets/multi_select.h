@@ -111,6 +111,7 @@ private:
 	void queryChanged();
 	void fieldFocused();
 	void computeItemsGeometry(int newWidth);
+	void layoutTailItems(int newWidth);
 	void updateItemsGeometry();
 	void updateFieldGeometry();
 	void updateHasAnyItems(bool hasAnyItems);
@@ -147,6 +148,15 @@ private:
 	int _fieldLeft = 0;
 	int _fieldTop = 0;
 	int _fieldWidth = 0;
+
+	// Positions of the first _laidOutCount items are valid for the
+	// current _layoutWidth, so appending items to the end only needs
+	// to lay out the tail starting from the stored cursor.
+	int _layoutWidth = 0;
+	int _laidOutCount = 0;
+	int _layoutItemLeft = 0;
+	int _layoutItemTop = 0;
+	int _layoutWidthLeft = 0;
 	object_ptr<Ui::InputField> _field;
 	object_ptr<Ui::CrossButton> _cancel;
 
@@ -174,6 +184,9 @@ public:
 	QRect rect() const {
 		return QRect(_x, _y, _width, _st.height);
 	}
+	bool animatingPosition() const {
+		return !_copies.empty();
+	}
 	bool isOverDelete() const {
 		return _overDelete;
 	}
@@ -8,6 +8,13 @@ https://github.com/telegramdesktop/tdesktop/blob/master/LEGAL
 #include "ui/widgets/scroll_area.h"
 
 namespace Ui {
+namespace {
+
+// The kinetic scroll is stepped by the shared animation clock, but
+// not more often than it was with its own timer before.
+constexpr auto kTouchScrollStep = TimeMs(15);
+
+} // namespace
 
 // flick scroll taken from http://qt-project.org/doc/qt-4.8/demos-embedded-anomaly-src-flickcharm-cpp.html
 
@@ -93,8 +100,12 @@ void ScrollBar::updateBar(bool force) {
 		newBar = QRect(x, _st->deltax, w, height() - 2 * _st->deltax);
 	}
 	if (newBar != _bar) {
+		// The bar is repainted on each scroll position change, so only
+		// the thumb delta is invalidated, not the whole bar length.
+		// One pixel is added for the rounded corners antialiasing.
+		const auto updated = newBar.united(_bar).adjusted(-1, -1, 1, 1);
 		_bar = newBar;
-		update();
+		update(updated);
 	}
 	if (_vertical) {
 		bool newTopSh = (_st->topsh < 0) || (area()->scrollTop() > _st->topsh), newBottomSh = (_st->bottomsh < 0) || (area()->scrollTop() < area()->scrollTopMax() - _st->bottomsh);
@@ -313,7 +324,8 @@ ScrollArea::ScrollArea(QWidget *parent, const style::ScrollArea &st, bool handle
 , _verticalBar(this, true, &_st)
 , _topShadow(this, &_st)
 , _bottomShadow(this, &_st)
-, _touchEnabled(handleTouch) {
+, _touchEnabled(handleTouch)
+, _a_touchScroll(animation(this, &ScrollArea::step_touchScroll)) {
 	setLayoutDirection(cLangDir());
 	setFocusPolicy(Qt::NoFocus);
 
@@ -334,7 +346,6 @@ ScrollArea::ScrollArea(QWidget *parent, const style::ScrollArea &st, bool handle
 		viewport()->setAttribute(Qt::WA_AcceptTouchEvents);
 		_touchTimer.setSingleShot(true);
 		connect(&_touchTimer, SIGNAL(timeout()), this, SLOT(onTouchTimer()));
-		connect(&_touchScrollTimer, SIGNAL(timeout()), this, SLOT(onTouchScrollTimer()));
 	}
 }
 
@@ -418,24 +429,31 @@ void ScrollArea::onTouchTimer() {
 	_touchRightButton = true;
 }
 
-void ScrollArea::onTouchScrollTimer() {
-	auto nowTime = getms();
-	if (_touchScrollState == TouchScrollState::Acceleration && _touchWaitingAcceleration && (nowTime - _touchAccelerationTime) > 40) {
+void ScrollArea::step_touchScroll(TimeMs ms, bool timer) {
+	if (_touchScrollState == TouchScrollState::Acceleration && _touchWaitingAcceleration && (ms - _touchAccelerationTime) > 40) {
 		_touchScrollState = TouchScrollState::Manual;
 		touchResetSpeed();
+		_a_touchScroll.stop();
 	} else if (_touchScrollState == TouchScrollState::Auto || _touchScrollState == TouchScrollState::Acceleration) {
-		int32 elapsed = int32(nowTime - _touchTime);
+		int32 elapsed = int32(ms - _touchTime);
+		if (elapsed < kTouchScrollStep) {
+			// The shared animation clock ticks more often than the
+			// kinetic scroll step, wait for the next step to come.
+			return;
+		}
 		QPoint delta = _touchSpeed * elapsed / 1000;
 		bool hasScrolled = touchScroll(delta);
 
 		if (_touchSpeed.isNull() || !hasScrolled) {
 			_touchScrollState = TouchScrollState::Manual;
 			_touchScroll = false;
-			_touchScrollTimer.stop();
+			_a_touchScroll.stop();
 		} else {
-			_touchTime = nowTime;
+			_touchTime = ms;
 		}
 		touchDeaccelerate(elapsed);
+	} else {
+		_a_touchScroll.stop();
 	}
 }
 
@@ -560,7 +578,7 @@ void ScrollArea::touchEvent(QTouchEvent *e) {
 			if (_touchScrollState == TouchScrollState::Manual) {
 				_touchScrollState = TouchScrollState::Auto;
 				_touchPrevPosValid = false;
-				_touchScrollTimer.start(15);
+				_a_touchScroll.start();
 				_touchTime = getms();
 			} else if (_touchScrollState == TouchScrollState::Auto) {
 				_touchScrollState = TouchScrollState::Manual;
@@ -229,7 +229,6 @@ public slots:
 	void onInnerResized();
 
 	void onTouchTimer();
-	void onTouchScrollTimer();
 
 	void onResizeOther();
 	void onUpdateOther(const QRect&);
@@ -254,6 +253,7 @@ private:
 
 	bool touchScroll(const QPoint &delta);
 
+	void step_touchScroll(TimeMs ms, bool timer);
 	void touchScrollUpdated(const QPoint &screenPos);
 
 	void touchResetSpeed();
@@ -282,7 +282,7 @@ private:
 	TimeMs _touchSpeedTime = 0;
 	TimeMs _touchAccelerationTime = 0;
 	TimeMs _touchTime = 0;
-	QTimer _touchScrollTimer;
+	BasicAnimation _a_touchScroll;
 
 	bool _widgetAcceptsTouch = false;
 
@@ -72,6 +72,7 @@ private:
 	void setLayerShown(bool shown);
 	void checkWasShown(bool wasShown);
 	void animationCallback();
+	void updateAnimatingRegion();
 
 	QPixmap _bodyCache;
 	QPixmap _mainMenuCache;
@@ -328,10 +329,52 @@ void LayerStackWidget::BackgroundWidget::finishAnimating() {
 }
 
 void LayerStackWidget::BackgroundWidget::animationCallback() {
-	update();
+	updateAnimatingRegion();
 	checkIfDone();
 }
 
+void LayerStackWidget::BackgroundWidget::updateAnimatingRegion() {
+	// While the background dim fades or the main menu slides the whole
+	// window content changes each frame, but the box fade animations
+	// repaint everything outside the boxes with exactly the same content,
+	// so clip those repaints to the animating boxes with their shadows.
+	if (rtl()
+		|| _a_shown.animating()
+		|| _a_mainMenuShown.animating()) {
+		update();
+		return;
+	}
+	const auto boxRegion = [&](QRect box, bool cached) {
+		if (box.isEmpty()) {
+			return QRect();
+		} else if (cached && _mainMenuRight > 0) {
+			// Showing boxes are moved right while the main menu is shown.
+			box.moveLeft(box.left() + _mainMenuRight / 2);
+		}
+		return box.marginsAdded(st::boxRoundShadow.extend);
+	};
+	auto region = QRegion();
+	if (_a_specialLayerShown.animating() || _a_layerShown.animating()) {
+		// A box fading above the special layer also repaints the special
+		// layer box, filling it with the changing complex opacity.
+		region += boxRegion(
+			_specialLayerCache.isNull()
+				? _specialLayerBox
+				: _specialLayerCacheBox,
+			!_specialLayerCache.isNull());
+	}
+	if (_a_layerShown.animating()) {
+		region += boxRegion(
+			_layerCache.isNull() ? _layerBox : _layerCacheBox,
+			!_layerCache.isNull());
+	}
+	if (region.isEmpty()) {
+		update();
+	} else {
+		update(region);
+	}
+}
+
 LayerStackWidget::LayerStackWidget(QWidget *parent)
 : RpWidget(parent)
 , _background(this) {
@@ -307,11 +307,19 @@ void MainWindow::handleActiveChanged() {
 }
 
 void MainWindow::updatePalette() {
+	// A theme apply that is known to have changed no palette entries
+	// (for example re-applying the active theme) needs no repainting.
+	const auto diff = Theme::LastPaletteDiff();
+	if (diff && diff->isEmpty()) {
+		return;
+	}
 	Ui::ForceFullRepaint(this);
 
-	auto p = palette();
-	p.setColor(QPalette::Window, st::windowBg->c);
-	setPalette(p);
+	if (Theme::PaletteEntryChanged(st::windowBg)) {
+		auto p = palette();
+		p.setColor(QPalette::Window, st::windowBg->c);
+		setPalette(p);
+	}
 }
 
 HitTestResult MainWindow::hitTest(const QPoint &p) const {
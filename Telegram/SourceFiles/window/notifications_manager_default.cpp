@@ -63,6 +63,11 @@ Manager::Manager(System *system)
 	subscribe(system->settingsChanged(), [this](ChangeType change) {
 		settingsChanged(change);
 	});
+	subscribe(Window::Theme::Background(), [this](const Window::Theme::BackgroundUpdate &data) {
+		if (data.paletteChanged()) {
+			_actionsCache = QPixmap();
+		}
+	});
 }
 
 Manager::QueuedNotification::QueuedNotification(
@@ -83,6 +88,14 @@ QPixmap Manager::hiddenUserpicPlaceholder() const {
 	return _hiddenUserpicPlaceholder;
 }
 
+QPixmap Manager::actionsCache() const {
+	return _actionsCache;
+}
+
+void Manager::setActionsCache(QPixmap cache) {
+	_actionsCache = std::move(cache);
+}
+
 bool Manager::hasReplyingNotification() const {
 	for_const (auto &notification, _notifications) {
 		if (notification->isReplying()) {
@@ -206,6 +219,7 @@ void Manager::showNextFromQueue() {
 			queued.author,
 			queued.item,
 			queued.forwardedCount,
+			queued.batchedCount,
 			startPosition, startShift, shiftDirection);
 		_notifications.push_back(std::move(notification));
 		--count;
@@ -289,6 +303,27 @@ void Manager::removeWidget(internal::Widget *remove) {
 }
 
 void Manager::doShowNotification(HistoryItem *item, int forwardedCount) {
+	// Coalesce a burst from one chat into a single grouped entry while
+	// its notification is still waiting in the queue, so a storm in a
+	// busy group doesn't render a separate toast for every message.
+	if (forwardedCount < 2) {
+		for (auto &queued : _queuedNotifications) {
+			if (queued.history == item->history()
+				&& queued.forwardedCount < 2) {
+				const auto author = (!queued.peer->isUser()
+					&& !item->isPost())
+					? item->author().get()
+					: nullptr;
+				if (queued.author != author) {
+					queued.author = nullptr;
+				}
+				queued.item = item;
+				++queued.batchedCount;
+				showNextFromQueue();
+				return;
+			}
+		}
+	}
 	_queuedNotifications.push_back(QueuedNotification(item, forwardedCount));
 	showNextFromQueue();
 }
@@ -501,6 +536,7 @@ Notification::Notification(
 	PeerData *author,
 	HistoryItem *msg,
 	int forwardedCount,
+	int batchedCount,
 	QPoint startPosition,
 	int shift,
 	Direction shiftDirection)
@@ -511,8 +547,9 @@ Notification::Notification(
 , _history(history)
 , _peer(peer)
 , _author(author)
-, _item(msg)
+, _item((batchedCount < 2) ? msg : nullptr)
 , _forwardedCount(forwardedCount)
+, _batchedCount(batchedCount)
 , _close(this, st::notifyClose)
 , _reply(this, langFactory(lng_notification_reply), st::defaultBoxButton) {
 	subscribe(Lang::Current().updated(), [this] { refreshLang(); });
@@ -567,6 +604,17 @@ void Notification::refreshLang() {
 }
 
 void Notification::prepareActionsCache() {
+	// The actions pixmap is the same for all toasts of the default
+	// height, so grabbing the reply button and composing the fade is
+	// done once per palette and then shared through the manager.
+	const auto defaultHeight = (height() == st::notifyMinHeight);
+	if (defaultHeight) {
+		auto cached = manager()->actionsCache();
+		if (!cached.isNull()) {
+			_buttonsCache = std::move(cached);
+			return;
+		}
+	}
 	auto replyCache = Ui::GrabWidget(_reply);
 	auto fadeWidth = st::notifyFadeRight.width();
 	auto actionsTop = st::notifyTextTop + st::msgNameFont->height;
@@ -583,6 +631,9 @@ void Notification::prepareActionsCache() {
 		p.drawPixmapRight(replyRight, _reply->y() - actionsTop, actionsCacheWidth, replyCache);
 	}
 	_buttonsCache = App::pixmapFromImageInPlace(std::move(actionsCacheImg));
+	if (defaultHeight) {
+		manager()->setActionsCache(_buttonsCache);
+	}
 }
 
 bool Notification::checkLastInput(bool hasReplyingNotifications) {
@@ -648,7 +699,7 @@ void Notification::actionsOpacityCallback() {
 }
 
 void Notification::updateNotifyDisplay() {
-	if (!_history || !_peer || (!_item && _forwardedCount < 2)) return;
+	if (!_history || !_peer || (!_item && _forwardedCount < 2 && _batchedCount < 2)) return;
 
 	auto options = Manager::getNotificationOptions(_item);
 	_hideReplyButton = options.hideReplyButton;
@@ -706,6 +757,16 @@ void Notification::updateNotifyDisplay() {
 				}
 				p.setPen(st::dialogsTextFg);
 				p.drawText(r.left(), r.top() + st::dialogsTextFont->ascent, lng_forward_messages(lt_count, _forwardedCount));
+			} else if (_batchedCount > 1) {
+				p.setFont(st::dialogsTextFont);
+				if (_author) {
+					itemTextCache.setText(st::dialogsTextStyle, _author->name);
+					p.setPen(st::dialogsTextFgService);
+					itemTextCache.drawElided(p, r.left(), r.top(), r.width());
+					r.setTop(r.top() + st::dialogsTextFont->height);
+				}
+				p.setPen(st::dialogsTextFg);
+				p.drawText(r.left(), r.top() + st::dialogsTextFont->ascent, lng_notification_new_messages(lt_count, _batchedCount));
 			}
 		} else {
 			static QString notifyText = st::dialogsTextFont->elided(lang(lng_notification_preview), itemWidth);
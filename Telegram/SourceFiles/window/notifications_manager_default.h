@@ -49,6 +49,8 @@ private:
 	using HideAllButton = internal::HideAllButton;
 
 	QPixmap hiddenUserpicPlaceholder() const;
+	QPixmap actionsCache() const;
+	void setActionsCache(QPixmap cache);
 
 	void doUpdateAll() override;
 	void doShowNotification(HistoryItem *item, int forwardedCount) override;
@@ -89,6 +91,7 @@ private:
 		PeerData *author;
 		HistoryItem *item;
 		int forwardedCount;
+		int batchedCount = 1;
 	};
 	std::deque<QueuedNotification> _queuedNotifications;
 
@@ -96,6 +99,10 @@ private:
 
 	mutable QPixmap _hiddenUserpicPlaceholder;
 
+	// The reply / fade actions pixmap is the same for all notifications,
+	// so it is rendered once and shared between the toast windows.
+	QPixmap _actionsCache;
+
 };
 
 namespace internal {
@@ -166,7 +173,7 @@ protected:
 
 class Notification : public Widget {
 public:
-	Notification(Manager *manager, History *history, PeerData *peer, PeerData *author, HistoryItem *item, int forwardedCount, QPoint startPosition, int shift, Direction shiftDirection);
+	Notification(Manager *manager, History *history, PeerData *peer, PeerData *author, HistoryItem *item, int forwardedCount, int batchedCount, QPoint startPosition, int shift, Direction shiftDirection);
 
 	void startHiding();
 	void stopHiding();
@@ -225,6 +232,7 @@ private:
 	PeerData *_author;
 	HistoryItem *_item;
 	int _forwardedCount;
+	int _batchedCount;
 	object_ptr<Ui::IconButton> _close;
 	object_ptr<Ui::RoundButton> _reply;
 	object_ptr<Background> _background = { nullptr };
@@ -45,6 +45,10 @@ struct Applying {
 NeverFreedPointer<ChatBackground> GlobalBackground;
 Applying GlobalApplying;
 
+// Filled by the last main palette apply, nullopt when the change could
+// not be tracked (loading a cache or resetting to the default palette).
+std::optional<QVector<int>> GlobalPaletteDiff;
+
 inline bool AreTestingTheme() {
 	return !GlobalApplying.paletteForRevert.isEmpty();
 };
@@ -199,7 +203,10 @@ void applyBackground(QImage &&background, bool tiled, Instance *out) {
 	}
 }
 
-bool loadThemeFromCache(const QByteArray &content, const Cached &cache) {
+bool loadThemeFromCache(
+		const QByteArray &content,
+		const Cached &cache,
+		Instance *out = nullptr) {
 	if (cache.paletteChecksum != style::palette::Checksum()) {
 		return false;
 	}
@@ -219,12 +226,16 @@ bool loadThemeFromCache(const QByteArray &content, const Cached &cache) {
 		}
 	}
 
-	if (!style::main_palette::load(cache.colors)) {
+	if (out) {
+		if (!out->palette.load(cache.colors)) {
+			return false;
+		}
+	} else if (!style::main_palette::load(cache.colors)) {
 		return false;
 	}
 	Background()->saveAdjustableColors();
 	if (!background.isNull()) {
-		applyBackground(std::move(background), cache.tiled, nullptr);
+		applyBackground(std::move(background), cache.tiled, out);
 	}
 
 	return true;
@@ -265,6 +276,12 @@ bool loadBackground(zlib::FileToRead &file, QByteArray *outBackground, bool *out
 }
 
 bool loadTheme(const QByteArray &content, Cached &cache, Instance *out = nullptr) {
+	if (out && loadThemeFromCache(content, cache, out)) {
+		// The cache is keyed by the content checksum, so re-applying an
+		// already prepared theme (the day/night switch) skips the archive
+		// parsing and the background image decoding entirely.
+		return true;
+	}
 	cache = Cached();
 	zlib::FileToRead file(content);
 
@@ -758,7 +775,7 @@ void ChatBackground::restoreAdjustableColors() {
 }
 
 void ChatBackground::setTestingTheme(Instance &&theme) {
-	style::main_palette::apply(theme.palette);
+	GlobalPaletteDiff = style::main_palette::apply(theme.palette);
 	saveAdjustableColors();
 
 	auto switchToThemeBackground = !theme.background.isNull()
@@ -792,6 +809,7 @@ void ChatBackground::setTestingTheme(Instance &&theme) {
 
 void ChatBackground::setTestingDefaultTheme() {
 	style::main_palette::reset();
+	GlobalPaletteDiff = std::nullopt;
 	saveAdjustableColors();
 
 	saveForRevert();
@@ -1052,6 +1070,7 @@ void Revert() {
 		return;
 	}
 	style::main_palette::load(GlobalApplying.paletteForRevert);
+	GlobalPaletteDiff = std::nullopt;
 	Background()->saveAdjustableColors();
 
 	ClearApplying();
@@ -1062,6 +1081,17 @@ QString NightThemePath() {
 	return str_const_toString(kNightThemeFile);
 }
 
+std::optional<QVector<int>> LastPaletteDiff() {
+	return GlobalPaletteDiff;
+}
+
+bool PaletteEntryChanged(style::color color) {
+	if (!GlobalPaletteDiff) {
+		return true;
+	}
+	return GlobalPaletteDiff->contains(style::main_palette::indexOfColor(color));
+}
+
 bool IsNonDefaultBackground() {
 	return Background()->isNonDefaultBackground();
 }
@@ -60,6 +60,13 @@ void ToggleNightMode(const QString &themePath);
 [[nodiscard]] bool IsNonDefaultBackground();
 void Revert();
 
+// Indices of style::palette entries changed by the last theme apply,
+// nullopt when the change could not be tracked (cache load or reset).
+// Subscribers of paletteChanged() updates may use these to invalidate
+// only the caches that depend on entries that really changed.
+[[nodiscard]] std::optional<QVector<int>> LastPaletteDiff();
+[[nodiscard]] bool PaletteEntryChanged(style::color color);
+
 bool LoadFromFile(const QString &file, Instance *out, QByteArray *outContent);
 bool IsPaletteTestingPath(const QString &path);
 QColor CountAverageColor(const QImage &image);
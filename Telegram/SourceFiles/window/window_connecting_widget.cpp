@@ -34,6 +34,10 @@ private:
 
 	Ui::InfiniteRadialAnimation _animation;
 
+	// This radial can spin for as long as the connection is being
+	// established, so its frame loop is prerendered once and blitted.
+	Ui::RadialSpriteLoop _frames;
+
 };
 
 Progress::Progress(QWidget *parent)
@@ -55,7 +59,8 @@ void Progress::paintEvent(QPaintEvent *e) {
 		p,
 		{ shift, shift },
 		QSize(st.size.width() - 2 * shift, st.size.height() - 2 * shift),
-		width());
+		width(),
+		_frames);
 }
 
 void Progress::step(TimeMs ms, bool timer) {
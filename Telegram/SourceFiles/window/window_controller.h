@@ -46,6 +46,10 @@ enum class GifPauseReason {
 	Layer         = (1 << 2),
 	RoundPlaying  = (1 << 3),
 	MediaPreview  = (1 << 4),
+
+	// The highest reason, set by MainWindow while the main loop misses
+	// frame deadlines, so it pauses gifs for every query level.
+	Overload      = (1 << 5),
 };
 using GifPauseReasons = base::flags<GifPauseReason>;
 inline constexpr bool is_flag_type(GifPauseReason) { return true; };
@@ -65,36 +65,6 @@ checksum countChecksum(const void *data, std::size_t size) {
 
 namespace {
 
-class string_span {
-public:
-	string_span() = default;
-	string_span(const utf16string *data, std::size_t size) : begin_(data), size_(size) {
-	}
-	string_span(const std::vector<utf16string> &data) : begin_(data.data()), size_(data.size()) {
-	}
-	string_span(const string_span &other) = default;
-	string_span &operator=(const string_span &other) = default;
-
-	const utf16string *begin() const {
-		return begin_;
-	}
-	const utf16string *end() const {
-		return begin_ + size_;
-	}
-	std::size_t size() const {
-		return size_;
-	}
-
-	string_span subspan(std::size_t offset, std::size_t size) {
-		return string_span(begin_ + offset, size);
-	}
-
-private:
-	const utf16string *begin_ = nullptr;
-	std::size_t size_ = 0;
-
-};
-
 bool IsNumber(utf16char ch) {
 	return (ch >= '0' && ch <= '9');
 }
@@ -139,7 +109,7 @@ private:
 	const utf16char *_queryBegin = nullptr;
 	int _querySize = 0;
 
-	const std::vector<const Replacement*> *_initialList = nullptr;
+	span<const Replacement*> _initialList;
 
 	string_span _currentItemWords;
 	int _currentItemWordsUsedCount = 0;
@@ -227,10 +197,10 @@ std::vector<Suggestion> Completer::resolve() {
 		return std::vector<Suggestion>();
 	}
 	_initialList = Ui::Emoji::internal::GetReplacements(*_queryBegin);
-	if (!_initialList) {
+	if (_initialList.empty()) {
 		return std::vector<Suggestion>();
 	}
-	_result.reserve(_initialList->size());
+	_result.reserve(_initialList.size());
 	processInitialList();
 	return prepareResult();
 }
@@ -270,7 +240,7 @@ void Completer::processInitialList() {
 		filterInitialList();
 	} else {
 		_currentItemWordsUsedCount = 1;
-		for (auto item : *_initialList) {
+		for (auto item : _initialList) {
 			addResult(item);
 		}
 	}
@@ -278,7 +248,7 @@ void Completer::processInitialList() {
 
 void Completer::initWordsTracking() {
 	auto maxWordsCount = 0;
-	for (auto item : *_initialList) {
+	for (auto item : _initialList) {
 		auto wordsCount = item->words.size();
 		if (maxWordsCount < wordsCount) {
 			maxWordsCount = wordsCount;
@@ -289,8 +259,8 @@ void Completer::initWordsTracking() {
 
 void Completer::filterInitialList() {
 	initWordsTracking();
-	for (auto item : *_initialList) {
-		_currentItemWords = string_span(item->words);
+	for (auto item : _initialList) {
+		_currentItemWords = item->words;
 		_currentItemWordsUsedCount = 1;
 		if (matchQueryForCurrentItem()) {
 			addResult(item);
@@ -20,20 +20,20 @@ static_assert(sizeof(utf16char) == 2, "Bad UTF-16 character size.");
 
 class utf16string {
 public:
-	utf16string() = default;
-	utf16string(const utf16char *data, std::size_t size) : data_(data), size_(size) {
+	constexpr utf16string() = default;
+	constexpr utf16string(const utf16char *data, std::size_t size) : data_(data), size_(size) {
 	}
 	utf16string(const utf16string &other) = default;
 	utf16string &operator=(const utf16string &other) = default;
 
-	const utf16char *data() const {
+	constexpr const utf16char *data() const {
 		return data_;
 	}
-	std::size_t size() const {
+	constexpr std::size_t size() const {
 		return size_;
 	}
 
-	utf16char operator[](int index) const {
+	constexpr utf16char operator[](int index) const {
 		return data_[index];
 	}
 
@@ -47,6 +47,44 @@ inline bool operator==(utf16string a, utf16string b) {
 	return (a.size() == b.size()) && (!a.size() || !memcmp(a.data(), b.data(), a.size() * sizeof(utf16char)));
 }
 
+// A non-owning view over constant data, the compiled suggestions
+// tables are only referenced through it, never copied or parsed.
+template <typename T>
+class span {
+public:
+	constexpr span() = default;
+	constexpr span(const T *data, std::size_t size) : begin_(data), size_(size) {
+	}
+	span(const std::vector<T> &data) : begin_(data.data()), size_(data.size()) {
+	}
+	span(const span &other) = default;
+	span &operator=(const span &other) = default;
+
+	constexpr const T *begin() const {
+		return begin_;
+	}
+	constexpr const T *end() const {
+		return begin_ + size_;
+	}
+	constexpr std::size_t size() const {
+		return size_;
+	}
+	constexpr bool empty() const {
+		return size_ == 0;
+	}
+
+	constexpr span subspan(std::size_t offset, std::size_t size) const {
+		return span(begin_ + offset, size);
+	}
+
+private:
+	const T *begin_ = nullptr;
+	std::size_t size_ = 0;
+
+};
+
+using string_span = span<utf16string>;
+
 namespace internal {
 
 using checksum = unsigned int;
@@ -55,6 +55,7 @@
       '<(src_loc)/base/enum_mask.h',
       '<(src_loc)/base/flat_map.h',
       '<(src_loc)/base/flat_set.h',
+      '<(src_loc)/base/frame_coalesce.h',
       '<(src_loc)/base/functors.h',
       '<(src_loc)/base/index_based_iterator.h',
 	  '<(src_loc)/base/last_used_cache.h',
@@ -117,6 +117,23 @@
       '<(src_loc)/rpl/variable.h',
       '<(src_loc)/rpl/variable_tests.cpp',
     ],
+  }, {
+    # Not listed in tests_list.txt on purpose: benchmarks are built and
+    # run explicitly, their results are tracked instead of asserted.
+    # Run with --output <file> to get the JSON report for CI.
+    'target_name': 'tests_bench',
+    'includes': [
+      'common_test.gypi',
+    ],
+    'sources': [
+      '<(src_loc)/base/benchmarks_main.cpp',
+      '<(src_loc)/base/flat_map.h',
+      '<(src_loc)/base/flat_set.h',
+      '<(src_loc)/rpl/rpl.h',
+    ],
+    'sources!': [
+      '<(src_loc)/base/tests_main.cpp',
+    ],
   }, {
     'target_name': 'tests_storage',
     'includes': [